@@ -0,0 +1,375 @@
+/*! @file bench_ad5697r.c
+ * @brief Host benchmark of the AD5697R 12-Bit, DAC C driver against the device emulator.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ad5697r.h"
+#include "ad5697r_sequence.h"
+#include "ad5697r_emu.h"
+#include "ad5697r_volts.h"
+#include "ad5697r_capture.h"
+
+#define BENCH_ADDR              (0x0C)
+#define BENCH_ENCODE_ITERATIONS (1000000u)
+#define BENCH_LATENCY_UPDATES   (100000u)
+#define BENCH_BATCH_FRAMES      (32u)
+#define BENCH_SEQ_FRAMES        (256u)
+#define BENCH_VOLTS_SAMPLES     (4096u)
+#define BENCH_VOLTS_ROUNDS      (1000u)
+#define BENCH_CAPTURE_BUF_SIZE  (65536u)
+
+/*!
+ * @brief Latency summary for one transport mode at one bus speed
+ */
+typedef struct {
+    double updatesPerSec;
+    double bytesPerUpdate;
+    uint32_t p50Ns;
+    uint32_t p99Ns;
+    uint32_t p999Ns;
+    uint32_t maxNs;
+} bench_latency_t;
+
+static const uint32_t bench_speeds[] = {
+    100000, AD5697R_I2C_FAST_MODE_HZ, AD5697R_I2C_FAST_PLUS_MODE_HZ, 3400000
+};
+
+static uint32_t bench_samples[BENCH_LATENCY_UPDATES];
+static uint8_t bench_buf[AD5697R_BATCH_BUF_SIZE(BENCH_SEQ_FRAMES)];
+static float bench_volts[BENCH_VOLTS_SAMPLES];
+static uint8_t bench_frames[AD5697R_BATCH_BUF_SIZE(BENCH_VOLTS_SAMPLES)];
+static uint8_t bench_capture[BENCH_CAPTURE_BUF_SIZE];
+static ad5697r_capture_t bench_cap;     /* Stays selected as the recorder of ad5697r_captureWrite() */
+
+static uint64_t bench_nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static int8_t bench_nullWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    (void)busAddr;
+    (void)data;
+    (void)len;
+    return AD5697R_RET_OK;
+}
+
+static int8_t bench_nullSink(void *ctx, const uint8_t *data, const uint32_t len) {
+    (void)ctx;
+    (void)data;
+    (void)len;
+    return AD5697R_RET_OK;
+}
+
+static int bench_compareU32(const void *a, const void *b) {
+    const uint32_t x = *(const uint32_t *)a;
+    const uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t bench_percentile(const uint32_t *sorted, const uint32_t count, const double pct) {
+    uint32_t idx = (uint32_t)(((double)count * pct) / 100.0);
+
+    if( idx >= count ) {
+        idx = count - 1;
+    }
+    return sorted[idx];
+}
+
+static void bench_summarize(bench_latency_t *res, const uint32_t count, const uint32_t updates, const uint64_t totalNs, const uint32_t wireBytes) {
+    qsort(bench_samples, count, sizeof(bench_samples[0]), bench_compareU32);
+
+    res->updatesPerSec = (totalNs > 0) ? ((double)updates * 1e9) / (double)totalNs : 0.0;
+    res->bytesPerUpdate = (double)wireBytes / (double)updates;
+    res->p50Ns = bench_percentile(bench_samples, count, 50.0);
+    res->p99Ns = bench_percentile(bench_samples, count, 99.0);
+    res->p999Ns = bench_percentile(bench_samples, count, 99.9);
+    res->maxNs = bench_samples[count - 1];
+}
+
+/*!
+ * @brief Host CPU time spent encoding and handing off one frame per call
+ */
+static double bench_encodeSingle(void) {
+    ad5697r_dev_t dev = {0};
+    uint64_t start = 0;
+    uint32_t i = 0;
+
+    dev.intf.i2c_addr = BENCH_ADDR;
+    dev.intf.write = bench_nullWrite;
+
+    start = bench_nowNs();
+    for( i = 0; i < BENCH_ENCODE_ITERATIONS; i++ ) {
+        ad5697r_writeChannel(&dev, (i & 1u) ? AD5697R_OUTPUT_CH_B : AD5697R_OUTPUT_CH_A, (uint16_t)(i & 0x0FFF));
+    }
+    return (double)(bench_nowNs() - start) / (double)BENCH_ENCODE_ITERATIONS;
+}
+
+/*!
+ * @brief Host CPU time spent encoding one frame into a batch
+ */
+static double bench_encodeBatch(void) {
+    ad5697r_dev_t dev = {0};
+    ad5697r_batch_t batch;
+    uint64_t start = 0;
+    uint32_t i = 0;
+
+    dev.intf.i2c_addr = BENCH_ADDR;
+    dev.intf.write = bench_nullWrite;
+    ad5697r_batchInit(&batch, &dev, bench_buf, AD5697R_BATCH_BUF_SIZE(BENCH_BATCH_FRAMES));
+
+    start = bench_nowNs();
+    for( i = 0; i < BENCH_ENCODE_ITERATIONS; i++ ) {
+        ad5697r_batchWriteChannel(&batch, (i & 1u) ? AD5697R_OUTPUT_CH_B : AD5697R_OUTPUT_CH_A, (uint16_t)(i & 0x0FFF));
+        if( (i % BENCH_BATCH_FRAMES) == (BENCH_BATCH_FRAMES - 1) ) {
+            ad5697r_batchCommit(&batch);
+        }
+    }
+    return (double)(bench_nowNs() - start) / (double)BENCH_ENCODE_ITERATIONS;
+}
+
+/*!
+ * @brief Host CPU time spent converting one voltage sample to a wire format frame
+ */
+static double bench_voltsToFrames(void) {
+    ad5697r_dev_t dev = {0};
+    ad5697r_volts_t conv;
+    uint64_t start = 0;
+    uint32_t i = 0;
+
+    ad5697r_voltsInit(&conv, &dev, 1, 0.0f);
+    for( i = 0; i < BENCH_VOLTS_SAMPLES; i++ ) {
+        bench_volts[i] = 2.5f * (float)i / (float)BENCH_VOLTS_SAMPLES;
+    }
+
+    start = bench_nowNs();
+    for( i = 0; i < BENCH_VOLTS_ROUNDS; i++ ) {
+        ad5697r_voltsToFrames(&conv, AD5697R_OUTPUT_CH_A, bench_volts, bench_frames, BENCH_VOLTS_SAMPLES);
+    }
+    return (double)(bench_nowNs() - start) / ((double)BENCH_VOLTS_ROUNDS * BENCH_VOLTS_SAMPLES);
+}
+
+/*!
+ * @brief Host CPU time of one single frame write, direct and through the
+ * capture recorder. Negative when the recorder could not be set up.
+ */
+static double bench_captureWrite(const ad5697r_write_fptr_t write) {
+    ad5697r_capture_config_t config = {0};
+    ad5697r_dev_t dev = {0};
+    uint64_t start = 0;
+    uint32_t i = 0;
+
+    config.write = bench_nullWrite;
+    config.sink = bench_nullSink;
+    if( ad5697r_captureInit(&bench_cap, &config, bench_capture, sizeof(bench_capture)) != AD5697R_RET_OK ) {
+        return -1.0;
+    }
+
+    dev.intf.i2c_addr = BENCH_ADDR;
+    dev.intf.write = write;
+
+    start = bench_nowNs();
+    for( i = 0; i < BENCH_ENCODE_ITERATIONS; i++ ) {
+        ad5697r_writeChannel(&dev, AD5697R_OUTPUT_CH_A, (uint16_t)(i & 0x0FFF));
+    }
+    return (double)(bench_nowNs() - start) / BENCH_ENCODE_ITERATIONS;
+}
+
+/*!
+ * @brief Per-update latency of individual writes. Each sample is the host
+ * time of the call plus the modelled wire time of its transaction.
+ */
+static void bench_latencySingle(bench_latency_t *res, ad5697r_dev_t *dev, ad5697r_emu_bus_t *bus) {
+    uint64_t total = 0;
+    uint64_t busBefore = 0;
+    uint64_t start = 0;
+    uint64_t sample = 0;
+    uint32_t i = 0;
+
+    ad5697r_emuBusResetStats(bus);
+    for( i = 0; i < BENCH_LATENCY_UPDATES; i++ ) {
+        busBefore = bus->busTimeNs;
+        start = bench_nowNs();
+        ad5697r_writeChannel(dev, AD5697R_OUTPUT_CH_A, (uint16_t)(i & 0x0FFF));
+        sample = (bench_nowNs() - start) + (bus->busTimeNs - busBefore);
+
+        bench_samples[i] = (sample > UINT32_MAX) ? UINT32_MAX : (uint32_t)sample;
+        total += sample;
+    }
+    bench_summarize(res, BENCH_LATENCY_UPDATES, BENCH_LATENCY_UPDATES, total, bus->wireBytes);
+}
+
+/*!
+ * @brief Per-commit latency of batched writes. A sample covers encoding the
+ * whole batch and its single transaction, i.e. the latency of the last update.
+ */
+static void bench_latencyBatch(bench_latency_t *res, ad5697r_dev_t *dev, ad5697r_emu_bus_t *bus) {
+    ad5697r_batch_t batch;
+    uint64_t total = 0;
+    uint64_t busBefore = 0;
+    uint64_t start = 0;
+    uint64_t sample = 0;
+    uint32_t commits = BENCH_LATENCY_UPDATES / BENCH_BATCH_FRAMES;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    ad5697r_batchInit(&batch, dev, bench_buf, AD5697R_BATCH_BUF_SIZE(BENCH_BATCH_FRAMES));
+    ad5697r_emuBusResetStats(bus);
+    for( i = 0; i < commits; i++ ) {
+        busBefore = bus->busTimeNs;
+        start = bench_nowNs();
+        for( j = 0; j < BENCH_BATCH_FRAMES; j++ ) {
+            ad5697r_batchWriteChannel(&batch, (j & 1u) ? AD5697R_OUTPUT_CH_B : AD5697R_OUTPUT_CH_A, (uint16_t)((i + j) & 0x0FFF));
+        }
+        ad5697r_batchCommit(&batch);
+        sample = (bench_nowNs() - start) + (bus->busTimeNs - busBefore);
+
+        bench_samples[i] = (sample > UINT32_MAX) ? UINT32_MAX : (uint32_t)sample;
+        total += sample;
+    }
+    bench_summarize(res, commits, commits * BENCH_BATCH_FRAMES, total, bus->wireBytes);
+}
+
+/*!
+ * @brief Wire bytes per logical update of one precompiled sequence replay
+ */
+static double bench_bytesSequence(ad5697r_dev_t *dev, ad5697r_emu_bus_t *bus) {
+    ad5697r_sequence_t seq;
+
+    ad5697r_seqInit(&seq, bench_buf, sizeof(bench_buf));
+    ad5697r_seqAddSine(&seq, AD5697R_OUTPUT_CH_A, BENCH_SEQ_FRAMES, 0x0800, 0x07FF);
+    ad5697r_emuBusResetStats(bus);
+    ad5697r_seqReplay(dev, &seq);
+
+    return (double)bus->wireBytes / (double)BENCH_SEQ_FRAMES;
+}
+
+/*!
+ * @brief Wire bytes per channel update of a synchronized dual-channel write
+ */
+static double bench_bytesSynchronized(ad5697r_dev_t *dev, ad5697r_emu_bus_t *bus) {
+    ad5697r_emuBusResetStats(bus);
+    ad5697r_writeChannelsSynchronized(dev, 0x0123, 0x0456);
+
+    return (double)bus->wireBytes / 2.0;
+}
+
+/*!
+ * @brief Modelled bus time of bringing a device up, with ad5697r_init() or
+ * one call per register
+ */
+static void bench_initBusNs(ad5697r_dev_t *dev, ad5697r_emu_bus_t *bus, uint64_t *initNs, uint64_t *sequentialNs) {
+    ad5697r_config_t config = {0};
+
+    config.refMode = AD5697R_REF_OFF;
+    config.modeB = AD5697R_OP_MODE_TRI_STATE;
+    config.ldacMask = AD5697R_OUTPUT_CH_A;
+    config.setCodes = true;
+    config.codeA = 0x0123;
+    config.codeB = 0x0456;
+
+    ad5697r_emuBusResetStats(bus);
+    ad5697r_init(dev, &config, NULL);
+    *initNs = bus->busTimeNs;
+
+    ad5697r_emuBusResetStats(bus);
+    ad5697r_setReferenceMode(dev, config.refMode);
+    ad5697r_setLdacMask(dev, config.ldacMask);
+    ad5697r_setOperatingMode(dev, AD5697R_OUTPUT_CH_A, config.modeA);
+    ad5697r_setOperatingMode(dev, AD5697R_OUTPUT_CH_B, config.modeB);
+    ad5697r_writeChannel(dev, AD5697R_OUTPUT_CH_A, config.codeA);
+    ad5697r_writeChannel(dev, AD5697R_OUTPUT_CH_B, config.codeB);
+    *sequentialNs = bus->busTimeNs;
+}
+
+static void bench_printLatency(FILE *out, const char *name, const bench_latency_t *res, const char *sep) {
+    fprintf(out, "        \"%s\": {\"updates_per_sec\": %.1f, \"bytes_per_update\": %.3f, "
+                 "\"p50_ns\": %u, \"p99_ns\": %u, \"p99_9_ns\": %u, \"max_ns\": %u}%s\n",
+            name, res->updatesPerSec, res->bytesPerUpdate,
+            (unsigned)res->p50Ns, (unsigned)res->p99Ns, (unsigned)res->p999Ns, (unsigned)res->maxNs, sep);
+}
+
+int main(int argc, char *argv[]) {
+    ad5697r_emu_bus_t bus;
+    ad5697r_emu_dev_t emu;
+    ad5697r_dev_t dev = {0};
+    bench_latency_t single;
+    bench_latency_t batch;
+    FILE *out = stdout;
+    double encodeSingle = 0.0;
+    double encodeBatch = 0.0;
+    double volts = 0.0;
+    double captureDirect = 0.0;
+    double captureRecorded = 0.0;
+    double bytesSync = 0.0;
+    double bytesSeq = 0.0;
+    uint64_t initNs = 0;
+    uint64_t sequentialNs = 0;
+    uint32_t i = 0;
+
+    if( argc > 1 ) {
+        out = fopen(argv[1], "w");
+        if( out == NULL ) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    encodeSingle = bench_encodeSingle();
+    encodeBatch = bench_encodeBatch();
+    volts = bench_voltsToFrames();
+    captureDirect = bench_captureWrite(bench_nullWrite);
+    captureRecorded = bench_captureWrite(ad5697r_captureWrite);
+    if( (captureDirect < 0.0) || (captureRecorded < 0.0) ) {
+        fprintf(stderr, "capture recorder setup failed\n");
+        return 1;
+    }
+
+    dev.intf.i2c_addr = BENCH_ADDR;
+    dev.intf.write = ad5697r_emuWrite;
+    dev.intf.read = ad5697r_emuRead;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"version\": \"%d.%d.%d\",\n", ad5697r_VERSION_MAJOR, ad5697r_VERSION_MINOR, ad5697r_VERSION_PATCH);
+    fprintf(out, "  \"encode_ns_per_frame\": {\"single\": %.2f, \"batch\": %.2f},\n", encodeSingle, encodeBatch);
+    fprintf(out, "  \"volts_ns_per_sample\": {\"kernel\": \"%s\", \"frames\": %.2f},\n", ad5697r_voltsGetKernel(), volts);
+    fprintf(out, "  \"capture_ns_per_write\": {\"direct\": %.2f, \"recorded\": %.2f},\n", captureDirect, captureRecorded);
+    fprintf(out, "  \"speeds\": [\n");
+
+    for( i = 0; i < (sizeof(bench_speeds) / sizeof(bench_speeds[0])); i++ ) {
+        ad5697r_emuBusInit(&bus, bench_speeds[i]);
+        ad5697r_emuAttach(&bus, &emu, BENCH_ADDR, false);
+
+        bench_latencySingle(&single, &dev, &bus);
+        bench_latencyBatch(&batch, &dev, &bus);
+        bytesSync = bench_bytesSynchronized(&dev, &bus);
+        bytesSeq = bench_bytesSequence(&dev, &bus);
+        bench_initBusNs(&dev, &bus, &initNs, &sequentialNs);
+
+        fprintf(out, "    {\n");
+        fprintf(out, "      \"bus_clock_hz\": %u,\n", (unsigned)bench_speeds[i]);
+        fprintf(out, "      \"frame_wire_ns\": %u,\n", (unsigned)ad5697r_getTransactionTimeNs(bench_speeds[i], AD5697R_FRAME_SIZE));
+        fprintf(out, "      \"synchronized_bytes_per_update\": %.3f,\n", bytesSync);
+        fprintf(out, "      \"sequence_bytes_per_update\": %.3f,\n", bytesSeq);
+        fprintf(out, "      \"init_bus_ns\": {\"init\": %llu, \"sequential\": %llu},\n", (unsigned long long)initNs, (unsigned long long)sequentialNs);
+        fprintf(out, "      \"modes\": {\n");
+        bench_printLatency(out, "single", &single, ",");
+        bench_printLatency(out, "batch", &batch, "");
+        fprintf(out, "      }\n");
+        fprintf(out, "    }%s\n", (i + 1 < (sizeof(bench_speeds) / sizeof(bench_speeds[0]))) ? "," : "");
+    }
+
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+
+    if( out != stdout ) {
+        fclose(out);
+    }
+    return 0;
+}
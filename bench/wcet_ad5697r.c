@@ -0,0 +1,213 @@
+/*! @file wcet_ad5697r.c
+ * @brief Host measurement of the worst-case execution time of ad5697r_setpointPublish().
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ad5697r.h"
+#include "ad5697r_setpoint.h"
+
+#define WCET_ADDR               (0x0C)
+#define WCET_WARM_ITERATIONS    (200000u)
+#define WCET_COLD_ITERATIONS    (500u)
+#define WCET_REPEATS            (5u)
+#define WCET_EVICT_SIZE         (8u * 1024u * 1024u)
+#define WCET_CALIBRATE_NS       (50000000u)
+
+/*!
+ * @brief Execution time summary of one scenario
+ */
+typedef struct {
+    uint32_t minNs;
+    uint32_t p50Ns;
+    uint32_t p99Ns;
+    uint32_t p999Ns;
+    uint32_t maxNs;
+    uint32_t maxRawNs;
+} wcet_result_t;
+
+static uint32_t wcet_samples[WCET_WARM_ITERATIONS];
+static uint8_t wcet_evict[WCET_EVICT_SIZE];
+static ad5697r_setpoint_t wcet_sp;
+static double wcet_nsPerTick = 1.0;
+static uint64_t wcet_overheadTicks = 0;
+
+static uint64_t wcet_nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/*!
+ * @brief Finest timer of the host: the time stamp counter on x86, the monotonic clock elsewhere
+ */
+static inline uint64_t wcet_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+
+    // rdtscp waits for the measured code to retire
+    __asm__ __volatile__("rdtscp" : "=a"(lo), "=d"(hi) : : "rcx", "memory");
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return wcet_nowNs();
+#endif
+}
+
+/*!
+ * @brief Measures the nano-seconds per tick and the cost of reading the timer twice
+ */
+static void wcet_calibrate(void) {
+    uint64_t startNs = wcet_nowNs();
+    uint64_t startTicks = wcet_ticks();
+    uint64_t t0 = 0;
+    uint64_t t1 = 0;
+    uint32_t i = 0;
+
+    while( (wcet_nowNs() - startNs) < WCET_CALIBRATE_NS ) {
+    }
+    wcet_nsPerTick = (double)(wcet_nowNs() - startNs) / (double)(wcet_ticks() - startTicks);
+
+    wcet_overheadTicks = UINT64_MAX;
+    for( i = 0; i < WCET_WARM_ITERATIONS; i++ ) {
+        t0 = wcet_ticks();
+        t1 = wcet_ticks();
+        if( (t1 - t0) < wcet_overheadTicks ) {
+            wcet_overheadTicks = t1 - t0;
+        }
+    }
+}
+
+static int8_t wcet_nullWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    (void)busAddr;
+    (void)data;
+    (void)len;
+    return AD5697R_RET_OK;
+}
+
+static int wcet_compareU32(const void *a, const void *b) {
+    const uint32_t x = *(const uint32_t *)a;
+    const uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*!
+ * @brief Times one ad5697r_setpointPublish() call in the state of a scenario
+ */
+static uint64_t wcet_publishTicks(const uint32_t i, const bool fresh, const bool cold) {
+    uint64_t t0 = 0;
+    uint64_t t1 = 0;
+
+    // The producer completes a setpoint just ahead of the tick, so the ISR takes the exchange path
+    if( fresh ) {
+        ad5697r_setpointSet(&wcet_sp, (uint16_t)(i & 0x0FFF), (uint16_t)(~i & 0x0FFF));
+    }
+
+    // Push the setpoint block out of the data cache, as after a long stretch without a tick
+    if( cold ) {
+        memset(wcet_evict, (int)i, sizeof(wcet_evict));
+    }
+
+    t0 = wcet_ticks();
+    ad5697r_setpointPublish(&wcet_sp);
+    t1 = wcet_ticks();
+
+    return ((t1 - t0) > wcet_overheadTicks) ? ((t1 - t0) - wcet_overheadTicks) : 0;
+}
+
+/*!
+ * @brief Times every ad5697r_setpointPublish() call of one scenario. Each call
+ * is repeated from the same state and the fastest repeat is kept, so a host
+ * interrupt only counts if it hits every repeat; the raw maximum is kept too.
+ */
+static void wcet_measure(wcet_result_t *res, const uint32_t iterations, const bool fresh, const bool cold) {
+    uint64_t ticks = 0;
+    uint64_t best = 0;
+    uint64_t raw = 0;
+    uint32_t i = 0;
+    uint32_t r = 0;
+
+    for( i = 0; i < iterations; i++ ) {
+        best = UINT64_MAX;
+        for( r = 0; r < WCET_REPEATS; r++ ) {
+            ticks = wcet_publishTicks(i, fresh, cold);
+            best = (ticks < best) ? ticks : best;
+            raw = (ticks > raw) ? ticks : raw;
+        }
+
+        wcet_samples[i] = (uint32_t)((double)best * wcet_nsPerTick + 0.5);
+    }
+
+    qsort(wcet_samples, iterations, sizeof(wcet_samples[0]), wcet_compareU32);
+    res->minNs = wcet_samples[0];
+    res->p50Ns = wcet_samples[iterations / 2];
+    res->p99Ns = wcet_samples[(uint32_t)(((uint64_t)iterations * 990) / 1000)];
+    res->p999Ns = wcet_samples[(uint32_t)(((uint64_t)iterations * 999) / 1000)];
+    res->maxNs = wcet_samples[iterations - 1];
+    res->maxRawNs = (uint32_t)((double)raw * wcet_nsPerTick + 0.5);
+}
+
+static void wcet_print(FILE *out, const char *name, const wcet_result_t *res, const char *sep) {
+    fprintf(out, "    \"%s\": {\"min_ns\": %u, \"p50_ns\": %u, \"p99_ns\": %u, \"p999_ns\": %u, \"max_ns\": %u, \"max_raw_ns\": %u}%s\n",
+            name, (unsigned)res->minNs, (unsigned)res->p50Ns, (unsigned)res->p99Ns, (unsigned)res->p999Ns, (unsigned)res->maxNs, (unsigned)res->maxRawNs, sep);
+}
+
+int main(int argc, char *argv[]) {
+    ad5697r_dev_t dev = {0};
+    wcet_result_t repeat;
+    wcet_result_t fresh;
+    wcet_result_t cold;
+    FILE *out = stdout;
+    uint32_t budgetNs = 0;
+    uint32_t wcetNs = 0;
+
+    if( argc > 2 ) {
+        budgetNs = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    if( (argc > 1) && (strcmp(argv[1], "-") != 0) ) {
+        out = fopen(argv[1], "w");
+        if( out == NULL ) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    // The transport is left out, only the cost of the driver is measured
+    dev.intf.i2c_addr = WCET_ADDR;
+    dev.intf.write = wcet_nullWrite;
+    ad5697r_setpointInit(&wcet_sp, &dev, AD5697R_OUTPUT_CH_A_B, 0x0000, 0x0FFF, NULL);
+
+    wcet_calibrate();
+    wcet_measure(&repeat, WCET_WARM_ITERATIONS, false, false);
+    wcet_measure(&fresh, WCET_WARM_ITERATIONS, true, false);
+    wcet_measure(&cold, WCET_COLD_ITERATIONS, true, true);
+
+    wcetNs = repeat.maxNs;
+    wcetNs = (fresh.maxNs > wcetNs) ? fresh.maxNs : wcetNs;
+    wcetNs = (cold.maxNs > wcetNs) ? cold.maxNs : wcetNs;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"version\": \"%d.%d.%d\",\n", ad5697r_VERSION_MAJOR, ad5697r_VERSION_MINOR, ad5697r_VERSION_PATCH);
+    fprintf(out, "  \"ns_per_tick\": %.4f,\n", wcet_nsPerTick);
+    fprintf(out, "  \"timer_overhead_ticks\": %llu,\n", (unsigned long long)wcet_overheadTicks);
+    fprintf(out, "  \"publish\": {\n");
+    wcet_print(out, "repeat", &repeat, ",");
+    wcet_print(out, "fresh", &fresh, ",");
+    wcet_print(out, "cold", &cold, "");
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"wcet_ns\": %u,\n", (unsigned)wcetNs);
+    fprintf(out, "  \"budget_ns\": %u\n", (unsigned)budgetNs);
+    fprintf(out, "}\n");
+
+    if( out != stdout ) {
+        fclose(out);
+    }
+
+    // A budget turns the harness into a check
+    return ((budgetNs > 0) && (wcetNs > budgetNs)) ? 2 : 0;
+}
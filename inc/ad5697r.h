@@ -16,6 +16,20 @@ extern "C" {
 #define ad5697r_VERSION_MINOR 1 /*! @brief VERSION MINOR */
 #define ad5697r_VERSION_PATCH 0 /*! @brief VERSION PATH */
 
+#define AD5697R_FRAME_SIZE              (3)                             /*! @brief Bytes per device command frame */
+#define AD5697R_BATCH_BUF_SIZE(frames)  ((frames) * AD5697R_FRAME_SIZE) /*! @brief Batch buffer size for the number of frames */
+#define AD5697R_INIT_MAX_FRAMES         (5)                             /*! @brief Frames ad5697r_init() writes in one transaction, the largest internal batch */
+
+#define AD5697R_I2C_FAST_MODE_HZ        (400000)                        /*! @brief Fast-mode SCL clock */
+#define AD5697R_I2C_FAST_PLUS_MODE_HZ   (1000000)                       /*! @brief Fast-mode plus SCL clock, above this the bus runs in Hs-mode */
+
+#ifndef AD5697R_SETTLING_TIME_US
+#define AD5697R_SETTLING_TIME_US        (8)                             /*! @brief Output voltage settling time, 1/4 to 3/4 scale, maximum */
+#endif
+#ifndef AD5697R_REF_POWER_UP_US
+#define AD5697R_REF_POWER_UP_US         (1000)                          /*! @brief Allowance for the internal reference to power up, override for your reference capacitor */
+#endif
+
 /*!
  * @brief This function pointer API reads I2C data from the specified
  * device on the bus.
@@ -47,6 +61,42 @@ typedef int8_t(*ad5697r_write_fptr_t)(const uint8_t busAddr, const uint8_t *data
  */
 typedef void(*ad5697r_delay_us_fptr_t)(uint32_t period);
 
+/*!
+ * @brief This function pointer API returns a free running microsecond timestamp.
+ * The counter is expected to wrap at 32 bits.
+ *
+ * @return The current time in micro-seconds
+ */
+typedef uint32_t(*ad5697r_get_time_us_fptr_t)(void);
+
+/*!
+ * @brief This function pointer API drives the !LDAC pin of the device(s).
+ *
+ * @param[in] level: Pin level, true for high
+ */
+typedef void(*ad5697r_ldac_fptr_t)(const bool level);
+
+/*!
+ * @brief ad5697r Bus Message, one addressed write within a combined transaction
+ */
+typedef struct {
+    uint8_t busAddr;        /* Address of the device to be written to */
+    const uint8_t *data;    /* Pointer to the data to be written */
+    uint32_t len;           /* Length of data to be written */
+} ad5697r_bus_msg_t;
+
+/*!
+ * @brief This function pointer API writes a list of messages as one combined
+ * transaction, separated by repeated STARTs, on the bus identified by ctx.
+ *
+ * @param[in] *ctx: User context identifying the bus, e.g. an adapter handle
+ * @param[in] *msgs: Pointer to the messages to be written
+ * @param[in] count: Number of messages
+ *
+ * @return The result of the transaction
+ */
+typedef int8_t(*ad5697r_bus_xfer_fptr_t)(void *ctx, const ad5697r_bus_msg_t *msgs, const uint32_t count);
+
 /*!
  * @brief ad5697r Return codes for the driver API
  */
@@ -89,6 +139,20 @@ typedef enum {
     AD5697R_REF__MAX__
 } ad5697r_reference_t;
 
+/*!
+ * @brief ad5697r Shadow Register Valid Flags
+ */
+typedef enum {
+    AD5697R_SHADOW_INPUT_A      = 0x01, /* Input register A is known */
+    AD5697R_SHADOW_INPUT_B      = 0x02, /* Input register B is known */
+    AD5697R_SHADOW_DAC_A        = 0x04, /* DAC register A is known */
+    AD5697R_SHADOW_DAC_B        = 0x08, /* DAC register B is known */
+    AD5697R_SHADOW_POWER        = 0x10, /* Power-down bits are known */
+    AD5697R_SHADOW_LDAC         = 0x20, /* LDAC mask is known */
+    AD5697R_SHADOW_REF          = 0x40, /* Reference setup is known */
+    AD5697R_SHADOW_ALL          = 0x7F, /* Every register is known */
+} ad5697r_shadow_t;
+
 /*!
  * @brief ad5697r Device Registers
  */
@@ -98,10 +162,122 @@ typedef union
     {
         uint8_t CHA_mode;   /* Channel A operating mode */
         uint8_t CHB_mode;   /* Channel B operating mode */
+        uint16_t CHA_input; /* Channel A input register */
+        uint16_t CHB_input; /* Channel B input register */
+        uint16_t CHA_dac;   /* Channel A DAC register */
+        uint16_t CHB_dac;   /* Channel B DAC register */
+        uint8_t ldac_mask;  /* LDAC mask register */
+        uint8_t ref_mode;   /* Internal reference setup */
+        uint8_t valid;      /* Shadow registers known to match the device (ad5697r_shadow_t) */
     } bits;
     uint8_t bytes[1];
 } ad5697r_registers_t;
 
+/*!
+ * @brief ad5697r Write Cache Statistics
+ */
+typedef struct {
+    uint32_t elidedWrites;      /* Frames not sent as they would not change the device */
+    uint32_t coalescedWrites;   /* Frames merged into a frame already queued in a batch */
+    uint32_t savedBytes;        /* Bytes kept off the wire */
+} ad5697r_cache_stats_t;
+
+/*!
+ * @brief ad5697r Write Cache
+ */
+typedef struct {
+    bool elide;                     /* Skip writes that would not change the device state */
+    ad5697r_cache_stats_t stats;    /* Write cache statistics */
+} ad5697r_cache_t;
+
+#define AD5697R_RETRY_HIST_BINS     (16)    /*! @brief Log2 latency bins, bin n holds latencies of 2^(n-1) to 2^n - 1 us */
+
+/*!
+ * @brief ad5697r Retry Policy. A zeroed policy makes a single attempt.
+ */
+typedef struct {
+    uint8_t maxAttempts;        /* Attempts per write transaction including the first, 0 or 1 disables retries */
+    uint32_t backoffUs;         /* Delay before the first retry, doubled for every further retry */
+    uint32_t maxBackoffUs;      /* Upper limit of a single delay, 0 for none */
+    uint32_t budgetUs;          /* Time a transaction may take including its retries, 0 for none */
+    bool resync;                /* Read back the input registers a failed write touched */
+} ad5697r_retry_policy_t;
+
+/*!
+ * @brief ad5697r Retry Statistics, kept while retries are enabled
+ */
+typedef struct {
+    uint32_t transactions;                      /* Write transactions under the policy */
+    uint32_t retries;                           /* Attempts after the first */
+    uint32_t recovered;                         /* Transactions that succeeded after a retry */
+    uint32_t exhausted;                         /* Transactions that failed every attempt */
+    uint32_t overBudget;                        /* Transactions given up as the next backoff would exceed the budget */
+    uint32_t resynced;                          /* Input registers restored from the device after a failed write */
+    uint32_t latency[AD5697R_RETRY_HIST_BINS];  /* Transaction latency histogram, retries included */
+    uint32_t maxLatencyUs;                      /* Longest transaction latency */
+} ad5697r_retry_stats_t;
+
+/*!
+ * @brief ad5697r Retry State
+ */
+typedef struct {
+    ad5697r_retry_policy_t policy;  /* Retry policy */
+    ad5697r_retry_stats_t stats;    /* Retry statistics */
+} ad5697r_retry_t;
+
+#ifdef AD5697R_INSTRUMENT
+#define AD5697R_INSTR_CMDS          (16)    /*! @brief Command nibbles counted, including the reserved ones */
+#define AD5697R_INSTR_RESULTS       (6)     /*! @brief Return codes counted, AD5697R_RET_OK to AD5697R_RET_NULL_PTR */
+#define AD5697R_INSTR_HIST_BINS     (16)    /*! @brief Latency histogram bins */
+
+/*!
+ * @brief ad5697r Bus Instrumentation Counters. Latency bin 0 counts transactions
+ * under 1 us and bin n those of 2^(n-1) to 2^n - 1 us, the last bin everything
+ * slower.
+ */
+typedef struct {
+    uint32_t writes;                                    /* Write transactions */
+    uint32_t reads;                                     /* Read transactions */
+    uint32_t frames[AD5697R_INSTR_CMDS];                /* Frames written per command */
+    uint32_t bytesWritten;                              /* Bytes of successful writes */
+    uint32_t bytesRead;                                 /* Bytes of successful reads */
+    uint32_t results[AD5697R_INSTR_RESULTS];            /* Transactions per result, indexed by -ad5697r_return_code_t */
+    uint32_t writeLatency[AD5697R_INSTR_HIST_BINS];     /* Write latency histogram */
+    uint32_t readLatency[AD5697R_INSTR_HIST_BINS];      /* Read latency histogram */
+    uint32_t maxLatencyUs;                              /* Slowest transaction */
+} ad5697r_instr_stats_t;
+
+/*!
+ * @brief ad5697r Bus Trace Event, describes one completed transaction
+ */
+typedef struct {
+    uint8_t busAddr;        /* Address of the device */
+    bool read;              /* True for a read, false for a write */
+    const uint8_t *data;    /* Bytes written or read, only valid during the callback */
+    uint32_t len;           /* Length of the transaction */
+    int8_t ret;             /* Result returned by the interface */
+    uint32_t latencyUs;     /* Time spent in the interface, 0 without intf.get_time_us */
+} ad5697r_trace_event_t;
+
+/*!
+ * @brief This function pointer API receives a trace event after every bus
+ * transaction. It runs in the context of the driver call.
+ *
+ * @param[in] *ctx: User context passed to ad5697r_instrSetTrace()
+ * @param[in] *event: Pointer to the completed transaction
+ */
+typedef void(*ad5697r_trace_fptr_t)(void *ctx, const ad5697r_trace_event_t *event);
+
+/*!
+ * @brief ad5697r Bus Instrumentation
+ */
+typedef struct {
+    ad5697r_instr_stats_t stats;    /* Bus instrumentation counters */
+    ad5697r_trace_fptr_t trace;     /* Optional trace callback */
+    void *traceCtx;                 /* User context of the trace callback */
+} ad5697r_instr_t;
+#endif // AD5697R_INSTRUMENT
+
 /*!
  * @brief ad5697r HW Interface
  */
@@ -110,6 +286,8 @@ typedef struct {
     ad5697r_read_fptr_t read;           /* User I2C Read Function Pointer */
     ad5697r_write_fptr_t write;         /* User I2C Write Function Pointer */
     ad5697r_delay_us_fptr_t delay_us;   /* User Micro-Second Delay Function Pointer */
+    ad5697r_ldac_fptr_t ldac;           /* Optional !LDAC GPIO Function Pointer */
+    ad5697r_get_time_us_fptr_t get_time_us; /* Optional Micro-Second Clock Function Pointer */
 } ad5697r_dev_intf_t;
 
 /*!
@@ -119,8 +297,61 @@ typedef struct
 {
     ad5697r_dev_intf_t intf;                        /* Device Hardware Interface */
     ad5697r_registers_t registers;                  /* Device Registers */
+    ad5697r_cache_t cache;                          /* Shadow Register Write Cache */
+    ad5697r_retry_t retry;                          /* Write Retry Policy */
+#ifdef AD5697R_INSTRUMENT
+    ad5697r_instr_t instr;                          /* Bus Instrumentation */
+#endif
 } ad5697r_dev_t;
 
+/*!
+ * @brief ad5697r Batch Statistics
+ */
+typedef struct {
+    uint32_t transactions;      /* Committed I2C transactions */
+    uint32_t updates;           /* Committed device command frames */
+    uint32_t wireBytes;         /* Bytes on the wire, including the address byte */
+} ad5697r_batch_stats_t;
+
+/*!
+ * @brief ad5697r Initial Configuration. A zeroed configuration keeps the
+ * power-on state: internal reference on, both channels powered up and no
+ * channel masked from !LDAC.
+ */
+typedef struct {
+    bool softReset;                     /* Reset the device to its power-on state first */
+    ad5697r_reference_t refMode;        /* Internal reference setup */
+    ad5697r_operation_mode_t modeA;     /* Channel A operating mode */
+    ad5697r_operation_mode_t modeB;     /* Channel B operating mode */
+    uint8_t ldacMask;                   /* Channels that ignore the !LDAC pin (ad5697r_output_channel_t bits) */
+    bool setCodes;                      /* Write codeA/codeB, otherwise the outputs keep their codes */
+    uint16_t codeA;                     /* Initial code of channel A */
+    uint16_t codeB;                     /* Initial code of channel B */
+} ad5697r_config_t;
+
+/*!
+ * @brief ad5697r Initialization Report
+ */
+typedef struct {
+    uint32_t transactions;      /* Bus transactions issued */
+    uint32_t frames;            /* Command frames written */
+    uint32_t settleUs;          /* Settling time after the last transaction, waited with intf.delay_us when set */
+    uint32_t firstOutputUs;     /* Measured time from the call to the first valid output, 0 without intf.get_time_us */
+} ad5697r_init_report_t;
+
+/*!
+ * @brief ad5697r Multi-Command Batch
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                 /* Device the batch is committed to */
+    uint8_t *buf;                       /* User provided frame buffer */
+    uint32_t size;                      /* Size of the frame buffer in bytes */
+    uint32_t len;                       /* Number of queued bytes */
+    ad5697r_registers_t registers;      /* Device registers once the batch is committed */
+    uint8_t touched;                    /* Shadow registers written by the queued frames */
+    ad5697r_batch_stats_t stats;        /* Committed batch statistics */
+} ad5697r_batch_t;
+
 /*!
  * @brief This function pointer API writes the desired DAC channel with the provided
  * value.
@@ -133,6 +364,43 @@ typedef struct
  */
 ad5697r_return_code_t ad5697r_writeChannel(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal);
 
+/*!
+ * @brief This API writes the desired value to the input register of the specified
+ * channel. The output only changes once the DAC register is updated, either with
+ * ad5697r_updateChannel() or a falling edge on !LDAC (unless !LDAC is held low).
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] outputVal: 12bit value to write the input register
+ *
+ * @return The result of writing the input register
+ */
+ad5697r_return_code_t ad5697r_writeInputRegister(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API updates the DAC output(s) with the contents of their input registers
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] ch: DAC output channel(s) to be updated
+ *
+ * @return The result of updating the DAC channel
+ */
+ad5697r_return_code_t ad5697r_updateChannel(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch);
+
+/*!
+ * @brief This API stages a value in each input register and updates both outputs
+ * with a single command, all within one I2C transaction, so there is no skew between
+ * channel A and B. The !LDAC pin must be held high, or masked, for the staged
+ * values to stay in the input registers until the update.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] outputValA: 12bit value for DAC channel A
+ * @param[in] outputValB: 12bit value for DAC channel B
+ *
+ * @return The result of writing the DAC channels
+ */
+ad5697r_return_code_t ad5697r_writeChannelsSynchronized(ad5697r_dev_t *dev, const uint16_t outputValA, const uint16_t outputValB);
+
 /*!
  * @brief This API sets the operation mode for each DAC output
  *
@@ -154,6 +422,303 @@ ad5697r_return_code_t ad5697r_setOperatingMode(ad5697r_dev_t *dev, const ad5697r
  */
 ad5697r_return_code_t ad5697r_setReferenceMode(ad5697r_dev_t *dev, const ad5697r_reference_t refSelect);
 
+/*!
+ * @brief This API sets the hardware !LDAC mask. Masked channels ignore the
+ * !LDAC pin, unmasked channels move their input register to the output on a
+ * falling edge. The mask has no effect while !LDAC is tied low.
+ *
+ * @param[in] *dev: Pointer to your ad56x device
+ * @param[in] mask: Channels to mask, any of AD5697R_OUTPUT_CH_A/B or 0 for none
+ *
+ * @return The result of writing the mask
+ */
+ad5697r_return_code_t ad5697r_setLdacMask(ad5697r_dev_t *dev, const uint8_t mask);
+
+/*!
+ * @brief This API pulses the !LDAC pin through intf.ldac, updating the DAC
+ * registers of every unmasked channel from their input registers at once.
+ *
+ * @param[in] *dev: Pointer to your ad56x device
+ *
+ * @return The result of pulsing the pin, AD5697R_RET_NULL_PTR without intf.ldac
+ */
+ad5697r_return_code_t ad5697r_pulseLdac(ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API reads back the input register of a channel: a no-operation
+ * frame addressing the channel, then a two byte read through intf.read. The DAC
+ * register itself cannot be read back.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[out] *outputVal: 12bit value held by the input register
+ *
+ * @return The result of reading the register
+ */
+ad5697r_return_code_t ad5697r_readInputRegister(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, uint16_t *outputVal);
+
+/*!
+ * @brief This API reads back every input register held by the shadow and
+ * compares it bit for bit. Mismatching registers are reported, not repaired;
+ * rewrite them or invalidate the shadow before relying on write elision.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[out] *mismatch: AD5697R_SHADOW_INPUT_A/B flags of the registers that differ
+ *
+ * @return The result of reading the registers
+ */
+ad5697r_return_code_t ad5697r_verifyShadow(ad5697r_dev_t *dev, uint8_t *mismatch);
+
+/*!
+ * @brief This API resets the device to its power-on state. The input and DAC
+ * registers return to zero or midscale depending on the RSTSEL pin, so they
+ * are marked unknown in the shadow; the reference, power and LDAC mask
+ * registers are known again.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ *
+ * @return The result of resetting the device
+ */
+ad5697r_return_code_t ad5697r_softReset(ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API brings the device up in the provided configuration with as
+ * few transactions as possible: the optional soft reset on its own, then every
+ * register that differs from the known state in one combined write. The
+ * reference frame goes first so the reference powers up while the rest is
+ * written. Once written, the call waits with intf.delay_us for the outputs to
+ * settle, and for the reference to power up when the internal one is selected.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *config: Pointer to the initial configuration
+ * @param[out] *report: Pointer to the initialization report, may be NULL
+ *
+ * @return The result of initializing the device
+ */
+ad5697r_return_code_t ad5697r_init(ad5697r_dev_t *dev, const ad5697r_config_t *config, ad5697r_init_report_t *report);
+
+/*!
+ * @brief This API enables/disables write elision. When enabled, writes that
+ * would not change the shadowed device state are skipped, and a batch merges a
+ * DAC write into the previous frame when it targets the same channel(s).
+ * Registers are only elided once they have been written by the driver.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] enable: Enables write elision when true
+ *
+ * @return The result of configuring the write cache
+ */
+ad5697r_return_code_t ad5697r_setWriteElision(ad5697r_dev_t *dev, const bool enable);
+
+/*!
+ * @brief This API marks every shadow register as unknown, e.g. after the device
+ * has been reset or power cycled outside of the driver.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ *
+ * @return The result of invalidating the shadow registers
+ */
+ad5697r_return_code_t ad5697r_invalidateShadow(ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API clears the write cache statistics
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ *
+ * @return The result of clearing the statistics
+ */
+ad5697r_return_code_t ad5697r_resetCacheStats(ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API sets the retry policy of write transactions. A write the
+ * interface reports as AD5697R_RET_BUSY or AD5697R_RET_TIMEOUT is repeated
+ * after a backoff waited with intf.delay_us, doubling up to maxBackoffUs. A
+ * retry is only started while its backoff fits the latency budget, measured
+ * with intf.get_time_us or, without it, as the sum of the backoffs. Other
+ * errors are returned straight away. Frames are absolute register writes, so
+ * repeating a transaction that partially reached the device is safe.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *policy: Pointer to the retry policy, copied into the device
+ *
+ * @return The result of setting the policy
+ */
+ad5697r_return_code_t ad5697r_setRetryPolicy(ad5697r_dev_t *dev, const ad5697r_retry_policy_t *policy);
+
+/*!
+ * @brief This API clears the retry statistics
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ *
+ * @return The result of clearing the statistics
+ */
+ad5697r_return_code_t ad5697r_resetRetryStats(ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API returns a write latency percentile from the retry
+ * statistics, e.g. 999 for p99.9. The result is the upper edge of the
+ * histogram bin holding the percentile, limited to the longest latency seen.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] permille: Percentile in permille, at most 1000
+ * @param[out] *latencyUs: Latency in micro-seconds, 0 without any transaction
+ *
+ * @return The result of computing the percentile
+ */
+ad5697r_return_code_t ad5697r_getRetryLatencyUs(const ad5697r_dev_t *dev, const uint16_t permille, uint32_t *latencyUs);
+
+#ifdef AD5697R_INSTRUMENT
+/*!
+ * @brief This API copies the bus instrumentation counters of the device. Every
+ * transaction is counted along with its result; bytes and frames only once the
+ * interface reported success. Latencies are measured around intf.write and
+ * intf.read with intf.get_time_us, and land in bin 0 without it.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[out] *snapshot: Pointer to the copy of the counters
+ *
+ * @return The result of copying the counters
+ */
+ad5697r_return_code_t ad5697r_instrGetSnapshot(const ad5697r_dev_t *dev, ad5697r_instr_stats_t *snapshot);
+
+/*!
+ * @brief This API clears the bus instrumentation counters of the device
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ *
+ * @return The result of clearing the counters
+ */
+ad5697r_return_code_t ad5697r_instrReset(ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API sets the callback receiving every bus transaction of the device
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] trace: Trace callback, NULL to stop tracing
+ * @param[in] *ctx: User context handed to the callback
+ *
+ * @return The result of setting the callback
+ */
+ad5697r_return_code_t ad5697r_instrSetTrace(ad5697r_dev_t *dev, const ad5697r_trace_fptr_t trace, void *ctx);
+#endif // AD5697R_INSTRUMENT
+
+/*!
+ * @brief This API estimates the time a transaction spends on the bus: START, the
+ * address byte, the data bytes with their ACKs and STOP. Above Fast-mode plus the
+ * Hs-mode master code sent at Fast-mode speed is included.
+ *
+ * @param[in] busClockHz: SCL clock frequency
+ * @param[in] len: Number of data bytes in the transaction
+ *
+ * @return Transaction time in nano-seconds, 0 for an invalid clock
+ */
+uint32_t ad5697r_getTransactionTimeNs(const uint32_t busClockHz, const uint32_t len);
+
+/*!
+ * @brief This API initializes a batch that packs many device commands into a
+ * single I2C transaction. Size the buffer with AD5697R_BATCH_BUF_SIZE().
+ *
+ * @param[out] *batch: Pointer to the batch to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *buf: Pointer to the buffer the frames are queued in
+ * @param[in] size: Size of the buffer in bytes
+ *
+ * @return The result of initializing the batch
+ */
+ad5697r_return_code_t ad5697r_batchInit(ad5697r_batch_t *batch, ad5697r_dev_t *dev, uint8_t *buf, const uint32_t size);
+
+/*!
+ * @brief This API discards every frame queued in the batch
+ *
+ * @param[in] *batch: Pointer to your batch
+ *
+ * @return The result of resetting the batch
+ */
+ad5697r_return_code_t ad5697r_batchReset(ad5697r_batch_t *batch);
+
+/*!
+ * @brief This API queues a write to and update of the DAC channel
+ *
+ * @param[in] *batch: Pointer to your batch
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] outputVal: 12bit value to write the DAC channel
+ *
+ * @return The result of queueing the frame, AD5697R_RET_ERROR when the batch is full
+ */
+ad5697r_return_code_t ad5697r_batchWriteChannel(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API queues a write to the input register of the DAC channel
+ *
+ * @param[in] *batch: Pointer to your batch
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] outputVal: 12bit value to write the input register
+ *
+ * @return The result of queueing the frame, AD5697R_RET_ERROR when the batch is full
+ */
+ad5697r_return_code_t ad5697r_batchWriteInputRegister(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API queues an update of the DAC channel from its input register
+ *
+ * @param[in] *batch: Pointer to your batch
+ * @param[in] ch: DAC output channel(s) to be updated
+ *
+ * @return The result of queueing the frame, AD5697R_RET_ERROR when the batch is full
+ */
+ad5697r_return_code_t ad5697r_batchUpdateChannel(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch);
+
+/*!
+ * @brief This API queues an operation mode change for the DAC output
+ *
+ * @param[in] *batch: Pointer to your batch
+ * @param[in] ch: DAC output channel to be configured
+ * @param[in] mode: DAC Channel operation mode
+ *
+ * @return The result of queueing the frame, AD5697R_RET_ERROR when the batch is full
+ */
+ad5697r_return_code_t ad5697r_batchSetOperatingMode(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch, const ad5697r_operation_mode_t mode);
+
+/*!
+ * @brief This API queues an internal reference change
+ *
+ * @param[in] *batch: Pointer to your batch
+ * @param[in] refSelect: Sets the state of the internal reference (on/off)
+ *
+ * @return The result of queueing the frame, AD5697R_RET_ERROR when the batch is full
+ */
+ad5697r_return_code_t ad5697r_batchSetReferenceMode(ad5697r_batch_t *batch, const ad5697r_reference_t refSelect);
+
+/*!
+ * @brief This API queues a hardware !LDAC mask change
+ *
+ * @param[in] *batch: Pointer to your batch
+ * @param[in] mask: Channels that ignore the !LDAC pin (ad5697r_output_channel_t bits)
+ *
+ * @return The result of queueing the frame, AD5697R_RET_ERROR when the batch is full
+ */
+ad5697r_return_code_t ad5697r_batchSetLdacMask(ad5697r_batch_t *batch, const uint8_t mask);
+
+/*!
+ * @brief This API writes every queued frame to the device in a single I2C
+ * transaction. The frames stay queued if the write fails so the commit can be retried.
+ *
+ * @param[in] *batch: Pointer to your batch
+ *
+ * @return The result of writing the batch
+ */
+ad5697r_return_code_t ad5697r_batchCommit(ad5697r_batch_t *batch);
+
+/*!
+ * @brief This API returns the average number of bytes on the wire per committed
+ * update, including the I2C address byte of each transaction.
+ *
+ * @param[in] *batch: Pointer to your batch
+ *
+ * @return Average bytes per update, 0 if nothing has been committed
+ */
+float ad5697r_batchGetBytesPerUpdate(const ad5697r_batch_t *batch);
+
 #endif // _ad5697r_H_
 
 #ifdef __cplusplus
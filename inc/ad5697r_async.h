@@ -0,0 +1,213 @@
+/*! @file ad5697r_async.h
+ * @brief Public header file for the ad5697r asynchronous transport queue.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_async_H_
+#define _ad5697r_async_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#ifndef AD5697R_ASYNC_MAX_FRAMES
+#define AD5697R_ASYNC_MAX_FRAMES    AD5697R_INIT_MAX_FRAMES     /*! @brief Frames carried by one request, fits every internal batch */
+#endif
+
+#define AD5697R_ASYNC_MAX_LEN       (AD5697R_ASYNC_MAX_FRAMES * AD5697R_FRAME_SIZE) /*! @brief Bytes carried by one request */
+
+/*!
+ * @brief Completion callback, called once per request with its result
+ */
+typedef void (*ad5697r_async_cb_fptr_t)(void *ctx, const ad5697r_return_code_t ret);
+
+/*!
+ * @brief Transport hook that starts a transfer and returns without waiting for
+ * it. The transport reports the result with ad5697r_asyncComplete() once the
+ * transfer ends. The data stays valid until then.
+ */
+typedef ad5697r_return_code_t (*ad5697r_async_start_fptr_t)(void *ctx, const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief Hook called while a synchronous wrapper waits for its completion,
+ * e.g. to sleep the core or block on the worker thread
+ */
+typedef void (*ad5697r_async_idle_fptr_t)(void *ctx);
+
+/*!
+ * @brief ad5697r Asynchronous Request
+ */
+typedef struct {
+    uint8_t busAddr;                        /* Device I2C Address */
+    uint32_t len;                           /* Bytes to be written */
+    uint8_t data[AD5697R_ASYNC_MAX_LEN];    /* Wire format frames */
+    ad5697r_async_cb_fptr_t cb;             /* Completion callback, may be NULL */
+    void *ctx;                              /* Completion callback context */
+} ad5697r_async_req_t;
+
+/*!
+ * @brief ad5697r Asynchronous Queue Statistics
+ */
+typedef struct {
+    uint32_t submitted;     /* Requests accepted into the ring */
+    uint32_t completed;     /* Requests completed, successful or not */
+    uint32_t errors;        /* Requests completed with an error */
+    uint32_t full;          /* Submissions rejected with a full ring */
+} ad5697r_async_stats_t;
+
+/*!
+ * @brief ad5697r Asynchronous Queue. One thread submits, the transport
+ * completes from its own context (interrupt, DMA or worker thread).
+ */
+typedef struct {
+    ad5697r_async_req_t *ring;          /* Caller provided submission ring */
+    uint32_t capacity;                  /* Number of requests in the ring */
+    uint32_t head;                      /* Index of the request in flight or next to start */
+    uint32_t tail;                      /* Index of the next free slot */
+    uint8_t inflight;                   /* Set while a transfer is in flight */
+    ad5697r_async_start_fptr_t start;   /* Transport start hook */
+    void *startCtx;                     /* Transport start hook context */
+    ad5697r_async_idle_fptr_t idle;     /* Synchronous wait hook, may be NULL */
+    void *idleCtx;                      /* Synchronous wait hook context */
+    ad5697r_async_stats_t stats;        /* Queue statistics */
+} ad5697r_async_queue_t;
+
+/*!
+ * @brief This API initializes a queue over a caller provided ring and selects
+ * it as the queue the ad5697r_asyncWrite() interface function submits to.
+ *
+ * @param[out] *queue: Pointer to the queue to be initialized
+ * @param[in] *ring: Submission ring
+ * @param[in] capacity: Number of requests in the ring
+ * @param[in] start: Transport start hook
+ * @param[in] *startCtx: Context passed to the start hook
+ *
+ * @return The result of initializing the queue
+ */
+ad5697r_return_code_t ad5697r_asyncInit(ad5697r_async_queue_t *queue, ad5697r_async_req_t *ring, const uint32_t capacity, ad5697r_async_start_fptr_t start, void *startCtx);
+
+/*!
+ * @brief This API selects the queue used by the interface function
+ *
+ * @param[in] *queue: Pointer to the queue
+ *
+ * @return The result of selecting the queue
+ */
+ad5697r_return_code_t ad5697r_asyncSelect(ad5697r_async_queue_t *queue);
+
+/*!
+ * @brief This API sets the hook called while the synchronous wrapper waits
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] idle: Wait hook, NULL to spin
+ * @param[in] *idleCtx: Context passed to the wait hook
+ *
+ * @return The result of setting the hook
+ */
+ad5697r_return_code_t ad5697r_asyncSetIdle(ad5697r_async_queue_t *queue, ad5697r_async_idle_fptr_t idle, void *idleCtx);
+
+/*!
+ * @brief This API copies wire format frames into the ring and starts the
+ * transfer if the transport is idle. Requests go straight to the transport:
+ * the retry policy and the bus instrumentation of the device do not apply to
+ * them, only ad5697r_asyncWrite() used as intf.write runs under both.
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] busAddr: Device I2C Address
+ * @param[in] *data: Frames to be written
+ * @param[in] len: Number of bytes, at most AD5697R_ASYNC_MAX_LEN
+ * @param[in] cb: Completion callback, may be NULL
+ * @param[in] *ctx: Completion callback context
+ *
+ * @return AD5697R_RET_OK once queued, AD5697R_RET_BUSY if the ring is full
+ */
+ad5697r_return_code_t ad5697r_asyncSubmit(ad5697r_async_queue_t *queue, const uint8_t busAddr, const uint8_t *data, const uint32_t len, ad5697r_async_cb_fptr_t cb, void *ctx);
+
+/*!
+ * @brief This API is called by the transport when the transfer in flight
+ * ends. It calls the completion callback and starts the next request.
+ * It must not be called from within the start hook.
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] ret: Result of the transfer
+ */
+void ad5697r_asyncComplete(ad5697r_async_queue_t *queue, const ad5697r_return_code_t ret);
+
+/*!
+ * @brief This API returns the number of requests queued or in flight
+ *
+ * @param[in] *queue: Pointer to the queue
+ *
+ * @return Number of pending requests
+ */
+uint32_t ad5697r_asyncGetPending(const ad5697r_async_queue_t *queue);
+
+/*!
+ * @brief This API queues a write and update of the specified channel(s).
+ * The shadow of the channel(s) is invalidated since the result arrives later.
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] *dev: Pointer to the device
+ * @param[in] ch: Output channel(s) to write
+ * @param[in] outputVal: 12-Bit output value
+ * @param[in] cb: Completion callback, may be NULL
+ * @param[in] *ctx: Completion callback context
+ *
+ * @return The result of queueing the request
+ */
+ad5697r_return_code_t ad5697r_asyncWriteChannel(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal, ad5697r_async_cb_fptr_t cb, void *ctx);
+
+/*!
+ * @brief This API queues a write of the input register(s) of the specified channel(s)
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] *dev: Pointer to the device
+ * @param[in] ch: Output channel(s) to stage
+ * @param[in] outputVal: 12-Bit output value
+ * @param[in] cb: Completion callback, may be NULL
+ * @param[in] *ctx: Completion callback context
+ *
+ * @return The result of queueing the request
+ */
+ad5697r_return_code_t ad5697r_asyncWriteInputRegister(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal, ad5697r_async_cb_fptr_t cb, void *ctx);
+
+/*!
+ * @brief This API queues a synchronized update of both channels as one request
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] *dev: Pointer to the device
+ * @param[in] outputValA: 12-Bit output value for channel A
+ * @param[in] outputValB: 12-Bit output value for channel B
+ * @param[in] cb: Completion callback, may be NULL
+ * @param[in] *ctx: Completion callback context
+ *
+ * @return The result of queueing the request
+ */
+ad5697r_return_code_t ad5697r_asyncWriteChannelsSynchronized(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const uint16_t outputValA, const uint16_t outputValB, ad5697r_async_cb_fptr_t cb, void *ctx);
+
+/*!
+ * @brief Synchronous write interface function for ad5697r_dev_intf_t. It
+ * submits to the selected queue and waits for the completion, so the
+ * blocking ad5697r_* calls run on top of the asynchronous transport. Every
+ * write is sent as one request, so it stays one bus transaction: writes
+ * longer than AD5697R_ASYNC_MAX_LEN are rejected with AD5697R_RET_INV_PARAM
+ * rather than split. The default fits every batch the driver writes itself,
+ * e.g. ad5697r_init(); define AD5697R_ASYNC_MAX_FRAMES to fit the largest
+ * batch, sequence or stream chunk of your own written through this function.
+ *
+ * @param[in] busAddr: Device I2C Address
+ * @param[in] *data: Pointer to the frames to be written
+ * @param[in] len: Number of bytes, at most AD5697R_ASYNC_MAX_LEN
+ *
+ * @return The result of the transfer
+ */
+int8_t ad5697r_asyncWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+#endif // _ad5697r_async_H_
+
+#ifdef __cplusplus
+}
+#endif
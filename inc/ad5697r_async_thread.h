@@ -0,0 +1,64 @@
+/*! @file ad5697r_async_thread.h
+ * @brief Public header file for the ad5697r thread-backed asynchronous transport.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_async_thread_H_
+#define _ad5697r_async_thread_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "ad5697r.h"
+#include "ad5697r_async.h"
+
+/*!
+ * @brief ad5697r Asynchronous Worker Thread. The worker runs a blocking write
+ * function for each request so the submitting thread never waits on the bus.
+ */
+typedef struct {
+    pthread_t thread;               /* Worker thread */
+    pthread_mutex_t lock;           /* Protects the fields below */
+    pthread_cond_t cond;            /* Signals a started transfer, a completion or a stop */
+    bool running;                   /* Cleared to stop the worker */
+    bool pending;                   /* A transfer was started and not yet picked up */
+    uint32_t completions;           /* Completions signalled, used by the idle hook */
+    uint8_t busAddr;                /* Device I2C Address of the started transfer */
+    const uint8_t *data;            /* Frames of the started transfer */
+    uint32_t len;                   /* Length of the started transfer */
+    ad5697r_write_fptr_t write;     /* Blocking write function run by the worker */
+    ad5697r_async_queue_t *queue;   /* Queue completed by the worker */
+} ad5697r_async_thread_t;
+
+/*!
+ * @brief This API initializes a queue whose transfers run on a worker thread
+ * calling a blocking write function, e.g. ad5697r_linuxWrite(), and starts the
+ * worker. The queue's idle hook blocks until the worker signals a completion.
+ *
+ * @param[out] *worker: Pointer to the worker to be started
+ * @param[out] *queue: Pointer to the queue to be initialized
+ * @param[in] *ring: Submission ring
+ * @param[in] capacity: Number of requests in the ring
+ * @param[in] write: Blocking write function
+ *
+ * @return The result of starting the worker
+ */
+ad5697r_return_code_t ad5697r_asyncThreadStart(ad5697r_async_thread_t *worker, ad5697r_async_queue_t *queue, ad5697r_async_req_t *ring, const uint32_t capacity, ad5697r_write_fptr_t write);
+
+/*!
+ * @brief This API waits for the queue to drain, then stops and joins the worker
+ *
+ * @param[in] *worker: Pointer to the worker
+ *
+ * @return The result of stopping the worker
+ */
+ad5697r_return_code_t ad5697r_asyncThreadStop(ad5697r_async_thread_t *worker);
+
+#endif // _ad5697r_async_thread_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,144 @@
+/*! @file ad5697r_capture.h
+ * @brief Public header file for the ad5697r bus capture and replay.
+ *
+ * A capture starts with an AD5697R_CAPTURE_HEADER_SIZE byte file header, the
+ * magic "AD56", the format version and three reserved bytes, followed by one
+ * record per write transaction:
+ *
+ *   | timestamp (4) | busAddr (1) | len (2) | data (len) |
+ *
+ * Multi-byte fields are little endian. The timestamp is the microsecond clock
+ * when the write started and data holds the frames exactly as written, the
+ * command in the upper nibble of every third byte.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_capture_H_
+#define _ad5697r_capture_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#define AD5697R_CAPTURE_VERSION         (1)     /*! @brief Capture format version */
+#define AD5697R_CAPTURE_HEADER_SIZE     (8)     /*! @brief Bytes of the file header */
+#define AD5697R_CAPTURE_RECORD_SIZE     (7)     /*! @brief Bytes of a record ahead of its data */
+#define AD5697R_CAPTURE_MAX_LEN         (0xFFFF)/*! @brief Data bytes per record */
+
+/*! @brief Smallest capture buffer, one record of a single frame after the file header */
+#define AD5697R_CAPTURE_MIN_BUF_SIZE    (AD5697R_CAPTURE_HEADER_SIZE + AD5697R_CAPTURE_RECORD_SIZE + AD5697R_FRAME_SIZE)
+
+/*!
+ * @brief This function pointer API stores a chunk of the capture, e.g. appends
+ * it to a file or a flash partition.
+ *
+ * @param[in] *ctx: User context of the sink
+ * @param[in] *data: Pointer to the chunk
+ * @param[in] len: Length of the chunk
+ *
+ * @return The result of storing the chunk
+ */
+typedef int8_t(*ad5697r_capture_sink_fptr_t)(void *ctx, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief ad5697r Capture Configuration
+ */
+typedef struct {
+    ad5697r_write_fptr_t write;                 /* Transport the writes are passed on to, NULL to record only */
+    ad5697r_get_time_us_fptr_t get_time_us;     /* Optional clock, records are stamped 0 when NULL */
+    ad5697r_capture_sink_fptr_t sink;           /* Sink the full buffer is flushed to */
+    void *sinkCtx;                              /* User context of the sink */
+} ad5697r_capture_config_t;
+
+/*!
+ * @brief ad5697r Capture Statistics
+ */
+typedef struct {
+    uint32_t transactions;  /* Write transactions recorded */
+    uint32_t bytes;         /* Data bytes recorded */
+    uint32_t flushes;       /* Chunks handed to the sink */
+    uint32_t dropped;       /* Records lost to a failed sink or too long for the buffer */
+} ad5697r_capture_stats_t;
+
+/*!
+ * @brief ad5697r Capture Recorder. Records are appended to a caller provided
+ * buffer, which only goes to the sink once the next record does not fit.
+ */
+typedef struct {
+    ad5697r_capture_config_t config;    /* Capture configuration */
+    uint8_t *buf;                       /* User provided capture buffer */
+    uint32_t size;                      /* Size of the capture buffer in bytes */
+    uint32_t len;                       /* Bytes waiting for the sink */
+    uint32_t pending;                   /* Records waiting for the sink */
+    bool headerSent;                    /* File header reached the sink, it is kept until then */
+    ad5697r_capture_stats_t stats;      /* Capture statistics */
+} ad5697r_capture_t;
+
+/*!
+ * @brief This API initializes a recorder, puts the file header into the
+ * buffer and selects the recorder as the one ad5697r_captureWrite() acts on.
+ *
+ * @param[out] *cap: Pointer to the recorder to be initialized
+ * @param[in] *config: Pointer to the capture configuration, a sink is required
+ * @param[in] *buf: Capture buffer, at least AD5697R_CAPTURE_MIN_BUF_SIZE bytes and
+ * AD5697R_CAPTURE_RECORD_SIZE bytes more than the longest transaction
+ * @param[in] size: Size of the capture buffer in bytes
+ *
+ * @return The result of initializing the recorder
+ */
+ad5697r_return_code_t ad5697r_captureInit(ad5697r_capture_t *cap, const ad5697r_capture_config_t *config, uint8_t *buf, const uint32_t size);
+
+/*!
+ * @brief This API selects the recorder used by ad5697r_captureWrite()
+ *
+ * @param[in] *cap: Pointer to the recorder
+ *
+ * @return The result of selecting the recorder
+ */
+ad5697r_return_code_t ad5697r_captureSelect(ad5697r_capture_t *cap);
+
+/*!
+ * @brief This API hands every buffered record to the sink. Call it before
+ * closing the capture. The records are discarded when the sink fails, the
+ * file header is kept until the sink has taken it.
+ *
+ * @param[in] *cap: Pointer to the recorder
+ *
+ * @return The result of the sink
+ */
+ad5697r_return_code_t ad5697r_captureFlush(ad5697r_capture_t *cap);
+
+/*!
+ * @brief Write interface function for ad5697r_dev_intf_t. Passes the write on
+ * to config.write and records it on the selected recorder. Records are never
+ * split: a write longer than the buffer can hold after a record header still
+ * goes to the transport, but is counted in stats.dropped instead of recorded.
+ * Size the buffer for the longest transaction, e.g. the largest batch.
+ */
+int8_t ad5697r_captureWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief This API replays a capture, e.g. one mapped with ad5697r_captureMap().
+ * The whole capture is checked before the first write, so a truncated or
+ * corrupt capture writes nothing. Every record becomes one write transaction
+ * with its data passed straight from the capture.
+ *
+ * @param[in] *capture: Pointer to the capture, file header included
+ * @param[in] len: Length of the capture in bytes
+ * @param[in] write: Transport to replay onto, e.g. ad5697r_emuWrite
+ * @param[in] delay_us: Reproduces the recorded gaps between writes, NULL replays at maximum speed
+ * @param[out] *transactions: Records replayed, may be NULL
+ *
+ * @return AD5697R_RET_OK, AD5697R_RET_INV_PARAM for a malformed capture or the result of the failed write
+ */
+ad5697r_return_code_t ad5697r_captureReplay(const uint8_t *capture, const uint32_t len, const ad5697r_write_fptr_t write,
+                                            const ad5697r_delay_us_fptr_t delay_us, uint32_t *transactions);
+
+#endif // _ad5697r_capture_H_
+
+#ifdef __cplusplus
+}
+#endif
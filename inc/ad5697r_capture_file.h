@@ -0,0 +1,56 @@
+/*! @file ad5697r_capture_file.h
+ * @brief Public header file for the ad5697r capture files on POSIX hosts.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_capture_file_H_
+#define _ad5697r_capture_file_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+#include "ad5697r_capture.h"
+
+/*!
+ * @brief ad5697r Mapped Capture File
+ */
+typedef struct {
+    const uint8_t *data;    /* Read-only mapping of the file, NULL while unmapped */
+    uint32_t len;           /* Length of the file in bytes */
+} ad5697r_capture_map_t;
+
+/*!
+ * @brief ad5697r_capture_sink_fptr_t implementation that appends the chunks to
+ * a file.
+ *
+ * @param[in] *ctx: Pointer to the int file descriptor, opened for writing
+ */
+int8_t ad5697r_captureFileSink(void *ctx, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief This API maps a capture file read-only, ready for ad5697r_captureReplay()
+ *
+ * @param[out] *map: Pointer to the mapping
+ * @param[in] *path: Path of the capture file
+ *
+ * @return The result of mapping the file
+ */
+ad5697r_return_code_t ad5697r_captureMap(ad5697r_capture_map_t *map, const char *path);
+
+/*!
+ * @brief This API unmaps a capture file
+ *
+ * @param[in] *map: Pointer to the mapping
+ *
+ * @return The result of unmapping the file
+ */
+ad5697r_return_code_t ad5697r_captureUnmap(ad5697r_capture_map_t *map);
+
+#endif // _ad5697r_capture_file_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,154 @@
+/*! @file ad5697r_emu.h
+ * @brief Public header file for the ad5697r software device model and simulated I2C bus.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_emu_H_
+#define _ad5697r_emu_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#define AD5697R_EMU_MAX_DEVICES     (4)     /*! @brief Devices per bus, set by the A0/A1 pins */
+#define AD5697R_EMU_CMD_COUNT       (16)    /*! @brief Number of command codes */
+
+/*!
+ * @brief ad5697r Emulated Device Statistics
+ */
+typedef struct {
+    uint32_t transactions;                      /* Write transactions addressed to the device */
+    uint32_t frames;                            /* Frames decoded */
+    uint32_t cmdCount[AD5697R_EMU_CMD_COUNT];   /* Frames decoded per command */
+    uint32_t invalidFrames;                     /* Reserved commands and partial frames */
+    uint32_t reads;                             /* Read transactions addressed to the device */
+} ad5697r_emu_stats_t;
+
+/*!
+ * @brief ad5697r Emulated Device
+ */
+typedef struct {
+    uint8_t i2c_addr;               /* Device I2C Address */
+    bool rstsel;                    /* RSTSEL pin, powers on at midscale when true and zero scale otherwise */
+    bool ldacPin;                   /* Level of the !LDAC pin, input registers are transparent while low */
+    uint16_t input[2];              /* Input registers A/B */
+    uint16_t dac[2];                /* DAC registers A/B */
+    uint8_t powerMode[2];           /* Power-down bits A/B */
+    uint8_t ldacMask;               /* !LDAC mask register (DB3 = B, DB0 = A) */
+    uint8_t refOff;                 /* Internal reference setup, reference off when set */
+    uint8_t readSlot;               /* Readback slot pointer */
+    int8_t injectRet;               /* Result returned while injecting errors */
+    uint32_t injectCount;           /* Remaining transactions to fail */
+    ad5697r_emu_stats_t stats;      /* Device statistics */
+} ad5697r_emu_dev_t;
+
+/*!
+ * @brief ad5697r Simulated I2C Bus
+ */
+typedef struct {
+    uint32_t clockHz;                                   /* SCL clock frequency */
+    uint64_t busTimeNs;                                 /* Accumulated time on the bus */
+    uint32_t transactions;                              /* Transactions on the bus, including NACKs */
+    uint32_t wireBytes;                                 /* Bytes on the wire, including address bytes */
+    ad5697r_emu_dev_t *devices[AD5697R_EMU_MAX_DEVICES];/* Attached devices */
+} ad5697r_emu_bus_t;
+
+/*!
+ * @brief This API initializes a simulated bus and selects it as the bus the
+ * ad5697r_emuWrite()/ad5697r_emuRead() interface functions act on.
+ *
+ * @param[out] *bus: Pointer to the bus to be initialized
+ * @param[in] clockHz: SCL clock frequency, e.g. 100k, 400k, 1M or 3.4MHz
+ *
+ * @return The result of initializing the bus
+ */
+ad5697r_return_code_t ad5697r_emuBusInit(ad5697r_emu_bus_t *bus, const uint32_t clockHz);
+
+/*!
+ * @brief This API selects the bus used by the interface functions
+ *
+ * @param[in] *bus: Pointer to the bus
+ *
+ * @return The result of selecting the bus
+ */
+ad5697r_return_code_t ad5697r_emuBusSelect(ad5697r_emu_bus_t *bus);
+
+/*!
+ * @brief This API powers on an emulated device and attaches it to the bus
+ *
+ * @param[in] *bus: Pointer to the bus
+ * @param[out] *emu: Pointer to the device to be attached
+ * @param[in] i2c_addr: Device I2C address
+ * @param[in] rstsel: RSTSEL pin state, midscale power-on code when true
+ *
+ * @return The result of attaching the device, AD5697R_RET_ERROR when the bus is full
+ */
+ad5697r_return_code_t ad5697r_emuAttach(ad5697r_emu_bus_t *bus, ad5697r_emu_dev_t *emu, const uint8_t i2c_addr, const bool rstsel);
+
+/*!
+ * @brief This API resets the bus time and transfer counters
+ *
+ * @param[in] *bus: Pointer to the bus
+ *
+ * @return The result of resetting the counters
+ */
+ad5697r_return_code_t ad5697r_emuBusResetStats(ad5697r_emu_bus_t *bus);
+
+/*!
+ * @brief ad5697r_write_fptr_t implementation that decodes the frames on the selected bus
+ */
+int8_t ad5697r_emuWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief ad5697r_bus_xfer_fptr_t implementation that runs a combined transaction,
+ * one repeated START per message, on the bus passed as context
+ */
+int8_t ad5697r_emuTransfer(void *ctx, const ad5697r_bus_msg_t *msgs, const uint32_t count);
+
+/*!
+ * @brief ad5697r_read_fptr_t implementation that reads back the input registers on the selected bus
+ */
+int8_t ad5697r_emuRead(const uint8_t busAddr, uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief This API drives the !LDAC pin of the device. A falling edge moves the
+ * input registers of the unmasked channels into their DAC registers.
+ *
+ * @param[in] *emu: Pointer to the emulated device
+ * @param[in] level: New level of the pin
+ *
+ * @return The result of driving the pin
+ */
+ad5697r_return_code_t ad5697r_emuSetLdacPin(ad5697r_emu_dev_t *emu, const bool level);
+
+/*!
+ * @brief This API makes the next transactions addressed to the device fail
+ *
+ * @param[in] *emu: Pointer to the emulated device
+ * @param[in] ret: Result to be returned by the failing transactions
+ * @param[in] count: Number of transactions to fail
+ *
+ * @return The result of injecting the error
+ */
+ad5697r_return_code_t ad5697r_emuInjectError(ad5697r_emu_dev_t *emu, const ad5697r_return_code_t ret, const uint32_t count);
+
+/*!
+ * @brief This API returns the output voltage of a DAC channel
+ *
+ * @param[in] *emu: Pointer to the emulated device
+ * @param[in] ch: DAC output channel, A or B
+ * @param[in] vrefExt: External reference voltage, used while the internal reference is off
+ * @param[in] gain: Output amplifier gain set by the GAIN pin, 1 or 2
+ *
+ * @return The output voltage, 0V while the channel is powered down
+ */
+float ad5697r_emuGetOutputVoltage(const ad5697r_emu_dev_t *emu, const ad5697r_output_channel_t ch, const float vrefExt, const uint8_t gain);
+
+#endif // _ad5697r_emu_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,226 @@
+/*! @file ad5697r_encode.h
+ * @brief Header-only frame encoders for the ad5697r input shift register.
+ *
+ * Frames are packed with explicit shifts and masks in wire order, so the
+ * output does not depend on the compiler's bitfield layout or on the host
+ * endianness. The unchecked encoders have no branches; called with constant
+ * arguments, e.g. through the fixed-channel encoders, they reduce to a few
+ * stores. The checked encoders validate their arguments first and otherwise
+ * produce the same bytes. The unchecked encoders are the AD5697R
+ * specialization of the family core in ad56x_family.h.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_encode_H_
+#define _ad5697r_encode_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ad5697r.h"
+#include "ad56x_family.h"
+
+#define AD5697R_ENC_MAX_CODE    AD56X_MAX_CODE(AD5697R)     /*! @brief Full scale 12bit code */
+#define AD5697R_ENC_PD_RSVD     AD56X_AD5697R_PD_FILL       /*! @brief Power-down frame DB5:DB2, set to 1 */
+
+/*!
+ * @brief AD5697R Command Definitions
+ */
+typedef enum {
+    AD5697R_CMD_NO_OP                         = 0x00, /* No operation */
+    AD5697R_CMD_W_INPUT_REG_N                 = 0x01, /* Write to Input Register n (Dependent on !LDAC) */
+    AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N   = 0x02, /* Update DAC Register n with contents from Input Register n */
+    AD5697R_CMD_WRITE_DAC                     = 0x03, /* Write to and update DAC Channel n */
+    AD5697R_CMD_POWER_DAC                     = 0x04, /* Power down/power up DAC */
+    AD5697R_CMD_HW_LDAC_MASK                  = 0x05, /* Hardware !LDAC mask register */
+    AD5697R_CMD_SOFT_RESET                    = 0x06, /* Software reset (power-on reset) */
+    AD5697R_CMD_INT_REF_SETUP                 = 0x07, /* Internal reference setup register */
+    AD5697R_CMD__MAX__
+} AD5697R_CMD_t;
+
+AD56X_DEFINE_PART(ad56x_ad5697r, AD5697R)   /*! @brief AD5697R specialization of the family encoders */
+
+/*!
+ * @brief Encodes a DAC data frame (write/update commands) without any checks
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] cmd: Write/update command
+ * @param[in] ch: DAC output channel(s) addressed by the frame
+ * @param[in] code: 12bit value of the frame, upper bits are dropped
+ */
+static inline void ad5697r_encDacUnchecked(uint8_t *frame, const uint8_t cmd, const uint8_t ch, const uint16_t code) {
+    ad56x_ad5697r_encDac(frame, cmd, ch, code);
+}
+
+/*!
+ * @brief Decodes the 12bit code of a DAC data frame or an input register readback
+ *
+ * @param[in] *data: Pointer to the two data bytes, MSB first
+ *
+ * @return 12bit code
+ */
+static inline uint16_t ad5697r_decCode(const uint8_t *data) {
+    return ad56x_ad5697r_decCode(data);
+}
+
+/*!
+ * @brief Encodes a power down/power up frame for both channels without any checks
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] modeA: Operating mode of channel A
+ * @param[in] modeB: Operating mode of channel B
+ */
+static inline void ad5697r_encPowerUnchecked(uint8_t *frame, const uint8_t modeA, const uint8_t modeB) {
+    const uint8_t modes[AD56X_AD5697R_CHANNELS] = {modeA, modeB};
+
+    ad56x_ad5697r_encPower(frame, modes);
+}
+
+/*!
+ * @brief Encodes an internal reference setup frame without any checks
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] refSelect: State of the internal reference
+ */
+static inline void ad5697r_encReferenceUnchecked(uint8_t *frame, const uint8_t refSelect) {
+    ad56x_ad5697r_encReference(frame, refSelect);
+}
+
+/*!
+ * @brief Encodes a hardware !LDAC mask frame without any checks. The channel
+ * bits of the mask already sit at their register positions, DB0 = A, DB3 = B.
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] mask: Channels that ignore the !LDAC pin (ad5697r_output_channel_t bits)
+ */
+static inline void ad5697r_encLdacMaskUnchecked(uint8_t *frame, const uint8_t mask) {
+    ad56x_ad5697r_encLdacMask(frame, mask);
+}
+
+/*!
+ * @brief Encodes a software reset frame
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ */
+static inline void ad5697r_encSoftResetUnchecked(uint8_t *frame) {
+    ad56x_ad5697r_encSoftReset(frame);
+}
+
+/*!
+ * @brief Returns true for a channel selection a frame can address
+ */
+static inline bool ad5697r_encValidChannel(const uint8_t ch) {
+    return (ch == AD5697R_OUTPUT_CH_A) || (ch == AD5697R_OUTPUT_CH_B) || (ch == AD5697R_OUTPUT_CH_A_B);
+}
+
+/*!
+ * @brief Encodes a DAC data frame after checking its arguments
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] cmd: AD5697R_CMD_W_INPUT_REG_N, AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N or AD5697R_CMD_WRITE_DAC
+ * @param[in] ch: DAC output channel(s) addressed by the frame
+ * @param[in] code: 12bit value of the frame
+ *
+ * @return The result of encoding the frame, the frame is untouched on error
+ */
+static inline ad5697r_return_code_t ad5697r_encDac(uint8_t *frame, const uint8_t cmd, const uint8_t ch, const uint16_t code) {
+    if( frame == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (cmd < AD5697R_CMD_W_INPUT_REG_N) || (cmd > AD5697R_CMD_WRITE_DAC) ||
+             !ad5697r_encValidChannel(ch) || (code > AD5697R_ENC_MAX_CODE) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_encDacUnchecked(frame, cmd, ch, code);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Encodes a power down/power up frame after checking its arguments
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] modeA: Operating mode of channel A
+ * @param[in] modeB: Operating mode of channel B
+ *
+ * @return The result of encoding the frame, the frame is untouched on error
+ */
+static inline ad5697r_return_code_t ad5697r_encPower(uint8_t *frame, const uint8_t modeA, const uint8_t modeB) {
+    if( frame == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (modeA >= AD5697R_OP_MODE__MAX__) || (modeB >= AD5697R_OP_MODE__MAX__) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_encPowerUnchecked(frame, modeA, modeB);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Encodes an internal reference setup frame after checking its arguments
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] refSelect: State of the internal reference
+ *
+ * @return The result of encoding the frame, the frame is untouched on error
+ */
+static inline ad5697r_return_code_t ad5697r_encReference(uint8_t *frame, const uint8_t refSelect) {
+    if( frame == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( refSelect >= AD5697R_REF__MAX__ ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_encReferenceUnchecked(frame, refSelect);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Encodes a hardware !LDAC mask frame after checking its arguments
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] mask: Channels that ignore the !LDAC pin (ad5697r_output_channel_t bits)
+ *
+ * @return The result of encoding the frame, the frame is untouched on error
+ */
+static inline ad5697r_return_code_t ad5697r_encLdacMask(uint8_t *frame, const uint8_t mask) {
+    if( frame == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( mask & (uint8_t)~AD5697R_OUTPUT_CH_A_B ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_encLdacMaskUnchecked(frame, mask);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Defines an encoder with the command and channel fixed at compile time,
+ * void name(uint8_t *frame, const uint16_t code)
+ */
+#define AD5697R_ENC_DEFINE_DAC(name, cmd, ch)                                   \
+    static inline void name(uint8_t *frame, const uint16_t code) {              \
+        ad5697r_encDacUnchecked(frame, (uint8_t)(cmd), (uint8_t)(ch), code);    \
+    }
+
+AD5697R_ENC_DEFINE_DAC(ad5697r_encWriteA, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A)               /*! @brief Write and update DAC A */
+AD5697R_ENC_DEFINE_DAC(ad5697r_encWriteB, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_B)               /*! @brief Write and update DAC B */
+AD5697R_ENC_DEFINE_DAC(ad5697r_encWriteAB, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A_B)            /*! @brief Write and update DAC A and B */
+AD5697R_ENC_DEFINE_DAC(ad5697r_encInputA, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A)           /*! @brief Write input register A */
+AD5697R_ENC_DEFINE_DAC(ad5697r_encInputB, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_B)           /*! @brief Write input register B */
+AD5697R_ENC_DEFINE_DAC(ad5697r_encInputAB, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A_B)        /*! @brief Write input register A and B */
+
+#endif // _ad5697r_encode_H_
+
+#ifdef __cplusplus
+}
+#endif
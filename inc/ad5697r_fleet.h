@@ -0,0 +1,188 @@
+/*! @file ad5697r_fleet.h
+ * @brief Public header file for the ad5697r multi-device bus manager.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_fleet_H_
+#define _ad5697r_fleet_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#define AD5697R_FLEET_BUS_DEVICES   (4)     /*! @brief Devices per bus, set by the A0/A1 pins */
+
+/*!
+ * @brief Hook called when a bus goes from idle to having pending updates,
+ * e.g. to wake the bus worker
+ */
+typedef void (*ad5697r_fleet_notify_fptr_t)(void *ctx);
+
+/*!
+ * @brief ad5697r Fleet Device
+ */
+typedef struct {
+    ad5697r_dev_t *dev;     /* Registered device */
+    uint32_t latest[2];     /* Latest pending code of channel A/B, flagged valid */
+} ad5697r_fleet_node_t;
+
+/*!
+ * @brief ad5697r Fleet Bus Statistics
+ */
+typedef struct {
+    uint32_t transactions;  /* Combined transactions issued */
+    uint32_t messages;      /* Device messages in those transactions */
+    uint32_t updates;       /* Channel updates written */
+    uint32_t errors;        /* Failed transactions */
+} ad5697r_fleet_stats_t;
+
+/*!
+ * @brief ad5697r Fleet Bus. Pending updates of every device on the bus go out
+ * as one combined transaction with a repeated START per device.
+ */
+typedef struct {
+    ad5697r_bus_xfer_fptr_t xfer;                                           /* Bus transfer function */
+    void *ctx;                                                              /* Bus transfer context, e.g. the adapter */
+    ad5697r_fleet_node_t nodes[AD5697R_FLEET_BUS_DEVICES];                  /* Registered devices */
+    uint8_t count;                                                          /* Number of registered devices */
+    uint8_t pending;                                                        /* Set while updates are pending */
+    bool staged;                                                            /* Write input registers, outputs move on !LDAC */
+    ad5697r_fleet_notify_fptr_t notify;                                     /* Pending hook, may be NULL */
+    void *notifyCtx;                                                        /* Pending hook context */
+    uint8_t frames[AD5697R_FLEET_BUS_DEVICES][AD5697R_BATCH_BUF_SIZE(2)];   /* Frames of the transaction */
+    ad5697r_bus_msg_t msgs[AD5697R_FLEET_BUS_DEVICES];                      /* Messages of the transaction */
+    ad5697r_fleet_stats_t stats;                                            /* Bus statistics */
+} ad5697r_fleet_bus_t;
+
+/*!
+ * @brief ad5697r Fleet
+ */
+typedef struct {
+    ad5697r_fleet_bus_t *buses;     /* Caller provided buses */
+    uint32_t count;                 /* Number of buses */
+    ad5697r_ldac_fptr_t ldac;       /* Shared !LDAC pin, NULL to update the outputs directly */
+} ad5697r_fleet_t;
+
+/*!
+ * @brief This API initializes a fleet over caller provided buses
+ *
+ * @param[out] *fleet: Pointer to the fleet to be initialized
+ * @param[in] *buses: Buses of the fleet
+ * @param[in] count: Number of buses
+ *
+ * @return The result of initializing the fleet
+ */
+ad5697r_return_code_t ad5697r_fleetInit(ad5697r_fleet_t *fleet, ad5697r_fleet_bus_t *buses, const uint32_t count);
+
+/*!
+ * @brief This API sets the transfer function of a bus
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[in] bus: Index of the bus
+ * @param[in] xfer: Combined transaction function, e.g. ad5697r_linuxTransfer()
+ * @param[in] *ctx: Context identifying the bus, e.g. the adapter
+ *
+ * @return The result of setting the transfer function
+ */
+ad5697r_return_code_t ad5697r_fleetSetBus(ad5697r_fleet_t *fleet, const uint32_t bus, ad5697r_bus_xfer_fptr_t xfer, void *ctx);
+
+/*!
+ * @brief This API sets the hook called when a bus gets pending updates
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[in] bus: Index of the bus
+ * @param[in] notify: Pending hook, NULL to disable
+ * @param[in] *notifyCtx: Pending hook context
+ *
+ * @return The result of setting the hook
+ */
+ad5697r_return_code_t ad5697r_fleetSetNotify(ad5697r_fleet_t *fleet, const uint32_t bus, ad5697r_fleet_notify_fptr_t notify, void *notifyCtx);
+
+/*!
+ * @brief This API sets the !LDAC pin shared by the fleet. With a pin set,
+ * flushes only write the input registers and ad5697r_fleetCommit() moves every
+ * staged code to the outputs of all devices on all buses with a single edge.
+ * The pin must idle high and the devices' !LDAC masks must be cleared.
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[in] ldac: !LDAC GPIO function, NULL to write the outputs directly
+ *
+ * @return The result of setting the pin
+ */
+ad5697r_return_code_t ad5697r_fleetSetLdac(ad5697r_fleet_t *fleet, ad5697r_ldac_fptr_t ldac);
+
+/*!
+ * @brief This API registers a device on a bus. The fleet writes the device
+ * through the bus transfer function, so its shadow is invalidated.
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[in] bus: Index of the bus
+ * @param[in] *dev: Pointer to the device, its intf.i2c_addr must be unique on the bus
+ *
+ * @return The result of registering the device
+ */
+ad5697r_return_code_t ad5697r_fleetAttach(ad5697r_fleet_t *fleet, const uint32_t bus, ad5697r_dev_t *dev);
+
+/*!
+ * @brief This API stages an update for a registered device. A pending update
+ * of the same channel is replaced. Safe to call from any thread.
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[in] *dev: Pointer to the registered device
+ * @param[in] ch: Output channel(s) to update
+ * @param[in] outputVal: 12-Bit output value
+ *
+ * @return The result of staging the update
+ */
+ad5697r_return_code_t ad5697r_fleetPost(ad5697r_fleet_t *fleet, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API writes the pending updates of one bus as one combined
+ * transaction. Only one thread may flush a given bus. The shadow of every
+ * written channel is invalidated. When the transaction fails the codes are
+ * kept for the next flush, unless a newer code was posted in the meantime.
+ * The transaction goes straight to the bus transfer function, so the retry
+ * policy and the bus instrumentation of the devices do not apply to it.
+ *
+ * @param[in] *bus: Pointer to the bus
+ *
+ * @return The result of the transaction
+ */
+ad5697r_return_code_t ad5697r_fleetFlushBus(ad5697r_fleet_bus_t *bus);
+
+/*!
+ * @brief This API flushes every bus of the fleet in turn
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ *
+ * @return AD5697R_RET_OK, or the first error of a bus
+ */
+ad5697r_return_code_t ad5697r_fleetFlush(ad5697r_fleet_t *fleet);
+
+/*!
+ * @brief This API flushes every bus, then pulses !LDAC once so all staged codes
+ * reach the outputs together. The pin is not pulsed if a bus fails.
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ *
+ * @return AD5697R_RET_OK, or the first error of a bus
+ */
+ad5697r_return_code_t ad5697r_fleetCommit(ad5697r_fleet_t *fleet);
+
+/*!
+ * @brief This API pulses the shared !LDAC pin
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ *
+ * @return The result of pulsing the pin, AD5697R_RET_NULL_PTR without a pin
+ */
+ad5697r_return_code_t ad5697r_fleetPulseLdac(ad5697r_fleet_t *fleet);
+
+#endif // _ad5697r_fleet_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+/*! @file ad5697r_fleet_thread.h
+ * @brief Public header file for the ad5697r fleet bus worker threads.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_fleet_thread_H_
+#define _ad5697r_fleet_thread_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "ad5697r.h"
+#include "ad5697r_fleet.h"
+
+/*!
+ * @brief ad5697r Fleet Bus Worker. Each bus is flushed by its own thread so
+ * the buses run their transactions in parallel.
+ */
+typedef struct {
+    pthread_t thread;               /* Worker thread */
+    pthread_mutex_t lock;           /* Protects the fields below */
+    pthread_cond_t cond;            /* Signals pending updates or a stop */
+    pthread_cond_t idle;            /* Signals the end of a flush */
+    bool running;                   /* Cleared to stop the worker */
+    bool signalled;                 /* The bus has pending updates */
+    bool busy;                      /* A flush is in progress */
+    ad5697r_return_code_t result;   /* Result of the last flush */
+    ad5697r_fleet_bus_t *bus;       /* Bus flushed by the worker */
+} ad5697r_fleet_worker_t;
+
+/*!
+ * @brief This API starts one worker per bus of the fleet. Register every
+ * device before starting the workers.
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[out] *workers: One worker per bus
+ *
+ * @return The result of starting the workers
+ */
+ad5697r_return_code_t ad5697r_fleetThreadStart(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers);
+
+/*!
+ * @brief This API waits until every worker has written the updates posted so
+ * far, then pulses the fleet's !LDAC pin once so all outputs move together.
+ * The pin is not pulsed if the last flush of a bus failed.
+ *
+ * @param[in] *fleet: Pointer to the fleet, with a pin set by ad5697r_fleetSetLdac()
+ * @param[in] *workers: Workers started with ad5697r_fleetThreadStart()
+ *
+ * @return AD5697R_RET_OK once pulsed, or the first error of a bus
+ */
+ad5697r_return_code_t ad5697r_fleetThreadCommit(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers);
+
+/*!
+ * @brief This API writes the remaining updates, then stops and joins the
+ * workers. Stop posting updates before stopping the workers.
+ *
+ * @param[in] *fleet: Pointer to the fleet
+ * @param[in] *workers: Workers started with ad5697r_fleetThreadStart()
+ *
+ * @return The result of stopping the workers
+ */
+ad5697r_return_code_t ad5697r_fleetThreadStop(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers);
+
+#endif // _ad5697r_fleet_thread_H_
+
+#ifdef __cplusplus
+}
+#endif
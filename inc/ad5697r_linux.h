@@ -0,0 +1,148 @@
+/*! @file ad5697r_linux.h
+ * @brief Public header file for the ad5697r Linux i2c-dev transport backend.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_linux_H_
+#define _ad5697r_linux_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "ad5697r.h"
+
+#define AD5697R_LINUX_MAX_MSGS      (I2C_RDWR_IOCTL_MAX_MSGS)   /*! @brief Messages per I2C_RDWR ioctl */
+
+/*!
+ * @brief ad5697r Linux Transport Statistics
+ */
+typedef struct {
+    uint32_t ioctls;        /* Transfer ioctls issued */
+    uint32_t messages;      /* I2C messages submitted */
+    uint32_t bytes;         /* Data bytes submitted, excluding address bytes */
+    uint32_t errors;        /* Failed transfer ioctls */
+} ad5697r_linux_stats_t;
+
+/*!
+ * @brief ad5697r Linux i2c-dev Adapter
+ */
+typedef struct {
+    int fd;                                         /* i2c-dev file descriptor, -1 while closed */
+    bool rdwr;                                      /* Adapter supports plain I2C messages (I2C_RDWR) */
+    bool deferred;                                  /* Queue writes until ad5697r_linuxFlush() */
+    uint8_t slaveAddr;                              /* Address selected with I2C_SLAVE for SMBus transfers */
+    uint8_t lastCmd;                                /* First byte of the last write, used for SMBus readback */
+    uint8_t *buf;                                   /* Caller provided staging buffer for queued writes */
+    uint32_t size;                                  /* Size of the staging buffer */
+    uint32_t len;                                   /* Bytes staged */
+    struct i2c_msg msgs[AD5697R_LINUX_MAX_MSGS];    /* Queued messages */
+    uint32_t nmsgs;                                 /* Number of queued messages */
+    ad5697r_linux_stats_t stats;                    /* Transport statistics */
+} ad5697r_linux_bus_t;
+
+/*!
+ * @brief This API initializes an adapter with a staging buffer for queued
+ * writes and selects it as the adapter the ad5697r_linuxWrite()/
+ * ad5697r_linuxRead() interface functions act on.
+ *
+ * @param[out] *bus: Pointer to the adapter to be initialized
+ * @param[in] *buf: Staging buffer for queued writes, may be NULL when writes are never deferred
+ * @param[in] size: Size of the staging buffer
+ *
+ * @return The result of initializing the adapter
+ */
+ad5697r_return_code_t ad5697r_linuxInit(ad5697r_linux_bus_t *bus, uint8_t *buf, const uint32_t size);
+
+/*!
+ * @brief This API opens an i2c-dev adapter, e.g. "/dev/i2c-1", and queries
+ * whether it supports plain I2C messages. Adapters that only support SMBus,
+ * such as the i2c-stub module, fall back to I2C block transfers.
+ *
+ * @param[in] *bus: Pointer to the initialized adapter
+ * @param[in] *path: Path of the i2c-dev character device
+ *
+ * @return The result of opening the adapter
+ */
+ad5697r_return_code_t ad5697r_linuxOpen(ad5697r_linux_bus_t *bus, const char *path);
+
+/*!
+ * @brief This API closes the adapter. Queued writes are discarded.
+ *
+ * @param[in] *bus: Pointer to the adapter
+ *
+ * @return The result of closing the adapter
+ */
+ad5697r_return_code_t ad5697r_linuxClose(ad5697r_linux_bus_t *bus);
+
+/*!
+ * @brief This API selects the adapter used by the interface functions
+ *
+ * @param[in] *bus: Pointer to the adapter
+ *
+ * @return The result of selecting the adapter
+ */
+ad5697r_return_code_t ad5697r_linuxSelect(ad5697r_linux_bus_t *bus);
+
+/*!
+ * @brief This API enables or disables deferred writes. While deferred,
+ * ad5697r_linuxWrite() only queues the frames and returns success, and
+ * ad5697r_linuxFlush() submits every queued message in one I2C_RDWR ioctl.
+ * Disabling flushes the queue.
+ *
+ * @param[in] *bus: Pointer to the adapter
+ * @param[in] deferred: Queue writes when true
+ *
+ * @return The result of the flush when disabling, AD5697R_RET_OK otherwise
+ */
+ad5697r_return_code_t ad5697r_linuxSetDeferred(ad5697r_linux_bus_t *bus, const bool deferred);
+
+/*!
+ * @brief This API queues a write message. A full queue is flushed first.
+ *
+ * @param[in] *bus: Pointer to the adapter
+ * @param[in] busAddr: 7-bit I2C address of the device
+ * @param[in] *data: Frames to be written
+ * @param[in] len: Number of bytes to be written
+ *
+ * @return The result of queueing the message
+ */
+ad5697r_return_code_t ad5697r_linuxQueue(ad5697r_linux_bus_t *bus, const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief This API submits every queued message. On failure the queue is
+ * kept so the flush can be retried, and the shadow of the devices involved
+ * should be invalidated with ad5697r_invalidateShadow().
+ *
+ * @param[in] *bus: Pointer to the adapter
+ *
+ * @return The result of the transfer
+ */
+ad5697r_return_code_t ad5697r_linuxFlush(ad5697r_linux_bus_t *bus);
+
+/*!
+ * @brief Write interface function for ad5697r_dev_intf_t
+ */
+int8_t ad5697r_linuxWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief ad5697r_bus_xfer_fptr_t implementation for the adapter passed as
+ * context. The messages go out in one I2C_RDWR ioctl, repeated START between
+ * them, split every AD5697R_LINUX_MAX_MSGS messages.
+ */
+int8_t ad5697r_linuxTransfer(void *ctx, const ad5697r_bus_msg_t *msgs, const uint32_t count);
+
+/*!
+ * @brief Read interface function for ad5697r_dev_intf_t. Queued writes are
+ * submitted in the same ioctl, ahead of the read, with a repeated start.
+ */
+int8_t ad5697r_linuxRead(const uint8_t busAddr, uint8_t *data, const uint32_t len);
+
+#endif // _ad5697r_linux_H_
+
+#ifdef __cplusplus
+}
+#endif
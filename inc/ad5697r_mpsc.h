@@ -0,0 +1,109 @@
+/*! @file ad5697r_mpsc.h
+ * @brief Public header file for the ad5697r lock-free multi-producer update queue.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_mpsc_H_
+#define _ad5697r_mpsc_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#ifndef AD5697R_MPSC_DRAIN_FRAMES
+#define AD5697R_MPSC_DRAIN_FRAMES   (8)     /*! @brief Updates packed into one transaction by a drain */
+#endif
+
+/*!
+ * @brief ad5697r Update Queue Cell
+ */
+typedef struct {
+    uint32_t seq;       /* Sequence number, marks the cell free or filled for a position */
+    uint8_t ch;         /* Output channel of the update */
+    uint16_t code;      /* 12-Bit output value, unused when coalescing */
+} ad5697r_mpsc_cell_t;
+
+/*!
+ * @brief ad5697r Update Queue Statistics
+ */
+typedef struct {
+    uint32_t posted;        /* Updates posted by the producers */
+    uint32_t coalesced;     /* Updates superseded by a newer code for the same channel */
+    uint32_t drops;         /* Updates rejected with a full queue */
+    uint32_t written;       /* Updates written to the device */
+    uint32_t writeErrors;   /* Transactions the device interface failed to write */
+    uint32_t maxDepth;      /* Largest number of queued updates seen by a producer */
+} ad5697r_mpsc_stats_t;
+
+/*!
+ * @brief ad5697r Lock-Free Update Queue. Any number of threads post updates,
+ * a single bus owner drains them to the device.
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                                 /* Device the updates are written to */
+    ad5697r_mpsc_cell_t *cells;                         /* Caller provided cells */
+    uint32_t mask;                                      /* Number of cells minus one */
+    uint32_t enqueuePos;                                /* Next position claimed by a producer */
+    uint32_t dequeuePos;                                /* Next position read by the bus owner */
+    bool coalesce;                                      /* Keep only the latest pending code per channel */
+    uint32_t latest[2];                                 /* Latest pending code of channel A/B, flagged valid */
+    uint8_t queued[2];                                  /* Channel A/B has an entry in the queue */
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(AD5697R_MPSC_DRAIN_FRAMES)]; /* Drain transaction buffer */
+    ad5697r_mpsc_stats_t stats;                         /* Queue statistics */
+} ad5697r_mpsc_t;
+
+/*!
+ * @brief This API initializes an update queue in front of a device
+ *
+ * @param[out] *queue: Pointer to the queue to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *cells: Queue cells
+ * @param[in] capacity: Number of cells, a power of two
+ * @param[in] coalesce: Merge pending updates to the same channel, last writer wins
+ *
+ * @return The result of initializing the queue
+ */
+ad5697r_return_code_t ad5697r_mpscInit(ad5697r_mpsc_t *queue, ad5697r_dev_t *dev, ad5697r_mpsc_cell_t *cells, const uint32_t capacity, const bool coalesce);
+
+/*!
+ * @brief This API posts an update without blocking. Safe to call from any
+ * number of threads. AD5697R_OUTPUT_CH_A_B posts one update per channel.
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] ch: Output channel(s) to update
+ * @param[in] outputVal: 12-Bit output value
+ *
+ * @return AD5697R_RET_OK once queued or merged, AD5697R_RET_BUSY if the queue is full
+ */
+ad5697r_return_code_t ad5697r_mpscPost(ad5697r_mpsc_t *queue, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API writes pending updates to the device, packing up to
+ * AD5697R_MPSC_DRAIN_FRAMES updates into each transaction. Only the bus owner
+ * thread may call it.
+ *
+ * @param[in] *queue: Pointer to the queue
+ * @param[in] maxUpdates: Largest number of updates to write, 0 for all pending
+ * @param[out] *written: Number of updates written, may be NULL
+ *
+ * @return The result of writing the updates
+ */
+ad5697r_return_code_t ad5697r_mpscDrain(ad5697r_mpsc_t *queue, const uint32_t maxUpdates, uint32_t *written);
+
+/*!
+ * @brief This API returns the number of queued updates
+ *
+ * @param[in] *queue: Pointer to the queue
+ *
+ * @return Queue depth
+ */
+uint32_t ad5697r_mpscGetDepth(const ad5697r_mpsc_t *queue);
+
+#endif // _ad5697r_mpsc_H_
+
+#ifdef __cplusplus
+}
+#endif
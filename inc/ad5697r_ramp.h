@@ -0,0 +1,133 @@
+/*! @file ad5697r_ramp.h
+ * @brief Public header file for the ad5697r slew-rate-limited ramp generator.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_ramp_H_
+#define _ad5697r_ramp_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#define AD5697R_RAMP_CHANNELS       (2)         /*! @brief Ramped channels, A and B */
+#define AD5697R_RAMP_MAX_CODE       (0x0FFF)    /*! @brief Full scale 12bit code */
+
+/*!
+ * @brief ad5697r Ramp Profile
+ */
+typedef enum {
+    AD5697R_RAMP_LINEAR         = 0x00, /* Constant slew to the target */
+    AD5697R_RAMP_S_CURVE        = 0x01, /* Smoothstep, accelerates and decelerates with the peak slew at the midpoint */
+    AD5697R_RAMP__MAX__
+} ad5697r_ramp_profile_t;
+
+/*!
+ * @brief ad5697r Ramped Channel
+ */
+typedef struct {
+    ad5697r_ramp_profile_t profile;     /* Profile of the running ramp */
+    bool active;                        /* Ramp has not reached its target yet */
+    bool synced;                        /* Device holds the current code */
+    uint16_t code;                      /* Current code */
+    uint16_t start;                     /* Code the S-curve started from */
+    uint16_t target;                    /* Code the ramp ends at */
+    uint32_t pos;                       /* Linear position in Q16.16 codes */
+    uint32_t step;                      /* Linear increment per tick in Q16.16 codes */
+    uint32_t tick;                      /* Ticks since the S-curve started */
+    uint32_t ticks;                     /* Ticks of the whole S-curve */
+    uint64_t tickScale;                 /* 2^48 / ticks rounded up, turns a tick into Q16 progress without a divide */
+} ad5697r_ramp_channel_t;
+
+/*!
+ * @brief ad5697r Ramp Statistics
+ */
+typedef struct {
+    uint32_t ticks;             /* Calls to ad5697r_rampStep() with a ramp running */
+    uint32_t transactions;      /* Transactions written */
+    uint32_t frames;            /* Frames written */
+    uint32_t unchanged;         /* Ticks where no code changed and nothing was written */
+    uint32_t errors;            /* Failed transactions */
+} ad5697r_ramp_stats_t;
+
+/*!
+ * @brief ad5697r Ramp Generator. Advances the outputs of one device towards
+ * their targets once per tick, in Q16.16 fixed point.
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                                 /* Device the ramp is written to */
+    uint32_t tickHz;                                    /* Rate ad5697r_rampStep() is called at */
+    ad5697r_ramp_channel_t ch[AD5697R_RAMP_CHANNELS];   /* Channel A and B ramps */
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(AD5697R_RAMP_CHANNELS)]; /* Frames of one tick */
+    ad5697r_ramp_stats_t stats;                         /* Ramp statistics */
+} ad5697r_ramp_t;
+
+/*!
+ * @brief This API initializes a ramp generator. The channels start from the
+ * DAC codes held by the shadow registers, so write the initial outputs first,
+ * e.g. with ad5697r_init(). A channel without a known code starts from zero
+ * and is written on the first tick.
+ *
+ * @param[out] *ramp: Pointer to the ramp generator to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] tickHz: Rate ad5697r_rampStep() will be called at
+ *
+ * @return The result of initializing the ramp generator
+ */
+ad5697r_return_code_t ad5697r_rampInit(ad5697r_ramp_t *ramp, ad5697r_dev_t *dev, const uint32_t tickHz);
+
+/*!
+ * @brief This API starts a ramp from the current code of the channel(s) to the
+ * target. A linear ramp moves at slewCodesPerSec; an S-curve takes one and a
+ * half times as long so its peak slew, at the midpoint, does not exceed it.
+ * Setting a new target while ramping starts over from the current code.
+ *
+ * @param[in] *ramp: Pointer to the ramp generator
+ * @param[in] ch: DAC output channel(s) to ramp
+ * @param[in] target: 12bit code to ramp to
+ * @param[in] slewCodesPerSec: Maximum slew in codes per second
+ * @param[in] profile: Ramp profile
+ *
+ * @return The result of starting the ramp
+ */
+ad5697r_return_code_t ad5697r_rampSetTarget(ad5697r_ramp_t *ramp, const ad5697r_output_channel_t ch, const uint16_t target,
+                                            const uint32_t slewCodesPerSec, const ad5697r_ramp_profile_t profile);
+
+/*!
+ * @brief This API advances every running ramp by one tick. Only channels whose
+ * 12bit code changed are written, both channels in one transaction. A failed
+ * write is retried with the codes of the next tick.
+ *
+ * @param[in] *ramp: Pointer to the ramp generator
+ *
+ * @return AD5697R_RET_OK or the result of the failed transaction
+ */
+ad5697r_return_code_t ad5697r_rampStep(ad5697r_ramp_t *ramp);
+
+/*!
+ * @brief This API returns whether every ramp reached its target and was written
+ *
+ * @param[in] *ramp: Pointer to the ramp generator
+ *
+ * @return True when idle, also for an invalid ramp generator
+ */
+bool ad5697r_rampIsIdle(const ad5697r_ramp_t *ramp);
+
+/*!
+ * @brief This API converts a slew in volts per second to codes per second
+ *
+ * @param[in] voltsPerSec: Slew in volts per second
+ * @param[in] fullScale: Output voltage of the full scale code, e.g. 2.5 V or 5.0 V with the gain of 2
+ *
+ * @return Slew in codes per second, at least 1, or 0 for an invalid full scale
+ */
+uint32_t ad5697r_rampSlewFromVolts(const float voltsPerSec, const float fullScale);
+
+#endif // _ad5697r_ramp_H_
+
+#ifdef __cplusplus
+}
+#endif
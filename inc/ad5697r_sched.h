@@ -0,0 +1,184 @@
+/*! @file ad5697r_sched.h
+ * @brief Public header file for the ad5697r deadline scheduler.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_sched_H_
+#define _ad5697r_sched_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#ifndef AD5697R_SCHED_MAX_FRAMES
+#define AD5697R_SCHED_MAX_FRAMES    (8)     /*! @brief Operations packed into one transaction */
+#endif
+
+/*!
+ * @brief ad5697r Scheduler Priority Class, lower values are served first
+ */
+typedef enum {
+    AD5697R_SCHED_PRIO_CONTROL        = 0x00, /* Control loop updates */
+    AD5697R_SCHED_PRIO_WAVEFORM       = 0x01, /* Waveform playback */
+    AD5697R_SCHED_PRIO_HOUSEKEEPING   = 0x02, /* Power modes, reference and other bulk traffic */
+    AD5697R_SCHED_PRIO__MAX__
+} ad5697r_sched_prio_t;
+
+/*!
+ * @brief ad5697r Scheduled Operation
+ */
+typedef enum {
+    AD5697R_SCHED_OP_WRITE            = 0x00, /* Write and update channel(s), value is the code */
+    AD5697R_SCHED_OP_INPUT            = 0x01, /* Write input register(s), value is the code */
+    AD5697R_SCHED_OP_UPDATE           = 0x02, /* Update channel(s) from their input registers */
+    AD5697R_SCHED_OP_POWER            = 0x03, /* Set the operating mode of channel(s), value is the mode */
+    AD5697R_SCHED_OP_REFERENCE        = 0x04, /* Set the reference mode, value is the mode */
+    AD5697R_SCHED_OP_LDAC_MASK        = 0x05, /* Set the !LDAC mask, value is the mask */
+    AD5697R_SCHED_OP__MAX__
+} ad5697r_sched_op_t;
+
+/*!
+ * @brief Completion callback, called once per operation with the result of
+ * its transaction and whether it completed after its deadline
+ */
+typedef void (*ad5697r_sched_cb_fptr_t)(void *ctx, const ad5697r_return_code_t ret, const bool missed);
+
+/*!
+ * @brief ad5697r Scheduler Slot
+ */
+typedef struct {
+    bool used;                          /* Slot holds a pending operation */
+    ad5697r_sched_op_t op;              /* Operation */
+    ad5697r_output_channel_t ch;        /* Channel(s) of the operation */
+    uint16_t value;                     /* Code, mode or mask */
+    ad5697r_sched_prio_t prio;          /* Priority class */
+    uint32_t seq;                       /* Submission order */
+    uint32_t submittedUs;               /* Time of the submission */
+    uint32_t deadlineUs;                /* Absolute deadline */
+    ad5697r_sched_cb_fptr_t cb;         /* Completion callback, may be NULL */
+    void *ctx;                          /* Completion callback context */
+} ad5697r_sched_slot_t;
+
+/*!
+ * @brief ad5697r Scheduler Statistics of one priority class
+ */
+typedef struct {
+    uint32_t submitted;     /* Operations accepted */
+    uint32_t completed;     /* Operations completed, successful or not */
+    uint32_t missed;        /* Operations completed after their deadline */
+    uint32_t errors;        /* Operations completed with an error */
+    uint32_t maxQueueUs;    /* Longest time from submission to dispatch */
+    uint64_t totalQueueUs;  /* Sum of the times from submission to dispatch */
+} ad5697r_sched_class_stats_t;
+
+/*!
+ * @brief ad5697r Scheduler Statistics
+ */
+typedef struct {
+    ad5697r_sched_class_stats_t cls[AD5697R_SCHED_PRIO__MAX__]; /* Per priority class */
+    uint32_t transactions;                                      /* Transactions dispatched */
+    uint32_t frames;                                            /* Frames written */
+    uint32_t full;                                              /* Submissions rejected with every slot in use */
+    uint64_t busNs;                                             /* Estimated bus time of the transactions */
+    uint32_t sinceUs;                                           /* Time the statistics were reset */
+} ad5697r_sched_stats_t;
+
+/*!
+ * @brief ad5697r Scheduler. Orders the pending operations of one device by
+ * priority class, then by deadline, and packs them into transactions.
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                 /* Device the operations are written to */
+    ad5697r_sched_slot_t *slots;        /* Caller provided operation slots */
+    uint32_t capacity;                  /* Number of slots */
+    uint32_t pending;                   /* Slots in use */
+    uint32_t seq;                       /* Submission order of the next operation */
+    uint32_t busClockHz;                /* SCL clock the transactions are costed at */
+    uint32_t maxTransactionNs;          /* Bus time one transaction may hold the bus for */
+    ad5697r_get_time_us_fptr_t get_time_us; /* Clock the deadlines are measured on */
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(AD5697R_SCHED_MAX_FRAMES)]; /* Frames of one transaction */
+    ad5697r_sched_stats_t stats;        /* Scheduler statistics */
+} ad5697r_sched_t;
+
+/*!
+ * @brief This API initializes a scheduler over caller provided slots
+ *
+ * @param[out] *sched: Pointer to the scheduler to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *slots: Operation slots
+ * @param[in] capacity: Number of slots
+ * @param[in] busClockHz: SCL clock frequency used to cost the transactions
+ * @param[in] maxTransactionNs: Bus time one transaction may take, so no
+ * operation waits longer behind it; 0 packs up to AD5697R_SCHED_MAX_FRAMES
+ * @param[in] get_time_us: Microsecond clock the deadlines are measured on
+ *
+ * @return The result of initializing the scheduler
+ */
+ad5697r_return_code_t ad5697r_schedInit(ad5697r_sched_t *sched, ad5697r_dev_t *dev, ad5697r_sched_slot_t *slots, const uint32_t capacity,
+                                        const uint32_t busClockHz, const uint32_t maxTransactionNs, const ad5697r_get_time_us_fptr_t get_time_us);
+
+/*!
+ * @brief This API submits an operation
+ *
+ * @param[in] *sched: Pointer to the scheduler
+ * @param[in] op: Operation
+ * @param[in] ch: Channel(s) of the operation, ignored for the reference and !LDAC mask
+ * @param[in] value: Code, mode or mask, ignored for an update
+ * @param[in] prio: Priority class
+ * @param[in] deadlineUs: Time from now the operation has to be written by
+ * @param[in] cb: Completion callback, may be NULL
+ * @param[in] *ctx: Completion callback context
+ *
+ * @return AD5697R_RET_OK once queued, AD5697R_RET_BUSY if every slot is in use
+ */
+ad5697r_return_code_t ad5697r_schedSubmit(ad5697r_sched_t *sched, const ad5697r_sched_op_t op, const ad5697r_output_channel_t ch, const uint16_t value,
+                                          const ad5697r_sched_prio_t prio, const uint32_t deadlineUs, ad5697r_sched_cb_fptr_t cb, void *ctx);
+
+/*!
+ * @brief This API writes the most urgent operations in one transaction. The
+ * highest priority class goes first, the earliest deadline first within a
+ * class. Writes, input writes and updates of a channel keep their submission
+ * order, so an urgent one takes the older ones along. Operations are packed
+ * while the cost model keeps the transaction within maxTransactionNs.
+ *
+ * @param[in] *sched: Pointer to the scheduler
+ *
+ * @return AD5697R_RET_OK, also with nothing pending, or the result of the failed transaction
+ */
+ad5697r_return_code_t ad5697r_schedDispatch(ad5697r_sched_t *sched);
+
+/*!
+ * @brief This API returns the number of pending operations
+ *
+ * @param[in] *sched: Pointer to the scheduler
+ *
+ * @return Number of pending operations
+ */
+uint32_t ad5697r_schedGetPending(const ad5697r_sched_t *sched);
+
+/*!
+ * @brief This API returns the bus utilisation since the statistics were reset
+ *
+ * @param[in] *sched: Pointer to the scheduler
+ *
+ * @return Estimated share of the time the bus was busy in permille
+ */
+uint32_t ad5697r_schedGetUtilisation(const ad5697r_sched_t *sched);
+
+/*!
+ * @brief This API resets the statistics and starts a new utilisation window
+ *
+ * @param[in] *sched: Pointer to the scheduler
+ *
+ * @return The result of resetting the statistics
+ */
+ad5697r_return_code_t ad5697r_schedResetStats(ad5697r_sched_t *sched);
+
+#endif // _ad5697r_sched_H_
+
+#ifdef __cplusplus
+}
+#endif
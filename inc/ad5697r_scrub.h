@@ -0,0 +1,74 @@
+/*! @file ad5697r_scrub.h
+ * @brief Public header file for the ad5697r incremental register scrubber.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_scrub_H_
+#define _ad5697r_scrub_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+/*!
+ * @brief ad5697r Scrubber Statistics
+ */
+typedef struct {
+    uint32_t checks;        /* Registers read back */
+    uint32_t mismatches;    /* Registers that differed from the shadow */
+    uint32_t repairs;       /* Registers rewritten from the shadow */
+    uint32_t errors;        /* Failed readbacks or repairs */
+    uint32_t deferred;      /* Calls without enough bus time for a check */
+} ad5697r_scrub_stats_t;
+
+/*!
+ * @brief ad5697r Register Scrubber. Each call reads back at most one input
+ * register and rewrites it from the shadow when it differs, so corruption is
+ * caught and fixed without reinitializing the device or disturbing healthy
+ * outputs.
+ */
+typedef struct {
+    ad5697r_dev_t *dev;             /* Device being scrubbed */
+    uint32_t checkNs;               /* Bus time of one readback */
+    uint32_t repairNs;              /* Bus time of one rewrite */
+    uint32_t budgetNs;              /* Bus time granted per call */
+    uint32_t creditNs;              /* Granted bus time not spent yet */
+    uint8_t next;                   /* Next register to check, 0 for input A and 1 for input B */
+    ad5697r_scrub_stats_t stats;    /* Scrubber statistics */
+} ad5697r_scrub_t;
+
+/*!
+ * @brief This API initializes a scrubber. Every call grants budgetNs of bus
+ * time; unspent time carries over until a check and a possible rewrite fit,
+ * so a budget below the cost of one check spreads the checks over several calls.
+ *
+ * @param[out] *scrub: Pointer to the scrubber to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device, with intf.read set
+ * @param[in] busClockHz: SCL clock frequency used to cost the transactions
+ * @param[in] budgetNs: Bus time granted per call
+ *
+ * @return The result of initializing the scrubber
+ */
+ad5697r_return_code_t ad5697r_scrubInit(ad5697r_scrub_t *scrub, ad5697r_dev_t *dev, const uint32_t busClockHz, const uint32_t budgetNs);
+
+/*!
+ * @brief This API checks the next shadowed input register when the granted bus
+ * time allows, and rewrites it when it differs. A channel whose DAC register
+ * matches its input register is rewritten with a write and update, so its
+ * output is restored too.
+ *
+ * @param[in] *scrub: Pointer to the scrubber
+ * @param[out] *repaired: AD5697R_SHADOW_INPUT_A/B flag of the register rewritten by the call, may be NULL
+ *
+ * @return AD5697R_RET_OK, or the result of the failed readback or rewrite
+ */
+ad5697r_return_code_t ad5697r_scrubStep(ad5697r_scrub_t *scrub, uint8_t *repaired);
+
+#endif // _ad5697r_scrub_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+/*! @file ad5697r_sequence.h
+ * @brief Public header file for the ad5697r precompiled command sequences.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_sequence_H_
+#define _ad5697r_sequence_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+/*!
+ * @brief ad5697r Command Sequence
+ */
+typedef struct {
+    uint8_t *buf;           /* User provided wire format buffer */
+    uint32_t size;          /* Size of the buffer in bytes */
+    uint32_t len;           /* Number of encoded bytes */
+    uint8_t touched;        /* Shadow registers written by the sequence (ad5697r_shadow_t) */
+} ad5697r_sequence_t;
+
+/*!
+ * @brief This API initializes an empty sequence. Every operation added to the
+ * sequence is validated and encoded once, so it can be replayed any number of
+ * times without further work. Size the buffer with AD5697R_BATCH_BUF_SIZE().
+ *
+ * @param[out] *seq: Pointer to the sequence to be initialized
+ * @param[in] *buf: Pointer to the buffer the frames are encoded in
+ * @param[in] size: Size of the buffer in bytes
+ *
+ * @return The result of initializing the sequence
+ */
+ad5697r_return_code_t ad5697r_seqInit(ad5697r_sequence_t *seq, uint8_t *buf, const uint32_t size);
+
+/*!
+ * @brief This API removes every operation from the sequence
+ *
+ * @param[in] *seq: Pointer to your sequence
+ *
+ * @return The result of clearing the sequence
+ */
+ad5697r_return_code_t ad5697r_seqClear(ad5697r_sequence_t *seq);
+
+/*!
+ * @brief This API returns the number of frames in the sequence
+ *
+ * @param[in] *seq: Pointer to your sequence
+ *
+ * @return Number of frames, 0 for an invalid sequence
+ */
+uint32_t ad5697r_seqGetFrames(const ad5697r_sequence_t *seq);
+
+/*!
+ * @brief This API adds a write to and update of the DAC channel
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] outputVal: 12bit value to write the DAC channel
+ *
+ * @return The result of adding the frame, AD5697R_RET_ERROR when the sequence is full, AD5697R_RET_INV_PARAM for a code above 12 bits
+ */
+ad5697r_return_code_t ad5697r_seqAddWriteChannel(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API adds a write to the input register of the DAC channel
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] outputVal: 12bit value to write the input register
+ *
+ * @return The result of adding the frame, AD5697R_RET_ERROR when the sequence is full, AD5697R_RET_INV_PARAM for a code above 12 bits
+ */
+ad5697r_return_code_t ad5697r_seqAddWriteInputRegister(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t outputVal);
+
+/*!
+ * @brief This API adds an update of the DAC channel(s) from their input registers
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel(s) to be updated
+ *
+ * @return The result of adding the frame, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_seqAddUpdateChannel(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch);
+
+/*!
+ * @brief This API adds a staged load of both channels followed by a single update
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] outputValA: 12bit value for DAC channel A
+ * @param[in] outputValB: 12bit value for DAC channel B
+ *
+ * @return The result of adding the frames, AD5697R_RET_ERROR when the sequence is full, AD5697R_RET_INV_PARAM for a code above 12 bits (nothing is added)
+ */
+ad5697r_return_code_t ad5697r_seqAddSynchronized(ad5697r_sequence_t *seq, const uint16_t outputValA, const uint16_t outputValB);
+
+/*!
+ * @brief This API adds a power down/power up of both channels
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] modeA: Operating mode of channel A
+ * @param[in] modeB: Operating mode of channel B
+ *
+ * @return The result of adding the frame, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_seqAddOperatingMode(ad5697r_sequence_t *seq, const ad5697r_operation_mode_t modeA, const ad5697r_operation_mode_t modeB);
+
+/*!
+ * @brief This API adds an internal reference change
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] refSelect: Sets the state of the internal reference (on/off)
+ *
+ * @return The result of adding the frame, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_seqAddReferenceMode(ad5697r_sequence_t *seq, const ad5697r_reference_t refSelect);
+
+/*!
+ * @brief This API adds a write to and update of the DAC channel for every code of the table
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] *table: Pointer to the 12bit codes
+ * @param[in] samples: Number of codes in the table
+ *
+ * @return The result of adding the frames, AD5697R_RET_ERROR when the sequence is full, AD5697R_RET_INV_PARAM for a code above 12 bits (nothing is added)
+ */
+ad5697r_return_code_t ad5697r_seqAddTable(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t *table, const uint32_t samples);
+
+/*!
+ * @brief This API adds one period of a sine wave, offset + amplitude * sin(2 pi n / samples)
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] samples: Number of samples per period
+ * @param[in] offset: Mid-point code of the sine wave
+ * @param[in] amplitude: Peak amplitude in codes, clamped to the 12bit range
+ *
+ * @return The result of adding the frames, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_seqAddSine(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint32_t samples, const uint16_t offset, const uint16_t amplitude);
+
+/*!
+ * @brief This API adds one period of a triangle wave rising from low to high and back
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] samples: Number of samples per period
+ * @param[in] low: Lowest code of the triangle
+ * @param[in] high: Highest code of the triangle
+ *
+ * @return The result of adding the frames, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_seqAddTriangle(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint32_t samples, const uint16_t low, const uint16_t high);
+
+/*!
+ * @brief This API adds a calibration sweep from start to stop (inclusive) in steps
+ *
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel to be written to
+ * @param[in] start: First code of the sweep
+ * @param[in] stop: Last code of the sweep
+ * @param[in] step: Code increment between frames
+ *
+ * @return The result of adding the frames, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_seqAddSweep(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t start, const uint16_t stop, const uint16_t step);
+
+/*!
+ * @brief This API writes the whole sequence to the device in a single transaction
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *seq: Pointer to your sequence
+ *
+ * @return The result of writing the sequence
+ */
+ad5697r_return_code_t ad5697r_seqReplay(ad5697r_dev_t *dev, const ad5697r_sequence_t *seq);
+
+/*!
+ * @brief This API writes a range of frames of the sequence in a single transaction
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] firstFrame: Index of the first frame to be written
+ * @param[in] frames: Number of frames to be written
+ *
+ * @return The result of writing the frames
+ */
+ad5697r_return_code_t ad5697r_seqReplayChunk(ad5697r_dev_t *dev, const ad5697r_sequence_t *seq, const uint32_t firstFrame, const uint32_t frames);
+
+#endif // _ad5697r_sequence_H_
+
+#ifdef __cplusplus
+}
+#endif
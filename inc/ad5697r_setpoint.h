@@ -0,0 +1,124 @@
+/*! @file ad5697r_setpoint.h
+ * @brief Public header file for the ad5697r ISR-safe triple-buffered setpoints.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_setpoint_H_
+#define _ad5697r_setpoint_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+#define AD5697R_SETPOINT_BUFFERS        (3)                         /*! @brief Published, latest and producer buffer */
+#define AD5697R_SETPOINT_MAX_FRAME_SIZE (3 * AD5697R_FRAME_SIZE)    /*! @brief Frames of a synchronized A/B setpoint */
+
+/*!
+ * @brief ad5697r Setpoint Buffer, the frames of one complete setpoint
+ */
+typedef struct {
+    uint8_t frames[AD5697R_SETPOINT_MAX_FRAME_SIZE];    /* Encoded frames, ready for the bus */
+    uint16_t code[2];                                   /* Codes of channel A/B the frames hold */
+} ad5697r_setpoint_buf_t;
+
+/*!
+ * @brief ad5697r Setpoint Statistics. The producer and the ISR each keep
+ * their own counters.
+ */
+typedef struct {
+    uint32_t sets;          /* Setpoints completed by the producer */
+    uint32_t overwritten;   /* Setpoints replaced before the ISR published them */
+    uint32_t published;     /* Calls to ad5697r_setpointPublish() */
+    uint32_t fresh;         /* Publishes that picked up a new setpoint */
+    uint32_t writeErrors;   /* Publishes the write function failed */
+} ad5697r_setpoint_stats_t;
+
+/*!
+ * @brief ad5697r Setpoint Block. One producer, e.g. the main loop, sets the
+ * codes at any time; one interrupt publishes the latest complete setpoint.
+ * Neither side waits for the other.
+ */
+typedef struct {
+    ad5697r_setpoint_buf_t buf[AD5697R_SETPOINT_BUFFERS]; /* Triple buffer */
+    uint8_t latest;                     /* Buffer of the latest setpoint, flagged until the ISR picks it up */
+    uint8_t back;                       /* Buffer the producer fills, owned by the producer */
+    uint8_t front;                      /* Buffer the ISR publishes, owned by the ISR */
+    ad5697r_output_channel_t ch;        /* Channel(s) of the setpoints */
+    uint32_t len;                       /* Bytes written per publish */
+    uint8_t i2c_addr;                   /* Device address, copied at init */
+    ad5697r_write_fptr_t write;         /* Write function of the ISR */
+    ad5697r_setpoint_stats_t stats;     /* Setpoint statistics */
+} ad5697r_setpoint_t;
+
+/*!
+ * @brief This API initializes a setpoint block with the initial codes, so the
+ * ISR always has a setpoint to publish. The device address and write function
+ * are copied, publishing never touches the device structure. It does use the
+ * bus: with the default intf.write, a publish can interrupt a main loop
+ * transfer on the same bus halfway, so every other access to that bus has
+ * to mask the ISR. A write function that only queues the frames, e.g. on a
+ * DMA channel the bus driver serializes, lifts that requirement. The shadow
+ * registers of the channel(s) are marked as unknown, as the published frames
+ * bypass them.
+ *
+ * @param[out] *sp: Pointer to the setpoint block to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] ch: Channel(s) of the setpoints. A and B are updated together
+ * with a synchronized write of 3 frames, a single channel with one frame.
+ * @param[in] codeA: Initial 12bit code of channel A (or of the single channel)
+ * @param[in] codeB: Initial 12bit code of channel B, ignored for a single channel
+ * @param[in] write: ISR-safe write function the ISR publishes with, e.g. one
+ * that queues a DMA transfer; NULL for intf.write of the device, which needs
+ * the ISR masked around every other access to the bus
+ *
+ * @return The result of initializing the setpoint block
+ */
+ad5697r_return_code_t ad5697r_setpointInit(ad5697r_setpoint_t *sp, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch,
+                                           const uint16_t codeA, const uint16_t codeB, const ad5697r_write_fptr_t write);
+
+/*!
+ * @brief This API sets new codes. The frames are checked and encoded here, in
+ * the producer, then made visible to the ISR with one atomic exchange. Call
+ * it from one context only.
+ *
+ * @param[in] *sp: Pointer to the setpoint block
+ * @param[in] codeA: 12bit code of channel A (or of the single channel)
+ * @param[in] codeB: 12bit code of channel B, ignored for a single channel
+ *
+ * @return The result of setting the codes
+ */
+ad5697r_return_code_t ad5697r_setpointSet(ad5697r_setpoint_t *sp, const uint16_t codeA, const uint16_t codeB);
+
+/*!
+ * @brief This API writes the frames of the latest complete setpoint, from
+ * the interrupt. It runs no parameter checks and does not touch the device:
+ * it picks up a new setpoint with one atomic exchange, if there is one, and
+ * hands a fixed number of bytes to the write function. Without a new setpoint
+ * the previous one is written again, so every tick costs the same on the bus.
+ *
+ * @param[in] *sp: Pointer to an initialized setpoint block
+ *
+ * @return The result of the write function
+ */
+int8_t ad5697r_setpointPublish(ad5697r_setpoint_t *sp);
+
+/*!
+ * @brief This API returns the codes of the setpoint published last. Call it
+ * from the ISR context or while the ISR is masked.
+ *
+ * @param[in] *sp: Pointer to the setpoint block
+ * @param[out] *codeA: Code of channel A (or of the single channel)
+ * @param[out] *codeB: Code of channel B
+ *
+ * @return The result of reading the codes
+ */
+ad5697r_return_code_t ad5697r_setpointGetPublished(const ad5697r_setpoint_t *sp, uint16_t *codeA, uint16_t *codeB);
+
+#endif // _ad5697r_setpoint_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,150 @@
+/*! @file ad5697r_stream.h
+ * @brief Public header file for the ad5697r waveform streaming engine.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_stream_H_
+#define _ad5697r_stream_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+
+/*!
+ * @brief ad5697r Stream Sample Layout
+ */
+typedef enum {
+    AD5697R_STREAM_SINGLE         = 0x00, /* One code per frame, written to the configured channel(s) */
+    AD5697R_STREAM_INTERLEAVED    = 0x01, /* A/B code pairs per frame, updated together */
+    AD5697R_STREAM__MAX__
+} ad5697r_stream_layout_t;
+
+/*!
+ * @brief ad5697r Stream Configuration
+ */
+typedef struct {
+    ad5697r_stream_layout_t layout;             /* Sample layout of the ring buffer */
+    ad5697r_output_channel_t ch;                /* Output channel(s), AD5697R_OUTPUT_CH_A_B for the interleaved layout */
+    uint32_t sampleRate;                        /* Output rate in frames per second */
+    ad5697r_get_time_us_fptr_t get_time_us;     /* Optional clock, paced by intf.delay_us alone when NULL */
+} ad5697r_stream_config_t;
+
+/*!
+ * @brief ad5697r Stream Statistics
+ */
+typedef struct {
+    uint32_t frames;            /* Frames written to the device */
+    uint32_t underruns;         /* Deadlines that passed with the ring buffer empty */
+    uint32_t writeErrors;       /* Frames the device interface failed to write */
+    uint32_t lastJitterUs;      /* Lateness of the last frame against its deadline */
+    uint32_t maxJitterUs;       /* Largest lateness of any frame against its deadline */
+    uint64_t totalJitterUs;     /* Sum of the lateness of every frame */
+    uint32_t elapsedUs;         /* Time between the start and the last frame */
+} ad5697r_stream_stats_t;
+
+/*!
+ * @brief ad5697r Stream Instance
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                 /* Device the stream is written to */
+    ad5697r_stream_config_t config;     /* Stream configuration */
+    uint16_t *ring;                     /* User provided sample ring buffer */
+    uint32_t capacity;                  /* Ring buffer capacity in frames, a power of two */
+    uint32_t mask;                      /* Capacity minus one */
+    uint32_t frameCodes;                /* Codes per frame */
+    uint32_t head;                      /* Frames pushed by the producer, published with release */
+    uint32_t tail;                      /* Frames consumed by the pump, published with release */
+    bool running;                       /* Stream has been started */
+    uint32_t startUs;                   /* Time the stream was started */
+    uint32_t paceUs;                    /* Stream time when paced without a clock */
+    uint32_t slot;                      /* Index of the next deadline since the start */
+    ad5697r_stream_stats_t stats;       /* Stream statistics */
+} ad5697r_stream_t;
+
+/*!
+ * @brief This API initializes a stream on top of the provided device and ring
+ * buffer. No memory is allocated, the ring holds capacity frames of one code
+ * (single layout) or two codes (interleaved layout). The stream needs
+ * config.get_time_us or intf.delay_us to keep time.
+ *
+ * @param[out] *stream: Pointer to the stream to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *config: Pointer to the stream configuration
+ * @param[in] *ring: Pointer to the sample ring buffer
+ * @param[in] capacity: Ring buffer capacity in frames, a power of two
+ *
+ * @return The result of initializing the stream, AD5697R_RET_NULL_PTR without either config.get_time_us or intf.delay_us
+ */
+ad5697r_return_code_t ad5697r_streamInit(ad5697r_stream_t *stream, ad5697r_dev_t *dev, const ad5697r_stream_config_t *config, uint16_t *ring, const uint32_t capacity);
+
+/*!
+ * @brief This API queues frames into the ring buffer. Only one producer and the
+ * pump may access a stream concurrently.
+ *
+ * @param[in] *stream: Pointer to your stream
+ * @param[in] *codes: Pointer to the frames to be queued (A/B pairs when interleaved)
+ * @param[in] frames: Number of frames to be queued
+ * @param[out] *queued: Number of frames that fit in the ring buffer
+ *
+ * @return The result of queueing the frames
+ */
+ad5697r_return_code_t ad5697r_streamWrite(ad5697r_stream_t *stream, const uint16_t *codes, const uint32_t frames, uint32_t *queued);
+
+/*!
+ * @brief This API returns the number of frames waiting in the ring buffer
+ *
+ * @param[in] *stream: Pointer to your stream
+ *
+ * @return Number of queued frames, 0 for an invalid stream
+ */
+uint32_t ad5697r_streamGetLevel(const ad5697r_stream_t *stream);
+
+/*!
+ * @brief This API starts the stream, the first frame is due immediately and every
+ * following frame on an absolute deadline of start + n / sampleRate.
+ *
+ * @param[in] *stream: Pointer to your stream
+ *
+ * @return The result of starting the stream
+ */
+ad5697r_return_code_t ad5697r_streamStart(ad5697r_stream_t *stream);
+
+/*!
+ * @brief This API stops the stream, queued frames are kept
+ *
+ * @param[in] *stream: Pointer to your stream
+ *
+ * @return The result of stopping the stream
+ */
+ad5697r_return_code_t ad5697r_streamStop(ad5697r_stream_t *stream);
+
+/*!
+ * @brief This API writes the frames that are due to the device. When intf.delay_us
+ * is provided the pump waits for each deadline, otherwise it returns as soon as
+ * the next frame is not due yet. A deadline that passes with the ring buffer
+ * empty is counted as an underrun and skipped.
+ *
+ * @param[in] *stream: Pointer to your stream
+ * @param[in] maxFrames: Maximum number of deadlines to service
+ *
+ * @return The result of pumping the stream
+ */
+ad5697r_return_code_t ad5697r_streamPump(ad5697r_stream_t *stream, const uint32_t maxFrames);
+
+/*!
+ * @brief This API returns the sample rate achieved since the stream was started
+ *
+ * @param[in] *stream: Pointer to your stream
+ *
+ * @return Achieved rate in frames per second, 0 until two frames were written
+ */
+float ad5697r_streamGetAchievedRate(const ad5697r_stream_t *stream);
+
+#endif // _ad5697r_stream_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,156 @@
+/*! @file ad5697r_volts.h
+ * @brief Public header file for the ad5697r voltage domain conversion.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_volts_H_
+#define _ad5697r_volts_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+#include "ad5697r_sequence.h"
+
+#define AD5697R_INT_REF_VOLTS   (2.5f)  /*! @brief Internal reference voltage */
+
+/*!
+ * @brief ad5697r Channel Calibration. The output measured for a requested
+ * voltage V is gain * V + offset; the conversion inverts it.
+ */
+typedef struct {
+    float gain;         /* Measured gain error, 1.0 for an ideal channel */
+    float offset;       /* Measured offset error in volts */
+    float min;          /* Lowest voltage written, lower samples are clamped */
+    float max;          /* Highest voltage written, higher samples are clamped */
+} ad5697r_volts_cal_t;
+
+/*!
+ * @brief ad5697r Channel Conversion Coefficients, code = clamp(V * scale + bias, lo, hi)
+ */
+typedef struct {
+    float scale;        /* Codes per volt */
+    float bias;         /* Code of 0 V */
+    float lo;           /* Lowest code */
+    float hi;           /* Highest code */
+} ad5697r_volts_coef_t;
+
+/*!
+ * @brief ad5697r Voltage Converter
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                 /* Device the reference state is read from */
+    float extRef;                       /* External reference voltage, 0 when none is fitted */
+    uint8_t gain;                       /* Output amplifier gain set by the GAIN pin, 1 or 2 */
+    uint8_t refMode;                    /* Reference state the coefficients were computed for */
+    ad5697r_volts_cal_t cal[2];         /* Calibration of channel A/B */
+    ad5697r_volts_coef_t coef[2];       /* Coefficients of channel A/B */
+} ad5697r_volts_t;
+
+/*!
+ * @brief This API initializes a converter for a device with an ideal calibration.
+ * The span follows the reference selected with ad5697r_setReferenceMode(): the
+ * internal 2.5 V reference while it is on, the external one once it is off.
+ *
+ * @param[out] *conv: Pointer to the converter to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] gain: Output amplifier gain set by the GAIN pin, 1 or 2
+ * @param[in] extRef: External reference voltage, 0 when none is fitted
+ *
+ * @return The result of initializing the converter
+ */
+ad5697r_return_code_t ad5697r_voltsInit(ad5697r_volts_t *conv, ad5697r_dev_t *dev, const uint8_t gain, const float extRef);
+
+/*!
+ * @brief This API sets the calibration of a channel
+ *
+ * @param[in] *conv: Pointer to the converter
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[in] *cal: Calibration, gain must be positive and min not above max
+ *
+ * @return The result of setting the calibration
+ */
+ad5697r_return_code_t ad5697r_voltsSetCalibration(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const ad5697r_volts_cal_t *cal);
+
+/*!
+ * @brief This API converts voltages to calibrated 12bit codes
+ *
+ * @param[in] *conv: Pointer to the converter
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[in] *volts: Samples in volts
+ * @param[out] *codes: Converted codes
+ * @param[in] samples: Number of samples
+ *
+ * @return The result of the conversion, AD5697R_RET_ERROR with the internal reference off and no external one
+ */
+ad5697r_return_code_t ad5697r_voltsToCodes(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const float *volts, uint16_t *codes, const uint32_t samples);
+
+/*!
+ * @brief This API converts Q16.16 fixed-point voltages to calibrated 12bit codes
+ *
+ * @param[in] *conv: Pointer to the converter
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[in] *volts: Samples in volts, Q16.16
+ * @param[out] *codes: Converted codes
+ * @param[in] samples: Number of samples
+ *
+ * @return The result of the conversion
+ */
+ad5697r_return_code_t ad5697r_voltsQ16ToCodes(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const int32_t *volts, uint16_t *codes, const uint32_t samples);
+
+/*!
+ * @brief This API converts voltages straight to write and update frames, ready
+ * to be sent in one transaction. Size the buffer with AD5697R_BATCH_BUF_SIZE().
+ *
+ * @param[in] *conv: Pointer to the converter
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[in] *volts: Samples in volts
+ * @param[out] *frames: Wire format buffer, AD5697R_FRAME_SIZE bytes per sample
+ * @param[in] samples: Number of samples
+ *
+ * @return The result of the conversion
+ */
+ad5697r_return_code_t ad5697r_voltsToFrames(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const float *volts, uint8_t *frames, const uint32_t samples);
+
+/*!
+ * @brief This API converts Q16.16 fixed-point voltages straight to write and update frames
+ *
+ * @param[in] *conv: Pointer to the converter
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[in] *volts: Samples in volts, Q16.16
+ * @param[out] *frames: Wire format buffer, AD5697R_FRAME_SIZE bytes per sample
+ * @param[in] samples: Number of samples
+ *
+ * @return The result of the conversion
+ */
+ad5697r_return_code_t ad5697r_voltsQ16ToFrames(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const int32_t *volts, uint8_t *frames, const uint32_t samples);
+
+/*!
+ * @brief This API converts voltages and appends them to a sequence as write and update frames
+ *
+ * @param[in] *conv: Pointer to the converter
+ * @param[in] *seq: Pointer to your sequence
+ * @param[in] ch: DAC output channel, AD5697R_OUTPUT_CH_A or AD5697R_OUTPUT_CH_B
+ * @param[in] *volts: Samples in volts
+ * @param[in] samples: Number of samples
+ *
+ * @return The result of adding the frames, AD5697R_RET_ERROR when the sequence is full
+ */
+ad5697r_return_code_t ad5697r_voltsToSequence(ad5697r_volts_t *conv, ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const float *volts, const uint32_t samples);
+
+/*!
+ * @brief This API returns the name of the conversion kernel selected at compile
+ * time: "avx2", "sse2", "neon" or "scalar". Define AD5697R_VOLTS_SCALAR to
+ * force the portable kernel.
+ *
+ * @return Name of the kernel
+ */
+const char *ad5697r_voltsGetKernel(void);
+
+#endif // _ad5697r_volts_H_
+
+#ifdef __cplusplus
+}
+#endif
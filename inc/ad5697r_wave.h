@@ -0,0 +1,185 @@
+/*! @file ad5697r_wave.h
+ * @brief Public header file for the ad5697r waveform files and their playback.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_wave_H_
+#define _ad5697r_wave_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+#include "ad5697r_stream.h"
+
+#define AD5697R_WAVE_HEADER_SIZE    (32)            /*! @brief Bytes ahead of the first sample */
+#define AD5697R_WAVE_VERSION        (1)             /*! @brief Version of the file format */
+#define AD5697R_WAVE_CODE_BITS      (12)            /*! @brief Code width of the AD5697R samples */
+#define AD5697R_WAVE_MAX_CODE       (0x0FFF)        /*! @brief Full scale 12bit code */
+#define AD5697R_WAVE_LOOP_FOREVER   (UINT32_MAX)    /*! @brief Repeats the loop region until stopped */
+
+/*!
+ * @brief Bytes of one sample: a write and update frame (single layout), or
+ * two input register frames and an update frame (interleaved layout)
+ */
+#define AD5697R_WAVE_SAMPLE_SIZE(layout)    (((layout) == AD5697R_STREAM_INTERLEAVED) ? (3 * AD5697R_FRAME_SIZE) : AD5697R_FRAME_SIZE)
+
+/*!
+ * @brief ad5697r Waveform Description, held by the file header
+ */
+typedef struct {
+    ad5697r_stream_layout_t layout;     /* Sample layout */
+    ad5697r_output_channel_t ch;        /* Output channel(s) of the single layout, A and B for the interleaved one */
+    uint8_t codeBits;                   /* Code width, AD5697R_WAVE_CODE_BITS */
+    uint32_t sampleRate;                /* Playback rate in samples per second */
+    uint32_t samples;                   /* Number of samples */
+    uint32_t loopStart;                 /* First sample of the loop region */
+    uint32_t loopEnd;                   /* Sample following the loop region, 0 without a loop */
+} ad5697r_wave_info_t;
+
+/*!
+ * @brief ad5697r Waveform, a view of a waveform file
+ */
+typedef struct {
+    ad5697r_wave_info_t info;           /* Waveform description */
+    uint32_t sampleSize;                /* Bytes per sample */
+    const uint8_t *samples;             /* Encoded samples, pointing into the file */
+} ad5697r_wave_t;
+
+/*!
+ * @brief ad5697r Waveform Player Configuration
+ */
+typedef struct {
+    uint32_t chunkSamples;                      /* Most samples written in one transaction, 0 for one */
+    uint32_t loops;                             /* Passes through the loop region after the first, or AD5697R_WAVE_LOOP_FOREVER */
+    ad5697r_get_time_us_fptr_t get_time_us;     /* Optional clock, paced by intf.delay_us alone when NULL */
+} ad5697r_wave_config_t;
+
+/*!
+ * @brief ad5697r Waveform Player Statistics
+ */
+typedef struct {
+    uint32_t samples;           /* Samples written to the device */
+    uint32_t transactions;      /* Transactions written */
+    uint32_t loops;             /* Jumps back to the start of the loop region */
+    uint32_t writeErrors;       /* Transactions the device interface failed to write */
+    uint32_t maxLatenessUs;     /* Largest lateness of a transaction against the deadline of its first sample */
+} ad5697r_wave_stats_t;
+
+/*!
+ * @brief ad5697r Waveform Player
+ */
+typedef struct {
+    ad5697r_dev_t *dev;                 /* Device the waveform is written to */
+    const ad5697r_wave_t *wave;         /* Waveform being played */
+    ad5697r_wave_config_t config;       /* Player configuration */
+    bool running;                       /* Playback has been started and not finished */
+    uint32_t pos;                       /* Next sample to write */
+    uint32_t loopsLeft;                 /* Passes through the loop region still to go */
+    uint32_t slot;                      /* Deadlines since startUs */
+    uint32_t startUs;                   /* Time of the first deadline, advanced every second */
+    uint32_t paceUs;                    /* Player time when paced without a clock */
+    ad5697r_wave_stats_t stats;         /* Player statistics */
+} ad5697r_wave_player_t;
+
+/*!
+ * @brief This API encodes a waveform file header
+ *
+ * @param[out] *header: Pointer to the AD5697R_WAVE_HEADER_SIZE byte header
+ * @param[in] *info: Waveform description
+ *
+ * @return The result of encoding the header
+ */
+ad5697r_return_code_t ad5697r_waveEncodeHeader(uint8_t *header, const ad5697r_wave_info_t *info);
+
+/*!
+ * @brief This API encodes one sample in its wire format, ready to be appended
+ * to the file after the header
+ *
+ * @param[out] *sample: Pointer to the AD5697R_WAVE_SAMPLE_SIZE(info->layout) byte sample
+ * @param[in] *info: Waveform description
+ * @param[in] *codes: One 12bit code (single layout) or the A/B pair (interleaved layout)
+ *
+ * @return The result of encoding the sample
+ */
+ad5697r_return_code_t ad5697r_waveEncodeSample(uint8_t *sample, const ad5697r_wave_info_t *info, const uint16_t *codes);
+
+/*!
+ * @brief This API opens a waveform file held in memory, e.g. mapped with
+ * ad5697r_waveMap(). The header is decoded and every frame is checked to be
+ * a data frame of the declared channels, so a corrupt file cannot reach the
+ * power, reference or reset registers. The samples are not copied.
+ *
+ * @param[out] *wave: Pointer to the waveform
+ * @param[in] *data: Pointer to the file, which has to outlive the waveform
+ * @param[in] len: Length of the file in bytes
+ *
+ * @return AD5697R_RET_OK, or AD5697R_RET_INV_PARAM for a malformed file
+ */
+ad5697r_return_code_t ad5697r_waveOpen(ad5697r_wave_t *wave, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief This API initializes a player of a waveform on the provided device.
+ * The player needs config.get_time_us or intf.delay_us to keep time: without
+ * a clock, time only advances by waiting, so playback would never progress.
+ *
+ * @param[out] *player: Pointer to the player to be initialized
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *wave: Waveform opened with ad5697r_waveOpen()
+ * @param[in] *config: Player configuration
+ *
+ * @return The result of initializing the player, AD5697R_RET_NULL_PTR without either config.get_time_us or intf.delay_us
+ */
+ad5697r_return_code_t ad5697r_wavePlayerInit(ad5697r_wave_player_t *player, ad5697r_dev_t *dev, const ad5697r_wave_t *wave, const ad5697r_wave_config_t *config);
+
+/*!
+ * @brief This API starts the playback from the first sample. The shadow
+ * registers of the played channels are marked as unknown, as the samples
+ * bypass them.
+ *
+ * @param[in] *player: Pointer to the player
+ *
+ * @return The result of starting the playback
+ */
+ad5697r_return_code_t ad5697r_wavePlayerStart(ad5697r_wave_player_t *player);
+
+/*!
+ * @brief This API stops the playback
+ *
+ * @param[in] *player: Pointer to the player
+ *
+ * @return The result of stopping the playback
+ */
+ad5697r_return_code_t ad5697r_wavePlayerStop(ad5697r_wave_player_t *player);
+
+/*!
+ * @brief This API writes the samples that are due to the device, against
+ * absolute deadlines (start + n / sampleRate), waiting through intf.delay_us
+ * when the next one is not due yet. The frames go to the bus straight from
+ * the file. Samples that fell behind are caught up in one transaction of up
+ * to chunkSamples, which never spans the end of the loop region.
+ *
+ * @param[in] *player: Pointer to the player
+ * @param[in] maxSamples: Most samples to write before returning
+ *
+ * @return AD5697R_RET_OK, AD5697R_RET_ERROR if not running, or the result of the failed transaction
+ */
+ad5697r_return_code_t ad5697r_wavePlayerPump(ad5697r_wave_player_t *player, const uint32_t maxSamples);
+
+/*!
+ * @brief This API returns whether the playback is over: the last sample was
+ * written, the playback was stopped, or it was never started
+ *
+ * @param[in] *player: Pointer to the player
+ *
+ * @return True when done, also for an invalid player
+ */
+bool ad5697r_wavePlayerIsDone(const ad5697r_wave_player_t *player);
+
+#endif // _ad5697r_wave_H_
+
+#ifdef __cplusplus
+}
+#endif
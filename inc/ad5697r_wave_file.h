@@ -0,0 +1,52 @@
+/*! @file ad5697r_wave_file.h
+ * @brief Public header file for the ad5697r waveform files on POSIX hosts.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad5697r_wave_file_H_
+#define _ad5697r_wave_file_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5697r.h"
+#include "ad5697r_wave.h"
+
+/*!
+ * @brief ad5697r Mapped Waveform File
+ */
+typedef struct {
+    const uint8_t *data;    /* Read-only mapping of the file, NULL while unmapped */
+    uint32_t len;           /* Length of the file in bytes */
+    ad5697r_wave_t wave;    /* Waveform opened on the mapping */
+} ad5697r_wave_map_t;
+
+/*!
+ * @brief This API maps a waveform file read-only and opens it with
+ * ad5697r_waveOpen(), ready for ad5697r_wavePlayerInit() with map->wave.
+ * The pages are only read in as the playback reaches them.
+ *
+ * @param[out] *map: Pointer to the mapping
+ * @param[in] *path: Path of the waveform file
+ *
+ * @return AD5697R_RET_OK, AD5697R_RET_ERROR if the file cannot be mapped, or
+ * AD5697R_RET_INV_PARAM for a malformed file
+ */
+ad5697r_return_code_t ad5697r_waveMap(ad5697r_wave_map_t *map, const char *path);
+
+/*!
+ * @brief This API unmaps a waveform file, stop its players first
+ *
+ * @param[in] *map: Pointer to the mapping
+ *
+ * @return The result of unmapping the file
+ */
+ad5697r_return_code_t ad5697r_waveUnmap(ad5697r_wave_map_t *map);
+
+#endif // _ad5697r_wave_file_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,466 @@
+/*! @file ad56x_dev.h
+ * @brief Header-only device core for the nanoDAC+ family.
+ *
+ * AD56X_DEFINE_DEV(prefix, PART) builds a device API for one part on top of
+ * the AD56X_DEFINE_PART(prefix, PART) encoders from ad56x_family.h, e.g. the
+ * 16-bit AD5693R and AD5696R. Every descriptor value is folded in at compile
+ * time, so a device carries no part descriptor and no lookups at run time.
+ * Channels are selected by index, bit i of a channel mask (AD56X_CH(i)) is
+ * channel i of the part, and the device maps them onto the address bits of
+ * the part. The shadow registers follow the same rules as the ad5697r_*
+ * driver, which stays the AD5697R specialization with its batches, retries
+ * and instrumentation.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad56x_dev_H_
+#define _ad56x_dev_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "ad5697r.h"
+#include "ad56x_family.h"
+
+#define AD56X_CH(i)                 ((uint8_t)(1u << (i)))                              /*! @brief Channel mask bit of channel i */
+#define AD56X_CH_MASK(channels)     ((uint8_t)((1u << (channels)) - 1))                 /*! @brief Channel mask of the first channels */
+#define AD56X_CH_ALL(part)          AD56X_CH_MASK(AD56X_##part##_CHANNELS)              /*! @brief Channel mask of every channel of a part */
+
+#define AD56X_SHADOW_INPUT(i)       ((uint8_t)(0x01u << (i)))   /*! @brief Input register of channel i is known */
+#define AD56X_SHADOW_DAC(i)         ((uint8_t)(0x10u << (i)))   /*! @brief DAC register of channel i is known */
+#define AD56X_SHADOW_POWER          (0x01)                      /*! @brief Power-down modes are known */
+#define AD56X_SHADOW_LDAC           (0x02)                      /*! @brief !LDAC mask is known */
+#define AD56X_SHADOW_REF            (0x04)                      /*! @brief Reference setup is known */
+#define AD56X_SHADOW_GAIN           (0x08)                      /*! @brief Gain is known, parts with the gain bit only */
+
+/*!
+ * @brief ad56x Output Gain, on parts with the gain bit (AD5693R)
+ */
+typedef enum {
+    AD56X_GAIN_1X               = 0x00, /* Output span 0 V to VREF */
+    AD56X_GAIN_2X               = 0x01, /* Output span 0 V to 2 x VREF */
+    AD56X_GAIN__MAX__
+} ad56x_gain_t;
+
+/*!
+ * @brief ad56x Shadow Registers, indexed by channel
+ */
+typedef struct {
+    uint16_t input[AD56X_MAX_CHANNELS];     /* Input registers */
+    uint16_t dac[AD56X_MAX_CHANNELS];       /* DAC registers */
+    uint8_t mode[AD56X_MAX_CHANNELS];       /* Operating modes (ad5697r_operation_mode_t) */
+    uint8_t ldacMask;                       /* Channels that ignore the !LDAC pin, channel mask */
+    uint8_t refMode;                        /* Internal reference setup (ad5697r_reference_t) */
+    uint8_t gain;                           /* Output gain (ad56x_gain_t) */
+    uint8_t valid;                          /* Known input/DAC registers (AD56X_SHADOW_INPUT/DAC) */
+    uint8_t ctrlValid;                      /* Known control registers (AD56X_SHADOW_POWER/LDAC/REF/GAIN) */
+} ad56x_shadow_t;
+
+/*!
+ * @brief ad56x Device Instance, shared by every part
+ */
+typedef struct {
+    ad5697r_dev_intf_t intf;                /* Device hardware interface */
+    ad56x_shadow_t shadow;                  /* Shadow registers */
+    bool elide;                             /* Skip writes that would not change the device state */
+} ad56x_dev_t;
+
+/*!
+ * @brief Checks the device and interface of a call writing to the device
+ *
+ * @param[in] *dev: Pointer to the device
+ *
+ * @return The result of the check
+ */
+static inline ad5697r_return_code_t ad56x_devCheck(const ad56x_dev_t *dev) {
+    if( (dev == NULL) || (dev->intf.write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( dev->intf.i2c_addr > 0x7F ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Checks a channel mask holds at least one channel of the part and no other
+ *
+ * @param[in] channels: Number of channels of the part
+ * @param[in] chMask: Channel mask, AD56X_CH() bits
+ *
+ * @return True for a valid channel mask
+ */
+static inline bool ad56x_devValidMask(const uint8_t channels, const uint8_t chMask) {
+    return (chMask != 0) && !(chMask & ~AD56X_CH_MASK(channels));
+}
+
+/*!
+ * @brief Writes a single frame transaction to the device
+ *
+ * @param[in] *dev: Pointer to the device
+ * @param[in] *frame: Pointer to the AD56X_FRAME_SIZE byte frame
+ *
+ * @return The result of the write
+ */
+static inline ad5697r_return_code_t ad56x_devWriteFrame(ad56x_dev_t *dev, const uint8_t *frame) {
+    return dev->intf.write(dev->intf.i2c_addr, frame, AD56X_FRAME_SIZE);
+}
+
+/*!
+ * @brief Checks whether a DAC data frame would leave every channel of the mask unchanged
+ *
+ * @param[in] *dev: Pointer to the device
+ * @param[in] channels: Number of channels of the part
+ * @param[in] cmd: AD56X_CMD_W_INPUT, AD56X_CMD_UPDATE or AD56X_CMD_WRITE_DAC
+ * @param[in] chMask: Channel mask of the frame
+ * @param[in] code: Code of the frame
+ *
+ * @return True when the frame can be left off the wire
+ */
+static inline bool ad56x_devDacMatches(const ad56x_dev_t *dev, const uint8_t channels, const uint8_t cmd,
+                                       const uint8_t chMask, const uint16_t code) {
+    uint8_t i = 0;
+
+    for( i = 0; i < channels; i++ ) {
+        if( (chMask & AD56X_CH(i)) &&
+            !ad56x_shadowChannelMatches(dev->shadow.input[i], dev->shadow.dac[i], dev->shadow.valid,
+                                        AD56X_SHADOW_INPUT(i), AD56X_SHADOW_DAC(i), cmd, code) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief Writes a packed DAC data frame and applies it to the shadow of every channel of the mask
+ *
+ * @param[in] *dev: Pointer to the device
+ * @param[in] channels: Number of channels of the part
+ * @param[in] *frame: Pointer to the packed frame
+ * @param[in] cmd: Command of the frame
+ * @param[in] chMask: Channel mask of the frame
+ * @param[in] code: Code of the frame
+ *
+ * @return The result of the write
+ */
+static inline ad5697r_return_code_t ad56x_devCommitDac(ad56x_dev_t *dev, const uint8_t channels, const uint8_t *frame,
+                                                       const uint8_t cmd, const uint8_t chMask, const uint16_t code) {
+    ad5697r_return_code_t ret = ad56x_devWriteFrame(dev, frame);
+    uint8_t i = 0;
+
+    if( ret != AD5697R_RET_OK ) {
+        // A failed transaction leaves the device in an unknown state
+        dev->shadow.valid &= (uint8_t)~((chMask & 0x0F) | ((chMask & 0x0F) << 4));
+        return ret;
+    }
+
+    for( i = 0; i < channels; i++ ) {
+        if( chMask & AD56X_CH(i) ) {
+            ad56x_shadowApplyChannel(&dev->shadow.input[i], &dev->shadow.dac[i], &dev->shadow.valid,
+                                     AD56X_SHADOW_INPUT(i), AD56X_SHADOW_DAC(i), cmd, code);
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Checks whether a control frame would leave the shadowed registers it writes unchanged
+ *
+ * @param[in] *dev: Pointer to the device
+ * @param[in] channels: Number of channels of the part
+ * @param[in] flags: Control registers the frame writes (AD56X_SHADOW_POWER/REF/GAIN)
+ * @param[in] *modes: Operating modes of the frame, one per channel
+ * @param[in] refMode: Reference setup of the frame
+ * @param[in] gain: Gain of the frame
+ *
+ * @return True when the frame can be left off the wire
+ */
+static inline bool ad56x_devControlMatches(const ad56x_dev_t *dev, const uint8_t channels, const uint8_t flags,
+                                           const uint8_t *modes, const uint8_t refMode, const uint8_t gain) {
+    uint8_t i = 0;
+
+    if( (dev->shadow.ctrlValid & flags) != flags ) {
+        return false;
+    }
+    for( i = 0; (flags & AD56X_SHADOW_POWER) && (i < channels); i++ ) {
+        if( dev->shadow.mode[i] != modes[i] ) {
+            return false;
+        }
+    }
+
+    return (!(flags & AD56X_SHADOW_REF) || (dev->shadow.refMode == refMode)) &&
+           (!(flags & AD56X_SHADOW_GAIN) || (dev->shadow.gain == gain));
+}
+
+/*!
+ * @brief Writes a packed control frame and adopts the registers it wrote in the shadow
+ *
+ * @param[in] *dev: Pointer to the device
+ * @param[in] flags: Control registers the frame writes (AD56X_SHADOW_POWER/REF/GAIN)
+ * @param[in] *frame: Pointer to the packed frame
+ * @param[in] *modes: Operating modes of the frame, AD56X_MAX_CHANNELS entries
+ * @param[in] refMode: Reference setup of the frame
+ * @param[in] gain: Gain of the frame
+ *
+ * @return The result of the write
+ */
+static inline ad5697r_return_code_t ad56x_devCommitControl(ad56x_dev_t *dev, const uint8_t flags, const uint8_t *frame,
+                                                           const uint8_t *modes, const uint8_t refMode, const uint8_t gain) {
+    ad5697r_return_code_t ret = ad56x_devWriteFrame(dev, frame);
+
+    if( ret != AD5697R_RET_OK ) {
+        dev->shadow.ctrlValid &= (uint8_t)~flags;
+        return ret;
+    }
+
+    if( flags & AD56X_SHADOW_POWER ) {
+        memcpy(dev->shadow.mode, modes, sizeof(dev->shadow.mode));
+    }
+    if( flags & AD56X_SHADOW_REF ) {
+        dev->shadow.refMode = refMode;
+    }
+    if( flags & AD56X_SHADOW_GAIN ) {
+        dev->shadow.gain = gain;
+    }
+    dev->shadow.ctrlValid |= flags;
+
+    return ret;
+}
+
+/*!
+ * @brief This API enables/disables write elision. Writes that would leave
+ * the shadowed device state unchanged are then not sent.
+ *
+ * @param[in] *dev: Pointer to the device
+ * @param[in] enable: True to skip writes that would not change the device
+ *
+ * @return The result of setting write elision
+ */
+static inline ad5697r_return_code_t ad56x_setWriteElision(ad56x_dev_t *dev, const bool enable) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    dev->elide = enable;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Defines the device API of a part on top of its AD56X_DEFINE_PART()
+ * encoders, which have to be defined first with the same prefix. All static
+ * inline; every call checks its arguments and returns ad5697r_return_code_t:
+ *
+ *   prefix_devInit(dev, intf)                      Nothing is written, every shadow register starts out unknown
+ *   prefix_writeChannel(dev, chMask, code)         Write to and update the DAC channel(s), in one frame
+ *   prefix_writeInputRegister(dev, chMask, code)   Write the input register(s), outputs follow on an update or !LDAC
+ *   prefix_updateChannel(dev, chMask)              Update the DAC output(s) from their input registers
+ *   prefix_setOperatingMode(dev, chMask, mode)     Operating mode of the channel(s), the others keep their shadowed mode
+ *   prefix_setReferenceMode(dev, refSelect)        Internal reference on/off
+ *   prefix_setGain(dev, gain)                      Output gain, AD5697R_RET_INV_PARAM on parts with a GAIN pin
+ *   prefix_setLdacMask(dev, chMask)                Channels that ignore !LDAC, AD5697R_RET_INV_PARAM without the register
+ *   prefix_softReset(dev)                          Power-on reset, the input and DAC registers become unknown
+ *   prefix_readInputRegister(dev, ch, code)        Read back the input register of channel index ch, read is required
+ *
+ * A control frame carries every register the part maps onto its command from
+ * the shadow, so on the AD5693R, where power-down, reference and gain share
+ * the control register, setting one of them rewrites the shadowed others.
+ */
+#define AD56X_DEFINE_DEV(prefix, part)                                                                              \
+    static inline uint8_t prefix##_addrOf(const uint8_t chMask) {                                                   \
+        uint8_t addr = 0;                                                                                           \
+        uint8_t i = 0;                                                                                              \
+        for( i = 0; i < AD56X_##part##_CHANNELS; i++ ) {                                                            \
+            if( chMask & AD56X_CH(i) ) {                                                                            \
+                addr |= prefix##_addr(i);                                                                           \
+            }                                                                                                       \
+        }                                                                                                           \
+        return addr;                                                                                                \
+    }                                                                                                               \
+    static inline uint8_t prefix##_controlFlags(const uint8_t cmd) {                                                \
+        uint8_t flags = 0;                                                                                          \
+        if( cmd == AD56X_CMD_POWER ) {                                                                              \
+            flags |= AD56X_SHADOW_POWER;                                                                            \
+        }                                                                                                           \
+        if( cmd == AD56X_##part##_REF_CMD ) {                                                                       \
+            flags |= AD56X_SHADOW_REF;                                                                              \
+        }                                                                                                           \
+        if( AD56X_##part##_GAIN && (cmd == AD56X_##part##_GAIN_CMD) ) {                                             \
+            flags |= AD56X_SHADOW_GAIN;                                                                             \
+        }                                                                                                           \
+        return flags;                                                                                               \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_writeControl(ad56x_dev_t *dev, const uint8_t cmd,                  \
+                                                              const uint8_t *modes, const uint8_t refMode,          \
+                                                              const uint8_t gain) {                                 \
+        const uint8_t flags = prefix##_controlFlags(cmd);                                                           \
+        uint8_t frame[AD56X_FRAME_SIZE];                                                                            \
+        if( dev->elide && ad56x_devControlMatches(dev, AD56X_##part##_CHANNELS, flags, modes, refMode, gain) ) {    \
+            return AD5697R_RET_OK;                                                                                  \
+        }                                                                                                           \
+        prefix##_encControl(frame, cmd, modes, refMode, gain);                                                      \
+        return ad56x_devCommitControl(dev, flags, frame, modes, refMode, gain);                                     \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_writeDac(ad56x_dev_t *dev, const uint8_t cmd,                      \
+                                                          const uint8_t chMask, const uint16_t code) {              \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        uint8_t frame[AD56X_FRAME_SIZE];                                                                            \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        else if( !ad56x_devValidMask(AD56X_##part##_CHANNELS, chMask) || (code & ~AD56X_MAX_CODE(part)) ) {         \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        if( dev->elide && ad56x_devDacMatches(dev, AD56X_##part##_CHANNELS, cmd, chMask, code) ) {                  \
+            return AD5697R_RET_OK;                                                                                  \
+        }                                                                                                           \
+        prefix##_encDac(frame, cmd, prefix##_addrOf(chMask), code);                                                 \
+        return ad56x_devCommitDac(dev, AD56X_##part##_CHANNELS, frame, cmd, chMask, code);                          \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_devInit(ad56x_dev_t *dev, const ad5697r_dev_intf_t *intf) {        \
+        if( (dev == NULL) || (intf == NULL) || (intf->write == NULL) ) {                                            \
+            return AD5697R_RET_NULL_PTR;                                                                            \
+        }                                                                                                           \
+        else if( intf->i2c_addr > 0x7F ) {                                                                          \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        memset(dev, 0, sizeof(*dev));                                                                               \
+        dev->intf = *intf;                                                                                          \
+        return AD5697R_RET_OK;                                                                                      \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_writeChannel(ad56x_dev_t *dev, const uint8_t chMask,               \
+                                                              const uint16_t code) {                                \
+        return prefix##_writeDac(dev, AD56X_CMD_WRITE_DAC, chMask, code);                                           \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_writeInputRegister(ad56x_dev_t *dev, const uint8_t chMask,         \
+                                                                    const uint16_t code) {                          \
+        return prefix##_writeDac(dev, AD56X_CMD_W_INPUT, chMask, code);                                             \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_updateChannel(ad56x_dev_t *dev, const uint8_t chMask) {            \
+        return prefix##_writeDac(dev, AD56X_CMD_UPDATE, chMask, 0x0000);                                            \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_setOperatingMode(ad56x_dev_t *dev, const uint8_t chMask,           \
+                                                                  const ad5697r_operation_mode_t mode) {            \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        uint8_t modes[AD56X_MAX_CHANNELS];                                                                          \
+        uint8_t i = 0;                                                                                              \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        else if( !ad56x_devValidMask(AD56X_##part##_CHANNELS, chMask) || (mode >= AD5697R_OP_MODE__MAX__) ) {       \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        memcpy(modes, dev->shadow.mode, sizeof(modes));                                                             \
+        for( i = 0; i < AD56X_##part##_CHANNELS; i++ ) {                                                            \
+            if( chMask & AD56X_CH(i) ) {                                                                            \
+                modes[i] = (uint8_t)mode;                                                                           \
+            }                                                                                                       \
+        }                                                                                                           \
+        return prefix##_writeControl(dev, AD56X_CMD_POWER, modes, dev->shadow.refMode, dev->shadow.gain);           \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_setReferenceMode(ad56x_dev_t *dev,                                 \
+                                                                  const ad5697r_reference_t refSelect) {            \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        else if( refSelect >= AD5697R_REF__MAX__ ) {                                                                \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        return prefix##_writeControl(dev, AD56X_##part##_REF_CMD, dev->shadow.mode, (uint8_t)refSelect,             \
+                                     dev->shadow.gain);                                                             \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_setGain(ad56x_dev_t *dev, const ad56x_gain_t gain) {               \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        else if( !AD56X_##part##_GAIN || (gain >= AD56X_GAIN__MAX__) ) {                                            \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        return prefix##_writeControl(dev, AD56X_##part##_GAIN_CMD, dev->shadow.mode, dev->shadow.refMode,           \
+                                     (uint8_t)gain);                                                                \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_setLdacMask(ad56x_dev_t *dev, const uint8_t chMask) {              \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        uint8_t frame[AD56X_FRAME_SIZE];                                                                            \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        else if( !AD56X_##part##_LDAC_MASK || (chMask & ~AD56X_CH_ALL(part)) ) {                                    \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        if( dev->elide && (dev->shadow.ctrlValid & AD56X_SHADOW_LDAC) && (dev->shadow.ldacMask == chMask) ) {       \
+            return AD5697R_RET_OK;                                                                                  \
+        }                                                                                                           \
+        prefix##_encLdacMask(frame, prefix##_addrOf(chMask));                                                       \
+        ret = ad56x_devWriteFrame(dev, frame);                                                                      \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            dev->shadow.ctrlValid &= ~AD56X_SHADOW_LDAC;                                                            \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        dev->shadow.ldacMask = chMask;                                                                              \
+        dev->shadow.ctrlValid |= AD56X_SHADOW_LDAC;                                                                 \
+        return ret;                                                                                                 \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_softReset(ad56x_dev_t *dev) {                                      \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        uint8_t frame[AD56X_FRAME_SIZE];                                                                            \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        prefix##_encSoftReset(frame);                                                                               \
+        ret = ad56x_devWriteFrame(dev, frame);                                                                      \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            dev->shadow.valid = 0;                                                                                  \
+            dev->shadow.ctrlValid = 0;                                                                              \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        memset(dev->shadow.mode, AD5697R_OP_MODE_NORMAL, sizeof(dev->shadow.mode));                                 \
+        dev->shadow.ldacMask = 0;                                                                                   \
+        dev->shadow.refMode = AD5697R_REF_ON;                                                                       \
+        dev->shadow.gain = AD56X_GAIN_1X;                                                                           \
+        dev->shadow.valid = 0;                                                                                      \
+        dev->shadow.ctrlValid = AD56X_SHADOW_POWER | AD56X_SHADOW_LDAC | AD56X_SHADOW_REF |                         \
+                                (AD56X_##part##_GAIN ? AD56X_SHADOW_GAIN : 0);                                      \
+        return ret;                                                                                                 \
+    }                                                                                                               \
+    static inline ad5697r_return_code_t prefix##_readInputRegister(ad56x_dev_t *dev, const uint8_t ch,              \
+                                                                   uint16_t *code) {                                \
+        ad5697r_return_code_t ret = ad56x_devCheck(dev);                                                            \
+        uint8_t frame[AD56X_FRAME_SIZE];                                                                            \
+        uint8_t data[2];                                                                                            \
+        if( ret != AD5697R_RET_OK ) {                                                                               \
+            return ret;                                                                                             \
+        }                                                                                                           \
+        else if( (dev->intf.read == NULL) || (code == NULL) ) {                                                     \
+            return AD5697R_RET_NULL_PTR;                                                                            \
+        }                                                                                                           \
+        else if( ch >= AD56X_##part##_CHANNELS ) {                                                                  \
+            return AD5697R_RET_INV_PARAM;                                                                           \
+        }                                                                                                           \
+        if( AD56X_##part##_READ_SELECT ) {                                                                          \
+            prefix##_encDac(frame, AD56X_CMD_NO_OP, prefix##_addr(ch), 0x0000);                                     \
+            ret = ad56x_devWriteFrame(dev, frame);                                                                  \
+        }                                                                                                           \
+        if( ret == AD5697R_RET_OK ) {                                                                               \
+            ret = dev->intf.read(dev->intf.i2c_addr, data, sizeof(data));                                           \
+        }                                                                                                           \
+        if( ret == AD5697R_RET_OK ) {                                                                               \
+            *code = prefix##_decCode(data);                                                                         \
+        }                                                                                                           \
+        return ret;                                                                                                 \
+    }
+
+#endif // _ad56x_dev_H_
+
+#ifdef __cplusplus
+}
+#endif
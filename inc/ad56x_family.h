@@ -0,0 +1,283 @@
+/*! @file ad56x_family.h
+ * @brief Header-only family core for the nanoDAC+ I2C parts: AD5693R, AD5696R and AD5697R.
+ *
+ * The parts share the 24-bit frame, command in DB23:DB20, channel address in
+ * DB19:DB16 and a left aligned code in DB15:DB0, but differ in resolution,
+ * channel count, address map and power-down layout. Each part is described
+ * by a set of AD56X_<PART>_* macros. AD56X_DEFINE_PART() turns a descriptor
+ * into static inline encoders with every part constant folded in, so the
+ * specialized encoders carry no descriptor lookups at run time. The
+ * ad5697r_* API is the AD5697R specialization of this core.
+ *
+ * A descriptor defines:
+ *   AD56X_<PART>_NAME          Part name
+ *   AD56X_<PART>_BITS          Code resolution in bits
+ *   AD56X_<PART>_CHANNELS      Number of channels
+ *   AD56X_<PART>_ADDR(i)       Address bits of channel i
+ *   AD56X_<PART>_PD_BYTE       Frame byte holding the power-down modes
+ *   AD56X_<PART>_PD_SHIFT(i)   Bit position of the power-down mode of channel i
+ *   AD56X_<PART>_PD_FILL       Bits set in the power-down byte regardless of the modes
+ *   AD56X_<PART>_REF_CMD       Command writing the reference bit
+ *   AD56X_<PART>_REF_BYTE      Frame byte holding the reference bit
+ *   AD56X_<PART>_REF_SHIFT     Bit position of the reference bit, 1 = off
+ *   AD56X_<PART>_GAIN          Non zero when the output gain is a register bit rather than the GAIN pin
+ *   AD56X_<PART>_GAIN_CMD      Command writing the gain bit
+ *   AD56X_<PART>_GAIN_BYTE     Frame byte holding the gain bit
+ *   AD56X_<PART>_GAIN_SHIFT    Bit position of the gain bit, 1 = 2x
+ *   AD56X_<PART>_LDAC_MASK     Non zero when the part has a !LDAC mask register
+ *   AD56X_<PART>_RESET_CMD     Command of the software reset
+ *   AD56X_<PART>_RESET_BYTE    Frame byte holding the reset bits
+ *   AD56X_<PART>_RESET_BITS    Reset bits, 0 when the command alone resets
+ *   AD56X_<PART>_READ_SELECT   Non zero when a no-operation frame selects the channel read back
+ *
+ * The shadow register rules below are shared by every device of the family:
+ * ad5697r_* and the devices of AD56X_DEFINE_DEV() in ad56x_dev.h track the
+ * input and DAC registers the same way.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ad56x_family_H_
+#define _ad56x_family_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AD56X_FRAME_SIZE        (3)     /*! @brief Bytes per device command frame */
+#define AD56X_MAX_CHANNELS      (4)     /*! @brief Channels of the widest part */
+
+#define AD56X_CMD_NO_OP         (0x00)  /*! @brief No operation, selects the channel read back */
+#define AD56X_CMD_W_INPUT       (0x01)  /*! @brief Write to input register n, dependent on !LDAC */
+#define AD56X_CMD_UPDATE        (0x02)  /*! @brief Update DAC register n from input register n */
+#define AD56X_CMD_WRITE_DAC     (0x03)  /*! @brief Write to and update DAC channel n */
+#define AD56X_CMD_POWER         (0x04)  /*! @brief Power down/power up, the control register on the AD5693R */
+#define AD56X_CMD_LDAC_MASK     (0x05)  /*! @brief Hardware !LDAC mask register */
+#define AD56X_CMD_SOFT_RESET    (0x06)  /*! @brief Software reset */
+#define AD56X_CMD_REF_SETUP     (0x07)  /*! @brief Internal reference setup register */
+
+/*! @brief AD5693R, 16-bit single channel, reset, power-down, reference and gain in the control register DB15:DB11 */
+#define AD56X_AD5693R_NAME          "AD5693R"
+#define AD56X_AD5693R_BITS          (16)
+#define AD56X_AD5693R_CHANNELS      (1)
+#define AD56X_AD5693R_ADDR(i)       (0x00 * (i))
+#define AD56X_AD5693R_PD_BYTE       (1)
+#define AD56X_AD5693R_PD_SHIFT(i)   (5 + 0 * (i))
+#define AD56X_AD5693R_PD_FILL       (0x00)
+#define AD56X_AD5693R_REF_CMD       AD56X_CMD_POWER
+#define AD56X_AD5693R_REF_BYTE      (1)
+#define AD56X_AD5693R_REF_SHIFT     (4)
+#define AD56X_AD5693R_GAIN          (1)
+#define AD56X_AD5693R_GAIN_CMD      AD56X_CMD_POWER
+#define AD56X_AD5693R_GAIN_BYTE     (1)
+#define AD56X_AD5693R_GAIN_SHIFT    (3)
+#define AD56X_AD5693R_LDAC_MASK     (0)
+#define AD56X_AD5693R_RESET_CMD     AD56X_CMD_POWER
+#define AD56X_AD5693R_RESET_BYTE    (1)
+#define AD56X_AD5693R_RESET_BITS    (0x80)
+#define AD56X_AD5693R_READ_SELECT   (0)
+
+/*! @brief AD5696R, 16-bit quad channel */
+#define AD56X_AD5696R_NAME          "AD5696R"
+#define AD56X_AD5696R_BITS          (16)
+#define AD56X_AD5696R_CHANNELS      (4)
+#define AD56X_AD5696R_ADDR(i)       (0x01 << (i))
+#define AD56X_AD5696R_PD_BYTE       (2)
+#define AD56X_AD5696R_PD_SHIFT(i)   (2 * (i))
+#define AD56X_AD5696R_PD_FILL       (0x00)
+#define AD56X_AD5696R_REF_CMD       AD56X_CMD_REF_SETUP
+#define AD56X_AD5696R_REF_BYTE      (2)
+#define AD56X_AD5696R_REF_SHIFT     (0)
+#define AD56X_AD5696R_GAIN          (0)
+#define AD56X_AD5696R_GAIN_CMD      AD56X_CMD_NO_OP
+#define AD56X_AD5696R_GAIN_BYTE     (0)
+#define AD56X_AD5696R_GAIN_SHIFT    (0)
+#define AD56X_AD5696R_LDAC_MASK     (1)
+#define AD56X_AD5696R_RESET_CMD     AD56X_CMD_SOFT_RESET
+#define AD56X_AD5696R_RESET_BYTE    (0)
+#define AD56X_AD5696R_RESET_BITS    (0x00)
+#define AD56X_AD5696R_READ_SELECT   (1)
+
+/*! @brief AD5697R, 12-bit dual channel on the outer channel slots, DB5:DB2 of the power-down byte set to 1 */
+#define AD56X_AD5697R_NAME          "AD5697R"
+#define AD56X_AD5697R_BITS          (12)
+#define AD56X_AD5697R_CHANNELS      (2)
+#define AD56X_AD5697R_ADDR(i)       (((i) == 0) ? 0x01 : 0x08)
+#define AD56X_AD5697R_PD_BYTE       (2)
+#define AD56X_AD5697R_PD_SHIFT(i)   (((i) == 0) ? 0 : 6)
+#define AD56X_AD5697R_PD_FILL       (0x3C)
+#define AD56X_AD5697R_REF_CMD       AD56X_CMD_REF_SETUP
+#define AD56X_AD5697R_REF_BYTE      (2)
+#define AD56X_AD5697R_REF_SHIFT     (0)
+#define AD56X_AD5697R_GAIN          (0)
+#define AD56X_AD5697R_GAIN_CMD      AD56X_CMD_NO_OP
+#define AD56X_AD5697R_GAIN_BYTE     (0)
+#define AD56X_AD5697R_GAIN_SHIFT    (0)
+#define AD56X_AD5697R_LDAC_MASK     (1)
+#define AD56X_AD5697R_RESET_CMD     AD56X_CMD_SOFT_RESET
+#define AD56X_AD5697R_RESET_BYTE    (0)
+#define AD56X_AD5697R_RESET_BITS    (0x00)
+#define AD56X_AD5697R_READ_SELECT   (1)
+
+/*! @brief Full scale code of a part */
+#define AD56X_MAX_CODE(part)        ((uint16_t)((1UL << AD56X_##part##_BITS) - 1))
+
+/*!
+ * @brief Defines the encoders of a part, all static inline and without checks:
+ *
+ *   uint8_t  prefix_addr(uint8_t i)                        Address bits of channel i
+ *   uint8_t  prefix_addrAll(void)                          Address bits of every channel
+ *   void     prefix_encDac(frame, cmd, addr, code)         Data frame, code dropped to the part resolution
+ *   uint16_t prefix_decCode(const uint8_t *data)           Code of the two data bytes of a frame or a readback
+ *   void     prefix_encControl(frame, cmd, modes, refOff, gain)
+ *                                                          Control frame of cmd with every field the part maps onto it
+ *   void     prefix_encPower(frame, const uint8_t *modes)  Power-down frame, one mode per channel
+ *   void     prefix_encReference(frame, refOff)            Reference frame
+ *   void     prefix_encLdacMask(frame, mask)               !LDAC mask frame of address bits, parts with the register only
+ *   void     prefix_encSoftReset(frame)                    Software reset frame
+ *
+ * On the AD5693R the reset, power-down modes, reference and gain share the
+ * control register. prefix_encControl() fills in all of them, while a
+ * prefix_encPower() frame turns the reference on at gain 1x and a
+ * prefix_encReference() frame powers the channel up at gain 1x.
+ */
+#define AD56X_DEFINE_PART(prefix, part)                                                                 \
+    static inline uint8_t prefix##_addr(const uint8_t i) {                                              \
+        return (uint8_t)AD56X_##part##_ADDR(i);                                                         \
+    }                                                                                                   \
+    static inline uint8_t prefix##_addrAll(void) {                                                      \
+        uint8_t all = 0;                                                                                \
+        uint8_t i = 0;                                                                                  \
+        for( i = 0; i < AD56X_##part##_CHANNELS; i++ ) {                                                \
+            all |= (uint8_t)AD56X_##part##_ADDR(i);                                                     \
+        }                                                                                               \
+        return all;                                                                                     \
+    }                                                                                                   \
+    static inline void prefix##_encDac(uint8_t *frame, const uint8_t cmd, const uint8_t addr,           \
+                                       const uint16_t code) {                                           \
+        const uint16_t word = (uint16_t)(code << (16 - AD56X_##part##_BITS));                           \
+        frame[0] = (uint8_t)((uint8_t)(cmd << 4) | (addr & 0x0F));                                      \
+        frame[1] = (uint8_t)(word >> 8);                                                                \
+        frame[2] = (uint8_t)word;                                                                       \
+    }                                                                                                   \
+    static inline uint16_t prefix##_decCode(const uint8_t *data) {                                      \
+        return (uint16_t)((((uint16_t)data[0] << 8) | data[1]) >> (16 - AD56X_##part##_BITS));          \
+    }                                                                                                   \
+    static inline void prefix##_encControl(uint8_t *frame, const uint8_t cmd, const uint8_t *modes,     \
+                                           const uint8_t refOff, const uint8_t gain) {                  \
+        uint8_t pd = AD56X_##part##_PD_FILL;                                                            \
+        uint8_t i = 0;                                                                                  \
+        frame[0] = (uint8_t)(cmd << 4);                                                                 \
+        frame[1] = 0x00;                                                                                \
+        frame[2] = 0x00;                                                                                \
+        if( cmd == AD56X_CMD_POWER ) {                                                                  \
+            for( i = 0; i < AD56X_##part##_CHANNELS; i++ ) {                                            \
+                pd |= (uint8_t)((modes[i] & 0x03) << AD56X_##part##_PD_SHIFT(i));                       \
+            }                                                                                           \
+            frame[AD56X_##part##_PD_BYTE] |= pd;                                                        \
+        }                                                                                               \
+        if( cmd == AD56X_##part##_REF_CMD ) {                                                           \
+            frame[AD56X_##part##_REF_BYTE] |= (uint8_t)((refOff & 0x01) << AD56X_##part##_REF_SHIFT);   \
+        }                                                                                               \
+        if( AD56X_##part##_GAIN && (cmd == AD56X_##part##_GAIN_CMD) ) {                                 \
+            frame[AD56X_##part##_GAIN_BYTE] |= (uint8_t)((gain & 0x01) << AD56X_##part##_GAIN_SHIFT);   \
+        }                                                                                               \
+    }                                                                                                   \
+    static inline void prefix##_encPower(uint8_t *frame, const uint8_t *modes) {                        \
+        prefix##_encControl(frame, AD56X_CMD_POWER, modes, 0, 0);                                       \
+    }                                                                                                   \
+    static inline void prefix##_encReference(uint8_t *frame, const uint8_t refOff) {                    \
+        const uint8_t modes[AD56X_MAX_CHANNELS] = {0};                                                  \
+        prefix##_encControl(frame, AD56X_##part##_REF_CMD, modes, refOff, 0);                           \
+    }                                                                                                   \
+    static inline void prefix##_encLdacMask(uint8_t *frame, const uint8_t mask) {                       \
+        frame[0] = (uint8_t)(AD56X_CMD_LDAC_MASK << 4);                                                 \
+        frame[1] = 0x00;                                                                                \
+        frame[2] = (uint8_t)(mask & prefix##_addrAll());                                                \
+    }                                                                                                   \
+    static inline void prefix##_encSoftReset(uint8_t *frame) {                                          \
+        frame[0] = (uint8_t)(AD56X_##part##_RESET_CMD << 4);                                            \
+        frame[1] = 0x00;                                                                                \
+        frame[2] = 0x00;                                                                                \
+        frame[AD56X_##part##_RESET_BYTE] |= (uint8_t)AD56X_##part##_RESET_BITS;                         \
+    }
+
+/*!
+ * @brief Applies a DAC data frame to the shadow of a single channel
+ *
+ * @param[in,out] *input: Shadowed input register
+ * @param[in,out] *dac: Shadowed DAC register
+ * @param[in,out] *valid: Valid flags the two flags below live in
+ * @param[in] inputFlag: Flag of a known input register
+ * @param[in] dacFlag: Flag of a known DAC register
+ * @param[in] cmd: AD56X_CMD_W_INPUT, AD56X_CMD_UPDATE or AD56X_CMD_WRITE_DAC
+ * @param[in] code: Code of the frame
+ */
+static inline void ad56x_shadowApplyChannel(uint16_t *input, uint16_t *dac, uint8_t *valid, const uint8_t inputFlag,
+                                            const uint8_t dacFlag, const uint8_t cmd, const uint16_t code) {
+    switch( cmd ) {
+        case AD56X_CMD_WRITE_DAC:
+            *input = code;
+            *dac = code;
+            *valid |= inputFlag | dacFlag;
+            break;
+
+        case AD56X_CMD_W_INPUT:
+            // The input register is transparent while !LDAC is low, so the
+            // DAC register can no longer be trusted.
+            *input = code;
+            *valid |= inputFlag;
+            *valid &= ~dacFlag;
+            break;
+
+        case AD56X_CMD_UPDATE:
+            if( *valid & inputFlag ) {
+                *dac = *input;
+                *valid |= dacFlag;
+            }
+            else {
+                *valid &= ~dacFlag;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief Checks whether a DAC data frame would leave a single channel unchanged
+ *
+ * @param[in] input: Shadowed input register
+ * @param[in] dac: Shadowed DAC register
+ * @param[in] valid: Valid flags the two flags below live in
+ * @param[in] inputFlag: Flag of a known input register
+ * @param[in] dacFlag: Flag of a known DAC register
+ * @param[in] cmd: AD56X_CMD_W_INPUT, AD56X_CMD_UPDATE or AD56X_CMD_WRITE_DAC
+ * @param[in] code: Code of the frame
+ *
+ * @return True when the frame can be left off the wire
+ */
+static inline bool ad56x_shadowChannelMatches(const uint16_t input, const uint16_t dac, const uint8_t valid, const uint8_t inputFlag,
+                                              const uint8_t dacFlag, const uint8_t cmd, const uint16_t code) {
+    switch( cmd ) {
+        case AD56X_CMD_WRITE_DAC:
+            return ((valid & (inputFlag | dacFlag)) == (inputFlag | dacFlag)) && (input == code) && (dac == code);
+
+        case AD56X_CMD_W_INPUT:
+            return (valid & inputFlag) && (input == code);
+
+        case AD56X_CMD_UPDATE:
+            return ((valid & (inputFlag | dacFlag)) == (inputFlag | dacFlag)) && (dac == input);
+
+        default:
+            return false;
+    }
+}
+
+#endif // _ad56x_family_H_
+
+#ifdef __cplusplus
+}
+#endif
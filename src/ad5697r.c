@@ -3,99 +3,313 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "ad5697r.h"
+#include "ad5697r_priv.h"
 
 /*!
- * @brief AD5697R Command Definitions
- */
-typedef enum {
-    AD5697R_CMD_NO_OP                         = 0x00, /* No operation */
-    AD5697R_CMD_W_INPUT_REG_N                 = 0x01, /* Write to Input Register n (Dependent on !LDAC) */
-    AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N   = 0x02, /* Update DAC Register n with contents from Input Register n */
-    AD5697R_CMD_WRITE_DAC                     = 0x03, /* Write to and update DAC Channel n */
-    AD5697R_CMD_POWER_DAC                     = 0x04, /* Power down/power up DAC */
-    AD5697R_CMD_HW_LDAC_MASK                  = 0x05, /* Hardware !LDAC mask register */
-    AD5697R_CMD_SOFT_RESET                    = 0x06, /* Software reset (power-on reset) */
-    AD5697R_CMD_INT_REF_SETUP                 = 0x07, /* Internal reference setup register */
-    AD5697R_CMD__MAX__
-} AD5697R_CMD_t;
-
-/*!
- * @brief AD5697R Input Shift Register Content
- */
-typedef union  {
-    struct {
-        union {
-            struct {
-                uint8_t cmd     : 4;    /* Command byte - Command */
-                uint8_t ch      : 4;    /* Command byte - DAC Channel */
-            } bits;                     /* Command byte - Bit Field */
-            uint8_t byte;               /* Command byte - Byte */
-        } command;                      /* Command byte */
-        uint8_t data_high;              /* Data high byte */
-        union {
-            struct {
-                uint8_t rsvd    : 4;    /* RSVD */
-                uint8_t data    : 4;    /* Date low nibble */
-            } bits;
-            uint8_t byte;           /* Date low byte */
-        } data_low;
-    } bits;
-    uint8_t bytes[3];
-} ad5697r_dac_register_t;
-
-/*!
- * @brief AD5697R Input Shift Register Content
- */
-typedef union  {
-    struct {
-        union {
-            struct {
-                uint8_t cmd     : 4;    /* Command byte - Command */
-                uint8_t rsvd    : 4;    /* Command byte - RSVD */
-            } bits;                     /* Command byte - Bit Field */
-            uint8_t byte;               /* Command byte - Byte */
-        } command;                      /* Command byte */
-        uint8_t rsvd;                   /* RSVD */
-        union {
-            struct {
-                uint8_t PDB     : 2;    /* Power Mode - CHB */
-                uint8_t rsvd    : 4;    /* RSVD */
-                uint8_t PDA     : 2;    /* Power Mode - CHA */
-            } bits;
-        } powerMode;                    /* Date low byte */
-    } bits;
-    uint8_t bytes[3];
-} ad5697r_operation_register_t;
-
-/*!
- * @brief AD5697R Reference Mode Content
- */
-typedef union  {
-    struct {
-        union {
-            struct {
-                uint8_t rsvd    : 4;    /* Command byte - RSVD */
-                uint8_t cmd     : 4;    /* Command byte - Command */
-            } bits;                     /* Command byte - Bit Field */
-            uint8_t byte;               /* Command byte - Byte */
-        } command;                      /* Command byte */
-        uint8_t rsvd;                   /* RSVD */
-        union {
-            struct {
-                uint8_t REF_EN  : 1;    /* Internal Reference Setup */
-                uint8_t rsvd    : 7;    /* RSVD */
-            } bits;
-        } reference;                    /* Date low byte */
-    } bits;
-    uint8_t bytes[3];
-} ad5697r_reference_register_t;
+ * @brief Applies an operating mode to the channel(s) of the provided register set
+ */
+static ad5697r_return_code_t ad5697r_applyOperatingMode(ad5697r_registers_t *registers, const ad5697r_output_channel_t ch, const ad5697r_operation_mode_t mode) {
+    switch( ch ) {
+        case AD5697R_OUTPUT_CH_A:
+            registers->bits.CHA_mode = mode;
+            break;
+
+        case AD5697R_OUTPUT_CH_B:
+            registers->bits.CHB_mode = mode;
+            break;
+
+        case AD5697R_OUTPUT_CH_A_B:
+            registers->bits.CHA_mode = mode;
+            registers->bits.CHB_mode = mode;
+            break;
+
+        default:
+            return AD5697R_RET_INV_PARAM;
+            break;
+    }
+
+    return AD5697R_RET_OK;
+}
 
 /*!
- * @brief This API writes the desired DAC value to the specified channel
+ * @brief Returns the shadow register flags written by a DAC data frame
  */
-ad5697r_return_code_t ad5697r_writeChannel(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
-    ad5697r_dac_register_t dac_register = {0};
+uint8_t ad5697r_shadowDacFlags(const uint8_t ch) {
+    uint8_t flags = 0;
+
+    if( ch & AD5697R_OUTPUT_CH_A ) {
+        flags |= AD5697R_SHADOW_INPUT_A | AD5697R_SHADOW_DAC_A;
+    }
+    if( ch & AD5697R_OUTPUT_CH_B ) {
+        flags |= AD5697R_SHADOW_INPUT_B | AD5697R_SHADOW_DAC_B;
+    }
+
+    return flags;
+}
+
+/*!
+ * @brief Applies a DAC data frame to the shadow registers
+ */
+static void ad5697r_shadowApplyDac(ad5697r_registers_t *registers, const AD5697R_CMD_t cmd, const uint8_t ch, const uint16_t outputVal) {
+    if( ch & AD5697R_OUTPUT_CH_A ) {
+        ad56x_shadowApplyChannel(&registers->bits.CHA_input, &registers->bits.CHA_dac, &registers->bits.valid,
+                                 AD5697R_SHADOW_INPUT_A, AD5697R_SHADOW_DAC_A, cmd, outputVal & AD5697R_ENC_MAX_CODE);
+    }
+    if( ch & AD5697R_OUTPUT_CH_B ) {
+        ad56x_shadowApplyChannel(&registers->bits.CHB_input, &registers->bits.CHB_dac, &registers->bits.valid,
+                                 AD5697R_SHADOW_INPUT_B, AD5697R_SHADOW_DAC_B, cmd, outputVal & AD5697R_ENC_MAX_CODE);
+    }
+}
+
+/*!
+ * @brief Checks whether a DAC data frame would leave the device unchanged
+ */
+static bool ad5697r_shadowDacMatches(const ad5697r_registers_t *registers, const AD5697R_CMD_t cmd, const uint8_t ch, const uint16_t outputVal) {
+    bool matches = true;
+
+    if( ch & AD5697R_OUTPUT_CH_A ) {
+        matches &= ad56x_shadowChannelMatches(registers->bits.CHA_input, registers->bits.CHA_dac, registers->bits.valid,
+                                              AD5697R_SHADOW_INPUT_A, AD5697R_SHADOW_DAC_A, cmd, outputVal & AD5697R_ENC_MAX_CODE);
+    }
+    if( ch & AD5697R_OUTPUT_CH_B ) {
+        matches &= ad56x_shadowChannelMatches(registers->bits.CHB_input, registers->bits.CHB_dac, registers->bits.valid,
+                                              AD5697R_SHADOW_INPUT_B, AD5697R_SHADOW_DAC_B, cmd, outputVal & AD5697R_ENC_MAX_CODE);
+    }
+
+    return matches;
+}
+
+/*!
+ * @brief Records a frame that was kept off the wire by the write cache
+ */
+static void ad5697r_cacheElided(ad5697r_dev_t *dev, const uint32_t savedBytes) {
+    dev->cache.stats.elidedWrites++;
+    dev->cache.stats.savedBytes += savedBytes;
+}
+
+/*!
+ * @brief Returns the timestamp of the device clock, 0 without a clock
+ */
+static uint32_t ad5697r_nowUs(const ad5697r_dev_t *dev) {
+    return (dev->intf.get_time_us != NULL) ? dev->intf.get_time_us() : 0;
+}
+
+/*!
+ * @brief Returns the log2 latency histogram bin of a transaction
+ */
+static uint8_t ad5697r_latencyBin(uint32_t latencyUs, const uint8_t bins) {
+    uint8_t bin = 0;
+
+    while( (latencyUs != 0) && (bin < (bins - 1)) ) {
+        latencyUs >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+#ifdef AD5697R_INSTRUMENT
+
+/*!
+ * @brief Accounts a completed transaction and hands it to the trace callback
+ */
+static void ad5697r_instrRecord(ad5697r_dev_t *dev, const bool read, const uint8_t *data, const uint32_t len, const int8_t ret, const uint32_t start) {
+    ad5697r_instr_stats_t *stats = &dev->instr.stats;
+    ad5697r_trace_event_t event;
+    uint32_t i = 0;
+
+    event.busAddr = dev->intf.i2c_addr;
+    event.read = read;
+    event.data = data;
+    event.len = len;
+    event.ret = ret;
+    event.latencyUs = ad5697r_nowUs(dev) - start;
+
+    // Codes outside the driver's own are counted as generic errors
+    stats->results[((ret <= 0) && (ret > -AD5697R_INSTR_RESULTS)) ? -ret : -AD5697R_RET_ERROR]++;
+    if( event.latencyUs > stats->maxLatencyUs ) {
+        stats->maxLatencyUs = event.latencyUs;
+    }
+
+    if( read ) {
+        stats->reads++;
+        stats->readLatency[ad5697r_latencyBin(event.latencyUs, AD5697R_INSTR_HIST_BINS)]++;
+        if( ret == AD5697R_RET_OK ) {
+            stats->bytesRead += len;
+        }
+    }
+    else {
+        stats->writes++;
+        stats->writeLatency[ad5697r_latencyBin(event.latencyUs, AD5697R_INSTR_HIST_BINS)]++;
+        if( ret == AD5697R_RET_OK ) {
+            stats->bytesWritten += len;
+            for( i = 0; (i + AD5697R_FRAME_SIZE) <= len; i += AD5697R_FRAME_SIZE ) {
+                stats->frames[data[i] >> 4]++;
+            }
+        }
+    }
+
+    if( dev->instr.trace != NULL ) {
+        dev->instr.trace(dev->instr.traceCtx, &event);
+    }
+}
+#endif // AD5697R_INSTRUMENT
+
+/*!
+ * @brief Makes a single attempt at a write transaction
+ */
+static int8_t ad5697r_busWriteOnce(ad5697r_dev_t *dev, const uint8_t *data, const uint32_t len) {
+#ifdef AD5697R_INSTRUMENT
+    const uint32_t start = ad5697r_nowUs(dev);
+    const int8_t ret = dev->intf.write(dev->intf.i2c_addr, data, len);
+
+    ad5697r_instrRecord(dev, false, data, len, ret, start);
+
+    return ret;
+#else
+    return dev->intf.write(dev->intf.i2c_addr, data, len);
+#endif
+}
+
+/*!
+ * @brief Returns the backoff ahead of the given retry, counted from 1
+ */
+static uint32_t ad5697r_retryBackoff(const ad5697r_retry_policy_t *policy, const uint8_t retry) {
+    const uint8_t shift = (retry > 32) ? 31 : (uint8_t)(retry - 1);
+    uint32_t delayUs = (policy->backoffUs > (UINT32_MAX >> shift)) ? UINT32_MAX : (policy->backoffUs << shift);
+
+    if( (policy->maxBackoffUs != 0) && (delayUs > policy->maxBackoffUs) ) {
+        delayUs = policy->maxBackoffUs;
+    }
+
+    return delayUs;
+}
+
+/*!
+ * @brief Writes a transaction under the retry policy and records its latency
+ */
+static int8_t ad5697r_retryWrite(ad5697r_dev_t *dev, const uint8_t *data, const uint32_t len) {
+    const ad5697r_retry_policy_t *policy = &dev->retry.policy;
+    ad5697r_retry_stats_t *stats = &dev->retry.stats;
+    const uint32_t start = ad5697r_nowUs(dev);
+    int8_t ret = ad5697r_busWriteOnce(dev, data, len);
+    uint32_t waitedUs = 0;
+    uint32_t delayUs = 0;
+    uint32_t latencyUs = 0;
+    uint8_t attempt = 1;
+
+    while( (ret == AD5697R_RET_BUSY) || (ret == AD5697R_RET_TIMEOUT) ) {
+        if( attempt >= policy->maxAttempts ) {
+            stats->exhausted++;
+            break;
+        }
+
+        // Without a clock the backoffs are the only measure of the time spent
+        delayUs = ad5697r_retryBackoff(policy, attempt);
+        latencyUs = (dev->intf.get_time_us != NULL) ? (ad5697r_nowUs(dev) - start) : waitedUs;
+        if( (policy->budgetUs != 0) && ((latencyUs > policy->budgetUs) || (delayUs > (policy->budgetUs - latencyUs))) ) {
+            stats->overBudget++;
+            break;
+        }
+
+        if( (dev->intf.delay_us != NULL) && (delayUs > 0) ) {
+            dev->intf.delay_us(delayUs);
+        }
+        waitedUs = ((UINT32_MAX - waitedUs) > delayUs) ? (waitedUs + delayUs) : UINT32_MAX;
+
+        stats->retries++;
+        attempt++;
+        ret = ad5697r_busWriteOnce(dev, data, len);
+    }
+
+    if( (ret == AD5697R_RET_OK) && (attempt > 1) ) {
+        stats->recovered++;
+    }
+
+    latencyUs = (dev->intf.get_time_us != NULL) ? (ad5697r_nowUs(dev) - start) : waitedUs;
+    stats->transactions++;
+    stats->latency[ad5697r_latencyBin(latencyUs, AD5697R_RETRY_HIST_BINS)]++;
+    if( latencyUs > stats->maxLatencyUs ) {
+        stats->maxLatencyUs = latencyUs;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Writes raw frames to the device in a single transaction
+ */
+ad5697r_return_code_t ad5697r_busWrite(ad5697r_dev_t *dev, const uint8_t *data, const uint32_t len) {
+    if( dev->retry.policy.maxAttempts > 1 ) {
+        return ad5697r_retryWrite(dev, data, len);
+    }
+
+    return ad5697r_busWriteOnce(dev, data, len);
+}
+
+/*!
+ * @brief Reads raw bytes from the device in a single transaction
+ */
+ad5697r_return_code_t ad5697r_busRead(ad5697r_dev_t *dev, uint8_t *data, const uint32_t len) {
+#ifdef AD5697R_INSTRUMENT
+    const uint32_t start = ad5697r_nowUs(dev);
+    const int8_t ret = dev->intf.read(dev->intf.i2c_addr, data, len);
+
+    ad5697r_instrRecord(dev, true, data, len, ret, start);
+
+    return ret;
+#else
+    return dev->intf.read(dev->intf.i2c_addr, data, len);
+#endif
+}
+
+/*!
+ * @brief Marks the registers a failed write touched as unknown, then restores
+ * the input registers from the device when the retry policy asks for it
+ */
+static void ad5697r_shadowFailed(ad5697r_dev_t *dev, const uint8_t touched) {
+    uint16_t outputVal = 0;
+
+    dev->registers.bits.valid &= ~touched;
+
+    if( !dev->retry.policy.resync || (dev->intf.read == NULL) ) {
+        return;
+    }
+
+    if( (touched & AD5697R_SHADOW_INPUT_A) && (ad5697r_readInputRegister(dev, AD5697R_OUTPUT_CH_A, &outputVal) == AD5697R_RET_OK) ) {
+        dev->registers.bits.CHA_input = outputVal;
+        dev->registers.bits.valid |= AD5697R_SHADOW_INPUT_A;
+        dev->retry.stats.resynced++;
+    }
+    if( (touched & AD5697R_SHADOW_INPUT_B) && (ad5697r_readInputRegister(dev, AD5697R_OUTPUT_CH_B, &outputVal) == AD5697R_RET_OK) ) {
+        dev->registers.bits.CHB_input = outputVal;
+        dev->registers.bits.valid |= AD5697R_SHADOW_INPUT_B;
+        dev->retry.stats.resynced++;
+    }
+}
+
+/*!
+ * @brief Writes a single frame transaction to the device and keeps the shadow registers in sync
+ */
+static ad5697r_return_code_t ad5697r_writeFrame(ad5697r_dev_t *dev, const uint8_t *frame, const uint8_t touched) {
+    ad5697r_return_code_t ret = ad5697r_busWrite(dev, frame, AD5697R_FRAME_SIZE);
+
+    // A failed transaction leaves the device in an unknown state
+    if( ret != AD5697R_RET_OK ) {
+        ad5697r_shadowFailed(dev, touched);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Writes a single DAC data frame with the provided command to the device
+ */
+static ad5697r_return_code_t ad5697r_writeDac(ad5697r_dev_t *dev, const AD5697R_CMD_t cmd, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frame[AD5697R_FRAME_SIZE];
 
     if( (dev == NULL) || (dev->intf.write == NULL) ) {
         return AD5697R_RET_NULL_PTR;
@@ -104,21 +318,83 @@ ad5697r_return_code_t ad5697r_writeChannel(ad5697r_dev_t *dev, const ad5697r_out
         return AD5697R_RET_INV_PARAM;
     }
 
-    // Setup the cmd register
-    dac_register.bits.command.bits.ch = ch;
-    dac_register.bits.command.bits.cmd = AD5697R_CMD_WRITE_DAC;
-    dac_register.bits.data_high = outputVal >> 4;
-    dac_register.bits.data_low.bits.data = outputVal;
+    if( dev->cache.elide && ad5697r_shadowDacMatches(&dev->registers, cmd, ch, outputVal) ) {
+        ad5697r_cacheElided(dev, AD5697R_FRAME_SIZE + 1);
+        return AD5697R_RET_OK;
+    }
+
+    ad5697r_packDacFrame(frame, cmd, ch, outputVal);
 
     // Write the DAC value to our device.
-    return dev->intf.write(dev->intf.i2c_addr, (uint8_t *)&dac_register, sizeof(dac_register));
+    ret = ad5697r_writeFrame(dev, frame, ad5697r_shadowDacFlags(ch));
+    if( ret == AD5697R_RET_OK ) {
+        ad5697r_shadowApplyDac(&dev->registers, cmd, ch, outputVal);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API writes the desired DAC value to the specified channel
+ */
+ad5697r_return_code_t ad5697r_writeChannel(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    return ad5697r_writeDac(dev, AD5697R_CMD_WRITE_DAC, ch, outputVal);
+}
+
+/*!
+ * @brief This API writes the desired value to the input register of the specified channel
+ */
+ad5697r_return_code_t ad5697r_writeInputRegister(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    return ad5697r_writeDac(dev, AD5697R_CMD_W_INPUT_REG_N, ch, outputVal);
+}
+
+/*!
+ * @brief This API updates the DAC output(s) with the contents of their input registers
+ */
+ad5697r_return_code_t ad5697r_updateChannel(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch) {
+    return ad5697r_writeDac(dev, AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, ch, 0x0000);
+}
+
+/*!
+ * @brief This API stages both channels and updates their outputs together in one transaction
+ */
+ad5697r_return_code_t ad5697r_writeChannelsSynchronized(ad5697r_dev_t *dev, const uint16_t outputValA, const uint16_t outputValB) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(3)];
+
+    if( (dev == NULL) || (dev->intf.write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( dev->intf.i2c_addr > 0x7F ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ret = ad5697r_batchInit(&batch, dev, buf, sizeof(buf));
+
+    // Stage both input registers, then move them to the outputs with one command
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_A, outputValA);
+
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_B, outputValB);
+
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_batchUpdateChannel(&batch, AD5697R_OUTPUT_CH_A_B);
+
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_batchCommit(&batch);
+
+    return ret;
 }
 
 /*!
  * @brief This API sets the operation mode for each DAC output
  */
 ad5697r_return_code_t ad5697r_setOperatingMode(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const ad5697r_operation_mode_t mode) {
-    ad5697r_operation_register_t op_register = {0};
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_registers_t registers;
+    uint8_t frame[AD5697R_FRAME_SIZE];
 
     if( (dev == NULL) || (dev->intf.write == NULL) ) {
         return AD5697R_RET_NULL_PTR;
@@ -127,38 +403,35 @@ ad5697r_return_code_t ad5697r_setOperatingMode(ad5697r_dev_t *dev, const ad5697r
         return AD5697R_RET_INV_PARAM;
     }
 
-    switch( ch ) {
-        case AD5697R_OUTPUT_CH_A:
-            dev->registers.bits.CHA_mode = mode;
-            break;
-
-        case AD5697R_OUTPUT_CH_B:
-            dev->registers.bits.CHB_mode = mode;
-            break;
-
-        case AD5697R_OUTPUT_CH_A_B:
-            dev->registers.bits.CHA_mode = mode;
-            dev->registers.bits.CHB_mode = mode;
-            break;
+    registers = dev->registers;
+    if( ad5697r_applyOperatingMode(&dev->registers, ch, mode) != AD5697R_RET_OK ) {
+        return AD5697R_RET_INV_PARAM;
+    }
 
-        default:
-            return AD5697R_RET_INV_PARAM;
-            break;
+    if( dev->cache.elide && (registers.bits.valid & AD5697R_SHADOW_POWER) &&
+        (registers.bits.CHA_mode == dev->registers.bits.CHA_mode) &&
+        (registers.bits.CHB_mode == dev->registers.bits.CHB_mode) ) {
+        ad5697r_cacheElided(dev, AD5697R_FRAME_SIZE + 1);
+        return AD5697R_RET_OK;
     }
 
-    op_register.bits.command.bits.cmd = AD5697R_CMD_POWER_DAC;
-    op_register.bits.powerMode.bits.PDA = dev->registers.bits.CHA_mode;
-    op_register.bits.powerMode.bits.PDB = dev->registers.bits.CHB_mode;
+    ad5697r_packPowerFrame(frame, dev->registers.bits.CHA_mode, dev->registers.bits.CHB_mode);
 
     // Write the Operation mode values to our device.
-    return dev->intf.write(dev->intf.i2c_addr, (uint8_t *)&op_register, sizeof(op_register));
+    ret = ad5697r_writeFrame(dev, frame, AD5697R_SHADOW_POWER);
+    if( ret == AD5697R_RET_OK ) {
+        dev->registers.bits.valid |= AD5697R_SHADOW_POWER;
+    }
+
+    return ret;
 }
 
 /*!
  * @brief This API sets enables/disables the internal reference
  */
 ad5697r_return_code_t ad5697r_setReferenceMode(ad5697r_dev_t *dev, const ad5697r_reference_t refSelect) {
-    ad5697r_reference_register_t ref_register = {0};
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frame[AD5697R_FRAME_SIZE];
 
     if( (dev == NULL) || (dev->intf.write == NULL) ) {
         return AD5697R_RET_NULL_PTR;
@@ -167,9 +440,725 @@ ad5697r_return_code_t ad5697r_setReferenceMode(ad5697r_dev_t *dev, const ad5697r
         return AD5697R_RET_INV_PARAM;
     }
 
-    ref_register.bits.command.bits.cmd = AD5697R_CMD_INT_REF_SETUP;
-    ref_register.bits.reference.bits.REF_EN = refSelect;
+    if( dev->cache.elide && (dev->registers.bits.valid & AD5697R_SHADOW_REF) && (dev->registers.bits.ref_mode == refSelect) ) {
+        ad5697r_cacheElided(dev, AD5697R_FRAME_SIZE + 1);
+        return AD5697R_RET_OK;
+    }
+
+    ad5697r_packReferenceFrame(frame, refSelect);
 
     // Write the Reference select mode values to our device.
-    return dev->intf.write(dev->intf.i2c_addr, (uint8_t *)&ref_register, sizeof(ref_register));
-}
\ No newline at end of file
+    ret = ad5697r_writeFrame(dev, frame, AD5697R_SHADOW_REF);
+    if( ret == AD5697R_RET_OK ) {
+        dev->registers.bits.ref_mode = refSelect;
+        dev->registers.bits.valid |= AD5697R_SHADOW_REF;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API sets the channels that ignore the !LDAC pin
+ */
+ad5697r_return_code_t ad5697r_setLdacMask(ad5697r_dev_t *dev, const uint8_t mask) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frame[AD5697R_FRAME_SIZE];
+
+    if( (dev == NULL) || (dev->intf.write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (mask & ~AD5697R_OUTPUT_CH_A_B) || (dev->intf.i2c_addr > 0x7F) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( dev->cache.elide && (dev->registers.bits.valid & AD5697R_SHADOW_LDAC) && (dev->registers.bits.ldac_mask == mask) ) {
+        ad5697r_cacheElided(dev, AD5697R_FRAME_SIZE + 1);
+        return AD5697R_RET_OK;
+    }
+
+    ad5697r_packLdacMaskFrame(frame, mask);
+
+    ret = ad5697r_writeFrame(dev, frame, AD5697R_SHADOW_LDAC);
+    if( ret == AD5697R_RET_OK ) {
+        dev->registers.bits.ldac_mask = mask;
+        dev->registers.bits.valid |= AD5697R_SHADOW_LDAC;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API pulses the !LDAC pin low, updating every unmasked channel
+ */
+ad5697r_return_code_t ad5697r_pulseLdac(ad5697r_dev_t *dev) {
+    if( (dev == NULL) || (dev->intf.ldac == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    // The falling edge latches, the pulse only has to be 20ns wide
+    dev->intf.ldac(false);
+    dev->intf.ldac(true);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API reads back the input register of a channel
+ */
+ad5697r_return_code_t ad5697r_readInputRegister(ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, uint16_t *outputVal) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frame[AD5697R_FRAME_SIZE];
+    uint8_t data[2];
+
+    if( (dev == NULL) || (dev->intf.write == NULL) || (dev->intf.read == NULL) || (outputVal == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( ((ch != AD5697R_OUTPUT_CH_A) && (ch != AD5697R_OUTPUT_CH_B)) || (dev->intf.i2c_addr > 0x7F) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // The address bits of a no-operation frame select the register to read back
+    ad5697r_packDacFrame(frame, AD5697R_CMD_NO_OP, ch, 0x0000);
+
+    ret = ad5697r_busWrite(dev, frame, AD5697R_FRAME_SIZE);
+    if( ret == AD5697R_RET_OK ) {
+        ret = ad5697r_busRead(dev, data, sizeof(data));
+    }
+
+    if( ret == AD5697R_RET_OK ) {
+        *outputVal = ad5697r_decCode(data);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API compares the shadowed input registers with the device
+ */
+ad5697r_return_code_t ad5697r_verifyShadow(ad5697r_dev_t *dev, uint8_t *mismatch) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint16_t outputVal = 0;
+
+    if( (dev == NULL) || (mismatch == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    *mismatch = 0;
+
+    if( dev->registers.bits.valid & AD5697R_SHADOW_INPUT_A ) {
+        ret = ad5697r_readInputRegister(dev, AD5697R_OUTPUT_CH_A, &outputVal);
+        if( (ret == AD5697R_RET_OK) && (outputVal != dev->registers.bits.CHA_input) ) {
+            *mismatch |= AD5697R_SHADOW_INPUT_A;
+        }
+    }
+
+    if( (ret == AD5697R_RET_OK) && (dev->registers.bits.valid & AD5697R_SHADOW_INPUT_B) ) {
+        ret = ad5697r_readInputRegister(dev, AD5697R_OUTPUT_CH_B, &outputVal);
+        if( (ret == AD5697R_RET_OK) && (outputVal != dev->registers.bits.CHB_input) ) {
+            *mismatch |= AD5697R_SHADOW_INPUT_B;
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API resets the device to its power-on state
+ */
+ad5697r_return_code_t ad5697r_softReset(ad5697r_dev_t *dev) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frame[AD5697R_FRAME_SIZE];
+
+    if( (dev == NULL) || (dev->intf.write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( dev->intf.i2c_addr > 0x7F ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_packSoftResetFrame(frame);
+
+    ret = ad5697r_writeFrame(dev, frame, AD5697R_SHADOW_ALL);
+    if( ret == AD5697R_RET_OK ) {
+        // The output codes depend on the RSTSEL pin, the control registers do not
+        dev->registers.bits.CHA_mode = AD5697R_OP_MODE_NORMAL;
+        dev->registers.bits.CHB_mode = AD5697R_OP_MODE_NORMAL;
+        dev->registers.bits.ldac_mask = 0;
+        dev->registers.bits.ref_mode = AD5697R_REF_ON;
+        dev->registers.bits.valid = AD5697R_SHADOW_POWER | AD5697R_SHADOW_LDAC | AD5697R_SHADOW_REF;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API enables/disables write elision
+ */
+ad5697r_return_code_t ad5697r_setWriteElision(ad5697r_dev_t *dev, const bool enable) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    dev->cache.elide = enable;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API marks every shadow register as unknown
+ */
+ad5697r_return_code_t ad5697r_invalidateShadow(ad5697r_dev_t *dev) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    dev->registers.bits.valid = 0;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API clears the write cache statistics
+ */
+ad5697r_return_code_t ad5697r_resetCacheStats(ad5697r_dev_t *dev) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(&dev->cache.stats, 0, sizeof(ad5697r_cache_stats_t));
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the retry policy of write transactions
+ */
+ad5697r_return_code_t ad5697r_setRetryPolicy(ad5697r_dev_t *dev, const ad5697r_retry_policy_t *policy) {
+    if( (dev == NULL) || (policy == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    dev->retry.policy = *policy;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API clears the retry statistics
+ */
+ad5697r_return_code_t ad5697r_resetRetryStats(ad5697r_dev_t *dev) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(&dev->retry.stats, 0, sizeof(ad5697r_retry_stats_t));
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API returns a write latency percentile from the retry statistics
+ */
+ad5697r_return_code_t ad5697r_getRetryLatencyUs(const ad5697r_dev_t *dev, const uint16_t permille, uint32_t *latencyUs) {
+    const ad5697r_retry_stats_t *stats = NULL;
+    uint64_t target = 0;
+    uint64_t seen = 0;
+    uint32_t edgeUs = 0;
+    uint8_t bin = 0;
+
+    if( (dev == NULL) || (latencyUs == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( permille > 1000 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    stats = &dev->retry.stats;
+    *latencyUs = 0;
+
+    // Smallest bin holding at least the requested share of the transactions
+    target = (((uint64_t)stats->transactions * permille) + 999) / 1000;
+    for( bin = 0; (bin < AD5697R_RETRY_HIST_BINS) && (target > 0); bin++ ) {
+        seen += stats->latency[bin];
+        if( seen >= target ) {
+            edgeUs = (bin == (AD5697R_RETRY_HIST_BINS - 1)) ? UINT32_MAX : ((1UL << bin) - 1);
+            *latencyUs = (edgeUs < stats->maxLatencyUs) ? edgeUs : stats->maxLatencyUs;
+            break;
+        }
+    }
+
+    return AD5697R_RET_OK;
+}
+
+#ifdef AD5697R_INSTRUMENT
+/*!
+ * @brief This API copies the bus instrumentation counters of the device
+ */
+ad5697r_return_code_t ad5697r_instrGetSnapshot(const ad5697r_dev_t *dev, ad5697r_instr_stats_t *snapshot) {
+    if( (dev == NULL) || (snapshot == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    *snapshot = dev->instr.stats;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API clears the bus instrumentation counters of the device
+ */
+ad5697r_return_code_t ad5697r_instrReset(ad5697r_dev_t *dev) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(&dev->instr.stats, 0, sizeof(ad5697r_instr_stats_t));
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the callback receiving every bus transaction of the device
+ */
+ad5697r_return_code_t ad5697r_instrSetTrace(ad5697r_dev_t *dev, const ad5697r_trace_fptr_t trace, void *ctx) {
+    if( dev == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    dev->instr.trace = trace;
+    dev->instr.traceCtx = ctx;
+
+    return AD5697R_RET_OK;
+}
+#endif // AD5697R_INSTRUMENT
+
+/*!
+ * @brief This API estimates the time a transaction spends on the bus
+ */
+uint32_t ad5697r_getTransactionTimeNs(const uint32_t busClockHz, const uint32_t len) {
+    uint64_t ns = 0;
+
+    if( busClockHz == 0 ) {
+        return 0;
+    }
+
+    // START + (address + data bytes) * (8 bits + ACK) + STOP
+    ns = (((uint64_t)(len + 1) * 9u + 2u) * 1000000000u) / busClockHz;
+
+    // Hs-mode is entered with a START and master code at Fast-mode speed
+    if( busClockHz > AD5697R_I2C_FAST_PLUS_MODE_HZ ) {
+        ns += ((uint64_t)10u * 1000000000u) / AD5697R_I2C_FAST_MODE_HZ;
+    }
+
+    return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+/*!
+ * @brief Reserves space for the next frame in the batch buffer
+ */
+static uint8_t *ad5697r_batchReserve(ad5697r_batch_t *batch) {
+    uint8_t *frame = NULL;
+
+    if( (batch->len + AD5697R_FRAME_SIZE) <= batch->size ) {
+        frame = &batch->buf[batch->len];
+        batch->len += AD5697R_FRAME_SIZE;
+    }
+
+    return frame;
+}
+
+/*!
+ * @brief This API initializes a batch against the provided device and frame buffer
+ */
+ad5697r_return_code_t ad5697r_batchInit(ad5697r_batch_t *batch, ad5697r_dev_t *dev, uint8_t *buf, const uint32_t size) {
+    if( (batch == NULL) || (dev == NULL) || (buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( size < AD5697R_FRAME_SIZE ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(batch, 0, sizeof(ad5697r_batch_t));
+    batch->dev = dev;
+    batch->buf = buf;
+    batch->size = size;
+    batch->registers = dev->registers;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API discards every frame queued in the batch
+ */
+ad5697r_return_code_t ad5697r_batchReset(ad5697r_batch_t *batch) {
+    if( (batch == NULL) || (batch->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    batch->len = 0;
+    batch->touched = 0;
+    batch->registers = batch->dev->registers;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Appends a DAC data frame with the provided command to the batch
+ */
+static ad5697r_return_code_t ad5697r_batchAppendDac(ad5697r_batch_t *batch, const AD5697R_CMD_t cmd, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    uint8_t *frame = NULL;
+    bool elide = false;
+
+    if( (batch == NULL) || (batch->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( ch >= AD5697R_OUTPUT_CH__MAX__ ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    elide = batch->dev->cache.elide;
+
+    if( elide && ad5697r_shadowDacMatches(&batch->registers, cmd, ch, outputVal) ) {
+        ad5697r_cacheElided(batch->dev, AD5697R_FRAME_SIZE);
+        return AD5697R_RET_OK;
+    }
+
+    // A write to and update of the same channel(s) as the previous frame
+    // supersedes it, so the previous frame can be reused.
+    if( elide && (cmd == AD5697R_CMD_WRITE_DAC) && (batch->len >= AD5697R_FRAME_SIZE) ) {
+        frame = &batch->buf[batch->len - AD5697R_FRAME_SIZE];
+
+        if( frame[0] == (uint8_t)((AD5697R_CMD_WRITE_DAC << 4) | ch) ) {
+            ad5697r_packDacFrame(frame, cmd, ch, outputVal);
+            ad5697r_shadowApplyDac(&batch->registers, cmd, ch, outputVal);
+
+            batch->dev->cache.stats.coalescedWrites++;
+            batch->dev->cache.stats.savedBytes += AD5697R_FRAME_SIZE;
+            return AD5697R_RET_OK;
+        }
+    }
+
+    frame = ad5697r_batchReserve(batch);
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    ad5697r_packDacFrame(frame, cmd, ch, outputVal);
+    ad5697r_shadowApplyDac(&batch->registers, cmd, ch, outputVal);
+    batch->touched |= ad5697r_shadowDacFlags(ch);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API appends a write to and update of the DAC channel to the batch
+ */
+ad5697r_return_code_t ad5697r_batchWriteChannel(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    return ad5697r_batchAppendDac(batch, AD5697R_CMD_WRITE_DAC, ch, outputVal);
+}
+
+/*!
+ * @brief This API appends a write to the input register of the DAC channel to the batch
+ */
+ad5697r_return_code_t ad5697r_batchWriteInputRegister(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    return ad5697r_batchAppendDac(batch, AD5697R_CMD_W_INPUT_REG_N, ch, outputVal);
+}
+
+/*!
+ * @brief This API appends an update of the DAC channel from its input register to the batch
+ */
+ad5697r_return_code_t ad5697r_batchUpdateChannel(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch) {
+    return ad5697r_batchAppendDac(batch, AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, ch, 0x0000);
+}
+
+/*!
+ * @brief Appends a power down/power up frame setting both channels to the batch
+ */
+static ad5697r_return_code_t ad5697r_batchAppendPower(ad5697r_batch_t *batch, const uint8_t modeA, const uint8_t modeB) {
+    uint8_t *frame = ad5697r_batchReserve(batch);
+
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    batch->registers.bits.CHA_mode = modeA;
+    batch->registers.bits.CHB_mode = modeB;
+    batch->registers.bits.valid |= AD5697R_SHADOW_POWER;
+    batch->touched |= AD5697R_SHADOW_POWER;
+    ad5697r_packPowerFrame(frame, modeA, modeB);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API appends an operation mode change to the batch
+ */
+ad5697r_return_code_t ad5697r_batchSetOperatingMode(ad5697r_batch_t *batch, const ad5697r_output_channel_t ch, const ad5697r_operation_mode_t mode) {
+    ad5697r_registers_t registers;
+
+    if( (batch == NULL) || (batch->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( mode >= AD5697R_OP_MODE__MAX__ ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    registers = batch->registers;
+    if( ad5697r_applyOperatingMode(&registers, ch, mode) != AD5697R_RET_OK ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( batch->dev->cache.elide && (batch->registers.bits.valid & AD5697R_SHADOW_POWER) &&
+        (registers.bits.CHA_mode == batch->registers.bits.CHA_mode) &&
+        (registers.bits.CHB_mode == batch->registers.bits.CHB_mode) ) {
+        ad5697r_cacheElided(batch->dev, AD5697R_FRAME_SIZE);
+        return AD5697R_RET_OK;
+    }
+
+    return ad5697r_batchAppendPower(batch, registers.bits.CHA_mode, registers.bits.CHB_mode);
+}
+
+/*!
+ * @brief This API appends an internal reference change to the batch
+ */
+ad5697r_return_code_t ad5697r_batchSetReferenceMode(ad5697r_batch_t *batch, const ad5697r_reference_t refSelect) {
+    uint8_t *frame = NULL;
+
+    if( (batch == NULL) || (batch->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( refSelect >= AD5697R_REF__MAX__ ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( batch->dev->cache.elide && (batch->registers.bits.valid & AD5697R_SHADOW_REF) && (batch->registers.bits.ref_mode == refSelect) ) {
+        ad5697r_cacheElided(batch->dev, AD5697R_FRAME_SIZE);
+        return AD5697R_RET_OK;
+    }
+
+    frame = ad5697r_batchReserve(batch);
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    batch->registers.bits.ref_mode = refSelect;
+    batch->registers.bits.valid |= AD5697R_SHADOW_REF;
+    batch->touched |= AD5697R_SHADOW_REF;
+    ad5697r_packReferenceFrame(frame, refSelect);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API appends a hardware !LDAC mask change to the batch
+ */
+ad5697r_return_code_t ad5697r_batchSetLdacMask(ad5697r_batch_t *batch, const uint8_t mask) {
+    uint8_t *frame = NULL;
+
+    if( (batch == NULL) || (batch->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( mask & ~AD5697R_OUTPUT_CH_A_B ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( batch->dev->cache.elide && (batch->registers.bits.valid & AD5697R_SHADOW_LDAC) && (batch->registers.bits.ldac_mask == mask) ) {
+        ad5697r_cacheElided(batch->dev, AD5697R_FRAME_SIZE);
+        return AD5697R_RET_OK;
+    }
+
+    frame = ad5697r_batchReserve(batch);
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    batch->registers.bits.ldac_mask = mask;
+    batch->registers.bits.valid |= AD5697R_SHADOW_LDAC;
+    batch->touched |= AD5697R_SHADOW_LDAC;
+    ad5697r_packLdacMaskFrame(frame, mask);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Copies the shadow registers covered by the touched flags from the
+ * batch to the device, leaving the rest as direct writes left them
+ */
+static void ad5697r_shadowMerge(ad5697r_registers_t *dst, const ad5697r_registers_t *src, const uint8_t touched) {
+    if( touched & AD5697R_SHADOW_INPUT_A ) {
+        dst->bits.CHA_input = src->bits.CHA_input;
+    }
+    if( touched & AD5697R_SHADOW_INPUT_B ) {
+        dst->bits.CHB_input = src->bits.CHB_input;
+    }
+    if( touched & AD5697R_SHADOW_DAC_A ) {
+        dst->bits.CHA_dac = src->bits.CHA_dac;
+    }
+    if( touched & AD5697R_SHADOW_DAC_B ) {
+        dst->bits.CHB_dac = src->bits.CHB_dac;
+    }
+    if( touched & AD5697R_SHADOW_POWER ) {
+        dst->bits.CHA_mode = src->bits.CHA_mode;
+        dst->bits.CHB_mode = src->bits.CHB_mode;
+    }
+    if( touched & AD5697R_SHADOW_LDAC ) {
+        dst->bits.ldac_mask = src->bits.ldac_mask;
+    }
+    if( touched & AD5697R_SHADOW_REF ) {
+        dst->bits.ref_mode = src->bits.ref_mode;
+    }
+
+    dst->bits.valid = (dst->bits.valid & ~touched) | (src->bits.valid & touched);
+}
+
+/*!
+ * @brief This API sends every queued frame to the device in a single I2C write
+ */
+ad5697r_return_code_t ad5697r_batchCommit(ad5697r_batch_t *batch) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_dev_t *dev = NULL;
+
+    if( (batch == NULL) || (batch->dev == NULL) || (batch->dev->intf.write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( batch->dev->intf.i2c_addr > 0x7F ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+    else if( batch->len == 0 ) {
+        return AD5697R_RET_OK;
+    }
+
+    dev = batch->dev;
+
+    // The input shift register latches on every 24th SCL edge, so each
+    // frame is executed in order within the one transaction.
+    ret = ad5697r_busWrite(dev, batch->buf, batch->len);
+
+    // Keep the frames queued on failure so the caller can retry the commit,
+    // any register the batch touched may or may not have been written.
+    if( ret == AD5697R_RET_OK ) {
+        // Direct writes made since the batch was started stay in the shadow
+        ad5697r_shadowMerge(&dev->registers, &batch->registers, batch->touched);
+
+        batch->stats.transactions++;
+        batch->stats.updates += batch->len / AD5697R_FRAME_SIZE;
+        batch->stats.wireBytes += batch->len + 1;
+        batch->len = 0;
+        batch->touched = 0;
+    }
+    else {
+        ad5697r_shadowFailed(dev, batch->touched);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns the average number of bytes on the wire per committed update
+ */
+float ad5697r_batchGetBytesPerUpdate(const ad5697r_batch_t *batch) {
+    if( (batch == NULL) || (batch->stats.updates == 0) ) {
+        return 0.0f;
+    }
+
+    return (float)batch->stats.wireBytes / (float)batch->stats.updates;
+}
+
+/*!
+ * @brief This API brings the device up in the provided configuration
+ */
+ad5697r_return_code_t ad5697r_init(ad5697r_dev_t *dev, const ad5697r_config_t *config, ad5697r_init_report_t *report) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(AD5697R_INIT_MAX_FRAMES)];
+    ad5697r_init_report_t rep;
+    ad5697r_batch_t batch;
+    uint32_t start = 0;
+
+    if( report != NULL ) {
+        memset(report, 0, sizeof(*report));
+    }
+    if( (dev == NULL) || (config == NULL) || (dev->intf.write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (config->refMode >= AD5697R_REF__MAX__) || (config->modeA >= AD5697R_OP_MODE__MAX__) ||
+             (config->modeB >= AD5697R_OP_MODE__MAX__) || (config->ldacMask & ~AD5697R_OUTPUT_CH_A_B) ||
+             (config->codeA > 0x0FFF) || (config->codeB > 0x0FFF) || (dev->intf.i2c_addr > 0x7F) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(&rep, 0, sizeof(rep));
+    if( dev->intf.get_time_us != NULL ) {
+        start = dev->intf.get_time_us();
+    }
+
+    // Only a reset gives a known starting point, a running device may have drifted from the shadow
+    if( config->softReset ) {
+        ret = ad5697r_softReset(dev);
+        if( ret != AD5697R_RET_OK ) {
+            return ret;
+        }
+        rep.transactions++;
+        rep.frames++;
+    }
+    else {
+        dev->registers.bits.valid = 0;
+    }
+
+    ret = ad5697r_batchInit(&batch, dev, buf, sizeof(buf));
+
+    if( (ret == AD5697R_RET_OK) && (!(dev->registers.bits.valid & AD5697R_SHADOW_REF) || (dev->registers.bits.ref_mode != config->refMode)) ) {
+        ret = ad5697r_batchSetReferenceMode(&batch, config->refMode);
+    }
+    if( (ret == AD5697R_RET_OK) && (!(dev->registers.bits.valid & AD5697R_SHADOW_LDAC) || (dev->registers.bits.ldac_mask != config->ldacMask)) ) {
+        ret = ad5697r_batchSetLdacMask(&batch, config->ldacMask);
+    }
+    if( (ret == AD5697R_RET_OK) && (!(dev->registers.bits.valid & AD5697R_SHADOW_POWER) || (dev->registers.bits.CHA_mode != config->modeA) || (dev->registers.bits.CHB_mode != config->modeB)) ) {
+        ret = ad5697r_batchAppendPower(&batch, config->modeA, config->modeB);
+    }
+    if( (ret == AD5697R_RET_OK) && config->setCodes && (config->codeA == config->codeB) ) {
+        ret = ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A_B, config->codeA);
+    }
+    else if( (ret == AD5697R_RET_OK) && config->setCodes ) {
+        ret = ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, config->codeA);
+        if( ret == AD5697R_RET_OK ) {
+            ret = ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_B, config->codeB);
+        }
+    }
+
+    if( ret != AD5697R_RET_OK ) {
+        if( report != NULL ) {
+            *report = rep;
+        }
+        return ret;
+    }
+
+    if( batch.len > 0 ) {
+        rep.frames += batch.len / AD5697R_FRAME_SIZE;
+        ret = ad5697r_batchCommit(&batch);
+        if( ret != AD5697R_RET_OK ) {
+            if( report != NULL ) {
+                *report = rep;
+            }
+            return ret;
+        }
+        rep.transactions++;
+    }
+
+    // The outputs are valid once they settled on a reference that is up
+    rep.settleUs = AD5697R_SETTLING_TIME_US;
+    if( (config->refMode == AD5697R_REF_ON) && (AD5697R_REF_POWER_UP_US > rep.settleUs) ) {
+        rep.settleUs = AD5697R_REF_POWER_UP_US;
+    }
+    if( dev->intf.delay_us != NULL ) {
+        dev->intf.delay_us(rep.settleUs);
+    }
+
+    if( dev->intf.get_time_us != NULL ) {
+        rep.firstOutputUs = dev->intf.get_time_us() - start;
+    }
+    if( report != NULL ) {
+        *report = rep;
+    }
+
+    return AD5697R_RET_OK;
+}
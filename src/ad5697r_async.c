@@ -0,0 +1,297 @@
+/*! @file ad5697r_async.c
+ * @brief Asynchronous transport queue for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_async.h"
+#include "ad5697r_priv.h"
+
+/*!
+ * @brief Completion state of a synchronous wrapper call
+ */
+typedef struct {
+    volatile uint8_t done;
+    volatile ad5697r_return_code_t ret;
+} ad5697r_async_wait_t;
+
+/*!
+ * @brief Queue the interface function submits to
+ */
+static ad5697r_async_queue_t *ad5697r_asyncQueue = NULL;
+
+/*!
+ * @brief Loads a ring index shared between the submitter and the transport
+ */
+static uint32_t ad5697r_asyncLoad(const uint32_t *index) {
+    return __atomic_load_n(index, __ATOMIC_SEQ_CST);
+}
+
+/*!
+ * @brief Ends the request in flight and clears the in-flight flag
+ */
+static void ad5697r_asyncFinish(ad5697r_async_queue_t *queue, const ad5697r_return_code_t ret) {
+    ad5697r_async_req_t *req = &queue->ring[ad5697r_asyncLoad(&queue->head) % queue->capacity];
+    ad5697r_async_cb_fptr_t cb = req->cb;
+    void *ctx = req->ctx;
+
+    queue->stats.completed++;
+    if( ret != AD5697R_RET_OK ) {
+        queue->stats.errors++;
+    }
+
+    // Free the slot before the callback so it can submit the next request
+    __atomic_add_fetch(&queue->head, 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&queue->inflight, 0, __ATOMIC_SEQ_CST);
+
+    if( cb != NULL ) {
+        cb(ctx, ret);
+    }
+}
+
+/*!
+ * @brief Starts the next request unless a transfer is already in flight.
+ * Called by both the submitter and the transport, the in-flight flag decides
+ * which of them starts it.
+ */
+static void ad5697r_asyncKick(ad5697r_async_queue_t *queue) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_async_req_t *req = NULL;
+    uint8_t idle = 0;
+
+    while( ad5697r_asyncLoad(&queue->head) != ad5697r_asyncLoad(&queue->tail) ) {
+        idle = 0;
+        if( !__atomic_compare_exchange_n(&queue->inflight, &idle, 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ) {
+            return;
+        }
+
+        // The ring may have drained between the check and taking the flag
+        if( ad5697r_asyncLoad(&queue->head) == ad5697r_asyncLoad(&queue->tail) ) {
+            __atomic_store_n(&queue->inflight, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+
+        req = &queue->ring[ad5697r_asyncLoad(&queue->head) % queue->capacity];
+        ret = queue->start(queue->startCtx, req->busAddr, req->data, req->len);
+        if( ret == AD5697R_RET_OK ) {
+            return;
+        }
+
+        // The transfer never started, complete it here and try the next one
+        ad5697r_asyncFinish(queue, ret);
+    }
+}
+
+/*!
+ * @brief Completion callback of the synchronous wrapper
+ */
+static void ad5697r_asyncWaitDone(void *ctx, const ad5697r_return_code_t ret) {
+    ad5697r_async_wait_t *wait = (ad5697r_async_wait_t *)ctx;
+
+    wait->ret = ret;
+    __atomic_store_n(&wait->done, 1, __ATOMIC_SEQ_CST);
+}
+
+/*!
+ * @brief This API initializes a queue over a caller provided ring
+ */
+ad5697r_return_code_t ad5697r_asyncInit(ad5697r_async_queue_t *queue, ad5697r_async_req_t *ring, const uint32_t capacity, ad5697r_async_start_fptr_t start, void *startCtx) {
+    if( (queue == NULL) || (ring == NULL) || (start == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( capacity == 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(queue, 0, sizeof(*queue));
+    queue->ring = ring;
+    queue->capacity = capacity;
+    queue->start = start;
+    queue->startCtx = startCtx;
+    ad5697r_asyncQueue = queue;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API selects the queue used by the interface function
+ */
+ad5697r_return_code_t ad5697r_asyncSelect(ad5697r_async_queue_t *queue) {
+    if( queue == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ad5697r_asyncQueue = queue;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the hook called while the synchronous wrapper waits
+ */
+ad5697r_return_code_t ad5697r_asyncSetIdle(ad5697r_async_queue_t *queue, ad5697r_async_idle_fptr_t idle, void *idleCtx) {
+    if( queue == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    queue->idle = idle;
+    queue->idleCtx = idleCtx;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API copies wire format frames into the ring
+ */
+ad5697r_return_code_t ad5697r_asyncSubmit(ad5697r_async_queue_t *queue, const uint8_t busAddr, const uint8_t *data, const uint32_t len, ad5697r_async_cb_fptr_t cb, void *ctx) {
+    ad5697r_async_req_t *req = NULL;
+    uint32_t tail = 0;
+
+    if( (queue == NULL) || (queue->ring == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (busAddr > 0x7F) || (len == 0) || (len > AD5697R_ASYNC_MAX_LEN) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    tail = ad5697r_asyncLoad(&queue->tail);
+    if( (tail - ad5697r_asyncLoad(&queue->head)) >= queue->capacity ) {
+        queue->stats.full++;
+        return AD5697R_RET_BUSY;
+    }
+
+    req = &queue->ring[tail % queue->capacity];
+    req->busAddr = busAddr;
+    req->len = len;
+    memcpy(req->data, data, len);
+    req->cb = cb;
+    req->ctx = ctx;
+
+    queue->stats.submitted++;
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_SEQ_CST);
+
+    ad5697r_asyncKick(queue);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API is called by the transport when the transfer in flight ends
+ */
+void ad5697r_asyncComplete(ad5697r_async_queue_t *queue, const ad5697r_return_code_t ret) {
+    if( (queue == NULL) || (__atomic_load_n(&queue->inflight, __ATOMIC_SEQ_CST) == 0) ) {
+        return;
+    }
+
+    ad5697r_asyncFinish(queue, ret);
+    ad5697r_asyncKick(queue);
+}
+
+/*!
+ * @brief This API returns the number of requests queued or in flight
+ */
+uint32_t ad5697r_asyncGetPending(const ad5697r_async_queue_t *queue) {
+    if( queue == NULL ) {
+        return 0;
+    }
+
+    return ad5697r_asyncLoad(&queue->tail) - ad5697r_asyncLoad(&queue->head);
+}
+
+/*!
+ * @brief Queues a single DAC data frame
+ */
+static ad5697r_return_code_t ad5697r_asyncDac(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const AD5697R_CMD_t cmd, const ad5697r_output_channel_t ch, const uint16_t outputVal, ad5697r_async_cb_fptr_t cb, void *ctx) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frame[AD5697R_FRAME_SIZE];
+
+    if( (queue == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !ad5697r_encValidChannel(ch) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_packDacFrame(frame, cmd, ch, outputVal);
+    ret = ad5697r_asyncSubmit(queue, dev->intf.i2c_addr, frame, sizeof(frame), cb, ctx);
+
+    // The device state is only known once the request completes
+    if( ret == AD5697R_RET_OK ) {
+        dev->registers.bits.valid &= ~ad5697r_shadowDacFlags(ch);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API queues a write and update of the specified channel(s)
+ */
+ad5697r_return_code_t ad5697r_asyncWriteChannel(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal, ad5697r_async_cb_fptr_t cb, void *ctx) {
+    return ad5697r_asyncDac(queue, dev, AD5697R_CMD_WRITE_DAC, ch, outputVal, cb, ctx);
+}
+
+/*!
+ * @brief This API queues a write of the input register(s) of the specified channel(s)
+ */
+ad5697r_return_code_t ad5697r_asyncWriteInputRegister(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal, ad5697r_async_cb_fptr_t cb, void *ctx) {
+    return ad5697r_asyncDac(queue, dev, AD5697R_CMD_W_INPUT_REG_N, ch, outputVal, cb, ctx);
+}
+
+/*!
+ * @brief This API queues a synchronized update of both channels as one request
+ */
+ad5697r_return_code_t ad5697r_asyncWriteChannelsSynchronized(ad5697r_async_queue_t *queue, ad5697r_dev_t *dev, const uint16_t outputValA, const uint16_t outputValB, ad5697r_async_cb_fptr_t cb, void *ctx) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t frames[AD5697R_BATCH_BUF_SIZE(3)];
+
+    if( (queue == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ad5697r_packDacFrame(&frames[0], AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A, outputValA);
+    ad5697r_packDacFrame(&frames[3], AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_B, outputValB);
+    ad5697r_packDacFrame(&frames[6], AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, AD5697R_OUTPUT_CH_A_B, 0);
+    ret = ad5697r_asyncSubmit(queue, dev->intf.i2c_addr, frames, sizeof(frames), cb, ctx);
+
+    if( ret == AD5697R_RET_OK ) {
+        dev->registers.bits.valid &= ~ad5697r_shadowDacFlags(AD5697R_OUTPUT_CH_A_B);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Synchronous write interface function over the selected queue
+ */
+int8_t ad5697r_asyncWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    ad5697r_async_queue_t *queue = ad5697r_asyncQueue;
+    ad5697r_async_wait_t wait = { 0, AD5697R_RET_OK };
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+
+    if( (queue == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    // Splitting would break the single transaction batches and sequences rely on
+    else if( (len == 0) || (len > AD5697R_ASYNC_MAX_LEN) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // Wait for a free slot, the transport drains the ring in the meantime
+    do {
+        ret = ad5697r_asyncSubmit(queue, busAddr, data, len, ad5697r_asyncWaitDone, &wait);
+        if( (ret == AD5697R_RET_BUSY) && (queue->idle != NULL) ) {
+            queue->idle(queue->idleCtx);
+        }
+    } while( ret == AD5697R_RET_BUSY );
+
+    if( ret == AD5697R_RET_OK ) {
+        while( __atomic_load_n(&wait.done, __ATOMIC_SEQ_CST) == 0 ) {
+            if( queue->idle != NULL ) {
+                queue->idle(queue->idleCtx);
+            }
+        }
+        ret = wait.ret;
+    }
+
+    return ret;
+}
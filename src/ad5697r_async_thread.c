@@ -0,0 +1,138 @@
+/*! @file ad5697r_async_thread.c
+ * @brief Thread-backed asynchronous transport for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_async_thread.h"
+
+/*!
+ * @brief Start hook, hands the transfer to the worker and returns
+ */
+static ad5697r_return_code_t ad5697r_asyncThreadStartHook(void *ctx, const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    ad5697r_async_thread_t *worker = (ad5697r_async_thread_t *)ctx;
+
+    pthread_mutex_lock(&worker->lock);
+    if( !worker->running ) {
+        pthread_mutex_unlock(&worker->lock);
+        return AD5697R_RET_ERROR;
+    }
+
+    worker->busAddr = busAddr;
+    worker->data = data;
+    worker->len = len;
+    worker->pending = true;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->lock);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Idle hook, blocks until the worker signals the next completion
+ */
+static void ad5697r_asyncThreadIdle(void *ctx) {
+    ad5697r_async_thread_t *worker = (ad5697r_async_thread_t *)ctx;
+    uint32_t seen = 0;
+
+    pthread_mutex_lock(&worker->lock);
+    seen = worker->completions;
+    while( worker->running && (worker->pending || (ad5697r_asyncGetPending(worker->queue) > 0)) && (worker->completions == seen) ) {
+        pthread_cond_wait(&worker->cond, &worker->lock);
+    }
+    pthread_mutex_unlock(&worker->lock);
+}
+
+/*!
+ * @brief Worker thread, runs the blocking write for each started transfer
+ */
+static void *ad5697r_asyncThreadMain(void *arg) {
+    ad5697r_async_thread_t *worker = (ad5697r_async_thread_t *)arg;
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t busAddr = 0;
+    const uint8_t *data = NULL;
+    uint32_t len = 0;
+
+    pthread_mutex_lock(&worker->lock);
+    while( true ) {
+        while( worker->running && !worker->pending ) {
+            pthread_cond_wait(&worker->cond, &worker->lock);
+        }
+        if( !worker->pending ) {
+            break;
+        }
+
+        busAddr = worker->busAddr;
+        data = worker->data;
+        len = worker->len;
+        worker->pending = false;
+        pthread_mutex_unlock(&worker->lock);
+
+        ret = worker->write(busAddr, data, len);
+
+        // Completing may start the next transfer, which takes the lock again
+        ad5697r_asyncComplete(worker->queue, ret);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->completions++;
+        pthread_cond_broadcast(&worker->cond);
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    return NULL;
+}
+
+/*!
+ * @brief This API initializes a queue backed by a worker thread and starts the worker
+ */
+ad5697r_return_code_t ad5697r_asyncThreadStart(ad5697r_async_thread_t *worker, ad5697r_async_queue_t *queue, ad5697r_async_req_t *ring, const uint32_t capacity, ad5697r_write_fptr_t write) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+
+    if( (worker == NULL) || (queue == NULL) || (write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ret = ad5697r_asyncInit(queue, ring, capacity, ad5697r_asyncThreadStartHook, worker);
+    if( ret != AD5697R_RET_OK ) {
+        return ret;
+    }
+
+    memset(worker, 0, sizeof(*worker));
+    worker->write = write;
+    worker->queue = queue;
+    worker->running = true;
+    pthread_mutex_init(&worker->lock, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+
+    if( pthread_create(&worker->thread, NULL, ad5697r_asyncThreadMain, worker) != 0 ) {
+        pthread_cond_destroy(&worker->cond);
+        pthread_mutex_destroy(&worker->lock);
+        worker->running = false;
+        return AD5697R_RET_ERROR;
+    }
+
+    return ad5697r_asyncSetIdle(queue, ad5697r_asyncThreadIdle, worker);
+}
+
+/*!
+ * @brief This API drains the queue, then stops and joins the worker
+ */
+ad5697r_return_code_t ad5697r_asyncThreadStop(ad5697r_async_thread_t *worker) {
+    if( worker == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    while( worker->running && (worker->pending || (ad5697r_asyncGetPending(worker->queue) > 0)) ) {
+        pthread_cond_wait(&worker->cond, &worker->lock);
+    }
+    worker->running = false;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->lock);
+
+    pthread_join(worker->thread, NULL);
+    pthread_cond_destroy(&worker->cond);
+    pthread_mutex_destroy(&worker->lock);
+
+    return AD5697R_RET_OK;
+}
@@ -0,0 +1,206 @@
+/*! @file ad5697r_capture.c
+ * @brief Bus capture and replay for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_capture.h"
+#include "ad5697r_priv.h"
+
+static const uint8_t ad5697r_captureMagic[4] = {'A', 'D', '5', '6'};
+
+/*!
+ * @brief Recorder the interface function acts on
+ */
+static ad5697r_capture_t *ad5697r_captureActive = NULL;
+
+/*!
+ * @brief Hands the buffered records to the sink
+ */
+static ad5697r_return_code_t ad5697r_captureDrain(ad5697r_capture_t *cap) {
+    int8_t ret = AD5697R_RET_OK;
+
+    if( cap->len == 0 ) {
+        return AD5697R_RET_OK;
+    }
+
+    ret = cap->config.sink(cap->config.sinkCtx, cap->buf, cap->len);
+    if( ret == AD5697R_RET_OK ) {
+        cap->stats.flushes++;
+        cap->headerSent = true;
+    }
+    else {
+        cap->stats.dropped += cap->pending;
+    }
+
+    // The records of a failed chunk are lost, the file header has to go out with the next one
+    cap->len = cap->headerSent ? 0 : AD5697R_CAPTURE_HEADER_SIZE;
+    cap->pending = 0;
+
+    return ret;
+}
+
+/*!
+ * @brief Appends a write to the buffer as one record, flushing first when it does not fit
+ */
+static void ad5697r_captureRecord(ad5697r_capture_t *cap, const uint32_t stamp, const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    // A record is never split, so replay keeps the transaction boundaries
+    if( (len > AD5697R_CAPTURE_MAX_LEN) || (len > (cap->size - AD5697R_CAPTURE_RECORD_SIZE)) ) {
+        cap->stats.dropped++;
+        return;
+    }
+
+    if( (cap->len + AD5697R_CAPTURE_RECORD_SIZE + len) > cap->size ) {
+        ad5697r_captureDrain(cap);
+    }
+    // Still held up by the file header of a sink that never took it
+    if( (cap->len + AD5697R_CAPTURE_RECORD_SIZE + len) > cap->size ) {
+        cap->stats.dropped++;
+        return;
+    }
+
+    ad5697r_putLe(&cap->buf[cap->len], stamp, 4);
+    cap->buf[cap->len + 4] = busAddr;
+    ad5697r_putLe(&cap->buf[cap->len + 5], len, 2);
+    memcpy(&cap->buf[cap->len + AD5697R_CAPTURE_RECORD_SIZE], data, len);
+
+    cap->len += AD5697R_CAPTURE_RECORD_SIZE + len;
+    cap->pending++;
+
+    cap->stats.transactions++;
+    cap->stats.bytes += len;
+}
+
+/*!
+ * @brief This API initializes a recorder and selects it
+ */
+ad5697r_return_code_t ad5697r_captureInit(ad5697r_capture_t *cap, const ad5697r_capture_config_t *config, uint8_t *buf, const uint32_t size) {
+    if( (cap == NULL) || (config == NULL) || (buf == NULL) || (config->sink == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( size < AD5697R_CAPTURE_MIN_BUF_SIZE ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(cap, 0, sizeof(*cap));
+    cap->config = *config;
+    cap->buf = buf;
+    cap->size = size;
+
+    memset(buf, 0, AD5697R_CAPTURE_HEADER_SIZE);
+    memcpy(buf, ad5697r_captureMagic, sizeof(ad5697r_captureMagic));
+    buf[sizeof(ad5697r_captureMagic)] = AD5697R_CAPTURE_VERSION;
+    cap->len = AD5697R_CAPTURE_HEADER_SIZE;
+
+    ad5697r_captureActive = cap;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API selects the recorder used by the interface function
+ */
+ad5697r_return_code_t ad5697r_captureSelect(ad5697r_capture_t *cap) {
+    if( cap == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ad5697r_captureActive = cap;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API hands every buffered record to the sink
+ */
+ad5697r_return_code_t ad5697r_captureFlush(ad5697r_capture_t *cap) {
+    if( cap == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    return ad5697r_captureDrain(cap);
+}
+
+/*!
+ * @brief ad5697r_write_fptr_t implementation that records the writes on the selected recorder
+ */
+int8_t ad5697r_captureWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    ad5697r_capture_t *cap = ad5697r_captureActive;
+    int8_t ret = AD5697R_RET_OK;
+    uint32_t stamp = 0;
+
+    if( (cap == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    if( cap->config.get_time_us != NULL ) {
+        stamp = cap->config.get_time_us();
+    }
+    if( cap->config.write != NULL ) {
+        ret = cap->config.write(busAddr, data, len);
+    }
+
+    // Recorded after the transport so the copy stays off the write latency
+    ad5697r_captureRecord(cap, stamp, busAddr, data, len);
+
+    return ret;
+}
+
+/*!
+ * @brief This API replays a capture
+ */
+ad5697r_return_code_t ad5697r_captureReplay(const uint8_t *capture, const uint32_t len, const ad5697r_write_fptr_t write,
+                                            const ad5697r_delay_us_fptr_t delay_us, uint32_t *transactions) {
+    int8_t ret = AD5697R_RET_OK;
+    uint32_t prevStamp = 0;
+    uint32_t stamp = 0;
+    uint32_t recLen = 0;
+    uint32_t off = 0;
+    uint32_t count = 0;
+
+    if( transactions != NULL ) {
+        *transactions = 0;
+    }
+    if( (capture == NULL) || (write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (len < AD5697R_CAPTURE_HEADER_SIZE) || (memcmp(capture, ad5697r_captureMagic, sizeof(ad5697r_captureMagic)) != 0) ||
+             (capture[sizeof(ad5697r_captureMagic)] != AD5697R_CAPTURE_VERSION) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // Walk the records once so a truncated capture is rejected up front
+    for( off = AD5697R_CAPTURE_HEADER_SIZE; off < len; off += AD5697R_CAPTURE_RECORD_SIZE + recLen ) {
+        if( (len - off) < AD5697R_CAPTURE_RECORD_SIZE ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+
+        recLen = ad5697r_getLe(&capture[off + 5], 2);
+        if( (len - off - AD5697R_CAPTURE_RECORD_SIZE) < recLen ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+    }
+
+    for( off = AD5697R_CAPTURE_HEADER_SIZE; off < len; off += AD5697R_CAPTURE_RECORD_SIZE + recLen ) {
+        stamp = ad5697r_getLe(&capture[off], 4);
+        recLen = ad5697r_getLe(&capture[off + 5], 2);
+
+        if( (delay_us != NULL) && (count > 0) && (stamp != prevStamp) ) {
+            delay_us(stamp - prevStamp);
+        }
+        prevStamp = stamp;
+
+        ret = write(capture[off + 4], &capture[off + AD5697R_CAPTURE_RECORD_SIZE], recLen);
+        if( ret != AD5697R_RET_OK ) {
+            break;
+        }
+
+        count++;
+    }
+
+    if( transactions != NULL ) {
+        *transactions = count;
+    }
+
+    return ret;
+}
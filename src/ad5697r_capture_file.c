@@ -0,0 +1,97 @@
+/*! @file ad5697r_capture_file.c
+ * @brief Capture files on POSIX hosts for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ad5697r_capture_file.h"
+
+/*!
+ * @brief ad5697r_capture_sink_fptr_t implementation that appends the chunks to a file
+ */
+int8_t ad5697r_captureFileSink(void *ctx, const uint8_t *data, const uint32_t len) {
+    uint32_t off = 0;
+    ssize_t n = 0;
+
+    if( (ctx == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    while( off < len ) {
+        n = write(*(int *)ctx, &data[off], len - off);
+        if( n < 0 ) {
+            if( errno == EINTR ) {
+                continue;
+            }
+            return AD5697R_RET_ERROR;
+        }
+        off += (uint32_t)n;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API maps a capture file read-only
+ */
+ad5697r_return_code_t ad5697r_captureMap(ad5697r_capture_map_t *map, const char *path) {
+    struct stat st;
+    void *data = NULL;
+    int fd = -1;
+
+    if( (map == NULL) || (path == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    map->data = NULL;
+    map->len = 0;
+
+    fd = open(path, O_RDONLY);
+    if( fd < 0 ) {
+        return AD5697R_RET_ERROR;
+    }
+    if( (fstat(fd, &st) < 0) || (st.st_size <= 0) || ((uint64_t)st.st_size > UINT32_MAX) ) {
+        close(fd);
+        return AD5697R_RET_ERROR;
+    }
+
+    // The mapping outlives the descriptor
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if( data == MAP_FAILED ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    // Replay walks the records front to back
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    map->data = (const uint8_t *)data;
+    map->len = (uint32_t)st.st_size;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API unmaps a capture file
+ */
+ad5697r_return_code_t ad5697r_captureUnmap(ad5697r_capture_map_t *map) {
+    if( map == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( map->data == NULL ) {
+        return AD5697R_RET_OK;
+    }
+
+    if( munmap((void *)map->data, map->len) < 0 ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    map->data = NULL;
+    map->len = 0;
+
+    return AD5697R_RET_OK;
+}
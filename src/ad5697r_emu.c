@@ -0,0 +1,392 @@
+/*! @file ad5697r_emu.c
+ * @brief Software device model and simulated I2C bus for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_emu.h"
+#include "ad5697r_priv.h"
+
+#define AD5697R_EMU_CH_A            (0)     /*! @brief Register index of channel A */
+#define AD5697R_EMU_CH_B            (1)     /*! @brief Register index of channel B */
+#define AD5697R_EMU_READ_SLOTS      (4)     /*! @brief Readback slots, A, two don't care slots and B */
+#define AD5697R_EMU_INTERNAL_VREF   (2.5f)  /*! @brief Internal reference voltage */
+
+/*!
+ * @brief Bus the interface functions act on
+ */
+static ad5697r_emu_bus_t *ad5697r_emuBus = NULL;
+
+/*!
+ * @brief Finds the device with the provided address on the bus
+ */
+static ad5697r_emu_dev_t *ad5697r_emuFind(ad5697r_emu_bus_t *bus, const uint8_t busAddr) {
+    uint8_t i = 0;
+
+    for( i = 0; i < AD5697R_EMU_MAX_DEVICES; i++ ) {
+        if( (bus->devices[i] != NULL) && (bus->devices[i]->i2c_addr == busAddr) ) {
+            return bus->devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ * @brief Accounts a transaction on the bus
+ */
+static void ad5697r_emuAccount(ad5697r_emu_bus_t *bus, const uint32_t len) {
+    bus->transactions++;
+    bus->wireBytes += len + 1;
+    bus->busTimeNs += ad5697r_getTransactionTimeNs(bus->clockHz, len);
+}
+
+/*!
+ * @brief Applies the power-on reset state to the device registers
+ */
+static void ad5697r_emuPowerOnReset(ad5697r_emu_dev_t *emu) {
+    uint16_t code = emu->rstsel ? 0x0800 : 0x0000;
+    uint8_t i = 0;
+
+    for( i = 0; i < 2; i++ ) {
+        emu->input[i] = code;
+        emu->dac[i] = code;
+        emu->powerMode[i] = AD5697R_OP_MODE_NORMAL;
+    }
+
+    emu->ldacMask = 0;
+    emu->refOff = 0;
+    emu->readSlot = 0;
+}
+
+/*!
+ * @brief Executes a single 24-bit frame
+ */
+static void ad5697r_emuExecute(ad5697r_emu_dev_t *emu, const uint8_t *frame) {
+    uint8_t cmd = frame[0] >> 4;
+    uint8_t addr = frame[0] & 0x0F;
+    uint16_t data = ad5697r_decCode(&frame[1]);
+    const uint8_t chBit[2] = {AD5697R_OUTPUT_CH_A, AD5697R_OUTPUT_CH_B};
+    bool selected[2];
+    uint8_t i = 0;
+
+    selected[AD5697R_EMU_CH_A] = (addr & chBit[AD5697R_EMU_CH_A]) != 0;
+    selected[AD5697R_EMU_CH_B] = (addr & chBit[AD5697R_EMU_CH_B]) != 0;
+
+    emu->stats.frames++;
+    emu->stats.cmdCount[cmd]++;
+
+    switch( cmd ) {
+        case AD5697R_CMD_NO_OP:
+            // Selects the register to read back, A when both are addressed
+            emu->readSlot = (!selected[AD5697R_EMU_CH_A] && selected[AD5697R_EMU_CH_B]) ? 3 : 0;
+            break;
+
+        case AD5697R_CMD_W_INPUT_REG_N:
+        case AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N:
+        case AD5697R_CMD_WRITE_DAC:
+            for( i = 0; i < 2; i++ ) {
+                if( !selected[i] ) {
+                    continue;
+                }
+
+                if( cmd != AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N ) {
+                    emu->input[i] = data;
+                }
+
+                // The input register is transparent while !LDAC is held low,
+                // masked channels see the pin as high
+                if( (cmd != AD5697R_CMD_W_INPUT_REG_N) || (!emu->ldacPin && !(emu->ldacMask & chBit[i])) ) {
+                    emu->dac[i] = emu->input[i];
+                }
+            }
+            break;
+
+        case AD5697R_CMD_POWER_DAC:
+            emu->powerMode[AD5697R_EMU_CH_A] = frame[2] & 0x03;
+            emu->powerMode[AD5697R_EMU_CH_B] = (frame[2] >> 6) & 0x03;
+            break;
+
+        case AD5697R_CMD_HW_LDAC_MASK:
+            emu->ldacMask = frame[2] & (AD5697R_OUTPUT_CH_A | AD5697R_OUTPUT_CH_B);
+            break;
+
+        case AD5697R_CMD_SOFT_RESET:
+            ad5697r_emuPowerOnReset(emu);
+            break;
+
+        case AD5697R_CMD_INT_REF_SETUP:
+            emu->refOff = frame[2] & 0x01;
+            break;
+
+        default:
+            emu->stats.invalidFrames++;
+            break;
+    }
+}
+
+/*!
+ * @brief Delivers one write message to the addressed device
+ *
+ * @param[out] *acked: Data bytes acknowledged by the device
+ */
+static int8_t ad5697r_emuDeliver(ad5697r_emu_bus_t *bus, const uint8_t busAddr, const uint8_t *data, const uint32_t len, uint32_t *acked) {
+    ad5697r_emu_dev_t *emu = ad5697r_emuFind(bus, busAddr);
+    uint32_t offset = 0;
+
+    *acked = 0;
+
+    if( emu == NULL ) {
+        // Nobody acknowledges the address byte
+        return AD5697R_RET_ERROR;
+    }
+
+    if( emu->injectCount > 0 ) {
+        emu->injectCount--;
+        return emu->injectRet;
+    }
+
+    *acked = len;
+    emu->stats.transactions++;
+
+    // Every 24th SCL edge latches a frame from the input shift register
+    for( offset = 0; (offset + AD5697R_FRAME_SIZE) <= len; offset += AD5697R_FRAME_SIZE ) {
+        ad5697r_emuExecute(emu, &data[offset]);
+    }
+
+    if( offset != len ) {
+        emu->stats.invalidFrames++;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API initializes a simulated bus
+ */
+ad5697r_return_code_t ad5697r_emuBusInit(ad5697r_emu_bus_t *bus, const uint32_t clockHz) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( clockHz == 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(bus, 0, sizeof(ad5697r_emu_bus_t));
+    bus->clockHz = clockHz;
+    ad5697r_emuBus = bus;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API selects the bus used by the interface functions
+ */
+ad5697r_return_code_t ad5697r_emuBusSelect(ad5697r_emu_bus_t *bus) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ad5697r_emuBus = bus;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API powers on an emulated device and attaches it to the bus
+ */
+ad5697r_return_code_t ad5697r_emuAttach(ad5697r_emu_bus_t *bus, ad5697r_emu_dev_t *emu, const uint8_t i2c_addr, const bool rstsel) {
+    uint8_t i = 0;
+
+    if( (bus == NULL) || (emu == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( i2c_addr > 0x7F ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    for( i = 0; i < AD5697R_EMU_MAX_DEVICES; i++ ) {
+        if( (bus->devices[i] != NULL) && (bus->devices[i]->i2c_addr == i2c_addr) ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+    }
+
+    for( i = 0; i < AD5697R_EMU_MAX_DEVICES; i++ ) {
+        if( bus->devices[i] == NULL ) {
+            memset(emu, 0, sizeof(ad5697r_emu_dev_t));
+            emu->i2c_addr = i2c_addr;
+            emu->rstsel = rstsel;
+            emu->ldacPin = true;
+            ad5697r_emuPowerOnReset(emu);
+
+            bus->devices[i] = emu;
+            return AD5697R_RET_OK;
+        }
+    }
+
+    return AD5697R_RET_ERROR;
+}
+
+/*!
+ * @brief This API resets the bus time and transfer counters
+ */
+ad5697r_return_code_t ad5697r_emuBusResetStats(ad5697r_emu_bus_t *bus) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    bus->busTimeNs = 0;
+    bus->transactions = 0;
+    bus->wireBytes = 0;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief ad5697r_write_fptr_t implementation that decodes the frames on the selected bus
+ */
+int8_t ad5697r_emuWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    int8_t ret = AD5697R_RET_OK;
+    uint32_t acked = 0;
+
+    if( (ad5697r_emuBus == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ret = ad5697r_emuDeliver(ad5697r_emuBus, busAddr, data, len, &acked);
+    ad5697r_emuAccount(ad5697r_emuBus, acked);
+
+    return ret;
+}
+
+/*!
+ * @brief ad5697r_bus_xfer_fptr_t implementation that runs a combined transaction
+ * on the bus passed as context
+ */
+int8_t ad5697r_emuTransfer(void *ctx, const ad5697r_bus_msg_t *msgs, const uint32_t count) {
+    ad5697r_emu_bus_t *bus = (ad5697r_emu_bus_t *)ctx;
+    int8_t ret = AD5697R_RET_OK;
+    uint32_t acked = 0;
+    uint32_t bytes = 0;
+    uint32_t i = 0;
+
+    if( (bus == NULL) || (msgs == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( count == 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // The master sends a STOP after the first message that is not acknowledged
+    for( i = 0; (i < count) && (ret == AD5697R_RET_OK); i++ ) {
+        ret = ad5697r_emuDeliver(bus, msgs[i].busAddr, msgs[i].data, msgs[i].len, &acked);
+        bytes += acked + 1;
+    }
+
+    // One START and STOP, a repeated START and an address byte per message
+    bus->transactions++;
+    bus->wireBytes += bytes;
+    bus->busTimeNs += ad5697r_getTransactionTimeNs(bus->clockHz, bytes - 1);
+    if( bus->clockHz > 0 ) {
+        bus->busTimeNs += ((uint64_t)(i - 1) * 1000000000u) / bus->clockHz;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief ad5697r_read_fptr_t implementation that reads back the input registers on the selected bus
+ */
+int8_t ad5697r_emuRead(const uint8_t busAddr, uint8_t *data, const uint32_t len) {
+    ad5697r_emu_dev_t *emu = NULL;
+    uint32_t i = 0;
+
+    if( (ad5697r_emuBus == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    emu = ad5697r_emuFind(ad5697r_emuBus, busAddr);
+    if( emu == NULL ) {
+        ad5697r_emuAccount(ad5697r_emuBus, 0);
+        return AD5697R_RET_ERROR;
+    }
+
+    if( emu->injectCount > 0 ) {
+        emu->injectCount--;
+        ad5697r_emuAccount(ad5697r_emuBus, 0);
+        return emu->injectRet;
+    }
+
+    ad5697r_emuAccount(ad5697r_emuBus, len);
+    emu->stats.reads++;
+
+    // Two bytes per slot, auto-incrementing A, don't care, don't care, B
+    for( i = 0; i < len; i++ ) {
+        uint8_t slot = (uint8_t)((emu->readSlot + (i / 2)) % AD5697R_EMU_READ_SLOTS);
+        uint16_t code = 0x0000;
+
+        if( slot == 0 ) {
+            code = emu->input[AD5697R_EMU_CH_A];
+        }
+        else if( slot == 3 ) {
+            code = emu->input[AD5697R_EMU_CH_B];
+        }
+
+        data[i] = (i & 0x01) ? (uint8_t)(code << 4) : (uint8_t)(code >> 4);
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API drives the !LDAC pin of the device
+ */
+ad5697r_return_code_t ad5697r_emuSetLdacPin(ad5697r_emu_dev_t *emu, const bool level) {
+    if( emu == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    // Masked channels see the pin as high and ignore the edge
+    if( emu->ldacPin && !level ) {
+        if( !(emu->ldacMask & AD5697R_OUTPUT_CH_A) ) {
+            emu->dac[AD5697R_EMU_CH_A] = emu->input[AD5697R_EMU_CH_A];
+        }
+        if( !(emu->ldacMask & AD5697R_OUTPUT_CH_B) ) {
+            emu->dac[AD5697R_EMU_CH_B] = emu->input[AD5697R_EMU_CH_B];
+        }
+    }
+
+    emu->ldacPin = level;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API makes the next transactions addressed to the device fail
+ */
+ad5697r_return_code_t ad5697r_emuInjectError(ad5697r_emu_dev_t *emu, const ad5697r_return_code_t ret, const uint32_t count) {
+    if( emu == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    emu->injectRet = ret;
+    emu->injectCount = count;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API returns the output voltage of a DAC channel
+ */
+float ad5697r_emuGetOutputVoltage(const ad5697r_emu_dev_t *emu, const ad5697r_output_channel_t ch, const float vrefExt, const uint8_t gain) {
+    uint8_t idx = (ch == AD5697R_OUTPUT_CH_B) ? AD5697R_EMU_CH_B : AD5697R_EMU_CH_A;
+    float vref = 0.0f;
+
+    if( (emu == NULL) || (emu->powerMode[idx] != AD5697R_OP_MODE_NORMAL) ) {
+        return 0.0f;
+    }
+
+    vref = emu->refOff ? vrefExt : AD5697R_EMU_INTERNAL_VREF;
+
+    return (vref * (float)((gain == 2) ? 2 : 1) * (float)emu->dac[idx]) / 4096.0f;
+}
@@ -0,0 +1,331 @@
+/*! @file ad5697r_fleet.c
+ * @brief Multi-device bus manager for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_fleet.h"
+#include "ad5697r_priv.h"
+
+#define AD5697R_FLEET_VALID     (0x80000000u)   /*! @brief Marks a pending code in the latest slots */
+
+/*!
+ * @brief Finds the node of a registered device
+ */
+static ad5697r_fleet_node_t *ad5697r_fleetFind(ad5697r_fleet_t *fleet, const ad5697r_dev_t *dev, ad5697r_fleet_bus_t **bus) {
+    uint32_t i = 0;
+    uint8_t j = 0;
+
+    for( i = 0; i < fleet->count; i++ ) {
+        for( j = 0; j < fleet->buses[i].count; j++ ) {
+            if( fleet->buses[i].nodes[j].dev == dev ) {
+                *bus = &fleet->buses[i];
+                return &fleet->buses[i].nodes[j];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ * @brief Puts codes taken by a failed flush back, unless a newer post replaced them
+ */
+static void ad5697r_fleetRestore(ad5697r_fleet_bus_t *bus, uint32_t (*taken)[2]) {
+    uint32_t empty = 0;
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    for( i = 0; i < bus->count; i++ ) {
+        for( j = 0; j < 2; j++ ) {
+            empty = 0;
+            if( taken[i][j] & AD5697R_FLEET_VALID ) {
+                __atomic_compare_exchange_n(&bus->nodes[i].latest[j], &empty, taken[i][j], false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            }
+        }
+    }
+}
+
+/*!
+ * @brief This API initializes a fleet over caller provided buses
+ */
+ad5697r_return_code_t ad5697r_fleetInit(ad5697r_fleet_t *fleet, ad5697r_fleet_bus_t *buses, const uint32_t count) {
+    if( (fleet == NULL) || (buses == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( count == 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(buses, 0, count * sizeof(*buses));
+    fleet->buses = buses;
+    fleet->count = count;
+    fleet->ldac = NULL;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the transfer function of a bus
+ */
+ad5697r_return_code_t ad5697r_fleetSetBus(ad5697r_fleet_t *fleet, const uint32_t bus, ad5697r_bus_xfer_fptr_t xfer, void *ctx) {
+    if( (fleet == NULL) || (fleet->buses == NULL) || (xfer == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( bus >= fleet->count ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    fleet->buses[bus].xfer = xfer;
+    fleet->buses[bus].ctx = ctx;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the hook called when a bus gets pending updates
+ */
+ad5697r_return_code_t ad5697r_fleetSetNotify(ad5697r_fleet_t *fleet, const uint32_t bus, ad5697r_fleet_notify_fptr_t notify, void *notifyCtx) {
+    if( (fleet == NULL) || (fleet->buses == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( bus >= fleet->count ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    fleet->buses[bus].notify = notify;
+    fleet->buses[bus].notifyCtx = notifyCtx;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the !LDAC pin shared by the fleet
+ */
+ad5697r_return_code_t ad5697r_fleetSetLdac(ad5697r_fleet_t *fleet, ad5697r_ldac_fptr_t ldac) {
+    uint32_t i = 0;
+
+    if( (fleet == NULL) || (fleet->buses == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    fleet->ldac = ldac;
+    for( i = 0; i < fleet->count; i++ ) {
+        fleet->buses[i].staged = (ldac != NULL);
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API registers a device on a bus
+ */
+ad5697r_return_code_t ad5697r_fleetAttach(ad5697r_fleet_t *fleet, const uint32_t bus, ad5697r_dev_t *dev) {
+    ad5697r_fleet_bus_t *owner = NULL;
+    ad5697r_fleet_bus_t *target = NULL;
+    uint8_t i = 0;
+
+    if( (fleet == NULL) || (fleet->buses == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (bus >= fleet->count) || (dev->intf.i2c_addr > 0x7F) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+    else if( ad5697r_fleetFind(fleet, dev, &owner) != NULL ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    target = &fleet->buses[bus];
+    if( target->count >= AD5697R_FLEET_BUS_DEVICES ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    for( i = 0; i < target->count; i++ ) {
+        if( target->nodes[i].dev->intf.i2c_addr == dev->intf.i2c_addr ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+    }
+
+    target->nodes[target->count].dev = dev;
+    target->nodes[target->count].latest[0] = 0;
+    target->nodes[target->count].latest[1] = 0;
+    target->count++;
+
+    dev->registers.bits.valid = 0;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API stages an update for a registered device
+ */
+ad5697r_return_code_t ad5697r_fleetPost(ad5697r_fleet_t *fleet, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    ad5697r_fleet_bus_t *bus = NULL;
+    ad5697r_fleet_node_t *node = NULL;
+    uint8_t idle = 0;
+
+    if( (fleet == NULL) || (fleet->buses == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (ch != AD5697R_OUTPUT_CH_A) && (ch != AD5697R_OUTPUT_CH_B) && (ch != AD5697R_OUTPUT_CH_A_B) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    node = ad5697r_fleetFind(fleet, dev, &bus);
+    if( node == NULL ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( ch & AD5697R_OUTPUT_CH_A ) {
+        __atomic_store_n(&node->latest[0], AD5697R_FLEET_VALID | outputVal, __ATOMIC_SEQ_CST);
+    }
+    if( ch & AD5697R_OUTPUT_CH_B ) {
+        __atomic_store_n(&node->latest[1], AD5697R_FLEET_VALID | outputVal, __ATOMIC_SEQ_CST);
+    }
+
+    // Only the post that makes the bus pending wakes its worker
+    if( __atomic_compare_exchange_n(&bus->pending, &idle, 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) &&
+        (bus->notify != NULL) ) {
+        bus->notify(bus->notifyCtx);
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API writes the pending updates of one bus as one combined transaction
+ */
+ad5697r_return_code_t ad5697r_fleetFlushBus(ad5697r_fleet_bus_t *bus) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint32_t taken[AD5697R_FLEET_BUS_DEVICES][2];
+    uint32_t latestA = 0;
+    uint32_t latestB = 0;
+    uint8_t ch = 0;
+    uint32_t updates = 0;
+    uint32_t count = 0;
+    uint8_t *frame = NULL;
+    AD5697R_CMD_t cmd = AD5697R_CMD_WRITE_DAC;
+    uint8_t i = 0;
+
+    if( (bus == NULL) || (bus->xfer == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    if( bus->staged ) {
+        cmd = AD5697R_CMD_W_INPUT_REG_N;
+    }
+
+    // Clear the flag first so a racing post notifies again
+    __atomic_store_n(&bus->pending, 0, __ATOMIC_SEQ_CST);
+
+    for( i = 0; i < bus->count; i++ ) {
+        latestA = __atomic_exchange_n(&bus->nodes[i].latest[0], 0, __ATOMIC_SEQ_CST);
+        latestB = __atomic_exchange_n(&bus->nodes[i].latest[1], 0, __ATOMIC_SEQ_CST);
+        taken[i][0] = latestA;
+        taken[i][1] = latestB;
+        frame = bus->frames[count];
+
+        if( (latestA & AD5697R_FLEET_VALID) && (latestA == latestB) ) {
+            // Same code on both channels, one frame addresses both
+            ad5697r_packDacFrame(frame, cmd, AD5697R_OUTPUT_CH_A_B, (uint16_t)latestA);
+            frame += AD5697R_FRAME_SIZE;
+            updates += 2;
+        }
+        else {
+            if( latestA & AD5697R_FLEET_VALID ) {
+                ad5697r_packDacFrame(frame, cmd, AD5697R_OUTPUT_CH_A, (uint16_t)latestA);
+                frame += AD5697R_FRAME_SIZE;
+                updates++;
+            }
+            if( latestB & AD5697R_FLEET_VALID ) {
+                ad5697r_packDacFrame(frame, cmd, AD5697R_OUTPUT_CH_B, (uint16_t)latestB);
+                frame += AD5697R_FRAME_SIZE;
+                updates++;
+            }
+        }
+
+        if( frame != bus->frames[count] ) {
+            // The frames bypass the device, so what its shadow holds for the channels goes stale
+            ch = (uint8_t)(((latestA & AD5697R_FLEET_VALID) ? AD5697R_OUTPUT_CH_A : 0) |
+                           ((latestB & AD5697R_FLEET_VALID) ? AD5697R_OUTPUT_CH_B : 0));
+            bus->nodes[i].dev->registers.bits.valid &= ~ad5697r_shadowDacFlags(ch);
+
+            bus->msgs[count].busAddr = bus->nodes[i].dev->intf.i2c_addr;
+            bus->msgs[count].data = bus->frames[count];
+            bus->msgs[count].len = (uint32_t)(frame - bus->frames[count]);
+            count++;
+        }
+    }
+
+    if( count == 0 ) {
+        return AD5697R_RET_OK;
+    }
+
+    ret = bus->xfer(bus->ctx, bus->msgs, count);
+
+    bus->stats.transactions++;
+    if( ret == AD5697R_RET_OK ) {
+        bus->stats.messages += count;
+        bus->stats.updates += updates;
+    }
+    else {
+        // Retry the codes with the next flush
+        ad5697r_fleetRestore(bus, taken);
+        bus->stats.errors++;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API flushes every bus of the fleet in turn
+ */
+ad5697r_return_code_t ad5697r_fleetFlush(ad5697r_fleet_t *fleet) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_return_code_t busRet = AD5697R_RET_OK;
+    uint32_t i = 0;
+
+    if( (fleet == NULL) || (fleet->buses == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    for( i = 0; i < fleet->count; i++ ) {
+        if( fleet->buses[i].xfer == NULL ) {
+            continue;
+        }
+
+        busRet = ad5697r_fleetFlushBus(&fleet->buses[i]);
+        if( ret == AD5697R_RET_OK ) {
+            ret = busRet;
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API flushes every bus, then pulses !LDAC once
+ */
+ad5697r_return_code_t ad5697r_fleetCommit(ad5697r_fleet_t *fleet) {
+    ad5697r_return_code_t ret = ad5697r_fleetFlush(fleet);
+
+    if( ret == AD5697R_RET_OK ) {
+        ret = ad5697r_fleetPulseLdac(fleet);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API pulses the shared !LDAC pin
+ */
+ad5697r_return_code_t ad5697r_fleetPulseLdac(ad5697r_fleet_t *fleet) {
+    if( (fleet == NULL) || (fleet->ldac == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    fleet->ldac(false);
+    fleet->ldac(true);
+
+    return AD5697R_RET_OK;
+}
@@ -0,0 +1,156 @@
+/*! @file ad5697r_fleet_thread.c
+ * @brief Fleet bus worker threads for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_fleet_thread.h"
+
+/*!
+ * @brief Pending hook, wakes the worker of the bus
+ */
+static void ad5697r_fleetThreadNotify(void *ctx) {
+    ad5697r_fleet_worker_t *worker = (ad5697r_fleet_worker_t *)ctx;
+
+    pthread_mutex_lock(&worker->lock);
+    worker->signalled = true;
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+/*!
+ * @brief Worker thread, flushes its bus whenever updates are pending
+ */
+static void *ad5697r_fleetThreadMain(void *arg) {
+    ad5697r_fleet_worker_t *worker = (ad5697r_fleet_worker_t *)arg;
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    bool running = true;
+
+    while( running ) {
+        pthread_mutex_lock(&worker->lock);
+        while( worker->running && !worker->signalled ) {
+            pthread_cond_wait(&worker->cond, &worker->lock);
+        }
+        worker->signalled = false;
+        worker->busy = true;
+        running = worker->running;
+        pthread_mutex_unlock(&worker->lock);
+
+        // Errors are also counted in the bus statistics
+        ret = ad5697r_fleetFlushBus(worker->bus);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->busy = false;
+        worker->result = ret;
+        pthread_cond_broadcast(&worker->idle);
+        pthread_mutex_unlock(&worker->lock);
+    }
+
+    return NULL;
+}
+
+/*!
+ * @brief Stops and joins the first count workers
+ */
+static void ad5697r_fleetThreadJoin(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers, const uint32_t count) {
+    uint32_t i = 0;
+
+    for( i = 0; i < count; i++ ) {
+        // The worker flushes once more on its way out
+        pthread_mutex_lock(&workers[i].lock);
+        workers[i].running = false;
+        pthread_cond_signal(&workers[i].cond);
+        pthread_mutex_unlock(&workers[i].lock);
+    }
+
+    for( i = 0; i < count; i++ ) {
+        pthread_join(workers[i].thread, NULL);
+        ad5697r_fleetSetNotify(fleet, i, NULL, NULL);
+        pthread_cond_destroy(&workers[i].idle);
+        pthread_cond_destroy(&workers[i].cond);
+        pthread_mutex_destroy(&workers[i].lock);
+    }
+}
+
+/*!
+ * @brief This API starts one worker per bus of the fleet
+ */
+ad5697r_return_code_t ad5697r_fleetThreadStart(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers) {
+    uint32_t i = 0;
+
+    if( (fleet == NULL) || (fleet->buses == NULL) || (workers == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    for( i = 0; i < fleet->count; i++ ) {
+        if( fleet->buses[i].xfer == NULL ) {
+            return AD5697R_RET_NULL_PTR;
+        }
+    }
+
+    for( i = 0; i < fleet->count; i++ ) {
+        memset(&workers[i], 0, sizeof(workers[i]));
+        workers[i].bus = &fleet->buses[i];
+        workers[i].running = true;
+        workers[i].signalled = true;    // Pick up updates posted before the start
+        pthread_mutex_init(&workers[i].lock, NULL);
+        pthread_cond_init(&workers[i].cond, NULL);
+        pthread_cond_init(&workers[i].idle, NULL);
+
+        // Hook up before the worker runs, a post racing its first flush must still wake it
+        ad5697r_fleetSetNotify(fleet, i, ad5697r_fleetThreadNotify, &workers[i]);
+
+        if( pthread_create(&workers[i].thread, NULL, ad5697r_fleetThreadMain, &workers[i]) != 0 ) {
+            ad5697r_fleetSetNotify(fleet, i, NULL, NULL);
+            pthread_cond_destroy(&workers[i].idle);
+            pthread_cond_destroy(&workers[i].cond);
+            pthread_mutex_destroy(&workers[i].lock);
+            ad5697r_fleetThreadJoin(fleet, workers, i);
+            return AD5697R_RET_ERROR;
+        }
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API waits for the workers to write the posted updates, then pulses !LDAC once
+ */
+ad5697r_return_code_t ad5697r_fleetThreadCommit(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint32_t i = 0;
+
+    if( (fleet == NULL) || (fleet->buses == NULL) || (workers == NULL) || (fleet->ldac == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    for( i = 0; i < fleet->count; i++ ) {
+        pthread_mutex_lock(&workers[i].lock);
+        while( workers[i].signalled || workers[i].busy ) {
+            pthread_cond_wait(&workers[i].idle, &workers[i].lock);
+        }
+        if( ret == AD5697R_RET_OK ) {
+            ret = workers[i].result;
+        }
+        pthread_mutex_unlock(&workers[i].lock);
+    }
+
+    if( ret != AD5697R_RET_OK ) {
+        return ret;
+    }
+
+    return ad5697r_fleetPulseLdac(fleet);
+}
+
+/*!
+ * @brief This API writes the remaining updates, then stops and joins the workers
+ */
+ad5697r_return_code_t ad5697r_fleetThreadStop(ad5697r_fleet_t *fleet, ad5697r_fleet_worker_t *workers) {
+    if( (fleet == NULL) || (fleet->buses == NULL) || (workers == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ad5697r_fleetThreadJoin(fleet, workers, fleet->count);
+
+    return AD5697R_RET_OK;
+}
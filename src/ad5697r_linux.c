@@ -0,0 +1,418 @@
+/*! @file ad5697r_linux.c
+ * @brief Linux i2c-dev transport backend for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "ad5697r_linux.h"
+
+#define AD5697R_LINUX_SMBUS_CHUNK   (I2C_SMBUS_BLOCK_MAX + 1)   /*! @brief Bytes per SMBus block write, command byte included */
+
+/*!
+ * @brief Adapter the interface functions act on
+ */
+static ad5697r_linux_bus_t *ad5697r_linuxBus = NULL;
+
+/*!
+ * @brief Clears the queued messages
+ */
+static void ad5697r_linuxClear(ad5697r_linux_bus_t *bus) {
+    bus->len = 0;
+    bus->nmsgs = 0;
+}
+
+/*!
+ * @brief Selects the device addressed by SMBus transfers
+ */
+static ad5697r_return_code_t ad5697r_linuxSetSlave(ad5697r_linux_bus_t *bus, const uint8_t busAddr) {
+    if( bus->slaveAddr == busAddr ) {
+        return AD5697R_RET_OK;
+    }
+
+    bus->stats.ioctls++;
+    if( ioctl(bus->fd, I2C_SLAVE, (unsigned long)busAddr) < 0 ) {
+        bus->stats.errors++;
+        bus->slaveAddr = 0;
+        return AD5697R_RET_ERROR;
+    }
+
+    bus->slaveAddr = busAddr;
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Issues one SMBus transfer
+ */
+static ad5697r_return_code_t ad5697r_linuxSmbus(ad5697r_linux_bus_t *bus, const uint8_t rw, const uint8_t cmd, const uint32_t size, union i2c_smbus_data *data) {
+    struct i2c_smbus_ioctl_data args;
+
+    args.read_write = rw;
+    args.command = cmd;
+    args.size = size;
+    args.data = data;
+
+    bus->stats.ioctls++;
+    if( ioctl(bus->fd, I2C_SMBUS, &args) < 0 ) {
+        bus->stats.errors++;
+        return (errno == EBUSY) ? AD5697R_RET_BUSY : (errno == ETIMEDOUT) ? AD5697R_RET_TIMEOUT : AD5697R_RET_ERROR;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Writes one message as SMBus I2C block writes. Chunks hold whole
+ * frames, so the device sees the same frames as with a single message.
+ */
+static ad5697r_return_code_t ad5697r_linuxSmbusWrite(ad5697r_linux_bus_t *bus, const struct i2c_msg *msg) {
+    ad5697r_return_code_t ret = ad5697r_linuxSetSlave(bus, (uint8_t)msg->addr);
+    union i2c_smbus_data data;
+    uint32_t off = 0;
+    uint32_t n = 0;
+
+    while( (ret == AD5697R_RET_OK) && (off < msg->len) ) {
+        n = msg->len - off;
+        if( n > AD5697R_LINUX_SMBUS_CHUNK ) {
+            n = AD5697R_LINUX_SMBUS_CHUNK;
+        }
+
+        if( n == 1 ) {
+            ret = ad5697r_linuxSmbus(bus, I2C_SMBUS_WRITE, msg->buf[off], I2C_SMBUS_BYTE, NULL);
+        }
+        else {
+            data.block[0] = (uint8_t)(n - 1);
+            memcpy(&data.block[1], &msg->buf[off + 1], n - 1);
+            ret = ad5697r_linuxSmbus(bus, I2C_SMBUS_WRITE, msg->buf[off], I2C_SMBUS_I2C_BLOCK_DATA, &data);
+        }
+        off += n;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Submits a list of messages, in one I2C_RDWR ioctl when the adapter
+ * supports it and as consecutive SMBus transfers otherwise
+ */
+static ad5697r_return_code_t ad5697r_linuxSubmit(ad5697r_linux_bus_t *bus, struct i2c_msg *msgs, const uint32_t nmsgs) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    struct i2c_rdwr_ioctl_data args;
+    uint32_t i = 0;
+
+    if( nmsgs == 0 ) {
+        return AD5697R_RET_OK;
+    }
+    if( bus->fd < 0 ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    if( bus->rdwr ) {
+        args.msgs = msgs;
+        args.nmsgs = nmsgs;
+
+        bus->stats.ioctls++;
+        if( ioctl(bus->fd, I2C_RDWR, &args) < 0 ) {
+            bus->stats.errors++;
+            ret = (errno == EBUSY) ? AD5697R_RET_BUSY : (errno == ETIMEDOUT) ? AD5697R_RET_TIMEOUT : AD5697R_RET_ERROR;
+        }
+    }
+    else {
+        for( i = 0; (i < nmsgs) && (ret == AD5697R_RET_OK); i++ ) {
+            if( (msgs[i].flags & I2C_M_RD) == 0 ) {
+                ret = ad5697r_linuxSmbusWrite(bus, &msgs[i]);
+            }
+        }
+    }
+
+    if( ret == AD5697R_RET_OK ) {
+        for( i = 0; i < nmsgs; i++ ) {
+            bus->stats.messages++;
+            bus->stats.bytes += msgs[i].len;
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API initializes a bus context with the optional deferred write buffer
+ */
+ad5697r_return_code_t ad5697r_linuxInit(ad5697r_linux_bus_t *bus, uint8_t *buf, const uint32_t size) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    if( (buf == NULL) && (size > 0) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    bus->fd = -1;
+    bus->buf = buf;
+    bus->size = size;
+    ad5697r_linuxBus = bus;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API opens the i2c-dev adapter and checks what transfers it supports
+ */
+ad5697r_return_code_t ad5697r_linuxOpen(ad5697r_linux_bus_t *bus, const char *path) {
+    unsigned long funcs = 0;
+
+    if( (bus == NULL) || (path == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    if( bus->fd >= 0 ) {
+        return AD5697R_RET_BUSY;
+    }
+
+    bus->fd = open(path, O_RDWR);
+    if( bus->fd < 0 ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    if( (ioctl(bus->fd, I2C_FUNCS, &funcs) < 0) ||
+        ((funcs & (I2C_FUNC_I2C | I2C_FUNC_SMBUS_WRITE_I2C_BLOCK)) == 0) ) {
+        close(bus->fd);
+        bus->fd = -1;
+        return AD5697R_RET_ERROR;
+    }
+
+    bus->rdwr = (funcs & I2C_FUNC_I2C) != 0;
+    bus->slaveAddr = 0;
+    ad5697r_linuxClear(bus);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API closes the adapter and drops any queued writes
+ */
+ad5697r_return_code_t ad5697r_linuxClose(ad5697r_linux_bus_t *bus) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    if( bus->fd >= 0 ) {
+        close(bus->fd);
+    }
+    bus->fd = -1;
+    ad5697r_linuxClear(bus);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API selects the bus context the interface functions use
+ */
+ad5697r_return_code_t ad5697r_linuxSelect(ad5697r_linux_bus_t *bus) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ad5697r_linuxBus = bus;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API enables or disables deferred writes, flushing the queue on disable
+ */
+ad5697r_return_code_t ad5697r_linuxSetDeferred(ad5697r_linux_bus_t *bus, const bool deferred) {
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    if( deferred && (bus->buf == NULL) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    bus->deferred = deferred;
+
+    return deferred ? AD5697R_RET_OK : ad5697r_linuxFlush(bus);
+}
+
+/*!
+ * @brief This API queues a write message, flushing first when the queue is full
+ */
+ad5697r_return_code_t ad5697r_linuxQueue(ad5697r_linux_bus_t *bus, const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    struct i2c_msg *msg = NULL;
+
+    if( (bus == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    if( (len == 0) || (len > bus->size) || (len > UINT16_MAX) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( ((bus->len + len) > bus->size) || (bus->nmsgs >= AD5697R_LINUX_MAX_MSGS) ) {
+        ret = ad5697r_linuxFlush(bus);
+        if( ret != AD5697R_RET_OK ) {
+            return ret;
+        }
+    }
+
+    memcpy(&bus->buf[bus->len], data, len);
+
+    msg = &bus->msgs[bus->nmsgs++];
+    msg->addr = busAddr;
+    msg->flags = 0;
+    msg->len = (uint16_t)len;
+    msg->buf = &bus->buf[bus->len];
+
+    bus->len += len;
+    bus->lastCmd = data[0];
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sends every queued write message in a single transfer
+ */
+ad5697r_return_code_t ad5697r_linuxFlush(ad5697r_linux_bus_t *bus) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+
+    if( bus == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ret = ad5697r_linuxSubmit(bus, bus->msgs, bus->nmsgs);
+    if( ret == AD5697R_RET_OK ) {
+        ad5697r_linuxClear(bus);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API writes to the device through the selected bus context
+ */
+int8_t ad5697r_linuxWrite(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    struct i2c_msg msg;
+
+    if( (ad5697r_linuxBus == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    if( ad5697r_linuxBus->deferred ) {
+        return ad5697r_linuxQueue(ad5697r_linuxBus, busAddr, data, len);
+    }
+    if( (len == 0) || (len > UINT16_MAX) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    msg.addr = busAddr;
+    msg.flags = 0;
+    msg.len = (uint16_t)len;
+    msg.buf = (uint8_t *)data;
+    ad5697r_linuxBus->lastCmd = data[0];
+
+    return ad5697r_linuxSubmit(ad5697r_linuxBus, &msg, 1);
+}
+
+/*!
+ * @brief This API sends a list of write messages with as few ioctls as possible
+ */
+int8_t ad5697r_linuxTransfer(void *ctx, const ad5697r_bus_msg_t *msgs, const uint32_t count) {
+    ad5697r_linux_bus_t *bus = (ad5697r_linux_bus_t *)ctx;
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    struct i2c_msg xfer[AD5697R_LINUX_MAX_MSGS];
+    uint32_t done = 0;
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+    if( (bus == NULL) || (msgs == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( count == 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // Keep the order of writes queued through the interface function
+    ret = ad5697r_linuxFlush(bus);
+
+    while( (ret == AD5697R_RET_OK) && (done < count) ) {
+        n = ((count - done) > AD5697R_LINUX_MAX_MSGS) ? AD5697R_LINUX_MAX_MSGS : (count - done);
+        for( i = 0; i < n; i++ ) {
+            if( (msgs[done + i].data == NULL) || (msgs[done + i].len == 0) || (msgs[done + i].len > UINT16_MAX) ) {
+                return AD5697R_RET_INV_PARAM;
+            }
+            xfer[i].addr = msgs[done + i].busAddr;
+            xfer[i].flags = 0;
+            xfer[i].len = (uint16_t)msgs[done + i].len;
+            xfer[i].buf = (uint8_t *)msgs[done + i].data;
+        }
+
+        ret = ad5697r_linuxSubmit(bus, xfer, n);
+        done += n;
+    }
+
+    if( ret == AD5697R_RET_OK ) {
+        bus->lastCmd = msgs[count - 1].data[0];
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API reads from the device through the selected bus context
+ */
+int8_t ad5697r_linuxRead(const uint8_t busAddr, uint8_t *data, const uint32_t len) {
+    ad5697r_linux_bus_t *bus = ad5697r_linuxBus;
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    union i2c_smbus_data block;
+    struct i2c_msg *msg = NULL;
+
+    if( (bus == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    if( (len == 0) || (len > UINT16_MAX) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( !bus->rdwr ) {
+        // SMBus adapters re-send the last command byte ahead of the read
+        if( len > I2C_SMBUS_BLOCK_MAX ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+
+        ret = ad5697r_linuxFlush(bus);
+        if( ret == AD5697R_RET_OK ) {
+            ret = ad5697r_linuxSetSlave(bus, busAddr);
+        }
+        if( ret == AD5697R_RET_OK ) {
+            block.block[0] = (uint8_t)len;
+            ret = ad5697r_linuxSmbus(bus, I2C_SMBUS_READ, bus->lastCmd, I2C_SMBUS_I2C_BLOCK_DATA, &block);
+        }
+        if( ret == AD5697R_RET_OK ) {
+            memcpy(data, &block.block[1], len);
+            bus->stats.messages++;
+            bus->stats.bytes += len;
+        }
+        return ret;
+    }
+
+    if( bus->nmsgs >= AD5697R_LINUX_MAX_MSGS ) {
+        ret = ad5697r_linuxFlush(bus);
+        if( ret != AD5697R_RET_OK ) {
+            return ret;
+        }
+    }
+
+    // Append the read so queued writes go out in the same transfer
+    msg = &bus->msgs[bus->nmsgs];
+    msg->addr = busAddr;
+    msg->flags = I2C_M_RD;
+    msg->len = (uint16_t)len;
+    msg->buf = data;
+
+    ret = ad5697r_linuxSubmit(bus, bus->msgs, bus->nmsgs + 1);
+    if( ret == AD5697R_RET_OK ) {
+        ad5697r_linuxClear(bus);
+    }
+
+    return ret;
+}
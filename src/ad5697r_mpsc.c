@@ -0,0 +1,257 @@
+/*! @file ad5697r_mpsc.c
+ * @brief Lock-free multi-producer update queue for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_mpsc.h"
+
+#define AD5697R_MPSC_VALID      (0x80000000u)   /*! @brief Marks a pending code in the latest slots */
+#define AD5697R_MPSC_CH_A       (0)             /*! @brief Slot index of channel A */
+#define AD5697R_MPSC_CH_B       (1)             /*! @brief Slot index of channel B */
+
+/*!
+ * @brief Adds to a statistics counter shared between threads
+ */
+static void ad5697r_mpscCount(uint32_t *counter, const uint32_t n) {
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+/*!
+ * @brief Raises the largest depth seen to the provided depth
+ */
+static void ad5697r_mpscTrackDepth(ad5697r_mpsc_t *queue, const uint32_t depth) {
+    uint32_t seen = __atomic_load_n(&queue->stats.maxDepth, __ATOMIC_RELAXED);
+
+    while( (depth > seen) &&
+           !__atomic_compare_exchange_n(&queue->stats.maxDepth, &seen, depth, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+    }
+}
+
+/*!
+ * @brief Claims a cell and publishes an update, fails when the queue is full
+ */
+static ad5697r_return_code_t ad5697r_mpscEnqueue(ad5697r_mpsc_t *queue, const uint8_t slot, const uint16_t code) {
+    ad5697r_mpsc_cell_t *cell = NULL;
+    uint32_t pos = __atomic_load_n(&queue->enqueuePos, __ATOMIC_RELAXED);
+    uint32_t seq = 0;
+    int32_t dif = 0;
+
+    while( true ) {
+        cell = &queue->cells[pos & queue->mask];
+        seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        dif = (int32_t)(seq - pos);
+
+        if( dif == 0 ) {
+            if( __atomic_compare_exchange_n(&queue->enqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+                break;
+            }
+        }
+        else if( dif < 0 ) {
+            // The cell still holds an update from the previous lap
+            return AD5697R_RET_BUSY;
+        }
+        else {
+            pos = __atomic_load_n(&queue->enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->ch = slot;
+    cell->code = code;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+    ad5697r_mpscTrackDepth(queue, (pos + 1) - __atomic_load_n(&queue->dequeuePos, __ATOMIC_RELAXED));
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Takes the next published update, fails when the queue is empty
+ */
+static bool ad5697r_mpscDequeue(ad5697r_mpsc_t *queue, uint8_t *slot, uint16_t *code) {
+    uint32_t pos = queue->dequeuePos;
+    ad5697r_mpsc_cell_t *cell = &queue->cells[pos & queue->mask];
+    uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+
+    if( (int32_t)(seq - (pos + 1)) < 0 ) {
+        return false;
+    }
+
+    *slot = cell->ch;
+    *code = cell->code;
+
+    // Hand the cell back to the producers for the next lap
+    __atomic_store_n(&cell->seq, pos + queue->mask + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&queue->dequeuePos, pos + 1, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+/*!
+ * @brief Posts one channel update
+ */
+static ad5697r_return_code_t ad5697r_mpscPostSlot(ad5697r_mpsc_t *queue, const uint8_t slot, const uint16_t code) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint8_t idle = 0;
+
+    ad5697r_mpscCount(&queue->stats.posted, 1);
+
+    if( !queue->coalesce ) {
+        ret = ad5697r_mpscEnqueue(queue, slot, code);
+        if( ret != AD5697R_RET_OK ) {
+            ad5697r_mpscCount(&queue->stats.drops, 1);
+        }
+        return ret;
+    }
+
+    __atomic_store_n(&queue->latest[slot], AD5697R_MPSC_VALID | code, __ATOMIC_SEQ_CST);
+
+    // A queued entry for the channel picks up the new code when drained
+    if( !__atomic_compare_exchange_n(&queue->queued[slot], &idle, 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ) {
+        ad5697r_mpscCount(&queue->stats.coalesced, 1);
+        return AD5697R_RET_OK;
+    }
+
+    ret = ad5697r_mpscEnqueue(queue, slot, 0);
+    if( ret != AD5697R_RET_OK ) {
+        __atomic_store_n(&queue->queued[slot], 0, __ATOMIC_SEQ_CST);
+        ad5697r_mpscCount(&queue->stats.drops, 1);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Writes the updates collected in the batch
+ */
+static ad5697r_return_code_t ad5697r_mpscCommit(ad5697r_mpsc_t *queue, ad5697r_batch_t *batch, const uint32_t updates) {
+    ad5697r_return_code_t ret = ad5697r_batchCommit(batch);
+
+    if( ret == AD5697R_RET_OK ) {
+        ad5697r_mpscCount(&queue->stats.written, updates);
+    }
+    else {
+        ad5697r_mpscCount(&queue->stats.writeErrors, 1);
+        ad5697r_batchReset(batch);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API initializes an update queue in front of a device
+ */
+ad5697r_return_code_t ad5697r_mpscInit(ad5697r_mpsc_t *queue, ad5697r_dev_t *dev, ad5697r_mpsc_cell_t *cells, const uint32_t capacity, const bool coalesce) {
+    uint32_t i = 0;
+
+    if( (queue == NULL) || (dev == NULL) || (cells == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (capacity < 2) || ((capacity & (capacity - 1)) != 0) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(queue, 0, sizeof(*queue));
+    queue->dev = dev;
+    queue->cells = cells;
+    queue->mask = capacity - 1;
+    queue->coalesce = coalesce;
+
+    for( i = 0; i < capacity; i++ ) {
+        cells[i].seq = i;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API posts an update without blocking
+ */
+ad5697r_return_code_t ad5697r_mpscPost(ad5697r_mpsc_t *queue, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+
+    if( (queue == NULL) || (queue->cells == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (ch != AD5697R_OUTPUT_CH_A) && (ch != AD5697R_OUTPUT_CH_B) && (ch != AD5697R_OUTPUT_CH_A_B) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( ch & AD5697R_OUTPUT_CH_A ) {
+        ret = ad5697r_mpscPostSlot(queue, AD5697R_MPSC_CH_A, outputVal);
+    }
+
+    if( (ret == AD5697R_RET_OK) && (ch & AD5697R_OUTPUT_CH_B) ) {
+        ret = ad5697r_mpscPostSlot(queue, AD5697R_MPSC_CH_B, outputVal);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API writes pending updates to the device
+ */
+ad5697r_return_code_t ad5697r_mpscDrain(ad5697r_mpsc_t *queue, const uint32_t maxUpdates, uint32_t *written) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_batch_t batch;
+    uint32_t latest = 0;
+    uint32_t pending = 0;
+    uint32_t total = 0;
+    uint16_t code = 0;
+    uint8_t slot = 0;
+
+    if( written != NULL ) {
+        *written = 0;
+    }
+    if( (queue == NULL) || (queue->cells == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    ret = ad5697r_batchInit(&batch, queue->dev, queue->buf, sizeof(queue->buf));
+
+    while( (ret == AD5697R_RET_OK) && ((maxUpdates == 0) || ((total + pending) < maxUpdates)) &&
+           ad5697r_mpscDequeue(queue, &slot, &code) ) {
+        if( queue->coalesce ) {
+            // Clear the flag first so a racing post queues a fresh entry
+            __atomic_store_n(&queue->queued[slot], 0, __ATOMIC_SEQ_CST);
+            latest = __atomic_exchange_n(&queue->latest[slot], 0, __ATOMIC_SEQ_CST);
+            if( (latest & AD5697R_MPSC_VALID) == 0 ) {
+                // An earlier entry already wrote the code posted with this one
+                ad5697r_mpscCount(&queue->stats.coalesced, 1);
+                continue;
+            }
+            code = (uint16_t)latest;
+        }
+
+        ret = ad5697r_batchWriteChannel(&batch, (slot == AD5697R_MPSC_CH_A) ? AD5697R_OUTPUT_CH_A : AD5697R_OUTPUT_CH_B, code);
+        pending++;
+
+        if( (ret == AD5697R_RET_OK) && (pending == AD5697R_MPSC_DRAIN_FRAMES) ) {
+            ret = ad5697r_mpscCommit(queue, &batch, pending);
+            total += (ret == AD5697R_RET_OK) ? pending : 0;
+            pending = 0;
+        }
+    }
+
+    if( (ret == AD5697R_RET_OK) && (pending > 0) ) {
+        ret = ad5697r_mpscCommit(queue, &batch, pending);
+        total += (ret == AD5697R_RET_OK) ? pending : 0;
+    }
+
+    if( written != NULL ) {
+        *written = total;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns the number of queued updates
+ */
+uint32_t ad5697r_mpscGetDepth(const ad5697r_mpsc_t *queue) {
+    if( queue == NULL ) {
+        return 0;
+    }
+
+    return __atomic_load_n(&queue->enqueuePos, __ATOMIC_RELAXED) - __atomic_load_n(&queue->dequeuePos, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,136 @@
+/*! @file ad5697r_priv.h
+ * @brief Private definitions shared between the AD5697R driver modules.
+ *
+ * Every frame the modules write is packed by the ad56x_ad5697r instantiation
+ * of the family encoders, the same ones AD56X_DEFINE_DEV() builds on.
+ */
+
+#ifndef _ad5697r_priv_H_
+#define _ad5697r_priv_H_
+
+#include <stdint.h>
+#include "ad5697r.h"
+#include "ad5697r_encode.h"
+
+/*!
+ * @brief Packs a DAC data frame (write/update commands) into the provided buffer
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] cmd: Write/update command
+ * @param[in] ch: DAC output channel(s) addressed by the frame
+ * @param[in] outputVal: 12bit value of the frame
+ */
+static inline void ad5697r_packDacFrame(uint8_t *frame, const AD5697R_CMD_t cmd, const uint8_t ch, const uint16_t outputVal) {
+    ad56x_ad5697r_encDac(frame, cmd, ch, outputVal);
+}
+
+/*!
+ * @brief Packs a power down/power up frame for both channels into the provided buffer
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] modeA: Operating mode of channel A
+ * @param[in] modeB: Operating mode of channel B
+ */
+static inline void ad5697r_packPowerFrame(uint8_t *frame, const uint8_t modeA, const uint8_t modeB) {
+    const uint8_t modes[AD56X_AD5697R_CHANNELS] = {modeA, modeB};
+
+    ad56x_ad5697r_encPower(frame, modes);
+}
+
+/*!
+ * @brief Packs an internal reference setup frame into the provided buffer
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] refSelect: State of the internal reference
+ */
+static inline void ad5697r_packReferenceFrame(uint8_t *frame, const ad5697r_reference_t refSelect) {
+    ad56x_ad5697r_encReference(frame, refSelect);
+}
+
+/*!
+ * @brief Packs a hardware !LDAC mask frame into the provided buffer
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ * @param[in] mask: Channels that ignore the !LDAC pin (ad5697r_output_channel_t bits)
+ */
+static inline void ad5697r_packLdacMaskFrame(uint8_t *frame, const uint8_t mask) {
+    ad56x_ad5697r_encLdacMask(frame, mask);
+}
+
+/*!
+ * @brief Packs a software reset frame into the provided buffer
+ *
+ * @param[out] *frame: Pointer to the AD5697R_FRAME_SIZE byte frame
+ */
+static inline void ad5697r_packSoftResetFrame(uint8_t *frame) {
+    ad56x_ad5697r_encSoftReset(frame);
+}
+
+/*!
+ * @brief Reads a little-endian field of the capture and waveform file formats
+ *
+ * @param[in] *p: Pointer to the first byte of the field
+ * @param[in] bytes: Size of the field, up to four bytes
+ *
+ * @return Value of the field
+ */
+static inline uint32_t ad5697r_getLe(const uint8_t *p, const uint8_t bytes) {
+    uint32_t val = 0;
+    uint8_t i = 0;
+
+    for( i = 0; i < bytes; i++ ) {
+        val |= (uint32_t)p[i] << (8 * i);
+    }
+
+    return val;
+}
+
+/*!
+ * @brief Writes a little-endian field of the capture and waveform file formats
+ *
+ * @param[out] *p: Pointer to the first byte of the field
+ * @param[in] val: Value to write
+ * @param[in] bytes: Size of the field, up to four bytes
+ */
+static inline void ad5697r_putLe(uint8_t *p, uint32_t val, const uint8_t bytes) {
+    uint8_t i = 0;
+
+    for( i = 0; i < bytes; i++ ) {
+        p[i] = (uint8_t)val;
+        val >>= 8;
+    }
+}
+
+/*!
+ * @brief Returns the shadow register flags written by a DAC data frame
+ *
+ * @param[in] ch: DAC output channel(s) addressed by the frame
+ *
+ * @return Shadow register flags (ad5697r_shadow_t)
+ */
+uint8_t ad5697r_shadowDacFlags(const uint8_t ch);
+
+/*!
+ * @brief Writes raw frames to the device in a single transaction. Every module
+ * goes through this call so the bus access is handled in one place.
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[in] *data: Pointer to the frames to be written
+ * @param[in] len: Length of the frames in bytes
+ *
+ * @return The result of writing the frames
+ */
+ad5697r_return_code_t ad5697r_busWrite(ad5697r_dev_t *dev, const uint8_t *data, const uint32_t len);
+
+/*!
+ * @brief Reads raw bytes from the device in a single transaction
+ *
+ * @param[in] *dev: Pointer to your ad5697r device
+ * @param[out] *data: Pointer to the bytes read
+ * @param[in] len: Number of bytes to read
+ *
+ * @return The result of reading the bytes
+ */
+ad5697r_return_code_t ad5697r_busRead(ad5697r_dev_t *dev, uint8_t *data, const uint32_t len);
+
+#endif // _ad5697r_priv_H_
@@ -0,0 +1,257 @@
+/*! @file ad5697r_ramp.c
+ * @brief Slew-rate-limited ramp generator for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_ramp.h"
+
+#define AD5697R_RAMP_ONE    (0x10000u)  /*! @brief 1.0 in Q16.16 */
+
+static const ad5697r_output_channel_t ad5697r_rampOutputs[AD5697R_RAMP_CHANNELS] = {
+    AD5697R_OUTPUT_CH_A, AD5697R_OUTPUT_CH_B
+};
+
+static const uint8_t ad5697r_rampDacFlags[AD5697R_RAMP_CHANNELS] = {
+    AD5697R_SHADOW_DAC_A, AD5697R_SHADOW_DAC_B
+};
+
+/*!
+ * @brief Advances a linear ramp by one tick
+ */
+static void ad5697r_rampLinear(ad5697r_ramp_channel_t *rc) {
+    const uint32_t end = (uint32_t)rc->target << 16;
+
+    if( rc->pos < end ) {
+        rc->pos = ((end - rc->pos) > rc->step) ? (rc->pos + rc->step) : end;
+    }
+    else {
+        rc->pos = ((rc->pos - end) > rc->step) ? (rc->pos - rc->step) : end;
+    }
+
+    rc->code = (uint16_t)((rc->pos + (AD5697R_RAMP_ONE / 2)) >> 16);
+    rc->active = (rc->pos != end);
+}
+
+/*!
+ * @brief Advances an S-curve by one tick, s(u) = 3u^2 - 2u^3
+ */
+static void ad5697r_rampSCurve(ad5697r_ramp_channel_t *rc) {
+    uint64_t u = 0;
+    uint64_t u2 = 0;
+    uint64_t u3 = 0;
+    uint32_t s = 0;
+    uint32_t dist = 0;
+    uint32_t moved = 0;
+
+    // tick * 2^16 / ticks, the rounded up reciprocal is exact at the last tick
+    rc->tick++;
+    u = (rc->tick * rc->tickScale) >> 32;
+    u2 = (u * u) >> 16;
+    u3 = (u2 * u) >> 16;
+    s = (uint32_t)((3 * u2) - (2 * u3));
+
+    dist = (rc->target > rc->start) ? (uint32_t)(rc->target - rc->start) : (uint32_t)(rc->start - rc->target);
+    moved = ((dist * s) + (AD5697R_RAMP_ONE / 2)) >> 16;
+
+    rc->code = (rc->target > rc->start) ? (uint16_t)(rc->start + moved) : (uint16_t)(rc->start - moved);
+    rc->pos = (uint32_t)rc->code << 16;
+    rc->active = (rc->tick < rc->ticks);
+}
+
+/*!
+ * @brief This API initializes a ramp generator
+ */
+ad5697r_return_code_t ad5697r_rampInit(ad5697r_ramp_t *ramp, ad5697r_dev_t *dev, const uint32_t tickHz) {
+    ad5697r_ramp_channel_t *rc = NULL;
+    uint8_t i = 0;
+
+    if( (ramp == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( tickHz == 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(ramp, 0, sizeof(*ramp));
+    ramp->dev = dev;
+    ramp->tickHz = tickHz;
+
+    for( i = 0; i < AD5697R_RAMP_CHANNELS; i++ ) {
+        rc = &ramp->ch[i];
+        rc->synced = (dev->registers.bits.valid & ad5697r_rampDacFlags[i]) != 0;
+        if( rc->synced ) {
+            rc->code = (i == 0) ? dev->registers.bits.CHA_dac : dev->registers.bits.CHB_dac;
+        }
+        rc->target = rc->code;
+        rc->pos = (uint32_t)rc->code << 16;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API starts a ramp from the current code of the channel(s) to the target
+ */
+ad5697r_return_code_t ad5697r_rampSetTarget(ad5697r_ramp_t *ramp, const ad5697r_output_channel_t ch, const uint16_t target,
+                                            const uint32_t slewCodesPerSec, const ad5697r_ramp_profile_t profile) {
+    ad5697r_ramp_channel_t *rc = NULL;
+    uint64_t ticks = 0;
+    uint64_t step = 0;
+    uint32_t dist = 0;
+    uint8_t i = 0;
+
+    if( (ramp == NULL) || (ramp->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( ((ch != AD5697R_OUTPUT_CH_A) && (ch != AD5697R_OUTPUT_CH_B) && (ch != AD5697R_OUTPUT_CH_A_B)) ||
+             (target > AD5697R_RAMP_MAX_CODE) || (slewCodesPerSec == 0) || (profile >= AD5697R_RAMP__MAX__) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    for( i = 0; i < AD5697R_RAMP_CHANNELS; i++ ) {
+        if( !(ch & ad5697r_rampOutputs[i]) ) {
+            continue;
+        }
+
+        rc = &ramp->ch[i];
+        dist = (target > rc->code) ? (uint32_t)(target - rc->code) : (uint32_t)(rc->code - target);
+
+        rc->profile = profile;
+        rc->start = rc->code;
+        rc->target = target;
+        rc->pos = (uint32_t)rc->code << 16;
+        rc->tick = 0;
+        rc->active = (dist > 0);
+
+        // A step below one LSB per tick still advances, just over several ticks;
+        // one above full scale reaches the target on the first tick anyway
+        step = ((uint64_t)slewCodesPerSec << 16) / ramp->tickHz;
+        rc->step = (step > ((uint64_t)AD5697R_RAMP_MAX_CODE << 16)) ? ((uint32_t)AD5697R_RAMP_MAX_CODE << 16) : (uint32_t)step;
+        if( rc->step == 0 ) {
+            rc->step = 1;
+        }
+
+        // The smoothstep peaks at 1.5x its average slew
+        ticks = (((uint64_t)dist * ramp->tickHz * 3) + ((uint64_t)slewCodesPerSec * 2) - 1) / ((uint64_t)slewCodesPerSec * 2);
+        rc->ticks = (ticks > UINT32_MAX) ? UINT32_MAX : (ticks == 0) ? 1 : (uint32_t)ticks;
+        rc->tickScale = ((1ull << 48) + rc->ticks - 1) / rc->ticks;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API advances every running ramp by one tick
+ */
+ad5697r_return_code_t ad5697r_rampStep(ad5697r_ramp_t *ramp) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_ramp_channel_t *rc = NULL;
+    ad5697r_batch_t batch;
+    uint16_t prev[AD5697R_RAMP_CHANNELS];
+    uint8_t changed = 0;
+    uint8_t running = 0;
+    uint8_t i = 0;
+
+    if( (ramp == NULL) || (ramp->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    for( i = 0; i < AD5697R_RAMP_CHANNELS; i++ ) {
+        rc = &ramp->ch[i];
+        prev[i] = rc->code;
+
+        if( rc->active ) {
+            running++;
+            if( rc->profile == AD5697R_RAMP_S_CURVE ) {
+                ad5697r_rampSCurve(rc);
+            }
+            else {
+                ad5697r_rampLinear(rc);
+            }
+        }
+
+        if( (rc->code != prev[i]) || !rc->synced ) {
+            changed |= ad5697r_rampOutputs[i];
+        }
+    }
+
+    if( running > 0 ) {
+        ramp->stats.ticks++;
+    }
+    if( changed == 0 ) {
+        ramp->stats.unchanged += (running > 0) ? 1 : 0;
+        return AD5697R_RET_OK;
+    }
+
+    ad5697r_batchInit(&batch, ramp->dev, ramp->buf, sizeof(ramp->buf));
+
+    // Channels moving in step share one frame
+    if( (changed == AD5697R_OUTPUT_CH_A_B) && (ramp->ch[0].code == ramp->ch[1].code) ) {
+        ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A_B, ramp->ch[0].code);
+    }
+    else {
+        for( i = 0; i < AD5697R_RAMP_CHANNELS; i++ ) {
+            if( changed & ad5697r_rampOutputs[i] ) {
+                ad5697r_batchWriteChannel(&batch, ad5697r_rampOutputs[i], ramp->ch[i].code);
+            }
+        }
+    }
+
+    // Write elision may have dropped codes the shadow already holds
+    if( batch.len > 0 ) {
+        ret = ad5697r_batchCommit(&batch);
+        if( ret == AD5697R_RET_OK ) {
+            ramp->stats.transactions++;
+            ramp->stats.frames += batch.stats.updates;
+        }
+        else {
+            ramp->stats.errors++;
+        }
+    }
+
+    for( i = 0; i < AD5697R_RAMP_CHANNELS; i++ ) {
+        if( changed & ad5697r_rampOutputs[i] ) {
+            ramp->ch[i].synced = (ret == AD5697R_RET_OK);
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns whether every ramp reached its target and was written
+ */
+bool ad5697r_rampIsIdle(const ad5697r_ramp_t *ramp) {
+    uint8_t i = 0;
+
+    if( ramp == NULL ) {
+        return true;
+    }
+
+    for( i = 0; i < AD5697R_RAMP_CHANNELS; i++ ) {
+        if( ramp->ch[i].active || !ramp->ch[i].synced ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief This API converts a slew in volts per second to codes per second
+ */
+uint32_t ad5697r_rampSlewFromVolts(const float voltsPerSec, const float fullScale) {
+    float codes = 0.0f;
+
+    if( !(fullScale > 0.0f) ) {
+        return 0;
+    }
+
+    codes = (voltsPerSec * (float)(AD5697R_RAMP_MAX_CODE + 1)) / fullScale + 0.5f;
+    if( !(codes >= 1.0f) ) {
+        return 1;
+    }
+
+    return (codes >= 4294967040.0f) ? UINT32_MAX : (uint32_t)codes;
+}
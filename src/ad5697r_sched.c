@@ -0,0 +1,317 @@
+/*! @file ad5697r_sched.c
+ * @brief Deadline scheduler for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_sched.h"
+
+/*!
+ * @brief Returns true for operations whose order on a channel matters
+ */
+static bool ad5697r_schedIsData(const ad5697r_sched_op_t op) {
+    return (op == AD5697R_SCHED_OP_WRITE) || (op == AD5697R_SCHED_OP_INPUT) || (op == AD5697R_SCHED_OP_UPDATE);
+}
+
+/*!
+ * @brief Returns true when slot a is more urgent than slot b
+ */
+static bool ad5697r_schedBefore(const ad5697r_sched_slot_t *a, const ad5697r_sched_slot_t *b) {
+    if( a->prio != b->prio ) {
+        return a->prio < b->prio;
+    }
+    else if( a->deadlineUs != b->deadlineUs ) {
+        return (int32_t)(a->deadlineUs - b->deadlineUs) < 0;
+    }
+
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+/*!
+ * @brief Picks the next operation to pack, or the capacity when none is left
+ */
+static uint32_t ad5697r_schedPick(const ad5697r_sched_t *sched) {
+    const ad5697r_sched_slot_t *best = NULL;
+    const ad5697r_sched_slot_t *slot = NULL;
+    uint32_t bestIdx = sched->capacity;
+    uint32_t i = 0;
+    bool pulled = false;
+
+    for( i = 0; i < sched->capacity; i++ ) {
+        slot = &sched->slots[i];
+        if( slot->used && ((best == NULL) || ad5697r_schedBefore(slot, best)) ) {
+            best = slot;
+            bestIdx = i;
+        }
+    }
+
+    // An older write to the same channel goes first, or it would undo the newer one
+    do {
+        pulled = false;
+        for( i = 0; (best != NULL) && ad5697r_schedIsData(best->op) && (i < sched->capacity); i++ ) {
+            slot = &sched->slots[i];
+            if( slot->used && ad5697r_schedIsData(slot->op) && (slot->ch & best->ch) &&
+                ((int32_t)(slot->seq - best->seq) < 0) ) {
+                best = slot;
+                bestIdx = i;
+                pulled = true;
+            }
+        }
+    } while( pulled );
+
+    return bestIdx;
+}
+
+/*!
+ * @brief Appends the frame of an operation to the batch
+ */
+static ad5697r_return_code_t ad5697r_schedAppend(ad5697r_batch_t *batch, const ad5697r_sched_slot_t *slot) {
+    switch( slot->op ) {
+        case AD5697R_SCHED_OP_WRITE:
+            return ad5697r_batchWriteChannel(batch, slot->ch, slot->value);
+        case AD5697R_SCHED_OP_INPUT:
+            return ad5697r_batchWriteInputRegister(batch, slot->ch, slot->value);
+        case AD5697R_SCHED_OP_UPDATE:
+            return ad5697r_batchUpdateChannel(batch, slot->ch);
+        case AD5697R_SCHED_OP_POWER:
+            return ad5697r_batchSetOperatingMode(batch, slot->ch, (ad5697r_operation_mode_t)slot->value);
+        case AD5697R_SCHED_OP_REFERENCE:
+            return ad5697r_batchSetReferenceMode(batch, (ad5697r_reference_t)slot->value);
+        case AD5697R_SCHED_OP_LDAC_MASK:
+            return ad5697r_batchSetLdacMask(batch, (uint8_t)slot->value);
+        default:
+            return AD5697R_RET_INV_PARAM;
+    }
+}
+
+/*!
+ * @brief Converts the cost of the first len bytes of a transaction to whole microseconds
+ */
+static uint32_t ad5697r_schedCostUs(const ad5697r_sched_t *sched, const uint32_t len) {
+    return (ad5697r_getTransactionTimeNs(sched->busClockHz, len) + 999u) / 1000u;
+}
+
+/*!
+ * @brief This API initializes a scheduler over caller provided slots
+ */
+ad5697r_return_code_t ad5697r_schedInit(ad5697r_sched_t *sched, ad5697r_dev_t *dev, ad5697r_sched_slot_t *slots, const uint32_t capacity,
+                                        const uint32_t busClockHz, const uint32_t maxTransactionNs, const ad5697r_get_time_us_fptr_t get_time_us) {
+    if( (sched == NULL) || (dev == NULL) || (slots == NULL) || (get_time_us == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (capacity == 0) || (busClockHz == 0) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(sched, 0, sizeof(*sched));
+    memset(slots, 0, capacity * sizeof(*slots));
+    sched->dev = dev;
+    sched->slots = slots;
+    sched->capacity = capacity;
+    sched->busClockHz = busClockHz;
+    sched->maxTransactionNs = maxTransactionNs;
+    sched->get_time_us = get_time_us;
+    sched->stats.sinceUs = get_time_us();
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API submits an operation
+ */
+ad5697r_return_code_t ad5697r_schedSubmit(ad5697r_sched_t *sched, const ad5697r_sched_op_t op, const ad5697r_output_channel_t ch, const uint16_t value,
+                                          const ad5697r_sched_prio_t prio, const uint32_t deadlineUs, ad5697r_sched_cb_fptr_t cb, void *ctx) {
+    ad5697r_sched_slot_t *slot = NULL;
+    bool chValid = (ch == AD5697R_OUTPUT_CH_A) || (ch == AD5697R_OUTPUT_CH_B) || (ch == AD5697R_OUTPUT_CH_A_B);
+    bool valid = false;
+    uint32_t i = 0;
+
+    if( (sched == NULL) || (sched->slots == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    switch( op ) {
+        case AD5697R_SCHED_OP_WRITE:
+        case AD5697R_SCHED_OP_INPUT:
+            valid = chValid && (value <= 0x0FFF);
+            break;
+        case AD5697R_SCHED_OP_UPDATE:
+            valid = chValid;
+            break;
+        case AD5697R_SCHED_OP_POWER:
+            valid = chValid && (value < AD5697R_OP_MODE__MAX__);
+            break;
+        case AD5697R_SCHED_OP_REFERENCE:
+            valid = (value < AD5697R_REF__MAX__);
+            break;
+        case AD5697R_SCHED_OP_LDAC_MASK:
+            valid = !(value & (uint16_t)~AD5697R_OUTPUT_CH_A_B);
+            break;
+        default:
+            valid = false;
+            break;
+    }
+    if( !valid || (prio >= AD5697R_SCHED_PRIO__MAX__) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    for( i = 0; i < sched->capacity; i++ ) {
+        if( !sched->slots[i].used ) {
+            slot = &sched->slots[i];
+            break;
+        }
+    }
+    if( slot == NULL ) {
+        sched->stats.full++;
+        return AD5697R_RET_BUSY;
+    }
+
+    slot->used = true;
+    slot->op = op;
+    slot->ch = ch;
+    slot->value = value;
+    slot->prio = prio;
+    slot->seq = sched->seq++;
+    slot->submittedUs = sched->get_time_us();
+    slot->deadlineUs = slot->submittedUs + deadlineUs;
+    slot->cb = cb;
+    slot->ctx = ctx;
+
+    sched->pending++;
+    sched->stats.cls[prio].submitted++;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API writes the most urgent operations in one transaction
+ */
+ad5697r_return_code_t ad5697r_schedDispatch(ad5697r_sched_t *sched) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_sched_class_stats_t *cls = NULL;
+    ad5697r_sched_slot_t done[AD5697R_SCHED_MAX_FRAMES];
+    uint32_t frameEnd[AD5697R_SCHED_MAX_FRAMES];
+    bool missed[AD5697R_SCHED_MAX_FRAMES];
+    ad5697r_batch_t batch;
+    uint32_t startUs = 0;
+    uint32_t queueUs = 0;
+    uint32_t slipUs = 0;
+    uint32_t len = 0;
+    uint32_t doneUs = 0;
+    uint32_t idx = 0;
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+    if( (sched == NULL) || (sched->slots == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( sched->pending == 0 ) {
+        return AD5697R_RET_OK;
+    }
+
+    ret = ad5697r_batchInit(&batch, sched->dev, sched->buf, sizeof(sched->buf));
+    if( ret != AD5697R_RET_OK ) {
+        return ret;
+    }
+
+    // Pack in order of urgency until the transaction would hold the bus too long
+    while( n < AD5697R_SCHED_MAX_FRAMES ) {
+        idx = ad5697r_schedPick(sched);
+        if( idx == sched->capacity ) {
+            break;
+        }
+        if( (n > 0) && (sched->maxTransactionNs > 0) &&
+            (ad5697r_getTransactionTimeNs(sched->busClockHz, batch.len + AD5697R_FRAME_SIZE) > sched->maxTransactionNs) ) {
+            break;
+        }
+
+        // The slot is free again once packed, so callbacks can submit
+        ad5697r_schedAppend(&batch, &sched->slots[idx]);
+        done[n] = sched->slots[idx];
+        frameEnd[n] = batch.len;
+        sched->slots[idx].used = false;
+        sched->pending--;
+        n++;
+    }
+
+    startUs = sched->get_time_us();
+    len = batch.len;
+    if( len > 0 ) {
+        ret = ad5697r_batchCommit(&batch);
+        sched->stats.transactions++;
+        sched->stats.busNs += ad5697r_getTransactionTimeNs(sched->busClockHz, len);
+        if( ret == AD5697R_RET_OK ) {
+            sched->stats.frames += len / AD5697R_FRAME_SIZE;
+        }
+
+        // A transport slower than the cost model delays every frame of the transaction
+        slipUs = sched->get_time_us() - startUs;
+        slipUs = (slipUs > ad5697r_schedCostUs(sched, len)) ? (slipUs - ad5697r_schedCostUs(sched, len)) : 0;
+    }
+
+    for( i = 0; i < n; i++ ) {
+        cls = &sched->stats.cls[done[i].prio];
+        queueUs = startUs - done[i].submittedUs;
+        doneUs = startUs + slipUs + ((frameEnd[i] > 0) ? ad5697r_schedCostUs(sched, frameEnd[i]) : 0);
+        missed[i] = (int32_t)(doneUs - done[i].deadlineUs) > 0;
+
+        cls->completed++;
+        cls->missed += missed[i] ? 1 : 0;
+        cls->errors += (ret != AD5697R_RET_OK) ? 1 : 0;
+        cls->totalQueueUs += queueUs;
+        if( queueUs > cls->maxQueueUs ) {
+            cls->maxQueueUs = queueUs;
+        }
+    }
+
+    for( i = 0; i < n; i++ ) {
+        if( done[i].cb != NULL ) {
+            done[i].cb(done[i].ctx, ret, missed[i]);
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns the number of pending operations
+ */
+uint32_t ad5697r_schedGetPending(const ad5697r_sched_t *sched) {
+    return (sched == NULL) ? 0 : sched->pending;
+}
+
+/*!
+ * @brief This API returns the bus utilisation since the statistics were reset
+ */
+uint32_t ad5697r_schedGetUtilisation(const ad5697r_sched_t *sched) {
+    uint64_t permille = 0;
+    uint32_t elapsedUs = 0;
+
+    if( (sched == NULL) || (sched->get_time_us == NULL) ) {
+        return 0;
+    }
+
+    // Nano-seconds busy per micro-second elapsed is the busy share in permille
+    elapsedUs = sched->get_time_us() - sched->stats.sinceUs;
+    if( elapsedUs == 0 ) {
+        return 0;
+    }
+
+    permille = sched->stats.busNs / elapsedUs;
+
+    return (permille > 1000) ? 1000 : (uint32_t)permille;
+}
+
+/*!
+ * @brief This API resets the statistics and starts a new utilisation window
+ */
+ad5697r_return_code_t ad5697r_schedResetStats(ad5697r_sched_t *sched) {
+    if( (sched == NULL) || (sched->get_time_us == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(&sched->stats, 0, sizeof(sched->stats));
+    sched->stats.sinceUs = sched->get_time_us();
+
+    return AD5697R_RET_OK;
+}
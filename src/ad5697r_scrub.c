@@ -0,0 +1,142 @@
+/*! @file ad5697r_scrub.c
+ * @brief Incremental register scrubber for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_scrub.h"
+#include "ad5697r_priv.h"
+
+#define AD5697R_SCRUB_REGISTERS     (2)     /*! @brief Registers that can be read back, input A and B */
+#define AD5697R_SCRUB_READ_LEN      (2)     /*! @brief Bytes read back per register */
+
+/*!
+ * @brief Scrubbed register details
+ */
+typedef struct {
+    ad5697r_output_channel_t ch;    /* Channel of the register */
+    uint8_t inputFlag;              /* Shadow flag of the input register */
+    uint8_t dacFlag;                /* Shadow flag of the DAC register */
+} ad5697r_scrub_reg_t;
+
+static const ad5697r_scrub_reg_t ad5697r_scrubRegs[AD5697R_SCRUB_REGISTERS] = {
+    { AD5697R_OUTPUT_CH_A, AD5697R_SHADOW_INPUT_A, AD5697R_SHADOW_DAC_A },
+    { AD5697R_OUTPUT_CH_B, AD5697R_SHADOW_INPUT_B, AD5697R_SHADOW_DAC_B },
+};
+
+/*!
+ * @brief Rewrites a register from the shadow, bypassing write elision
+ */
+static ad5697r_return_code_t ad5697r_scrubRepair(ad5697r_dev_t *dev, const ad5697r_scrub_reg_t *reg, const uint16_t input, const uint16_t dac) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    AD5697R_CMD_t cmd = AD5697R_CMD_W_INPUT_REG_N;
+    uint8_t frame[AD5697R_FRAME_SIZE];
+
+    // An output that followed its input register gets both back, a staged input only itself
+    if( (dev->registers.bits.valid & reg->dacFlag) && (dac == input) ) {
+        cmd = AD5697R_CMD_WRITE_DAC;
+    }
+
+    ad5697r_packDacFrame(frame, cmd, reg->ch, input);
+
+    ret = ad5697r_busWrite(dev, frame, AD5697R_FRAME_SIZE);
+    if( ret != AD5697R_RET_OK ) {
+        dev->registers.bits.valid &= ~ad5697r_shadowDacFlags(reg->ch);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API initializes a scrubber
+ */
+ad5697r_return_code_t ad5697r_scrubInit(ad5697r_scrub_t *scrub, ad5697r_dev_t *dev, const uint32_t busClockHz, const uint32_t budgetNs) {
+    if( (scrub == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (busClockHz == 0) || (budgetNs == 0) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(scrub, 0, sizeof(*scrub));
+    scrub->dev = dev;
+    scrub->checkNs = ad5697r_getTransactionTimeNs(busClockHz, AD5697R_FRAME_SIZE) +
+                     ad5697r_getTransactionTimeNs(busClockHz, AD5697R_SCRUB_READ_LEN);
+    scrub->repairNs = ad5697r_getTransactionTimeNs(busClockHz, AD5697R_FRAME_SIZE);
+    scrub->budgetNs = budgetNs;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API checks and repairs the next shadowed input register
+ */
+ad5697r_return_code_t ad5697r_scrubStep(ad5697r_scrub_t *scrub, uint8_t *repaired) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    const ad5697r_scrub_reg_t *reg = NULL;
+    ad5697r_dev_t *dev = NULL;
+    uint32_t worstNs = 0;
+    uint16_t input = 0;
+    uint16_t dac = 0;
+    uint16_t readback = 0;
+    uint8_t i = 0;
+
+    if( repaired != NULL ) {
+        *repaired = 0;
+    }
+    if( (scrub == NULL) || (scrub->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    dev = scrub->dev;
+    worstNs = scrub->checkNs + scrub->repairNs;
+
+    // Grant this call's bus time, holding no more than one check and rewrite
+    scrub->creditNs = ((worstNs - scrub->creditNs) > scrub->budgetNs) ? (scrub->creditNs + scrub->budgetNs) : worstNs;
+    if( scrub->creditNs < worstNs ) {
+        scrub->stats.deferred++;
+        return AD5697R_RET_OK;
+    }
+
+    // Only registers the shadow holds can be compared
+    for( i = 0; i < AD5697R_SCRUB_REGISTERS; i++ ) {
+        reg = &ad5697r_scrubRegs[(scrub->next + i) % AD5697R_SCRUB_REGISTERS];
+        if( dev->registers.bits.valid & reg->inputFlag ) {
+            break;
+        }
+    }
+    if( i == AD5697R_SCRUB_REGISTERS ) {
+        return AD5697R_RET_OK;
+    }
+
+    scrub->next = (uint8_t)((scrub->next + i + 1) % AD5697R_SCRUB_REGISTERS);
+    input = (reg->ch == AD5697R_OUTPUT_CH_A) ? dev->registers.bits.CHA_input : dev->registers.bits.CHB_input;
+    dac = (reg->ch == AD5697R_OUTPUT_CH_A) ? dev->registers.bits.CHA_dac : dev->registers.bits.CHB_dac;
+
+    ret = ad5697r_readInputRegister(dev, reg->ch, &readback);
+    scrub->creditNs -= scrub->checkNs;
+    if( ret != AD5697R_RET_OK ) {
+        scrub->stats.errors++;
+        return ret;
+    }
+
+    scrub->stats.checks++;
+    if( readback == input ) {
+        return AD5697R_RET_OK;
+    }
+
+    scrub->stats.mismatches++;
+    ret = ad5697r_scrubRepair(dev, reg, input, dac);
+    scrub->creditNs -= scrub->repairNs;
+    if( ret != AD5697R_RET_OK ) {
+        scrub->stats.errors++;
+        return ret;
+    }
+
+    scrub->stats.repairs++;
+    if( repaired != NULL ) {
+        *repaired = reg->inputFlag;
+    }
+
+    return AD5697R_RET_OK;
+}
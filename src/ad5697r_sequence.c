@@ -0,0 +1,360 @@
+/*! @file ad5697r_sequence.c
+ * @brief Precompiled command sequences for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_sequence.h"
+#include "ad5697r_priv.h"
+
+/*!
+ * @brief Quarter-wave sine table, sin(pi/2 * n/64) in Q15
+ */
+static const int16_t ad5697r_sineQ15[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+/*!
+ * @brief Returns sin(2 pi phase / 65536) in Q15 using the interpolated quarter-wave table
+ */
+static int32_t ad5697r_sine(const uint16_t phase) {
+    uint16_t quadrant = phase >> 14;
+    uint16_t offset = phase & 0x3FFF;
+    int32_t lo = 0;
+    int32_t hi = 0;
+    int32_t value = 0;
+
+    // Mirror the second and fourth quadrant back onto the first
+    if( quadrant & 0x01 ) {
+        offset = 0x4000 - offset;
+    }
+
+    lo = ad5697r_sineQ15[offset >> 8];
+    hi = (offset >> 8) < 64 ? ad5697r_sineQ15[(offset >> 8) + 1] : lo;
+    value = lo + (((hi - lo) * (int32_t)(offset & 0xFF)) >> 8);
+
+    return (quadrant & 0x02) ? -value : value;
+}
+
+/*!
+ * @brief Clamps a code to the 12bit range
+ */
+static uint16_t ad5697r_seqClamp(const int32_t code) {
+    if( code < 0 ) {
+        return 0;
+    }
+    else if( code > AD5697R_ENC_MAX_CODE ) {
+        return AD5697R_ENC_MAX_CODE;
+    }
+
+    return (uint16_t)code;
+}
+
+/*!
+ * @brief Reserves space for the next frame in the sequence buffer
+ */
+static uint8_t *ad5697r_seqReserve(ad5697r_sequence_t *seq) {
+    uint8_t *frame = NULL;
+
+    if( (seq->len + AD5697R_FRAME_SIZE) <= seq->size ) {
+        frame = &seq->buf[seq->len];
+        seq->len += AD5697R_FRAME_SIZE;
+    }
+
+    return frame;
+}
+
+/*!
+ * @brief Adds a DAC data frame with the provided command to the sequence
+ */
+static ad5697r_return_code_t ad5697r_seqAddDac(ad5697r_sequence_t *seq, const AD5697R_CMD_t cmd, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    uint8_t *frame = NULL;
+
+    if( (seq == NULL) || (seq->buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !ad5697r_encValidChannel(ch) || (outputVal > AD5697R_ENC_MAX_CODE) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    frame = ad5697r_seqReserve(seq);
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    ad5697r_packDacFrame(frame, cmd, ch, outputVal);
+    seq->touched |= ad5697r_shadowDacFlags(ch);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Checks that the sequence has room for the provided number of frames
+ */
+static ad5697r_return_code_t ad5697r_seqCheckRoom(const ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint32_t frames) {
+    if( (seq == NULL) || (seq->buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !ad5697r_encValidChannel(ch) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+    else if( ((seq->size - seq->len) / AD5697R_FRAME_SIZE) < frames ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API initializes an empty sequence
+ */
+ad5697r_return_code_t ad5697r_seqInit(ad5697r_sequence_t *seq, uint8_t *buf, const uint32_t size) {
+    if( (seq == NULL) || (buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( size < AD5697R_FRAME_SIZE ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(seq, 0, sizeof(ad5697r_sequence_t));
+    seq->buf = buf;
+    seq->size = size;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API removes every operation from the sequence
+ */
+ad5697r_return_code_t ad5697r_seqClear(ad5697r_sequence_t *seq) {
+    if( seq == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    seq->len = 0;
+    seq->touched = 0;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API returns the number of frames in the sequence
+ */
+uint32_t ad5697r_seqGetFrames(const ad5697r_sequence_t *seq) {
+    if( seq == NULL ) {
+        return 0;
+    }
+
+    return seq->len / AD5697R_FRAME_SIZE;
+}
+
+/*!
+ * @brief This API adds a write to and update of the DAC channel
+ */
+ad5697r_return_code_t ad5697r_seqAddWriteChannel(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    return ad5697r_seqAddDac(seq, AD5697R_CMD_WRITE_DAC, ch, outputVal);
+}
+
+/*!
+ * @brief This API adds a write to the input register of the DAC channel
+ */
+ad5697r_return_code_t ad5697r_seqAddWriteInputRegister(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t outputVal) {
+    return ad5697r_seqAddDac(seq, AD5697R_CMD_W_INPUT_REG_N, ch, outputVal);
+}
+
+/*!
+ * @brief This API adds an update of the DAC channel(s) from their input registers
+ */
+ad5697r_return_code_t ad5697r_seqAddUpdateChannel(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch) {
+    return ad5697r_seqAddDac(seq, AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, ch, 0x0000);
+}
+
+/*!
+ * @brief This API adds a staged load of both channels followed by a single update
+ */
+ad5697r_return_code_t ad5697r_seqAddSynchronized(ad5697r_sequence_t *seq, const uint16_t outputValA, const uint16_t outputValB) {
+    ad5697r_return_code_t ret = ad5697r_seqCheckRoom(seq, AD5697R_OUTPUT_CH_A_B, 3);
+
+    // Check both codes up front so a bad one leaves the sequence untouched
+    if( (ret == AD5697R_RET_OK) && ((outputValA > AD5697R_ENC_MAX_CODE) || (outputValB > AD5697R_ENC_MAX_CODE)) )
+        ret = AD5697R_RET_INV_PARAM;
+
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A, outputValA);
+
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_B, outputValB);
+
+    if( ret == AD5697R_RET_OK )
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, AD5697R_OUTPUT_CH_A_B, 0x0000);
+
+    return ret;
+}
+
+/*!
+ * @brief This API adds a power down/power up of both channels
+ */
+ad5697r_return_code_t ad5697r_seqAddOperatingMode(ad5697r_sequence_t *seq, const ad5697r_operation_mode_t modeA, const ad5697r_operation_mode_t modeB) {
+    uint8_t *frame = NULL;
+
+    if( (seq == NULL) || (seq->buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (modeA >= AD5697R_OP_MODE__MAX__) || (modeB >= AD5697R_OP_MODE__MAX__) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    frame = ad5697r_seqReserve(seq);
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    ad5697r_packPowerFrame(frame, modeA, modeB);
+    seq->touched |= AD5697R_SHADOW_POWER;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API adds an internal reference change
+ */
+ad5697r_return_code_t ad5697r_seqAddReferenceMode(ad5697r_sequence_t *seq, const ad5697r_reference_t refSelect) {
+    uint8_t *frame = NULL;
+
+    if( (seq == NULL) || (seq->buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( refSelect >= AD5697R_REF__MAX__ ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    frame = ad5697r_seqReserve(seq);
+    if( frame == NULL ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    ad5697r_packReferenceFrame(frame, refSelect);
+    seq->touched |= AD5697R_SHADOW_REF;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API adds a write to and update of the DAC channel for every code of the table
+ */
+ad5697r_return_code_t ad5697r_seqAddTable(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t *table, const uint32_t samples) {
+    ad5697r_return_code_t ret = ad5697r_seqCheckRoom(seq, ch, samples);
+    uint32_t i = 0;
+
+    if( table == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    // Check every code up front so a bad one leaves the sequence untouched
+    for( i = 0; (i < samples) && (ret == AD5697R_RET_OK); i++ ) {
+        if( table[i] > AD5697R_ENC_MAX_CODE ) {
+            ret = AD5697R_RET_INV_PARAM;
+        }
+    }
+
+    for( i = 0; (i < samples) && (ret == AD5697R_RET_OK); i++ ) {
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_WRITE_DAC, ch, table[i]);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API adds one period of a sine wave
+ */
+ad5697r_return_code_t ad5697r_seqAddSine(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint32_t samples, const uint16_t offset, const uint16_t amplitude) {
+    ad5697r_return_code_t ret = ad5697r_seqCheckRoom(seq, ch, samples);
+    uint32_t i = 0;
+
+    for( i = 0; (i < samples) && (ret == AD5697R_RET_OK); i++ ) {
+        uint16_t phase = (uint16_t)(((uint64_t)i << 16) / samples);
+        int32_t value = ((int32_t)amplitude * ad5697r_sine(phase) + (1 << 14)) >> 15;
+
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_WRITE_DAC, ch, ad5697r_seqClamp((int32_t)offset + value));
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API adds one period of a triangle wave
+ */
+ad5697r_return_code_t ad5697r_seqAddTriangle(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint32_t samples, const uint16_t low, const uint16_t high) {
+    ad5697r_return_code_t ret = ad5697r_seqCheckRoom(seq, ch, samples);
+    uint32_t half = samples / 2;
+    uint32_t i = 0;
+
+    if( (ret == AD5697R_RET_OK) && ((low > high) || (high > AD5697R_ENC_MAX_CODE) || (samples < 2)) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    for( i = 0; (i < samples) && (ret == AD5697R_RET_OK); i++ ) {
+        uint32_t pos = (i <= half) ? i : (samples - i);
+        uint16_t code = low + (uint16_t)(((uint32_t)(high - low) * pos) / half);
+
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_WRITE_DAC, ch, ad5697r_seqClamp(code));
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API adds a calibration sweep from start to stop (inclusive) in steps
+ */
+ad5697r_return_code_t ad5697r_seqAddSweep(ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const uint16_t start, const uint16_t stop, const uint16_t step) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint32_t frames = 0;
+    uint32_t i = 0;
+
+    if( (step == 0) || (start > AD5697R_ENC_MAX_CODE) || (stop > AD5697R_ENC_MAX_CODE) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    frames = ((start <= stop) ? (stop - start) : (start - stop)) / step + 1;
+
+    ret = ad5697r_seqCheckRoom(seq, ch, frames);
+    for( i = 0; (i < frames) && (ret == AD5697R_RET_OK); i++ ) {
+        uint16_t code = (start <= stop) ? (start + (i * step)) : (start - (i * step));
+
+        ret = ad5697r_seqAddDac(seq, AD5697R_CMD_WRITE_DAC, ch, code);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API writes the whole sequence to the device in a single transaction
+ */
+ad5697r_return_code_t ad5697r_seqReplay(ad5697r_dev_t *dev, const ad5697r_sequence_t *seq) {
+    return ad5697r_seqReplayChunk(dev, seq, 0, ad5697r_seqGetFrames(seq));
+}
+
+/*!
+ * @brief This API writes a range of frames of the sequence in a single transaction
+ */
+ad5697r_return_code_t ad5697r_seqReplayChunk(ad5697r_dev_t *dev, const ad5697r_sequence_t *seq, const uint32_t firstFrame, const uint32_t frames) {
+    if( (dev == NULL) || (dev->intf.write == NULL) || (seq == NULL) || (seq->buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (frames == 0) || (firstFrame >= ad5697r_seqGetFrames(seq)) || (frames > (ad5697r_seqGetFrames(seq) - firstFrame)) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // The sequence bypasses the shadow registers, so forget what it writes
+    dev->registers.bits.valid &= ~seq->touched;
+
+    return ad5697r_busWrite(dev, &seq->buf[firstFrame * AD5697R_FRAME_SIZE], frames * AD5697R_FRAME_SIZE);
+}
@@ -0,0 +1,119 @@
+/*! @file ad5697r_setpoint.c
+ * @brief ISR-safe triple-buffered setpoints for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_setpoint.h"
+#include "ad5697r_priv.h"
+
+#define AD5697R_SETPOINT_FRESH  (0x80)  /*! @brief Flags a latest buffer the ISR has not picked up */
+#define AD5697R_SETPOINT_INDEX  (0x03)  /*! @brief Buffer index bits of the latest buffer */
+
+/*!
+ * @brief Encodes the frames of a setpoint into a buffer
+ */
+static void ad5697r_setpointEncode(const ad5697r_setpoint_t *sp, ad5697r_setpoint_buf_t *buf, const uint16_t codeA, const uint16_t codeB) {
+    if( sp->ch == AD5697R_OUTPUT_CH_A_B ) {
+        // Same frames as ad5697r_writeChannelsSynchronized()
+        ad5697r_packDacFrame(&buf->frames[0], AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A, codeA);
+        ad5697r_packDacFrame(&buf->frames[AD5697R_FRAME_SIZE], AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_B, codeB);
+        ad5697r_packDacFrame(&buf->frames[2 * AD5697R_FRAME_SIZE], AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, AD5697R_OUTPUT_CH_A_B, 0x0000);
+    }
+    else {
+        ad5697r_packDacFrame(buf->frames, AD5697R_CMD_WRITE_DAC, sp->ch, codeA);
+    }
+
+    buf->code[0] = codeA;
+    buf->code[1] = (sp->ch == AD5697R_OUTPUT_CH_A_B) ? codeB : codeA;
+}
+
+/*!
+ * @brief This API initializes a setpoint block with the initial codes
+ */
+ad5697r_return_code_t ad5697r_setpointInit(ad5697r_setpoint_t *sp, ad5697r_dev_t *dev, const ad5697r_output_channel_t ch,
+                                           const uint16_t codeA, const uint16_t codeB, const ad5697r_write_fptr_t write) {
+    if( (sp == NULL) || (dev == NULL) || ((write == NULL) && (dev->intf.write == NULL)) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( ((ch != AD5697R_OUTPUT_CH_A) && (ch != AD5697R_OUTPUT_CH_B) && (ch != AD5697R_OUTPUT_CH_A_B)) ||
+             (codeA > 0x0FFF) || ((ch == AD5697R_OUTPUT_CH_A_B) && (codeB > 0x0FFF)) || (dev->intf.i2c_addr > 0x7F) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(sp, 0, sizeof(*sp));
+    sp->ch = ch;
+    sp->len = (ch == AD5697R_OUTPUT_CH_A_B) ? (3 * AD5697R_FRAME_SIZE) : AD5697R_FRAME_SIZE;
+    sp->i2c_addr = dev->intf.i2c_addr;
+    // intf.write is shared with the main loop, whose other bus accesses then have to mask the ISR
+    sp->write = (write != NULL) ? write : dev->intf.write;
+
+    // The ISR starts out on buffer 0, the producer fills buffer 2 next
+    ad5697r_setpointEncode(sp, &sp->buf[0], codeA, codeB);
+    sp->front = 0;
+    sp->latest = 1;
+    sp->back = 2;
+
+    // The published frames bypass the shadow, so what it holds for the channels goes stale
+    dev->registers.bits.valid &= ~ad5697r_shadowDacFlags(ch);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets new codes
+ */
+ad5697r_return_code_t ad5697r_setpointSet(ad5697r_setpoint_t *sp, const uint16_t codeA, const uint16_t codeB) {
+    uint8_t prev = 0;
+
+    if( (sp == NULL) || (sp->write == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (codeA > 0x0FFF) || ((sp->ch == AD5697R_OUTPUT_CH_A_B) && (codeB > 0x0FFF)) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    ad5697r_setpointEncode(sp, &sp->buf[sp->back], codeA, codeB);
+
+    // Release the frames to the ISR and take back the buffer it no longer reads
+    prev = __atomic_exchange_n(&sp->latest, (uint8_t)(sp->back | AD5697R_SETPOINT_FRESH), __ATOMIC_ACQ_REL);
+    sp->back = prev & AD5697R_SETPOINT_INDEX;
+
+    sp->stats.sets++;
+    sp->stats.overwritten += (prev & AD5697R_SETPOINT_FRESH) ? 1 : 0;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API writes the frames of the latest complete setpoint, from the interrupt
+ */
+int8_t ad5697r_setpointPublish(ad5697r_setpoint_t *sp) {
+    int8_t ret = AD5697R_RET_OK;
+
+    if( __atomic_load_n(&sp->latest, __ATOMIC_RELAXED) & AD5697R_SETPOINT_FRESH ) {
+        sp->front = __atomic_exchange_n(&sp->latest, sp->front, __ATOMIC_ACQ_REL) & AD5697R_SETPOINT_INDEX;
+        sp->stats.fresh++;
+    }
+
+    ret = sp->write(sp->i2c_addr, sp->buf[sp->front].frames, sp->len);
+
+    sp->stats.published++;
+    sp->stats.writeErrors += (ret != AD5697R_RET_OK) ? 1 : 0;
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns the codes of the setpoint published last
+ */
+ad5697r_return_code_t ad5697r_setpointGetPublished(const ad5697r_setpoint_t *sp, uint16_t *codeA, uint16_t *codeB) {
+    if( (sp == NULL) || (codeA == NULL) || (codeB == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    *codeA = sp->buf[sp->front].code[0];
+    *codeB = sp->buf[sp->front].code[1];
+
+    return AD5697R_RET_OK;
+}
@@ -0,0 +1,221 @@
+/*! @file ad5697r_stream.c
+ * @brief Waveform streaming engine for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_stream.h"
+#include "ad5697r_encode.h"
+
+/*!
+ * @brief Returns the current stream time
+ */
+static uint32_t ad5697r_streamNow(const ad5697r_stream_t *stream) {
+    if( stream->config.get_time_us != NULL ) {
+        return stream->config.get_time_us();
+    }
+
+    return stream->paceUs;
+}
+
+/*!
+ * @brief Returns the absolute deadline of the provided slot
+ */
+static uint32_t ad5697r_streamDeadline(const ad5697r_stream_t *stream, const uint32_t slot) {
+    // Computed from the start every time so the rounding never accumulates
+    return stream->startUs + (uint32_t)(((uint64_t)slot * 1000000u) / stream->config.sampleRate);
+}
+
+/*!
+ * @brief This API initializes a stream on top of the provided device and ring buffer
+ */
+ad5697r_return_code_t ad5697r_streamInit(ad5697r_stream_t *stream, ad5697r_dev_t *dev, const ad5697r_stream_config_t *config, uint16_t *ring, const uint32_t capacity) {
+    if( (stream == NULL) || (dev == NULL) || (config == NULL) || (ring == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    // Without a clock the stream time only advances by waiting, so it needs one of the two
+    else if( (config->get_time_us == NULL) && (dev->intf.delay_us == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    // The free running indices wrap onto the same slots only with a power of two capacity
+    else if( (config->layout >= AD5697R_STREAM__MAX__) || !ad5697r_encValidChannel(config->ch) ||
+             ((config->layout == AD5697R_STREAM_INTERLEAVED) && (config->ch != AD5697R_OUTPUT_CH_A_B)) ||
+             (config->sampleRate == 0) || (capacity == 0) || ((capacity & (capacity - 1)) != 0) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(stream, 0, sizeof(ad5697r_stream_t));
+    stream->dev = dev;
+    stream->config = *config;
+    stream->ring = ring;
+    stream->capacity = capacity;
+    stream->mask = capacity - 1;
+    stream->frameCodes = (config->layout == AD5697R_STREAM_INTERLEAVED) ? 2 : 1;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API queues frames into the ring buffer
+ */
+ad5697r_return_code_t ad5697r_streamWrite(ad5697r_stream_t *stream, const uint16_t *codes, const uint32_t frames, uint32_t *queued) {
+    uint32_t head = 0;
+    uint32_t count = 0;
+    uint32_t i = 0;
+
+    if( (stream == NULL) || (stream->ring == NULL) || (codes == NULL) || (queued == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    // The pump may run concurrently: acquire its tail so the slots it released are free
+    head = __atomic_load_n(&stream->head, __ATOMIC_RELAXED);
+    count = stream->capacity - (head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE));
+    if( count > frames ) {
+        count = frames;
+    }
+
+    for( i = 0; i < count; i++ ) {
+        uint32_t idx = ((head + i) & stream->mask) * stream->frameCodes;
+
+        stream->ring[idx] = codes[i * stream->frameCodes];
+        if( stream->frameCodes == 2 ) {
+            stream->ring[idx + 1] = codes[(i * stream->frameCodes) + 1];
+        }
+    }
+
+    // Publish the frames only once they have been copied in
+    __atomic_store_n(&stream->head, head + count, __ATOMIC_RELEASE);
+    *queued = count;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API returns the number of frames waiting in the ring buffer
+ */
+uint32_t ad5697r_streamGetLevel(const ad5697r_stream_t *stream) {
+    if( stream == NULL ) {
+        return 0;
+    }
+
+    return __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE);
+}
+
+/*!
+ * @brief This API starts the stream
+ */
+ad5697r_return_code_t ad5697r_streamStart(ad5697r_stream_t *stream) {
+    if( (stream == NULL) || (stream->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(&stream->stats, 0, sizeof(ad5697r_stream_stats_t));
+    stream->slot = 0;
+    stream->startUs = ad5697r_streamNow(stream);
+    stream->running = true;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API stops the stream
+ */
+ad5697r_return_code_t ad5697r_streamStop(ad5697r_stream_t *stream) {
+    if( stream == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    stream->running = false;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API writes the frames that are due to the device
+ */
+ad5697r_return_code_t ad5697r_streamPump(ad5697r_stream_t *stream, const uint32_t maxFrames) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    ad5697r_dev_t *dev = NULL;
+    uint32_t serviced = 0;
+    uint32_t tail = 0;
+
+    if( (stream == NULL) || (stream->dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !stream->running ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    dev = stream->dev;
+
+    for( serviced = 0; serviced < maxFrames; serviced++ ) {
+        uint32_t deadline = ad5697r_streamDeadline(stream, stream->slot);
+        uint32_t now = ad5697r_streamNow(stream);
+        int32_t early = (int32_t)(deadline - now);
+        uint32_t lateness = 0;
+        uint16_t *frame = NULL;
+
+        if( early > 0 ) {
+            if( dev->intf.delay_us == NULL ) {
+                break;
+            }
+
+            dev->intf.delay_us((uint32_t)early);
+            stream->paceUs += (uint32_t)early;
+            now = ad5697r_streamNow(stream);
+        }
+
+        stream->slot++;
+
+        // Acquire the head so the frames the producer published are visible
+        tail = __atomic_load_n(&stream->tail, __ATOMIC_RELAXED);
+        if( __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) == tail ) {
+            // Nothing to output, the DAC holds the previous code for this slot
+            stream->stats.underruns++;
+            continue;
+        }
+
+        frame = &stream->ring[(tail & stream->mask) * stream->frameCodes];
+
+        if( stream->config.layout == AD5697R_STREAM_INTERLEAVED ) {
+            ret = ad5697r_writeChannelsSynchronized(dev, frame[0], frame[1]);
+        }
+        else {
+            ret = ad5697r_writeChannel(dev, stream->config.ch, frame[0]);
+        }
+
+        // Release the slot only once the frame has been read
+        __atomic_store_n(&stream->tail, tail + 1, __ATOMIC_RELEASE);
+
+        if( ret != AD5697R_RET_OK ) {
+            stream->stats.writeErrors++;
+            break;
+        }
+
+        if( (int32_t)(now - deadline) > 0 ) {
+            lateness = now - deadline;
+        }
+
+        stream->stats.frames++;
+        stream->stats.lastJitterUs = lateness;
+        stream->stats.totalJitterUs += lateness;
+        if( lateness > stream->stats.maxJitterUs ) {
+            stream->stats.maxJitterUs = lateness;
+        }
+        stream->stats.elapsedUs = now - stream->startUs;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns the sample rate achieved since the stream was started
+ */
+float ad5697r_streamGetAchievedRate(const ad5697r_stream_t *stream) {
+    if( (stream == NULL) || (stream->stats.frames < 2) || (stream->stats.elapsedUs == 0) ) {
+        return 0.0f;
+    }
+
+    // The first frame is written at the start, so N frames span N - 1 periods
+    return ((float)(stream->stats.frames - 1) * 1000000.0f) / (float)stream->stats.elapsedUs;
+}
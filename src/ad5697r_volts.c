@@ -0,0 +1,373 @@
+/*! @file ad5697r_volts.c
+ * @brief Voltage domain conversion for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "ad5697r_volts.h"
+#include "ad5697r_priv.h"
+
+#if !defined(AD5697R_VOLTS_SCALAR)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AD5697R_VOLTS_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AD5697R_VOLTS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AD5697R_VOLTS_NEON
+#endif
+#endif
+
+#define AD5697R_CODES           (4096.0f)   /*! @brief Codes across the span of the output */
+#define AD5697R_VOLTS_BLOCK     (64)        /*! @brief Samples converted per block on the stack */
+#define AD5697R_Q16_ONE         (65536.0f)  /*! @brief 1.0 in Q16.16 */
+
+/*!
+ * @brief Returns the coefficient slot of a channel, -1 for anything but A or B
+ */
+static int8_t ad5697r_voltsSlot(const ad5697r_output_channel_t ch) {
+    if( ch == AD5697R_OUTPUT_CH_A ) {
+        return 0;
+    }
+    else if( ch == AD5697R_OUTPUT_CH_B ) {
+        return 1;
+    }
+
+    return -1;
+}
+
+/*!
+ * @brief Clamps a code to the 12bit range and rounds it up or down to a whole code
+ */
+static float ad5697r_voltsLimit(const float code, const bool up) {
+    float whole = 0.0f;
+
+    // Also catches the infinities of an open calibration range
+    if( !(code > 0.0f) ) {
+        return 0.0f;
+    }
+    else if( !(code < (float)AD5697R_ENC_MAX_CODE) ) {
+        return (float)AD5697R_ENC_MAX_CODE;
+    }
+
+    whole = (float)(int32_t)code;
+    if( up && (whole < code) ) {
+        whole += 1.0f;
+    }
+
+    return whole;
+}
+
+/*!
+ * @brief Computes the coefficients of a channel for the output span
+ */
+static void ad5697r_voltsCompute(ad5697r_volts_t *conv, const uint8_t slot, const float span) {
+    const ad5697r_volts_cal_t *cal = &conv->cal[slot];
+    ad5697r_volts_coef_t *coef = &conv->coef[slot];
+
+    coef->scale = AD5697R_CODES / (span * cal->gain);
+    coef->bias = -cal->offset * coef->scale;
+
+    // Keep the clamped codes inside the requested voltage range
+    coef->lo = ad5697r_voltsLimit(cal->min * coef->scale + coef->bias, true);
+    coef->hi = ad5697r_voltsLimit(cal->max * coef->scale + coef->bias, false);
+    if( coef->hi < coef->lo ) {
+        coef->hi = coef->lo;
+    }
+}
+
+/*!
+ * @brief Recomputes the coefficients when the reference changed, checks the channel
+ */
+static ad5697r_return_code_t ad5697r_voltsPrepare(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const void *in, const void *out) {
+    uint8_t refMode = AD5697R_REF_ON;
+    float span = 0.0f;
+
+    if( (conv == NULL) || (conv->dev == NULL) || (in == NULL) || (out == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( ad5697r_voltsSlot(ch) < 0 ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // The internal reference is on after a power-on reset
+    if( conv->dev->registers.bits.valid & AD5697R_SHADOW_REF ) {
+        refMode = conv->dev->registers.bits.ref_mode;
+    }
+
+    if( refMode != conv->refMode ) {
+        span = (refMode == AD5697R_REF_ON) ? AD5697R_INT_REF_VOLTS : conv->extRef;
+        if( span <= 0.0f ) {
+            return AD5697R_RET_ERROR;
+        }
+
+        span *= conv->gain;
+        ad5697r_voltsCompute(conv, 0, span);
+        ad5697r_voltsCompute(conv, 1, span);
+        conv->refMode = refMode;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief Converts one sample, the reference the vector kernels must match
+ */
+static uint16_t ad5697r_voltsScalar(const ad5697r_volts_coef_t *coef, const float volts) {
+    float code = volts * coef->scale;
+
+    code = code + coef->bias;
+
+    // Same operand order as maxps/minps, so NaN clamps to the lowest code
+    code = (code > coef->lo) ? code : coef->lo;
+    code = (code < coef->hi) ? code : coef->hi;
+
+    return (uint16_t)(code + 0.5f);
+}
+
+/*!
+ * @brief Converts an array of samples with the vector kernel and a scalar tail
+ */
+static void ad5697r_voltsKernel(const ad5697r_volts_coef_t *coef, const float *volts, uint16_t *codes, const uint32_t samples) {
+    uint32_t i = 0;
+
+#if defined(AD5697R_VOLTS_AVX2)
+    const __m256 scale = _mm256_set1_ps(coef->scale);
+    const __m256 bias = _mm256_set1_ps(coef->bias);
+    const __m256 lo = _mm256_set1_ps(coef->lo);
+    const __m256 hi = _mm256_set1_ps(coef->hi);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    for( ; (i + 8) <= samples; i += 8 ) {
+        __m256 code = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&volts[i]), scale), bias);
+        __m256i word = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(code, lo), hi), half));
+
+        // Codes fit in 12 bits, the signed saturating pack is exact
+        _mm_storeu_si128((__m128i *)&codes[i],
+                         _mm_packs_epi32(_mm256_castsi256_si128(word), _mm256_extracti128_si256(word, 1)));
+    }
+#elif defined(AD5697R_VOLTS_SSE2)
+    const __m128 scale = _mm_set1_ps(coef->scale);
+    const __m128 bias = _mm_set1_ps(coef->bias);
+    const __m128 lo = _mm_set1_ps(coef->lo);
+    const __m128 hi = _mm_set1_ps(coef->hi);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for( ; (i + 8) <= samples; i += 8 ) {
+        __m128 code0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&volts[i]), scale), bias);
+        __m128 code1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&volts[i + 4]), scale), bias);
+        __m128i word0 = _mm_cvttps_epi32(_mm_add_ps(_mm_min_ps(_mm_max_ps(code0, lo), hi), half));
+        __m128i word1 = _mm_cvttps_epi32(_mm_add_ps(_mm_min_ps(_mm_max_ps(code1, lo), hi), half));
+
+        // Codes fit in 12 bits, the signed saturating pack is exact
+        _mm_storeu_si128((__m128i *)&codes[i], _mm_packs_epi32(word0, word1));
+    }
+#elif defined(AD5697R_VOLTS_NEON)
+    const float32x4_t scale = vdupq_n_f32(coef->scale);
+    const float32x4_t bias = vdupq_n_f32(coef->bias);
+    const float32x4_t lo = vdupq_n_f32(coef->lo);
+    const float32x4_t hi = vdupq_n_f32(coef->hi);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+
+    for( ; (i + 8) <= samples; i += 8 ) {
+        // Separate multiply and add, a fused one would round differently from the scalar tail
+        float32x4_t code0 = vaddq_f32(vmulq_f32(vld1q_f32(&volts[i]), scale), bias);
+        float32x4_t code1 = vaddq_f32(vmulq_f32(vld1q_f32(&volts[i + 4]), scale), bias);
+        uint32x4_t word0 = vcvtq_u32_f32(vaddq_f32(vminnmq_f32(vmaxnmq_f32(code0, lo), hi), half));
+        uint32x4_t word1 = vcvtq_u32_f32(vaddq_f32(vminnmq_f32(vmaxnmq_f32(code1, lo), hi), half));
+
+        vst1q_u16(&codes[i], vcombine_u16(vmovn_u32(word0), vmovn_u32(word1)));
+    }
+#endif
+
+    for( ; i < samples; i++ ) {
+        codes[i] = ad5697r_voltsScalar(coef, volts[i]);
+    }
+}
+
+/*!
+ * @brief Widens Q16.16 samples to float, exact for every voltage the DAC can output
+ */
+static void ad5697r_voltsWiden(const int32_t *q16, float *volts, const uint32_t samples) {
+    uint32_t i = 0;
+
+    for( i = 0; i < samples; i++ ) {
+        volts[i] = (float)q16[i] * (1.0f / AD5697R_Q16_ONE);
+    }
+}
+
+/*!
+ * @brief Packs converted codes into write and update frames
+ */
+static void ad5697r_voltsPack(uint8_t *frames, const ad5697r_output_channel_t ch, const uint16_t *codes, const uint32_t samples) {
+    uint32_t i = 0;
+
+    for( i = 0; i < samples; i++ ) {
+        ad5697r_packDacFrame(&frames[i * AD5697R_FRAME_SIZE], AD5697R_CMD_WRITE_DAC, ch, codes[i]);
+    }
+}
+
+/*!
+ * @brief This API initializes a converter for a device
+ */
+ad5697r_return_code_t ad5697r_voltsInit(ad5697r_volts_t *conv, ad5697r_dev_t *dev, const uint8_t gain, const float extRef) {
+    uint8_t i = 0;
+
+    if( (conv == NULL) || (dev == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( ((gain != 1) && (gain != 2)) || !(extRef >= 0.0f) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(conv, 0, sizeof(*conv));
+    conv->dev = dev;
+    conv->gain = gain;
+    conv->extRef = extRef;
+    conv->refMode = AD5697R_REF__MAX__;
+
+    for( i = 0; i < 2; i++ ) {
+        conv->cal[i].gain = 1.0f;
+        conv->cal[i].offset = 0.0f;
+        conv->cal[i].min = -FLT_MAX;
+        conv->cal[i].max = FLT_MAX;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API sets the calibration of a channel
+ */
+ad5697r_return_code_t ad5697r_voltsSetCalibration(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const ad5697r_volts_cal_t *cal) {
+    int8_t slot = ad5697r_voltsSlot(ch);
+
+    if( (conv == NULL) || (cal == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (slot < 0) || !(cal->gain > 0.0f) || !(cal->min <= cal->max) || !isfinite(cal->offset) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    conv->cal[slot] = *cal;
+
+    // Recompute on the next conversion
+    conv->refMode = AD5697R_REF__MAX__;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API converts voltages to calibrated 12bit codes
+ */
+ad5697r_return_code_t ad5697r_voltsToCodes(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const float *volts, uint16_t *codes, const uint32_t samples) {
+    ad5697r_return_code_t ret = ad5697r_voltsPrepare(conv, ch, volts, codes);
+
+    if( ret == AD5697R_RET_OK ) {
+        ad5697r_voltsKernel(&conv->coef[ad5697r_voltsSlot(ch)], volts, codes, samples);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API converts Q16.16 fixed-point voltages to calibrated 12bit codes
+ */
+ad5697r_return_code_t ad5697r_voltsQ16ToCodes(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const int32_t *volts, uint16_t *codes, const uint32_t samples) {
+    ad5697r_return_code_t ret = ad5697r_voltsPrepare(conv, ch, volts, codes);
+    float block[AD5697R_VOLTS_BLOCK];
+    uint32_t done = 0;
+    uint32_t n = 0;
+
+    for( done = 0; (ret == AD5697R_RET_OK) && (done < samples); done += n ) {
+        n = ((samples - done) < AD5697R_VOLTS_BLOCK) ? (samples - done) : AD5697R_VOLTS_BLOCK;
+        ad5697r_voltsWiden(&volts[done], block, n);
+        ad5697r_voltsKernel(&conv->coef[ad5697r_voltsSlot(ch)], block, &codes[done], n);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API converts voltages straight to write and update frames
+ */
+ad5697r_return_code_t ad5697r_voltsToFrames(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const float *volts, uint8_t *frames, const uint32_t samples) {
+    ad5697r_return_code_t ret = ad5697r_voltsPrepare(conv, ch, volts, frames);
+    uint16_t codes[AD5697R_VOLTS_BLOCK];
+    uint32_t done = 0;
+    uint32_t n = 0;
+
+    for( done = 0; (ret == AD5697R_RET_OK) && (done < samples); done += n ) {
+        n = ((samples - done) < AD5697R_VOLTS_BLOCK) ? (samples - done) : AD5697R_VOLTS_BLOCK;
+        ad5697r_voltsKernel(&conv->coef[ad5697r_voltsSlot(ch)], &volts[done], codes, n);
+        ad5697r_voltsPack(&frames[done * AD5697R_FRAME_SIZE], ch, codes, n);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API converts Q16.16 fixed-point voltages straight to write and update frames
+ */
+ad5697r_return_code_t ad5697r_voltsQ16ToFrames(ad5697r_volts_t *conv, const ad5697r_output_channel_t ch, const int32_t *volts, uint8_t *frames, const uint32_t samples) {
+    ad5697r_return_code_t ret = ad5697r_voltsPrepare(conv, ch, volts, frames);
+    float block[AD5697R_VOLTS_BLOCK];
+    uint16_t codes[AD5697R_VOLTS_BLOCK];
+    uint32_t done = 0;
+    uint32_t n = 0;
+
+    for( done = 0; (ret == AD5697R_RET_OK) && (done < samples); done += n ) {
+        n = ((samples - done) < AD5697R_VOLTS_BLOCK) ? (samples - done) : AD5697R_VOLTS_BLOCK;
+        ad5697r_voltsWiden(&volts[done], block, n);
+        ad5697r_voltsKernel(&conv->coef[ad5697r_voltsSlot(ch)], block, codes, n);
+        ad5697r_voltsPack(&frames[done * AD5697R_FRAME_SIZE], ch, codes, n);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API converts voltages and appends them to a sequence
+ */
+ad5697r_return_code_t ad5697r_voltsToSequence(ad5697r_volts_t *conv, ad5697r_sequence_t *seq, const ad5697r_output_channel_t ch, const float *volts, const uint32_t samples) {
+    ad5697r_return_code_t ret = ad5697r_voltsPrepare(conv, ch, volts, seq);
+    uint16_t codes[AD5697R_VOLTS_BLOCK];
+    uint32_t done = 0;
+    uint32_t n = 0;
+
+    if( (ret == AD5697R_RET_OK) && (seq->buf == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    // All or nothing, like the other sequence operations
+    if( (ret == AD5697R_RET_OK) && (((uint64_t)seq->len + (uint64_t)samples * AD5697R_FRAME_SIZE) > seq->size) ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    for( done = 0; (ret == AD5697R_RET_OK) && (done < samples); done += n ) {
+        n = ((samples - done) < AD5697R_VOLTS_BLOCK) ? (samples - done) : AD5697R_VOLTS_BLOCK;
+        ad5697r_voltsKernel(&conv->coef[ad5697r_voltsSlot(ch)], &volts[done], codes, n);
+        ret = ad5697r_seqAddTable(seq, ch, codes, n);
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns the name of the conversion kernel
+ */
+const char *ad5697r_voltsGetKernel(void) {
+#if defined(AD5697R_VOLTS_AVX2)
+    return "avx2";
+#elif defined(AD5697R_VOLTS_SSE2)
+    return "sse2";
+#elif defined(AD5697R_VOLTS_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,325 @@
+/*! @file ad5697r_wave.c
+ * @brief Waveform files and their playback for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ad5697r_wave.h"
+#include "ad5697r_priv.h"
+
+static const uint8_t ad5697r_waveMagic[4] = { 'A', 'D', '5', 'W' };
+
+/*!
+ * @brief Returns true for a waveform description the player can write
+ */
+static bool ad5697r_waveValidInfo(const ad5697r_wave_info_t *info) {
+    bool chValid = false;
+
+    if( info->layout == AD5697R_STREAM_INTERLEAVED ) {
+        chValid = (info->ch == AD5697R_OUTPUT_CH_A_B);
+    }
+    else if( info->layout == AD5697R_STREAM_SINGLE ) {
+        chValid = (info->ch == AD5697R_OUTPUT_CH_A) || (info->ch == AD5697R_OUTPUT_CH_B) || (info->ch == AD5697R_OUTPUT_CH_A_B);
+    }
+
+    return chValid && (info->codeBits == AD5697R_WAVE_CODE_BITS) && (info->sampleRate > 0) && (info->samples > 0) &&
+           ((info->loopEnd == 0) ? (info->loopStart == 0) : ((info->loopStart < info->loopEnd) && (info->loopEnd <= info->samples)));
+}
+
+/*!
+ * @brief Returns the command and address byte of each frame of a sample
+ */
+static uint8_t ad5697r_waveFrameHead(const ad5697r_wave_info_t *info, const uint32_t frame) {
+    if( info->layout == AD5697R_STREAM_SINGLE ) {
+        return (uint8_t)((AD5697R_CMD_WRITE_DAC << 4) | info->ch);
+    }
+    else if( frame < 2 ) {
+        return (uint8_t)((AD5697R_CMD_W_INPUT_REG_N << 4) | ((frame == 0) ? AD5697R_OUTPUT_CH_A : AD5697R_OUTPUT_CH_B));
+    }
+
+    return (uint8_t)((AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N << 4) | AD5697R_OUTPUT_CH_A_B);
+}
+
+/*!
+ * @brief Returns the absolute deadline of the provided slot
+ */
+static uint32_t ad5697r_waveDeadline(const ad5697r_wave_player_t *player, const uint32_t slot) {
+    return player->startUs + (uint32_t)(((uint64_t)slot * 1000000u) / player->wave->info.sampleRate);
+}
+
+/*!
+ * @brief Returns the current player time
+ */
+static uint32_t ad5697r_waveNow(const ad5697r_wave_player_t *player) {
+    if( player->config.get_time_us != NULL ) {
+        return player->config.get_time_us();
+    }
+
+    return player->paceUs;
+}
+
+/*!
+ * @brief This API encodes a waveform file header
+ */
+ad5697r_return_code_t ad5697r_waveEncodeHeader(uint8_t *header, const ad5697r_wave_info_t *info) {
+    if( (header == NULL) || (info == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !ad5697r_waveValidInfo(info) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(header, 0, AD5697R_WAVE_HEADER_SIZE);
+    memcpy(header, ad5697r_waveMagic, sizeof(ad5697r_waveMagic));
+    header[4] = AD5697R_WAVE_VERSION;
+    header[5] = (uint8_t)info->layout;
+    header[6] = (uint8_t)info->ch;
+    header[7] = info->codeBits;
+    ad5697r_putLe(&header[8], AD5697R_WAVE_SAMPLE_SIZE(info->layout), 2);
+    ad5697r_putLe(&header[12], info->sampleRate, 4);
+    ad5697r_putLe(&header[16], info->samples, 4);
+    ad5697r_putLe(&header[20], info->loopStart, 4);
+    ad5697r_putLe(&header[24], info->loopEnd, 4);
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API encodes one sample in its wire format
+ */
+ad5697r_return_code_t ad5697r_waveEncodeSample(uint8_t *sample, const ad5697r_wave_info_t *info, const uint16_t *codes) {
+    if( (sample == NULL) || (info == NULL) || (codes == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !ad5697r_waveValidInfo(info) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    if( info->layout == AD5697R_STREAM_INTERLEAVED ) {
+        if( (codes[0] > AD5697R_WAVE_MAX_CODE) || (codes[1] > AD5697R_WAVE_MAX_CODE) ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+
+        // Same frames as ad5697r_writeChannelsSynchronized()
+        ad5697r_encDacUnchecked(&sample[0], AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A, codes[0]);
+        ad5697r_encDacUnchecked(&sample[AD5697R_FRAME_SIZE], AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_B, codes[1]);
+        ad5697r_encDacUnchecked(&sample[2 * AD5697R_FRAME_SIZE], AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N, AD5697R_OUTPUT_CH_A_B, 0x0000);
+    }
+    else {
+        if( codes[0] > AD5697R_WAVE_MAX_CODE ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+
+        ad5697r_encDacUnchecked(sample, AD5697R_CMD_WRITE_DAC, info->ch, codes[0]);
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API opens a waveform file held in memory
+ */
+ad5697r_return_code_t ad5697r_waveOpen(ad5697r_wave_t *wave, const uint8_t *data, const uint32_t len) {
+    ad5697r_wave_info_t info;
+    const uint8_t *frame = NULL;
+    uint32_t sampleSize = 0;
+    uint32_t frames = 0;
+    uint32_t i = 0;
+
+    if( (wave == NULL) || (data == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( (len < AD5697R_WAVE_HEADER_SIZE) || (memcmp(data, ad5697r_waveMagic, sizeof(ad5697r_waveMagic)) != 0) ||
+             (data[4] != AD5697R_WAVE_VERSION) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(&info, 0, sizeof(info));
+    info.layout = (ad5697r_stream_layout_t)data[5];
+    info.ch = (ad5697r_output_channel_t)data[6];
+    info.codeBits = data[7];
+    info.sampleRate = ad5697r_getLe(&data[12], 4);
+    info.samples = ad5697r_getLe(&data[16], 4);
+    info.loopStart = ad5697r_getLe(&data[20], 4);
+    info.loopEnd = ad5697r_getLe(&data[24], 4);
+
+    if( !ad5697r_waveValidInfo(&info) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    sampleSize = AD5697R_WAVE_SAMPLE_SIZE(info.layout);
+    if( (ad5697r_getLe(&data[8], 2) != sampleSize) ||
+        ((uint64_t)info.samples * sampleSize > (uint64_t)(len - AD5697R_WAVE_HEADER_SIZE)) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    // Checked once here, so playback hands the frames to the bus untouched
+    frames = sampleSize / AD5697R_FRAME_SIZE;
+    frame = &data[AD5697R_WAVE_HEADER_SIZE];
+    for( i = 0; i < info.samples * frames; i++, frame += AD5697R_FRAME_SIZE ) {
+        if( (frame[0] != ad5697r_waveFrameHead(&info, i % frames)) || (frame[2] & 0x0F) ) {
+            return AD5697R_RET_INV_PARAM;
+        }
+    }
+
+    wave->info = info;
+    wave->sampleSize = sampleSize;
+    wave->samples = &data[AD5697R_WAVE_HEADER_SIZE];
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API initializes a player of a waveform on the provided device
+ */
+ad5697r_return_code_t ad5697r_wavePlayerInit(ad5697r_wave_player_t *player, ad5697r_dev_t *dev, const ad5697r_wave_t *wave, const ad5697r_wave_config_t *config) {
+    if( (player == NULL) || (dev == NULL) || (wave == NULL) || (wave->samples == NULL) || (config == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    // Without a clock the player time only advances by waiting, so it needs one of the two
+    else if( (config->get_time_us == NULL) && (dev->intf.delay_us == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !ad5697r_waveValidInfo(&wave->info) || (wave->sampleSize != AD5697R_WAVE_SAMPLE_SIZE(wave->info.layout)) ) {
+        return AD5697R_RET_INV_PARAM;
+    }
+
+    memset(player, 0, sizeof(*player));
+    player->dev = dev;
+    player->wave = wave;
+    player->config = *config;
+    if( player->config.chunkSamples == 0 ) {
+        player->config.chunkSamples = 1;
+    }
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API starts the playback from the first sample
+ */
+ad5697r_return_code_t ad5697r_wavePlayerStart(ad5697r_wave_player_t *player) {
+    if( (player == NULL) || (player->dev == NULL) || (player->wave == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    // The frames bypass the shadow, so what it holds for the channels goes stale
+    player->dev->registers.bits.valid &= ~ad5697r_shadowDacFlags(player->wave->info.ch);
+
+    memset(&player->stats, 0, sizeof(player->stats));
+    player->pos = 0;
+    player->loopsLeft = (player->wave->info.loopEnd > 0) ? player->config.loops : 0;
+    player->slot = 0;
+    player->startUs = ad5697r_waveNow(player);
+    player->running = true;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API stops the playback
+ */
+ad5697r_return_code_t ad5697r_wavePlayerStop(ad5697r_wave_player_t *player) {
+    if( player == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    player->running = false;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API writes the samples that are due to the device
+ */
+ad5697r_return_code_t ad5697r_wavePlayerPump(ad5697r_wave_player_t *player, const uint32_t maxSamples) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    const ad5697r_wave_info_t *info = NULL;
+    ad5697r_dev_t *dev = NULL;
+    uint32_t serviced = 0;
+    uint32_t deadline = 0;
+    uint32_t lateness = 0;
+    uint32_t end = 0;
+    uint32_t now = 0;
+    uint32_t n = 0;
+    int32_t early = 0;
+
+    if( (player == NULL) || (player->dev == NULL) || (player->wave == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( !player->running ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    dev = player->dev;
+    info = &player->wave->info;
+
+    while( player->running && (serviced < maxSamples) ) {
+        deadline = ad5697r_waveDeadline(player, player->slot);
+        now = ad5697r_waveNow(player);
+        early = (int32_t)(deadline - now);
+
+        if( early > 0 ) {
+            if( dev->intf.delay_us == NULL ) {
+                break;
+            }
+
+            dev->intf.delay_us((uint32_t)early);
+            player->paceUs += (uint32_t)early;
+            now = ad5697r_waveNow(player);
+        }
+
+        // Take along the following samples that are already due, up to the end of the segment
+        end = (player->loopsLeft > 0) ? info->loopEnd : info->samples;
+        for( n = 1; (n < player->config.chunkSamples) && ((player->pos + n) < end) && ((serviced + n) < maxSamples); n++ ) {
+            if( (int32_t)(ad5697r_waveDeadline(player, player->slot + n) - now) > 0 ) {
+                break;
+            }
+        }
+
+        ret = ad5697r_busWrite(dev, &player->wave->samples[(size_t)player->pos * player->wave->sampleSize], n * player->wave->sampleSize);
+
+        // The slots are spent either way, a failed transaction is not repeated late
+        player->pos += n;
+        player->slot += n;
+        serviced += n;
+
+        // Keep the deadlines exact without letting the time since the start overflow
+        while( player->slot >= info->sampleRate ) {
+            player->slot -= info->sampleRate;
+            player->startUs += 1000000u;
+        }
+
+        if( player->pos == end ) {
+            if( player->loopsLeft > 0 ) {
+                player->pos = info->loopStart;
+                player->loopsLeft -= (player->loopsLeft != AD5697R_WAVE_LOOP_FOREVER) ? 1 : 0;
+                player->stats.loops++;
+            }
+            else {
+                player->running = false;
+            }
+        }
+
+        if( ret != AD5697R_RET_OK ) {
+            player->stats.writeErrors++;
+            break;
+        }
+
+        lateness = ((int32_t)(now - deadline) > 0) ? (now - deadline) : 0;
+        if( lateness > player->stats.maxLatenessUs ) {
+            player->stats.maxLatenessUs = lateness;
+        }
+        player->stats.samples += n;
+        player->stats.transactions++;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief This API returns whether the playback is over
+ */
+bool ad5697r_wavePlayerIsDone(const ad5697r_wave_player_t *player) {
+    return (player == NULL) || !player->running;
+}
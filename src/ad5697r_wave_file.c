@@ -0,0 +1,76 @@
+/*! @file ad5697r_wave_file.c
+ * @brief Waveform files on POSIX hosts for the AD5697R 12-Bit, DAC C driver.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ad5697r_wave_file.h"
+
+/*!
+ * @brief This API maps a waveform file read-only and opens it
+ */
+ad5697r_return_code_t ad5697r_waveMap(ad5697r_wave_map_t *map, const char *path) {
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    struct stat st;
+    void *data = NULL;
+    int fd = -1;
+
+    if( (map == NULL) || (path == NULL) ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+
+    memset(map, 0, sizeof(*map));
+
+    fd = open(path, O_RDONLY);
+    if( fd < 0 ) {
+        return AD5697R_RET_ERROR;
+    }
+    if( (fstat(fd, &st) < 0) || (st.st_size <= 0) || ((uint64_t)st.st_size > UINT32_MAX) ) {
+        close(fd);
+        return AD5697R_RET_ERROR;
+    }
+
+    // The mapping outlives the descriptor
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if( data == MAP_FAILED ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    // Playback walks the samples front to back
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    ret = ad5697r_waveOpen(&map->wave, (const uint8_t *)data, (uint32_t)st.st_size);
+    if( ret != AD5697R_RET_OK ) {
+        munmap(data, (size_t)st.st_size);
+        return ret;
+    }
+
+    map->data = (const uint8_t *)data;
+    map->len = (uint32_t)st.st_size;
+
+    return AD5697R_RET_OK;
+}
+
+/*!
+ * @brief This API unmaps a waveform file
+ */
+ad5697r_return_code_t ad5697r_waveUnmap(ad5697r_wave_map_t *map) {
+    if( map == NULL ) {
+        return AD5697R_RET_NULL_PTR;
+    }
+    else if( map->data == NULL ) {
+        return AD5697R_RET_OK;
+    }
+
+    if( munmap((void *)map->data, map->len) < 0 ) {
+        return AD5697R_RET_ERROR;
+    }
+
+    memset(map, 0, sizeof(*map));
+
+    return AD5697R_RET_OK;
+}
@@ -30,7 +30,7 @@ int main(void) {
     ad5697r_return_code_t ret = AD5697R_RET_OK;
 
     // Create an instance of our ad5697r device
-    ad5697r_dev_t dev;
+    ad5697r_dev_t dev = {0};
 
     // Provide the hardware abstraction functions for
     // I2c Read/Write and a micro-second delay function
@@ -39,17 +39,23 @@ int main(void) {
     dev.intf.read = usr_i2c_read;
     dev.intf.delay_us = usr_delay_us;
 
-    // Set the desired operation mode for our DAC outputs
+    // Describe the state the DAC should start up in, starting from the power-on state
+    ad5697r_config_t config = {0};
+    config.softReset = true;
+
     // Enable channel A to run in normal operation
-    ret = ad5697r_setOperatingMode(&dev, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE_NORMAL);
+    config.modeA = AD5697R_OP_MODE_NORMAL;
 
     // Disable channel B and put a 1K resistance to ground on the output
-    if( ret == AD5697R_RET_OK )
-        ret = ad5697r_setOperatingMode(&dev, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_1K_TO_GND);
+    config.modeB = AD5697R_OP_MODE_1K_TO_GND;
 
     // Set the DAC output value to 50% of the reference voltage
-    if( ret == AD5697R_RET_OK )
-        ret = ad5697r_writeChannel(&dev, AD5697R_OUTPUT_CH_A, 0x00FF);
+    config.setCodes = true;
+    config.codeA = 0x0800;
+    config.codeB = 0x0800;
+
+    // Apply the configuration in as few transactions as possible and wait for the output to settle
+    ret = ad5697r_init(&dev, &config, NULL);
 
     return ret;
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_async.h"
+#include "ad5697r_async_thread.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_async_queue_t queue;
+static ad5697r_async_req_t ring[4];
+
+static uint8_t started[AD5697R_ASYNC_MAX_LEN];
+static uint32_t started_len = 0;
+static uint32_t start_count = 0;
+static ad5697r_return_code_t start_ret = AD5697R_RET_OK;
+
+static uint32_t cb_count = 0;
+static ad5697r_return_code_t cb_ret = AD5697R_RET_OK;
+
+static ad5697r_return_code_t manual_start(void *ctx, const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    memcpy(started, data, len);
+    started_len = len;
+    start_count++;
+    return start_ret;
+}
+
+static void count_cb(void *ctx, const ad5697r_return_code_t ret) {
+    cb_count++;
+    cb_ret = ret;
+}
+
+void setUp(void)
+{
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    ad5697r_device.intf.write = ad5697r_asyncWrite;
+
+    started_len = 0;
+    start_count = 0;
+    start_ret = AD5697R_RET_OK;
+    cb_count = 0;
+    cb_ret = AD5697R_RET_OK;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncInit(&queue, ring, 4, manual_start, NULL));
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Queue ******************************/
+void test_ad5697r_asyncInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_asyncInit(NULL, ring, 4, manual_start, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_asyncInit(&queue, ring, 4, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_asyncInit(&queue, ring, 0, manual_start, NULL));
+}
+
+void test_ad5697r_asyncSubmit_StartsWhenIdle(void) {
+    const uint8_t first[] = {0x31, 0x12, 0x30};
+    const uint8_t second[] = {0x38, 0x45, 0x60};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncSubmit(&queue, 0x0C, first, sizeof(first), count_cb, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncSubmit(&queue, 0x0C, second, sizeof(second), count_cb, NULL));
+
+    // Only the first request is in flight
+    TEST_ASSERT_EQUAL_UINT32(1, start_count);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(first, started, sizeof(first));
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_asyncGetPending(&queue));
+
+    ad5697r_asyncComplete(&queue, AD5697R_RET_OK);
+    TEST_ASSERT_EQUAL_UINT32(1, cb_count);
+    TEST_ASSERT_EQUAL_UINT32(2, start_count);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(second, started, sizeof(second));
+
+    ad5697r_asyncComplete(&queue, AD5697R_RET_TIMEOUT);
+    TEST_ASSERT_EQUAL_UINT32(2, cb_count);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, cb_ret);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_asyncGetPending(&queue));
+    TEST_ASSERT_EQUAL_UINT32(1, queue.stats.errors);
+
+    // Spurious completions are ignored
+    ad5697r_asyncComplete(&queue, AD5697R_RET_OK);
+    TEST_ASSERT_EQUAL_UINT32(2, cb_count);
+}
+
+void test_ad5697r_asyncSubmit_RingFull(void) {
+    const uint8_t frame[] = {0x31, 0x00, 0x00};
+    uint8_t i = 0;
+
+    for( i = 0; i < 4; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncSubmit(&queue, 0x0C, frame, sizeof(frame), NULL, NULL));
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_asyncSubmit(&queue, 0x0C, frame, sizeof(frame), NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, queue.stats.full);
+
+    ad5697r_asyncComplete(&queue, AD5697R_RET_OK);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncSubmit(&queue, 0x0C, frame, sizeof(frame), NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_asyncSubmit(&queue, 0x0C, frame, AD5697R_ASYNC_MAX_LEN + 1, NULL, NULL));
+}
+
+void test_ad5697r_asyncSubmit_StartFailure(void) {
+    const uint8_t frame[] = {0x31, 0x00, 0x00};
+
+    start_ret = AD5697R_RET_BUSY;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncSubmit(&queue, 0x0C, frame, sizeof(frame), count_cb, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(1, cb_count);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, cb_ret);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_asyncGetPending(&queue));
+}
+
+/****************************** Requests ******************************/
+void test_ad5697r_asyncWriteChannel_Frame(void) {
+    const uint8_t expected[] = {0x38, 0xAB, 0xC0};
+
+    ad5697r_device.registers.bits.valid = AD5697R_SHADOW_ALL;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncWriteChannel(&queue, &ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0ABC, count_cb, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(3, started_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, started, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX8(0, ad5697r_device.registers.bits.valid & (AD5697R_SHADOW_INPUT_B | AD5697R_SHADOW_DAC_B));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_asyncWriteChannel(&queue, &ad5697r_device, AD5697R_OUTPUT_CH__MAX__, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_asyncWriteChannel(&queue, &ad5697r_device, 0, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_asyncWriteInputRegister(&queue, &ad5697r_device, 2, 0, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, start_count);
+}
+
+void test_ad5697r_asyncWriteChannelsSynchronized_Frame(void) {
+    const uint8_t expected[] = {0x11, 0x12, 0x30, 0x18, 0x45, 0x60, 0x29, 0x00, 0x00};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncWriteChannelsSynchronized(&queue, &ad5697r_device, 0x0123, 0x0456, NULL, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(9, started_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, started, sizeof(expected));
+}
+
+/****************************** Worker Thread ******************************/
+void test_ad5697r_asyncThread_SynchronousWrapper(void) {
+    ad5697r_async_thread_t worker;
+    ad5697r_emu_bus_t bus;
+    ad5697r_emu_dev_t emu;
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(8)];
+    uint16_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, 400000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncThreadStart(&worker, &queue, ring, 4, ad5697r_emuWrite));
+
+    // The blocking API returns once the worker has completed the transfer
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+
+    // A batch that fits one request stays one transaction
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    for( i = 0; i < AD5697R_ASYNC_MAX_FRAMES; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_B, i));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+    TEST_ASSERT_EQUAL_HEX16(AD5697R_ASYNC_MAX_FRAMES - 1, emu.dac[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, emu.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(1 + AD5697R_ASYNC_MAX_FRAMES, emu.stats.frames);
+
+    // A longer one is rejected as a whole rather than split
+    for( i = 0; i <= AD5697R_ASYNC_MAX_FRAMES; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_B, 0x0100 + i));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_batchCommit(&batch));
+    TEST_ASSERT_EQUAL_HEX16(AD5697R_ASYNC_MAX_FRAMES - 1, emu.dac[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, emu.stats.transactions);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncThreadStop(&worker));
+}
+
+void test_ad5697r_asyncThread_Init(void) {
+    ad5697r_async_thread_t worker;
+    ad5697r_emu_bus_t bus;
+    ad5697r_emu_dev_t emu;
+    ad5697r_config_t config;
+    ad5697r_init_report_t report;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, 400000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncThreadStart(&worker, &queue, ring, 4, ad5697r_emuWrite));
+
+    // The largest bring-up, every register off its power-on value, fits one request
+    memset(&config, 0, sizeof(config));
+    config.refMode = AD5697R_REF_OFF;
+    config.modeA = AD5697R_OP_MODE_1K_TO_GND;
+    config.ldacMask = AD5697R_OUTPUT_CH_B;
+    config.setCodes = true;
+    config.codeA = 0x0123;
+    config.codeB = 0x0456;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(1, report.transactions);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_INIT_MAX_FRAMES, report.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, emu.stats.transactions);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0456, emu.dac[1]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncThreadStop(&worker));
+}
+
+void test_ad5697r_asyncThread_Callbacks(void) {
+    ad5697r_async_thread_t worker;
+    ad5697r_emu_bus_t bus;
+    ad5697r_emu_dev_t emu;
+    ad5697r_return_code_t ret = AD5697R_RET_OK;
+    uint16_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, 400000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncThreadStart(&worker, &queue, ring, 4, ad5697r_emuWrite));
+
+    for( i = 0; i < 200; i++ ) {
+        do {
+            ret = ad5697r_asyncWriteChannel(&queue, &ad5697r_device, AD5697R_OUTPUT_CH_A, i, count_cb, NULL);
+        } while( ret == AD5697R_RET_BUSY );
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_asyncThreadStop(&worker));
+
+    TEST_ASSERT_EQUAL_UINT32(200, cb_count);
+    TEST_ASSERT_EQUAL_UINT32(200, emu.stats.frames);
+    TEST_ASSERT_EQUAL_HEX16(199, emu.dac[0]);
+}
@@ -0,0 +1,300 @@
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_capture.h"
+#include "ad5697r_capture_file.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device;
+static ad5697r_capture_t cap;
+static ad5697r_capture_config_t config;
+static uint8_t capture_buf[256];
+static uint8_t sink_data[1024];
+static uint32_t sink_len = 0;
+static uint32_t sink_calls = 0;
+static int8_t sink_ret = AD5697R_RET_OK;
+static uint32_t fake_time_us = 0;
+static uint32_t delays[8];
+static uint32_t delay_count = 0;
+
+int8_t usr_sink(void *ctx, const uint8_t *data, const uint32_t len);
+uint32_t usr_get_time_us(void);
+void usr_delay_us(uint32_t period);
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    sink_len = 0;
+    sink_calls = 0;
+    sink_ret = AD5697R_RET_OK;
+    fake_time_us = 1000;
+    delay_count = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.write = ad5697r_emuWrite;
+    config.get_time_us = usr_get_time_us;
+    config.sink = usr_sink;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureInit(&cap, &config, capture_buf, sizeof(capture_buf)));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    ad5697r_device.intf.write = ad5697r_captureWrite;
+    ad5697r_device.intf.read = ad5697r_emuRead;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_sink(void *ctx, const uint8_t *data, const uint32_t len) {
+    sink_calls++;
+    if( sink_ret != AD5697R_RET_OK ) {
+        return sink_ret;
+    }
+
+    TEST_ASSERT_TRUE(sink_len + len <= sizeof(sink_data));
+    memcpy(&sink_data[sink_len], data, len);
+    sink_len += len;
+
+    return AD5697R_RET_OK;
+}
+
+uint32_t usr_get_time_us(void) {
+    return fake_time_us;
+}
+
+void usr_delay_us(uint32_t period) {
+    if( delay_count < 8 ) {
+        delays[delay_count] = period;
+    }
+    delay_count++;
+}
+
+/****************************** Record ******************************/
+void test_ad5697r_captureInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureInit(NULL, &config, capture_buf, sizeof(capture_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureInit(&cap, NULL, capture_buf, sizeof(capture_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureInit(&cap, &config, NULL, sizeof(capture_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_captureInit(&cap, &config, capture_buf, AD5697R_CAPTURE_MIN_BUF_SIZE - 1));
+    config.sink = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureInit(&cap, &config, capture_buf, sizeof(capture_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureSelect(NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureFlush(NULL));
+}
+
+void test_ad5697r_captureWrite_WireFormat(void) {
+    const uint8_t expected[] = {
+        'A', 'D', '5', '6', AD5697R_CAPTURE_VERSION, 0x00, 0x00, 0x00,
+        0xE8, 0x03, 0x00, 0x00, 0x0C, 0x03, 0x00,   // 1000 us, 0x0C, 3 bytes
+        0x31, 0x12, 0x30,                           // Write and update DAC A, 0x123
+        0x4C, 0x04, 0x00, 0x00, 0x0C, 0x03, 0x00,   // 1100 us
+        0x70, 0x00, 0x01,                           // Reference off
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    fake_time_us = 1100;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+
+    // Nothing reaches the sink before a flush, the writes reached the device
+    TEST_ASSERT_EQUAL_UINT32(0, sink_calls);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), sink_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, sink_data, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT32(2, cap.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(6, cap.stats.bytes);
+    TEST_ASSERT_EQUAL_UINT32(1, cap.stats.flushes);
+}
+
+void test_ad5697r_captureWrite_FlushesInChunks(void) {
+    uint8_t small[AD5697R_CAPTURE_HEADER_SIZE + 2 * (AD5697R_CAPTURE_RECORD_SIZE + AD5697R_FRAME_SIZE)];
+    uint16_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureInit(&cap, &config, small, sizeof(small)));
+
+    // Every chunk holds two records, the last one waits for the flush
+    for( i = 0; i < 8; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, sink_calls);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    TEST_ASSERT_EQUAL_UINT32(4, cap.stats.flushes);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_CAPTURE_HEADER_SIZE + 8 * (AD5697R_CAPTURE_RECORD_SIZE + AD5697R_FRAME_SIZE), sink_len);
+
+    // Flushing an empty buffer does not call the sink
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    TEST_ASSERT_EQUAL_UINT32(4, sink_calls);
+}
+
+void test_ad5697r_captureWrite_SinkFailure(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0002));
+
+    sink_ret = AD5697R_RET_ERROR;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_captureFlush(&cap));
+    TEST_ASSERT_EQUAL_UINT32(2, cap.stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, cap.stats.flushes);
+
+    // The device writes are unaffected by the sink
+    TEST_ASSERT_EQUAL_HEX16(0x0002, emu.dac[0]);
+}
+
+void test_ad5697r_captureWrite_SinkFailureKeepsHeader(void) {
+    ad5697r_emu_dev_t replayed;
+    uint32_t transactions = 0;
+
+    // The first chunk fails, the header goes out with the next one
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    sink_ret = AD5697R_RET_ERROR;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_captureFlush(&cap));
+
+    sink_ret = AD5697R_RET_OK;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0002));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_CAPTURE_HEADER_SIZE + AD5697R_CAPTURE_RECORD_SIZE + AD5697R_FRAME_SIZE, sink_len);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &replayed, 0x0C, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, NULL, &transactions));
+    TEST_ASSERT_EQUAL_UINT32(1, transactions);
+    TEST_ASSERT_EQUAL_HEX16(0x0002, replayed.dac[0]);
+}
+
+/****************************** Replay ******************************/
+void test_ad5697r_captureReplay_ReproducesDevice(void) {
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(3)];
+    ad5697r_batch_t batch;
+    ad5697r_emu_dev_t replayed;
+    uint32_t transactions = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_1K_TO_GND));
+    fake_time_us = 1250;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_A, 0x0AAA));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_B, 0x0555));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchUpdateChannel(&batch, AD5697R_OUTPUT_CH_A_B));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+    fake_time_us = 1300;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0FFF));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+
+    // Replay onto a fresh device with the recorded gaps
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &replayed, 0x0C, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, usr_delay_us, &transactions));
+
+    TEST_ASSERT_EQUAL_UINT32(3, transactions);
+    TEST_ASSERT_EQUAL_UINT32(3, replayed.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(emu.stats.frames, replayed.stats.frames);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(emu.dac, replayed.dac, 2);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(emu.input, replayed.input, 2);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(emu.powerMode, replayed.powerMode, 2);
+    TEST_ASSERT_EQUAL_UINT32(2, delay_count);
+    TEST_ASSERT_EQUAL_UINT32(250, delays[0]);
+    TEST_ASSERT_EQUAL_UINT32(50, delays[1]);
+
+    // At maximum speed there are no delays
+    delay_count = 0;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, delay_count);
+    TEST_ASSERT_EQUAL_UINT32(6, replayed.stats.transactions);
+}
+
+void test_ad5697r_captureWrite_DropsOversizedWrites(void) {
+    uint8_t small[AD5697R_CAPTURE_MIN_BUF_SIZE + AD5697R_FRAME_SIZE];
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(5)];
+    ad5697r_batch_t batch;
+    ad5697r_emu_dev_t replayed;
+    uint32_t transactions = 0;
+    uint16_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureInit(&cap, &config, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+
+    // Two frames fit an empty buffer and are recorded whole
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_A, 0x0100));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_B, 0x0101));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+
+    // Five frames do not fit even an empty buffer: the write still reaches
+    // the device, the record is dropped rather than split
+    for( i = 0; i < 5; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, (i & 1) ? AD5697R_OUTPUT_CH_B : AD5697R_OUTPUT_CH_A, 0x0200 + i));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+    TEST_ASSERT_EQUAL_HEX16(0x0204, emu.input[0]);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    TEST_ASSERT_EQUAL_UINT32(1, cap.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(1, cap.stats.dropped);
+
+    // The replay reproduces the recorded transaction exactly
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &replayed, 0x0C, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, NULL, &transactions));
+    TEST_ASSERT_EQUAL_UINT32(1, transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, replayed.stats.frames);
+    TEST_ASSERT_EQUAL_HEX16(0x0100, replayed.input[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0101, replayed.input[1]);
+}
+
+void test_ad5697r_captureReplay_RejectsMalformed(void) {
+    uint32_t transactions = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0456));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    emu.stats.transactions = 0;
+
+    // A truncated capture writes nothing
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_captureReplay(sink_data, sink_len - 1, ad5697r_emuWrite, NULL, &transactions));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_captureReplay(sink_data, AD5697R_CAPTURE_HEADER_SIZE + 3, ad5697r_emuWrite, NULL, &transactions));
+    TEST_ASSERT_EQUAL_UINT32(0, transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, emu.stats.transactions);
+
+    sink_data[0] = 'X';
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, NULL, NULL));
+    sink_data[0] = 'A';
+    sink_data[4] = AD5697R_CAPTURE_VERSION + 1;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, NULL, NULL));
+    sink_data[4] = AD5697R_CAPTURE_VERSION;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureReplay(sink_data, sink_len, NULL, NULL, NULL));
+
+    // Replay stops at the first failed write
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_TIMEOUT, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_captureReplay(sink_data, sink_len, ad5697r_emuWrite, NULL, &transactions));
+    TEST_ASSERT_EQUAL_UINT32(0, transactions);
+}
+
+/****************************** File ******************************/
+void test_ad5697r_captureMap_FileRoundTrip(void) {
+    char path[] = "/tmp/ad5697r_captureXXXXXX";
+    ad5697r_capture_map_t map;
+    uint32_t transactions = 0;
+    int fd = mkstemp(path);
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    config.sink = ad5697r_captureFileSink;
+    config.sinkCtx = &fd;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureInit(&cap, &config, capture_buf, sizeof(capture_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0111, 0x0222));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureFlush(&cap));
+    close(fd);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureMap(&map, path));
+    unlink(path);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureReplay(map.data, map.len, ad5697r_emuWrite, NULL, &transactions));
+    TEST_ASSERT_EQUAL_UINT32(1, transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, emu.stats.transactions);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_captureUnmap(&map));
+    TEST_ASSERT_NULL(map.data);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_captureMap(&map, "/tmp/ad5697r_capture_does_not_exist"));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_captureMap(NULL, path));
+}
@@ -0,0 +1,205 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_emu_bus_t bus = {0};
+static ad5697r_emu_dev_t emu = {0};
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, 400000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = ad5697r_emuWrite;
+    ad5697r_device.intf.read = ad5697r_emuRead;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Attach ******************************/
+void test_ad5697r_emuAttach_PowerOnReset(void) {
+    ad5697r_emu_dev_t midscale;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &midscale, 0x0D, true));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0800, midscale.dac[1]);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_emuAttach(&bus, &midscale, 0x0C, true));
+}
+
+/****************************** Decode ******************************/
+void test_ad5697r_emuWrite_WriteChannel(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0ABC));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0ABC, emu.input[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x0ABC, emu.dac[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, emu.stats.cmdCount[0x03]);
+}
+
+void test_ad5697r_emuWrite_PowerAndReference(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE_1K_TO_GND));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_TRI_STATE));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_OP_MODE_1K_TO_GND, emu.powerMode[0]);
+    TEST_ASSERT_EQUAL_INT(AD5697R_OP_MODE_TRI_STATE, emu.powerMode[1]);
+    TEST_ASSERT_EQUAL_INT(1, emu.refOff);
+    TEST_ASSERT_EQUAL_UINT32(0, emu.stats.invalidFrames);
+}
+
+void test_ad5697r_emuWrite_StagedUpdate(void) {
+    // Stage the input registers, the outputs must not move until the update
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[0]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0456, 0x0789));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0456, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0789, emu.dac[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, emu.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(4, emu.stats.frames);
+}
+
+void test_ad5697r_emuWrite_LdacTransparent(void) {
+    // With !LDAC held low the input register write goes straight to the output
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuSetLdacPin(&emu, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+}
+
+void test_ad5697r_emuWrite_LdacMaskedNotTransparent(void) {
+    const uint8_t mask_b[] = {0x50, 0x00, 0x08};
+
+    // A masked channel keeps its output while !LDAC is held low
+    TEST_ASSERT_EQUAL_INT8(AD5697R_RET_OK, ad5697r_emuWrite(0x0C, mask_b, sizeof(mask_b)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuSetLdacPin(&emu, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0123));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.input[1]);
+}
+
+void test_ad5697r_emuSetLdacPin_FallingEdge(void) {
+    const uint8_t mask_b[] = {0x50, 0x00, 0x08};
+
+    // Mask channel B from the !LDAC pin
+    TEST_ASSERT_EQUAL_INT8(AD5697R_RET_OK, ad5697r_emuWrite(0x0C, mask_b, sizeof(mask_b)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0321));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuSetLdacPin(&emu, false));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0321, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[1]);
+}
+
+void test_ad5697r_emuWrite_SoftReset(void) {
+    const uint8_t reset[] = {0x60, 0x00, 0x00};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0FFF));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+
+    TEST_ASSERT_EQUAL_INT8(AD5697R_RET_OK, ad5697r_emuWrite(0x0C, reset, sizeof(reset)));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[1]);
+    TEST_ASSERT_EQUAL_INT(0, emu.refOff);
+}
+
+void test_ad5697r_emuWrite_InvalidFrames(void) {
+    const uint8_t reserved[] = {0x81, 0x00, 0x00, 0x31};
+
+    TEST_ASSERT_EQUAL_INT8(AD5697R_RET_OK, ad5697r_emuWrite(0x0C, reserved, sizeof(reserved)));
+
+    TEST_ASSERT_EQUAL_UINT32(2, emu.stats.invalidFrames);
+}
+
+void test_ad5697r_emuWrite_Nack(void) {
+    ad5697r_device.intf.i2c_addr = 0x0E;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+    TEST_ASSERT_EQUAL_UINT32(1, bus.wireBytes);
+}
+
+void test_ad5697r_emuInjectError_Busy(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_BUSY, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_HEX16(0x0001, emu.dac[0]);
+}
+
+/****************************** Readback ******************************/
+void test_ad5697r_emuRead_AutoIncrement(void) {
+    const uint8_t select_a[] = {0x01, 0x00, 0x00};
+    const uint8_t expected[] = {0x12, 0x30, 0x00, 0x00, 0x00, 0x00, 0x45, 0x60, 0x12, 0x30};
+    uint8_t data[10] = {0};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0456));
+
+    TEST_ASSERT_EQUAL_INT8(AD5697R_RET_OK, ad5697r_emuWrite(0x0C, select_a, sizeof(select_a)));
+    TEST_ASSERT_EQUAL_INT8(AD5697R_RET_OK, ad5697r_emuRead(0x0C, data, sizeof(data)));
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, data, sizeof(expected));
+}
+
+/****************************** Bus Timing ******************************/
+void test_ad5697r_emuBus_TransactionTime(void) {
+    // START + 4 bytes with ACK + STOP = 38 bits
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_UINT32(95000, (uint32_t)bus.busTimeNs);
+
+    TEST_ASSERT_EQUAL_UINT32(380000, ad5697r_getTransactionTimeNs(100000, 3));
+    TEST_ASSERT_EQUAL_UINT32(38000, ad5697r_getTransactionTimeNs(1000000, 3));
+
+    // Hs-mode pays for the master code at Fast-mode speed
+    TEST_ASSERT_EQUAL_UINT32(11176 + 25000, ad5697r_getTransactionTimeNs(3400000, 3));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_getTransactionTimeNs(0, 3));
+}
+
+void test_ad5697r_emuBus_BatchSavesBusTime(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(8)];
+    uint64_t single_ns = 0;
+    uint8_t i = 0;
+
+    for( i = 0; i < 8; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, i));
+    }
+    single_ns = bus.busTimeNs;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusResetStats(&bus));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    for( i = 0; i < 8; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, i));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0007, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT32(25, bus.wireBytes);
+    TEST_ASSERT_TRUE((bus.busTimeNs * 4) < (single_ns * 3));
+}
+
+/****************************** Output ******************************/
+void test_ad5697r_emuGetOutputVoltage_Reference(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0800));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.25f, ad5697r_emuGetOutputVoltage(&emu, AD5697R_OUTPUT_CH_A, 3.3f, 1));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.5f, ad5697r_emuGetOutputVoltage(&emu, AD5697R_OUTPUT_CH_B, 3.3f, 2));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.65f, ad5697r_emuGetOutputVoltage(&emu, AD5697R_OUTPUT_CH_A, 3.3f, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE_1K_TO_GND));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, ad5697r_emuGetOutputVoltage(&emu, AD5697R_OUTPUT_CH_A, 3.3f, 1));
+}
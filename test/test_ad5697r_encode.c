@@ -0,0 +1,151 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_encode.h"
+
+static const uint8_t channels[] = {AD5697R_OUTPUT_CH_A, AD5697R_OUTPUT_CH_B, AD5697R_OUTPUT_CH_A_B};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** DAC ******************************/
+void test_ad5697r_encDac_WireFormat(void) {
+    const uint8_t expected[] = {0x31, 0xAB, 0xC0};
+    uint8_t frame[AD5697R_FRAME_SIZE] = {0};
+
+    ad5697r_encDacUnchecked(frame, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A, 0x0ABC);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+}
+
+void test_ad5697r_encDac_CheckedMatchesUnchecked(void) {
+    uint8_t checked[AD5697R_FRAME_SIZE];
+    uint8_t unchecked[AD5697R_FRAME_SIZE];
+    uint16_t code = 0;
+    uint8_t cmd = 0;
+    uint8_t i = 0;
+
+    // Every command, channel and code a checked caller can encode
+    for( cmd = AD5697R_CMD_W_INPUT_REG_N; cmd <= AD5697R_CMD_WRITE_DAC; cmd++ ) {
+        for( i = 0; i < sizeof(channels); i++ ) {
+            for( code = 0; code <= AD5697R_ENC_MAX_CODE; code++ ) {
+                memset(checked, 0xA5, sizeof(checked));
+                memset(unchecked, 0x5A, sizeof(unchecked));
+
+                TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_encDac(checked, cmd, channels[i], code));
+                ad5697r_encDacUnchecked(unchecked, cmd, channels[i], code);
+
+                TEST_ASSERT_EQUAL_HEX8_ARRAY(unchecked, checked, AD5697R_FRAME_SIZE);
+                TEST_ASSERT_EQUAL_HEX8((cmd << 4) | channels[i], checked[0]);
+                TEST_ASSERT_EQUAL_HEX16(code, ((uint16_t)checked[1] << 4) | (checked[2] >> 4));
+                TEST_ASSERT_EQUAL_HEX8(0x00, checked[2] & 0x0F);
+            }
+        }
+    }
+}
+
+void test_ad5697r_encDac_Specialized(void) {
+    uint8_t expected[AD5697R_FRAME_SIZE];
+    uint8_t frame[AD5697R_FRAME_SIZE];
+    uint16_t code = 0;
+
+    for( code = 0; code <= AD5697R_ENC_MAX_CODE; code += 7 ) {
+        ad5697r_encDacUnchecked(expected, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A, code);
+        ad5697r_encWriteA(frame, code);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+
+        ad5697r_encDacUnchecked(expected, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_B, code);
+        ad5697r_encWriteB(frame, code);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+
+        ad5697r_encDacUnchecked(expected, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A_B, code);
+        ad5697r_encWriteAB(frame, code);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+
+        ad5697r_encDacUnchecked(expected, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A, code);
+        ad5697r_encInputA(frame, code);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+
+        ad5697r_encDacUnchecked(expected, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_B, code);
+        ad5697r_encInputB(frame, code);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+
+        ad5697r_encDacUnchecked(expected, AD5697R_CMD_W_INPUT_REG_N, AD5697R_OUTPUT_CH_A_B, code);
+        ad5697r_encInputAB(frame, code);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame, AD5697R_FRAME_SIZE);
+    }
+}
+
+void test_ad5697r_encDac_InvalidParams(void) {
+    uint8_t frame[AD5697R_FRAME_SIZE] = {0xEE, 0xEE, 0xEE};
+    const uint8_t untouched[AD5697R_FRAME_SIZE] = {0xEE, 0xEE, 0xEE};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_encDac(NULL, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encDac(frame, AD5697R_CMD_POWER_DAC, AD5697R_OUTPUT_CH_A, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encDac(frame, AD5697R_CMD_NO_OP, AD5697R_OUTPUT_CH_A, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encDac(frame, AD5697R_CMD_WRITE_DAC, 0x02, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encDac(frame, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A, 0x1000));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(untouched, frame, AD5697R_FRAME_SIZE);
+}
+
+/****************************** Control ******************************/
+void test_ad5697r_encPower_CheckedMatchesUnchecked(void) {
+    const uint8_t expected[] = {0x40, 0x00, 0xFE};  // B tri-state, A 10k to GND
+    uint8_t checked[AD5697R_FRAME_SIZE];
+    uint8_t unchecked[AD5697R_FRAME_SIZE];
+    uint8_t modeA = 0;
+    uint8_t modeB = 0;
+
+    ad5697r_encPowerUnchecked(unchecked, AD5697R_OP_MODE_10K_TO_GND, AD5697R_OP_MODE_TRI_STATE);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, unchecked, AD5697R_FRAME_SIZE);
+
+    for( modeA = 0; modeA < AD5697R_OP_MODE__MAX__; modeA++ ) {
+        for( modeB = 0; modeB < AD5697R_OP_MODE__MAX__; modeB++ ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_encPower(checked, modeA, modeB));
+            ad5697r_encPowerUnchecked(unchecked, modeA, modeB);
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(unchecked, checked, AD5697R_FRAME_SIZE);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encPower(checked, AD5697R_OP_MODE__MAX__, 0));
+}
+
+void test_ad5697r_encReference_CheckedMatchesUnchecked(void) {
+    const uint8_t expectedOff[] = {0x70, 0x00, 0x01};
+    uint8_t checked[AD5697R_FRAME_SIZE];
+    uint8_t unchecked[AD5697R_FRAME_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_encReference(checked, AD5697R_REF_OFF));
+    ad5697r_encReferenceUnchecked(unchecked, AD5697R_REF_OFF);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedOff, checked, AD5697R_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(unchecked, checked, AD5697R_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_encReference(checked, AD5697R_REF_ON));
+    ad5697r_encReferenceUnchecked(unchecked, AD5697R_REF_ON);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(unchecked, checked, AD5697R_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encReference(checked, AD5697R_REF__MAX__));
+}
+
+void test_ad5697r_encLdacMask_CheckedMatchesUnchecked(void) {
+    const uint8_t expected[] = {0x50, 0x00, 0x08};
+    uint8_t checked[AD5697R_FRAME_SIZE];
+    uint8_t unchecked[AD5697R_FRAME_SIZE];
+    uint8_t i = 0;
+
+    for( i = 0; i < sizeof(channels); i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_encLdacMask(checked, channels[i]));
+        ad5697r_encLdacMaskUnchecked(unchecked, channels[i]);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(unchecked, checked, AD5697R_FRAME_SIZE);
+    }
+
+    ad5697r_encLdacMaskUnchecked(unchecked, AD5697R_OUTPUT_CH_B);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, unchecked, AD5697R_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_encLdacMask(checked, 0x02));
+}
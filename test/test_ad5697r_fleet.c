@@ -0,0 +1,258 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_fleet.h"
+#include "ad5697r_fleet_thread.h"
+#include "ad5697r_emu.h"
+
+#define FLEET_BUSES     (2)
+
+static ad5697r_emu_bus_t emu_bus[FLEET_BUSES];
+static ad5697r_emu_dev_t emu[FLEET_BUSES][AD5697R_FLEET_BUS_DEVICES];
+static ad5697r_dev_t devs[FLEET_BUSES][AD5697R_FLEET_BUS_DEVICES];
+static ad5697r_fleet_bus_t buses[FLEET_BUSES];
+static ad5697r_fleet_t fleet;
+
+void setUp(void)
+{
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetInit(&fleet, buses, FLEET_BUSES));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&emu_bus[i], 400000));
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetSetBus(&fleet, i, ad5697r_emuTransfer, &emu_bus[i]));
+
+        // Four chips per bus on the A0/A1 straps
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&emu_bus[i], &emu[i][j], 0x0C + j, false));
+            memset(&devs[i][j], 0, sizeof(devs[i][j]));
+            devs[i][j].intf.i2c_addr = 0x0C + j;
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetAttach(&fleet, i, &devs[i][j]));
+        }
+    }
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Attach ******************************/
+void test_ad5697r_fleetAttach_InvalidParams(void) {
+    ad5697r_dev_t extra = {0};
+
+    extra.intf.i2c_addr = 0x0C;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_fleetAttach(&fleet, 0, &devs[0][0]));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_fleetAttach(&fleet, FLEET_BUSES, &extra));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_fleetAttach(&fleet, 1, &extra));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_fleetPost(&fleet, &extra, AD5697R_OUTPUT_CH_A, 0));
+}
+
+/****************************** Flush ******************************/
+void test_ad5697r_fleetFlush_OneTransactionPerBus(void) {
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[i][j], AD5697R_OUTPUT_CH_A, (uint16_t)(0x100 * i + j)));
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[i][j], AD5697R_OUTPUT_CH_B, (uint16_t)(0x100 * i + j + 0x10)));
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlush(&fleet));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        // START, 4 x (address + 2 frames), STOP
+        TEST_ASSERT_EQUAL_UINT32(1, emu_bus[i].transactions);
+        TEST_ASSERT_EQUAL_UINT32(4 * 7, emu_bus[i].wireBytes);
+        TEST_ASSERT_EQUAL_UINT32(8, buses[i].stats.updates);
+
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_HEX16(0x100 * i + j, emu[i][j].dac[0]);
+            TEST_ASSERT_EQUAL_HEX16(0x100 * i + j + 0x10, emu[i][j].dac[1]);
+        }
+    }
+
+    // Nothing pending, nothing on the wire
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlush(&fleet));
+    TEST_ASSERT_EQUAL_UINT32(1, emu_bus[0].transactions);
+}
+
+void test_ad5697r_fleetPost_Coalesces(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][2], AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][2], AD5697R_OUTPUT_CH_A, 0x0002));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][3], AD5697R_OUTPUT_CH_A_B, 0x0333));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlushBus(&buses[0]));
+
+    // One frame for device 2, one frame addressing both channels of device 3
+    TEST_ASSERT_EQUAL_UINT32(8, emu_bus[0].wireBytes);
+    TEST_ASSERT_EQUAL_UINT32(2, buses[0].stats.messages);
+    TEST_ASSERT_EQUAL_HEX16(0x0002, emu[0][2].dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0333, emu[0][3].dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0333, emu[0][3].dac[1]);
+}
+
+void test_ad5697r_fleetFlushBus_Error(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu[1][0], AD5697R_RET_ERROR, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[1][0], AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][0], AD5697R_OUTPUT_CH_A, 0x0002));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_fleetFlush(&fleet));
+
+    // The healthy bus is still written
+    TEST_ASSERT_EQUAL_HEX16(0x0002, emu[0][0].dac[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, buses[1].stats.errors);
+
+    // The failed code is kept for the next flush
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlushBus(&buses[1]));
+    TEST_ASSERT_EQUAL_HEX16(0x0001, emu[1][0].dac[0]);
+}
+
+void test_ad5697r_fleetFlushBus_ErrorKeepsNewerPost(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu[0][1], AD5697R_RET_ERROR, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][1], AD5697R_OUTPUT_CH_A_B, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_fleetFlushBus(&buses[0]));
+
+    // A code posted after the failure wins over the restored one
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][1], AD5697R_OUTPUT_CH_B, 0x0222));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlushBus(&buses[0]));
+    TEST_ASSERT_EQUAL_HEX16(0x0001, emu[0][1].dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0222, emu[0][1].dac[1]);
+}
+
+void test_ad5697r_fleetFlushBus_InvalidatesShadow(void) {
+    devs[0][0].intf.write = ad5697r_emuWrite;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusSelect(&emu_bus[0]));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&devs[0][0], true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&devs[0][0], AD5697R_OUTPUT_CH_A_B, 0x0100));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][0], AD5697R_OUTPUT_CH_A, 0x0200));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlushBus(&buses[0]));
+    TEST_ASSERT_EQUAL_HEX8(0, devs[0][0].registers.bits.valid & (AD5697R_SHADOW_INPUT_A | AD5697R_SHADOW_DAC_A));
+    TEST_ASSERT_TRUE(devs[0][0].registers.bits.valid & AD5697R_SHADOW_DAC_B);
+
+    // The direct write is no longer elided against the stale shadow
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&devs[0][0], AD5697R_OUTPUT_CH_A, 0x0100));
+    TEST_ASSERT_EQUAL_HEX16(0x0100, emu[0][0].dac[0]);
+}
+
+/****************************** Workers ******************************/
+void test_ad5697r_fleetThread_Workers(void) {
+    ad5697r_fleet_worker_t workers[FLEET_BUSES];
+    uint16_t n = 0;
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[1][1], AD5697R_OUTPUT_CH_B, 0x0ABC));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetThreadStart(&fleet, workers));
+
+    for( n = 0; n < 1000; n++ ) {
+        for( i = 0; i < FLEET_BUSES; i++ ) {
+            for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+                TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[i][j], AD5697R_OUTPUT_CH_A, (uint16_t)(n + i + j)));
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetThreadStop(&fleet, workers));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        TEST_ASSERT_EQUAL_UINT32(0, buses[i].stats.errors);
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_HEX16(999 + i + j, emu[i][j].dac[0]);
+        }
+    }
+    TEST_ASSERT_EQUAL_HEX16(0x0ABC, emu[1][1].dac[1]);
+}
+
+/****************************** LDAC ******************************/
+static void usr_ldac(const bool level) {
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    // One GPIO drives the !LDAC pin of every chip
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            ad5697r_emuSetLdacPin(&emu[i][j], level);
+        }
+    }
+}
+
+void test_ad5697r_fleetCommit_SimultaneousUpdate(void) {
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetSetLdac(&fleet, usr_ldac));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[i][j], AD5697R_OUTPUT_CH_A_B, (uint16_t)(0x200 + 0x10 * i + j)));
+        }
+    }
+
+    // Staged only, no output moves before the pulse
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetFlush(&fleet));
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_HEX16(0x200 + 0x10 * i + j, emu[i][j].input[1]);
+            TEST_ASSERT_EQUAL_HEX16(0x0000, emu[i][j].dac[0]);
+            TEST_ASSERT_EQUAL_HEX16(0x0000, emu[i][j].dac[1]);
+        }
+    }
+
+    // Execute the function under test
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetCommit(&fleet));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        TEST_ASSERT_EQUAL_UINT32(1, emu_bus[i].transactions);
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_HEX16(0x200 + 0x10 * i + j, emu[i][j].dac[0]);
+            TEST_ASSERT_EQUAL_HEX16(0x200 + 0x10 * i + j, emu[i][j].dac[1]);
+            TEST_ASSERT_TRUE(emu[i][j].ldacPin);
+        }
+    }
+}
+
+void test_ad5697r_fleetCommit_ErrorSkipsPulse(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_fleetCommit(&fleet));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetSetLdac(&fleet, usr_ldac));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu[1][0], AD5697R_RET_ERROR, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[0][0], AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[1][0], AD5697R_OUTPUT_CH_A, 0x0002));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_fleetCommit(&fleet));
+
+    TEST_ASSERT_EQUAL_HEX16(0x0001, emu[0][0].input[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu[0][0].dac[0]);
+}
+
+void test_ad5697r_fleetThreadCommit_Workers(void) {
+    ad5697r_fleet_worker_t workers[FLEET_BUSES];
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetSetLdac(&fleet, usr_ldac));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetThreadStart(&fleet, workers));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetPost(&fleet, &devs[i][j], AD5697R_OUTPUT_CH_A, (uint16_t)(0x300 + i + j)));
+        }
+    }
+
+    // Execute the function under test
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetThreadCommit(&fleet, workers));
+
+    for( i = 0; i < FLEET_BUSES; i++ ) {
+        for( j = 0; j < AD5697R_FLEET_BUS_DEVICES; j++ ) {
+            TEST_ASSERT_EQUAL_HEX16(0x300 + i + j, emu[i][j].dac[0]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_fleetThreadStop(&fleet, workers));
+}
@@ -0,0 +1,182 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_encode.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static int8_t desired_ret = AD5697R_RET_OK;
+static uint32_t fake_time_us = 0;
+static uint32_t write_time_us = 0;
+static uint8_t read_data[2] = {0};
+static ad5697r_trace_event_t last_event;
+static uint32_t trace_count = 0;
+static uint8_t traced_byte = 0;
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len);
+uint32_t usr_get_time_us(void);
+void usr_trace(void *ctx, const ad5697r_trace_event_t *event);
+
+void setUp(void)
+{
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = usr_i2c_write;
+    ad5697r_device.intf.read = usr_i2c_read;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    desired_ret = AD5697R_RET_OK;
+    fake_time_us = 0;
+    write_time_us = 0;
+    memset(&last_event, 0, sizeof(last_event));
+    trace_count = 0;
+    traced_byte = 0;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    fake_time_us += write_time_us;
+    return desired_ret;
+}
+
+int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len) {
+    memcpy(data, read_data, len);
+    return desired_ret;
+}
+
+uint32_t usr_get_time_us(void) {
+    return fake_time_us;
+}
+
+void usr_trace(void *ctx, const ad5697r_trace_event_t *event) {
+    *(uint32_t *)ctx += 1;
+    last_event = *event;
+    traced_byte = event->data[0];
+}
+
+/****************************** Counters ******************************/
+void test_ad5697r_instr_CountsFramesAndBytes(void) {
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(3)];
+    ad5697r_instr_stats_t snapshot;
+    ad5697r_batch_t batch;
+    uint16_t readback = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+
+    // One transaction carrying three frames
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_B, 0x0002));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchUpdateChannel(&batch, AD5697R_OUTPUT_CH_A_B));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_B, &readback));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrGetSnapshot(&ad5697r_device, &snapshot));
+    TEST_ASSERT_EQUAL_UINT32(4, snapshot.writes);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.reads);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.frames[AD5697R_CMD_NO_OP]);
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.frames[AD5697R_CMD_W_INPUT_REG_N]);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.frames[AD5697R_CMD_UPDATE_DAC_FROM_INPUT_REG_N]);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.frames[AD5697R_CMD_WRITE_DAC]);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.frames[AD5697R_CMD_INT_REF_SETUP]);
+    TEST_ASSERT_EQUAL_UINT32(18, snapshot.bytesWritten);
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.bytesRead);
+    TEST_ASSERT_EQUAL_UINT32(5, snapshot.results[-AD5697R_RET_OK]);
+}
+
+void test_ad5697r_instr_CountsResults(void) {
+    ad5697r_instr_stats_t snapshot;
+
+    desired_ret = AD5697R_RET_BUSY;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    desired_ret = AD5697R_RET_TIMEOUT;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    // Codes the driver does not define are counted as errors
+    desired_ret = -42;
+    ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123);
+    desired_ret = AD5697R_RET_OK;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrGetSnapshot(&ad5697r_device, &snapshot));
+    TEST_ASSERT_EQUAL_UINT32(4, snapshot.writes);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.results[-AD5697R_RET_OK]);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.results[-AD5697R_RET_ERROR]);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.results[-AD5697R_RET_BUSY]);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.results[-AD5697R_RET_TIMEOUT]);
+
+    // Failed writes put no bytes on the device
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, snapshot.bytesWritten);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.frames[AD5697R_CMD_WRITE_DAC]);
+}
+
+void test_ad5697r_instr_LatencyHistogram(void) {
+    const uint32_t latencies[] = {0, 1, 3, 80, 100000};
+    const uint8_t bins[] = {0, 1, 2, 7, 15};
+    ad5697r_instr_stats_t snapshot;
+    uint8_t i = 0;
+
+    ad5697r_device.intf.get_time_us = usr_get_time_us;
+
+    for( i = 0; i < sizeof(bins); i++ ) {
+        write_time_us = latencies[i];
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, i));
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrGetSnapshot(&ad5697r_device, &snapshot));
+    for( i = 0; i < sizeof(bins); i++ ) {
+        TEST_ASSERT_EQUAL_UINT32(1, snapshot.writeLatency[bins[i]]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(100000, snapshot.maxLatencyUs);
+}
+
+void test_ad5697r_instr_Reset(void) {
+    ad5697r_instr_stats_t snapshot;
+    ad5697r_instr_stats_t zero;
+
+    memset(&zero, 0, sizeof(zero));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrReset(&ad5697r_device));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrGetSnapshot(&ad5697r_device, &snapshot));
+    TEST_ASSERT_EQUAL_MEMORY(&zero, &snapshot, sizeof(snapshot));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_instrReset(NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_instrGetSnapshot(NULL, &snapshot));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_instrGetSnapshot(&ad5697r_device, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_instrSetTrace(NULL, usr_trace, NULL));
+}
+
+/****************************** Trace ******************************/
+void test_ad5697r_instr_Trace(void) {
+    uint16_t readback = 0;
+
+    ad5697r_device.intf.get_time_us = usr_get_time_us;
+    write_time_us = 12;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrSetTrace(&ad5697r_device, usr_trace, &trace_count));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0ABC));
+    TEST_ASSERT_EQUAL_UINT32(1, trace_count);
+    TEST_ASSERT_EQUAL_HEX8(0x0C, last_event.busAddr);
+    TEST_ASSERT_FALSE(last_event.read);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, last_event.len);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, last_event.ret);
+    TEST_ASSERT_EQUAL_UINT32(12, last_event.latencyUs);
+    TEST_ASSERT_EQUAL_HEX8(0x38, traced_byte);
+
+    read_data[0] = 0xAB;
+    read_data[1] = 0xC0;
+    desired_ret = AD5697R_RET_OK;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_B, &readback));
+    TEST_ASSERT_EQUAL_UINT32(3, trace_count);
+    TEST_ASSERT_TRUE(last_event.read);
+    TEST_ASSERT_EQUAL_UINT32(2, last_event.len);
+    TEST_ASSERT_EQUAL_HEX8(0xAB, traced_byte);
+
+    // Tracing stops with a NULL callback
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_instrSetTrace(&ad5697r_device, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_UINT32(3, trace_count);
+}
@@ -0,0 +1,101 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_linux.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_linux_bus_t bus;
+static uint8_t staging[AD5697R_BATCH_BUF_SIZE(4)];
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxInit(&bus, staging, sizeof(staging)));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = ad5697r_linuxWrite;
+    ad5697r_device.intf.read = ad5697r_linuxRead;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+}
+
+void tearDown(void)
+{
+    ad5697r_linuxClose(&bus);
+}
+
+/****************************** Open ******************************/
+void test_ad5697r_linuxInit_NullPtr(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_linuxInit(NULL, staging, sizeof(staging)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_linuxInit(&bus, NULL, sizeof(staging)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxInit(&bus, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_linuxSetDeferred(&bus, true));
+}
+
+void test_ad5697r_linuxOpen_Missing(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_linuxOpen(&bus, "/dev/i2c-does-not-exist"));
+    TEST_ASSERT_EQUAL_INT(-1, bus.fd);
+}
+
+void test_ad5697r_linuxOpen_NotAnAdapter(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_linuxOpen(&bus, "/dev/null"));
+    TEST_ASSERT_EQUAL_INT(-1, bus.fd);
+}
+
+void test_ad5697r_linuxWrite_Closed(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(0, bus.stats.ioctls);
+}
+
+/****************************** Deferred ******************************/
+void test_ad5697r_linuxWrite_Deferred(void) {
+    const uint8_t expected[] = {0x31, 0x12, 0x30, 0x38, 0x45, 0x60};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxSetDeferred(&bus, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    ad5697r_device.intf.i2c_addr = 0x0D;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0456));
+
+    TEST_ASSERT_EQUAL_UINT32(2, bus.nmsgs);
+    TEST_ASSERT_EQUAL_UINT32(6, bus.len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, staging, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX16(0x0C, bus.msgs[0].addr);
+    TEST_ASSERT_EQUAL_HEX16(0x0D, bus.msgs[1].addr);
+    TEST_ASSERT_EQUAL_UINT32(3, bus.msgs[1].len);
+    TEST_ASSERT_EQUAL_PTR(&staging[3], bus.msgs[1].buf);
+    TEST_ASSERT_EQUAL_UINT32(0, bus.stats.ioctls);
+}
+
+void test_ad5697r_linuxFlush_KeepsQueueOnError(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxSetDeferred(&bus, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_linuxFlush(&bus));
+    TEST_ASSERT_EQUAL_UINT32(1, bus.nmsgs);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_linuxSetDeferred(&bus, false));
+    TEST_ASSERT_EQUAL_UINT32(1, bus.nmsgs);
+}
+
+void test_ad5697r_linuxQueue_FullFlushes(void) {
+    const uint8_t frame[] = {0x31, 0x00, 0x00};
+    uint8_t i = 0;
+
+    for( i = 0; i < 4; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxQueue(&bus, 0x0C, frame, sizeof(frame)));
+    }
+
+    // The staging buffer is full, the implicit flush fails on a closed adapter
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_linuxQueue(&bus, 0x0C, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT32(4, bus.nmsgs);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_linuxQueue(&bus, 0x0C, frame, 0));
+}
+
+void test_ad5697r_linuxClose_DiscardsQueue(void) {
+    const uint8_t frame[] = {0x31, 0x00, 0x00};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxQueue(&bus, 0x0C, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxClose(&bus));
+
+    TEST_ASSERT_EQUAL_UINT32(0, bus.nmsgs);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_linuxFlush(&bus));
+}
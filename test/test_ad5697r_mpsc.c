@@ -0,0 +1,161 @@
+#include <string.h>
+#include <pthread.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_mpsc.h"
+#include "ad5697r_emu.h"
+
+#define PRODUCER_UPDATES    (20000)
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_mpsc_t queue;
+static ad5697r_mpsc_cell_t cells[16];
+static uint32_t finished = 0;
+
+typedef struct {
+    ad5697r_output_channel_t ch;
+    uint16_t offset;
+} producer_t;
+
+static void *producer(void *arg) {
+    const producer_t *p = (const producer_t *)arg;
+    uint32_t i = 0;
+
+    for( i = 0; i < PRODUCER_UPDATES; i++ ) {
+        ad5697r_mpscPost(&queue, p->ch, (uint16_t)((p->offset + i) & 0x0FFF));
+    }
+    __atomic_add_fetch(&finished, 1, __ATOMIC_SEQ_CST);
+
+    return NULL;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, 400000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = ad5697r_emuWrite;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_mpscInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_mpscInit(&queue, NULL, cells, 16, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 12, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 1, true));
+}
+
+/****************************** Coalescing ******************************/
+void test_ad5697r_mpscPost_LastWriterWins(void) {
+    uint32_t written = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 16, true));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_B, 0x0002));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, 0x0003));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, 0x0004));
+
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_mpscGetDepth(&queue));
+    TEST_ASSERT_EQUAL_UINT32(2, queue.stats.coalesced);
+
+    // Both channels go out in one transaction
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscDrain(&queue, 0, &written));
+    TEST_ASSERT_EQUAL_UINT32(2, written);
+    TEST_ASSERT_EQUAL_UINT32(1, emu.stats.transactions);
+    TEST_ASSERT_EQUAL_HEX16(0x0004, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0002, emu.dac[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_mpscGetDepth(&queue));
+}
+
+void test_ad5697r_mpscPost_BothChannels(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 16, true));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A_B, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_B, 0x0456));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH__MAX__, 0));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscDrain(&queue, 0, NULL));
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0456, emu.dac[1]);
+}
+
+/****************************** Ordered ******************************/
+void test_ad5697r_mpscPost_DropsWhenFull(void) {
+    uint32_t written = 0;
+    uint16_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 4, false));
+
+    for( i = 0; i < 4; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, i));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, 4));
+
+    TEST_ASSERT_EQUAL_UINT32(1, queue.stats.drops);
+    TEST_ASSERT_EQUAL_UINT32(4, queue.stats.maxDepth);
+
+    // Drain part of the queue, the freed cells take new updates
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscDrain(&queue, 3, &written));
+    TEST_ASSERT_EQUAL_UINT32(3, written);
+    TEST_ASSERT_EQUAL_HEX16(0x0002, emu.dac[0]);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, 5));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscDrain(&queue, 0, &written));
+    TEST_ASSERT_EQUAL_UINT32(2, written);
+    TEST_ASSERT_EQUAL_HEX16(0x0005, emu.dac[0]);
+}
+
+void test_ad5697r_mpscDrain_WriteError(void) {
+    uint32_t written = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 16, false));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscPost(&queue, AD5697R_OUTPUT_CH_A, 0x0001));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_ERROR, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_mpscDrain(&queue, 0, &written));
+    TEST_ASSERT_EQUAL_UINT32(0, written);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.stats.writeErrors);
+}
+
+/****************************** Concurrency ******************************/
+void test_ad5697r_mpsc_ConcurrentProducers(void) {
+    producer_t producers[4] = {
+        { AD5697R_OUTPUT_CH_A, 0 },
+        { AD5697R_OUTPUT_CH_B, 100 },
+        { AD5697R_OUTPUT_CH_A, 200 },
+        { AD5697R_OUTPUT_CH_B, 300 },
+    };
+    pthread_t threads[4];
+    uint32_t written = 0;
+    uint8_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscInit(&queue, &ad5697r_device, cells, 16, true));
+    finished = 0;
+
+    for( i = 0; i < 4; i++ ) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, producer, &producers[i]));
+    }
+
+    // Drain as the bus owner while the producers run
+    while( __atomic_load_n(&finished, __ATOMIC_SEQ_CST) < 4 ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscDrain(&queue, 0, &written));
+    }
+    for( i = 0; i < 4; i++ ) {
+        pthread_join(threads[i], NULL);
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_mpscDrain(&queue, 0, NULL));
+
+    // Every post was written, merged into a newer one or dropped
+    TEST_ASSERT_EQUAL_UINT32(4 * PRODUCER_UPDATES, queue.stats.posted);
+    TEST_ASSERT_EQUAL_UINT32(queue.stats.posted, queue.stats.written + queue.stats.coalesced + queue.stats.drops);
+    TEST_ASSERT_EQUAL_UINT32(queue.stats.written, emu.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_mpscGetDepth(&queue));
+}
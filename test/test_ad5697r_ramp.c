@@ -0,0 +1,180 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_ramp.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device;
+static ad5697r_ramp_t ramp;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    ad5697r_device.intf.write = ad5697r_emuWrite;
+    ad5697r_device.intf.read = ad5697r_emuRead;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0000, 0x0100));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampInit(&ramp, &ad5697r_device, 1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusResetStats(&bus));
+    memset(&emu.stats, 0, sizeof(emu.stats));
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_rampInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_rampInit(NULL, &ad5697r_device, 1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_rampInit(&ramp, NULL, 1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_rampInit(&ramp, &ad5697r_device, 0));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_rampSetTarget(&ramp, 0x02, 100, 1000, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 0x1000, 1000, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 100, 0, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 100, 1000, AD5697R_RAMP__MAX__));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_rampStep(NULL));
+}
+
+void test_ad5697r_rampInit_StartsFromShadow(void) {
+    TEST_ASSERT_EQUAL_HEX16(0x0000, ramp.ch[0].code);
+    TEST_ASSERT_EQUAL_HEX16(0x0100, ramp.ch[1].code);
+    TEST_ASSERT_TRUE(ad5697r_rampIsIdle(&ramp));
+
+    // Nothing to do, nothing written
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+    TEST_ASSERT_EQUAL_UINT32(0, bus.transactions);
+}
+
+/****************************** Linear ******************************/
+void test_ad5697r_rampStep_LinearWritesOnlyChanges(void) {
+    uint16_t last = 0;
+    uint32_t i = 0;
+
+    // A quarter code per tick, 100 codes take 400 ticks
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 100, 250, AD5697R_RAMP_LINEAR));
+
+    for( i = 0; (i < 1000) && !ad5697r_rampIsIdle(&ramp); i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+        TEST_ASSERT_TRUE(emu.dac[0] >= last);
+        TEST_ASSERT_TRUE(emu.dac[0] - last <= 1);
+        last = emu.dac[0];
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(400, i);
+    TEST_ASSERT_EQUAL_HEX16(100, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0100, emu.dac[1]);
+    TEST_ASSERT_EQUAL_UINT32(100, bus.transactions);
+    TEST_ASSERT_EQUAL_UINT32(100, ramp.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(300, ramp.stats.unchanged);
+}
+
+void test_ad5697r_rampStep_FastSlewClamped(void) {
+    uint32_t i = 0;
+
+    // 65536000 codes/s at 1 kHz wrapped the 16.16 step to zero, and UINT32_MAX overflowed it
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 0x0FFF, 65536000u, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)AD5697R_RAMP_MAX_CODE << 16, ramp.ch[0].step);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+    TEST_ASSERT_EQUAL_HEX16(0x0FFF, emu.dac[0]);
+    TEST_ASSERT_TRUE(ad5697r_rampIsIdle(&ramp));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 0x0000, UINT32_MAX, AD5697R_RAMP_LINEAR));
+    for( i = 0; (i < 10) && !ad5697r_rampIsIdle(&ramp); i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, i);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[0]);
+}
+
+void test_ad5697r_rampStep_BothChannelsOneTransaction(void) {
+    uint32_t i = 0;
+
+    // A rises and B falls at 2 codes per tick until they meet at 0x80
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 0x0080, 2000, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_B, 0x0080, 1000, AD5697R_RAMP_LINEAR));
+
+    for( i = 0; (i < 1000) && !ad5697r_rampIsIdle(&ramp); i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(128, i);
+    TEST_ASSERT_EQUAL_UINT32(128, bus.transactions);
+    TEST_ASSERT_EQUAL_UINT32(64 * 2 + 64, emu.stats.frames);
+    TEST_ASSERT_EQUAL_HEX16(0x0080, emu.dac[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0080, emu.dac[1]);
+}
+
+void test_ad5697r_rampStep_SharedFrame(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0200, 0x0200));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampInit(&ramp, &ad5697r_device, 1000));
+    memset(&emu.stats, 0, sizeof(emu.stats));
+
+    // Channels moving in step go out in one frame
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A_B, 0x0210, 16000, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+    TEST_ASSERT_TRUE(ad5697r_rampIsIdle(&ramp));
+    TEST_ASSERT_EQUAL_UINT32(1, emu.stats.frames);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(((uint16_t[]){0x0210, 0x0210}), emu.dac, 2);
+}
+
+/****************************** S-curve ******************************/
+void test_ad5697r_rampStep_SCurve(void) {
+    uint16_t codes[1000];
+    uint32_t maxDelta = 0;
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+    // 1000 codes at a peak of 10 codes per tick take 150 ticks
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_B, 0x0100 + 1000, 10000, AD5697R_RAMP_S_CURVE));
+
+    for( n = 0; (n < 1000) && !ad5697r_rampIsIdle(&ramp); n++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+        codes[n] = emu.dac[1];
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(150, n);
+    TEST_ASSERT_EQUAL_HEX16(0x0100 + 1000, emu.dac[1]);
+
+    for( i = 1; i < n; i++ ) {
+        TEST_ASSERT_TRUE(codes[i] >= codes[i - 1]);
+        if( (uint32_t)(codes[i] - codes[i - 1]) > maxDelta ) {
+            maxDelta = codes[i] - codes[i - 1];
+        }
+    }
+
+    // Slow at both ends, no faster than the slew limit in the middle
+    TEST_ASSERT_TRUE(codes[0] - 0x0100 <= 1);
+    TEST_ASSERT_TRUE(codes[n - 1] - codes[n - 2] <= 1);
+    TEST_ASSERT_TRUE(maxDelta <= 10);
+    TEST_ASSERT_TRUE(maxDelta >= 9);
+}
+
+/****************************** Errors ******************************/
+void test_ad5697r_rampStep_RetriesFailedWrite(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampSetTarget(&ramp, AD5697R_OUTPUT_CH_A, 2, 1000, AD5697R_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_TIMEOUT, 2));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_rampStep(&ramp));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_rampStep(&ramp));
+    TEST_ASSERT_EQUAL_UINT32(2, ramp.stats.errors);
+
+    // The code reached its target but the device does not hold it yet
+    TEST_ASSERT_FALSE(ad5697r_rampIsIdle(&ramp));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_rampStep(&ramp));
+    TEST_ASSERT_TRUE(ad5697r_rampIsIdle(&ramp));
+    TEST_ASSERT_EQUAL_HEX16(2, emu.dac[0]);
+}
+
+void test_ad5697r_rampSlewFromVolts(void) {
+    TEST_ASSERT_EQUAL_UINT32(1638, ad5697r_rampSlewFromVolts(1.0f, 2.5f));
+    TEST_ASSERT_EQUAL_UINT32(819, ad5697r_rampSlewFromVolts(1.0f, 5.0f));
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_rampSlewFromVolts(0.0f, 2.5f));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_rampSlewFromVolts(1.0f, 0.0f));
+}
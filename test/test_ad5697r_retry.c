@@ -0,0 +1,195 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device;
+static uint32_t fake_time_us = 0;
+static uint32_t delays[8];
+static uint32_t delay_count = 0;
+
+static void usr_delay_us(uint32_t period) {
+    if( delay_count < (sizeof(delays) / sizeof(delays[0])) ) {
+        delays[delay_count] = period;
+    }
+    delay_count++;
+    fake_time_us += period;
+}
+
+static uint32_t usr_get_time_us(void) {
+    return fake_time_us;
+}
+
+static void setPolicy(const uint8_t maxAttempts, const uint32_t backoffUs, const uint32_t maxBackoffUs, const uint32_t budgetUs, const bool resync) {
+    ad5697r_retry_policy_t policy;
+
+    policy.maxAttempts = maxAttempts;
+    policy.backoffUs = backoffUs;
+    policy.maxBackoffUs = maxBackoffUs;
+    policy.budgetUs = budgetUs;
+    policy.resync = resync;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setRetryPolicy(&ad5697r_device, &policy));
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    ad5697r_device.intf.write = ad5697r_emuWrite;
+    ad5697r_device.intf.read = ad5697r_emuRead;
+    ad5697r_device.intf.delay_us = usr_delay_us;
+    ad5697r_device.intf.get_time_us = usr_get_time_us;
+
+    fake_time_us = 0;
+    delay_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Policy ******************************/
+void test_ad5697r_setRetryPolicy_InvalidParams(void) {
+    uint32_t latencyUs = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setRetryPolicy(NULL, &ad5697r_device.retry.policy));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setRetryPolicy(&ad5697r_device, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_resetRetryStats(NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_getRetryLatencyUs(NULL, 999, &latencyUs));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_getRetryLatencyUs(&ad5697r_device, 999, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_getRetryLatencyUs(&ad5697r_device, 1001, &latencyUs));
+}
+
+void test_ad5697r_retry_DisabledByDefault(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_BUSY, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(0, delay_count);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.retry.stats.transactions);
+}
+
+/****************************** Retries ******************************/
+void test_ad5697r_retry_RecoversWithBackoff(void) {
+    uint32_t latencyUs = 0;
+
+    setPolicy(4, 10, 0, 0, false);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_BUSY, 2));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+    TEST_ASSERT_TRUE(ad5697r_device.registers.bits.valid & AD5697R_SHADOW_DAC_A);
+
+    TEST_ASSERT_EQUAL_UINT32(2, delay_count);
+    TEST_ASSERT_EQUAL_UINT32(10, delays[0]);
+    TEST_ASSERT_EQUAL_UINT32(20, delays[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_device.retry.stats.retries);
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.recovered);
+    TEST_ASSERT_EQUAL_UINT32(30, ad5697r_device.retry.stats.maxLatencyUs);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_getRetryLatencyUs(&ad5697r_device, 1000, &latencyUs));
+    TEST_ASSERT_EQUAL_UINT32(30, latencyUs);
+}
+
+void test_ad5697r_retry_BackoffLimit(void) {
+    setPolicy(4, 10, 15, 0, false);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_TIMEOUT, 3));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(3, delay_count);
+    TEST_ASSERT_EQUAL_UINT32(10, delays[0]);
+    TEST_ASSERT_EQUAL_UINT32(15, delays[1]);
+    TEST_ASSERT_EQUAL_UINT32(15, delays[2]);
+}
+
+void test_ad5697r_retry_Exhausted(void) {
+    setPolicy(3, 10, 0, 0, false);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_TIMEOUT, 5));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_device.retry.stats.retries);
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.exhausted);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.retry.stats.recovered);
+    TEST_ASSERT_FALSE(ad5697r_device.registers.bits.valid & AD5697R_SHADOW_DAC_A);
+}
+
+void test_ad5697r_retry_LatencyBudget(void) {
+    // The second backoff would end after the budget
+    setPolicy(8, 100, 0, 250, false);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_BUSY, 5));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.retries);
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.overBudget);
+    TEST_ASSERT_TRUE(ad5697r_device.retry.stats.maxLatencyUs <= 250);
+
+    // Without a clock the backoffs are counted against the budget
+    ad5697r_device.intf.get_time_us = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_device.retry.stats.retries);
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_device.retry.stats.overBudget);
+}
+
+void test_ad5697r_retry_OtherErrorsNotRetried(void) {
+    setPolicy(4, 10, 0, 0, false);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_ERROR, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_UINT32(0, delay_count);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.retry.stats.retries);
+}
+
+/****************************** Resync ******************************/
+void test_ad5697r_retry_ResyncAfterFailedBatch(void) {
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(2)];
+    ad5697r_batch_t batch;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0123, 0x0456));
+    setPolicy(2, 10, 0, 0, true);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_A, 0x0AAA));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchSetReferenceMode(&batch, AD5697R_REF_OFF));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_TIMEOUT, 2));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_batchCommit(&batch));
+
+    // The input register is read back, the reference stays unknown
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.resynced);
+    TEST_ASSERT_TRUE(ad5697r_device.registers.bits.valid & AD5697R_SHADOW_INPUT_A);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, ad5697r_device.registers.bits.CHA_input);
+    TEST_ASSERT_FALSE(ad5697r_device.registers.bits.valid & AD5697R_SHADOW_REF);
+    TEST_ASSERT_TRUE(ad5697r_device.registers.bits.valid & AD5697R_SHADOW_INPUT_B);
+}
+
+/****************************** Statistics ******************************/
+void test_ad5697r_getRetryLatencyUs_Percentiles(void) {
+    uint32_t latencyUs = 0;
+    uint32_t i = 0;
+
+    setPolicy(4, 40, 0, 0, false);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_getRetryLatencyUs(&ad5697r_device, 999, &latencyUs));
+    TEST_ASSERT_EQUAL_UINT32(0, latencyUs);
+
+    for( i = 0; i < 1000; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, (uint16_t)i));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_BUSY, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0FFF));
+
+    // One transaction in 1001 waited for a 40us backoff, landing in the 32..63us bin
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_getRetryLatencyUs(&ad5697r_device, 999, &latencyUs));
+    TEST_ASSERT_EQUAL_UINT32(0, latencyUs);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_getRetryLatencyUs(&ad5697r_device, 1000, &latencyUs));
+    TEST_ASSERT_EQUAL_UINT32(40, latencyUs);
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.retry.stats.latency[6]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_resetRetryStats(&ad5697r_device));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.retry.stats.transactions);
+}
@@ -0,0 +1,200 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_sched.h"
+#include "ad5697r_emu.h"
+
+#define SLOTS   (4)
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device;
+static ad5697r_sched_t sched;
+static ad5697r_sched_slot_t slots[SLOTS];
+static uint32_t fake_time_us = 0;
+static uint32_t frame_ns = 0;
+
+static uint8_t wire[64];
+static uint32_t wire_len = 0;
+static uint32_t writes = 0;
+
+static ad5697r_return_code_t cb_ret[8];
+static bool cb_missed[8];
+static uint32_t cb_count = 0;
+
+static uint32_t usr_get_time_us(void) {
+    return fake_time_us;
+}
+
+static int8_t usr_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    if( (wire_len + len) <= sizeof(wire) ) {
+        memcpy(&wire[wire_len], data, len);
+        wire_len += len;
+    }
+    writes++;
+
+    return ad5697r_emuWrite(busAddr, data, len);
+}
+
+static void usr_done(void *ctx, const ad5697r_return_code_t ret, const bool missed) {
+    (void)ctx;
+    cb_ret[cb_count] = ret;
+    cb_missed[cb_count] = missed;
+    cb_count++;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    ad5697r_device.intf.write = usr_write;
+    ad5697r_device.intf.read = ad5697r_emuRead;
+
+    fake_time_us = 1000;
+    wire_len = 0;
+    writes = 0;
+    cb_count = 0;
+    frame_ns = ad5697r_getTransactionTimeNs(AD5697R_I2C_FAST_MODE_HZ, AD5697R_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedInit(&sched, &ad5697r_device, slots, SLOTS, AD5697R_I2C_FAST_MODE_HZ, 0, usr_get_time_us));
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_schedInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_schedInit(NULL, &ad5697r_device, slots, SLOTS, AD5697R_I2C_FAST_MODE_HZ, 0, usr_get_time_us));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_schedInit(&sched, NULL, slots, SLOTS, AD5697R_I2C_FAST_MODE_HZ, 0, usr_get_time_us));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_schedInit(&sched, &ad5697r_device, NULL, SLOTS, AD5697R_I2C_FAST_MODE_HZ, 0, usr_get_time_us));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_schedInit(&sched, &ad5697r_device, slots, SLOTS, AD5697R_I2C_FAST_MODE_HZ, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedInit(&sched, &ad5697r_device, slots, 0, AD5697R_I2C_FAST_MODE_HZ, 0, usr_get_time_us));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedInit(&sched, &ad5697r_device, slots, SLOTS, 0, 0, usr_get_time_us));
+}
+
+void test_ad5697r_schedSubmit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_schedSubmit(NULL, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0x1000, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_INPUT, 0x02, 0, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_POWER, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE__MAX__, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_REFERENCE, 0, AD5697R_REF__MAX__, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_LDAC_MASK, 0, 0x02, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP__MAX__, AD5697R_OUTPUT_CH_A, 0, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0, AD5697R_SCHED_PRIO__MAX__, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_schedGetPending(&sched));
+}
+
+void test_ad5697r_schedSubmit_Full(void) {
+    uint8_t i = 0;
+
+    for( i = 0; i < SLOTS; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, i, AD5697R_SCHED_PRIO_WAVEFORM, 100, NULL, NULL));
+    }
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0, AD5697R_SCHED_PRIO_WAVEFORM, 100, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.stats.full);
+    TEST_ASSERT_EQUAL_UINT32(SLOTS, ad5697r_schedGetPending(&sched));
+}
+
+/****************************** Ordering ******************************/
+void test_ad5697r_schedDispatch_PriorityThenDeadline(void) {
+    // Each transaction carries one frame
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedInit(&sched, &ad5697r_device, slots, SLOTS, AD5697R_I2C_FAST_MODE_HZ, frame_ns, usr_get_time_us));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_REFERENCE, 0, AD5697R_REF_OFF, AD5697R_SCHED_PRIO_HOUSEKEEPING, 10, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0x0111, AD5697R_SCHED_PRIO_CONTROL, 5000, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_B, 0x0333, AD5697R_SCHED_PRIO_CONTROL, 500, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_B, 0x0222, AD5697R_SCHED_PRIO_WAVEFORM, 100, NULL, NULL));
+
+    while( ad5697r_schedGetPending(&sched) > 0 ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedDispatch(&sched));
+    }
+
+    // Control by deadline, then waveform, then housekeeping
+    TEST_ASSERT_EQUAL_UINT32(4, writes);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x38, 0x33, 0x30, 0x31, 0x11, 0x10, 0x38, 0x22, 0x20, 0x70, 0x00, 0x01}), wire, 12);
+}
+
+void test_ad5697r_schedDispatch_KeepsChannelOrder(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedInit(&sched, &ad5697r_device, slots, SLOTS, AD5697R_I2C_FAST_MODE_HZ, frame_ns, usr_get_time_us));
+
+    // A staged input and its update must not be overtaken by a later urgent write
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_INPUT, AD5697R_OUTPUT_CH_A, 0x0111, AD5697R_SCHED_PRIO_HOUSEKEEPING, 1000, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_POWER, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_TRI_STATE, AD5697R_SCHED_PRIO_HOUSEKEEPING, 1000, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0x0222, AD5697R_SCHED_PRIO_CONTROL, 100, NULL, NULL));
+
+    while( ad5697r_schedGetPending(&sched) > 0 ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedDispatch(&sched));
+    }
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x11, 0x11, 0x10, 0x31, 0x22, 0x20, 0x40, 0x00, 0xFC}), wire, 9);
+    TEST_ASSERT_EQUAL_HEX16(0x0222, emu.dac[0]);
+}
+
+void test_ad5697r_schedDispatch_PacksTransaction(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_LDAC_MASK, 0, AD5697R_OUTPUT_CH_B, AD5697R_SCHED_PRIO_HOUSEKEEPING, 1000, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 0x0123, AD5697R_SCHED_PRIO_CONTROL, 1000, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_INPUT, AD5697R_OUTPUT_CH_B, 0x0456, AD5697R_SCHED_PRIO_WAVEFORM, 1000, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_UPDATE, AD5697R_OUTPUT_CH_B, 0, AD5697R_SCHED_PRIO_WAVEFORM, 1000, NULL, NULL));
+
+    // Without a bus time limit everything goes out at once, most urgent first
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedDispatch(&sched));
+    TEST_ASSERT_EQUAL_UINT32(1, writes);
+    TEST_ASSERT_EQUAL_UINT32(12, wire_len);
+    TEST_ASSERT_EQUAL_HEX8(0x31, wire[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x18, wire[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x28, wire[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x50, wire[9]);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_schedGetPending(&sched));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(4, sched.stats.frames);
+
+    // Nothing left to do
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedDispatch(&sched));
+    TEST_ASSERT_EQUAL_UINT32(1, writes);
+}
+
+/****************************** Statistics ******************************/
+void test_ad5697r_schedDispatch_DeadlinesAndQueueing(void) {
+    const uint32_t frameUs = (frame_ns + 999) / 1000;
+    const uint32_t twoUs = (ad5697r_getTransactionTimeNs(AD5697R_I2C_FAST_MODE_HZ, 2 * AD5697R_FRAME_SIZE) + 999) / 1000;
+
+    // The first frame makes its deadline, the second lands after it
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 1, AD5697R_SCHED_PRIO_CONTROL, 200 + frameUs, usr_done, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_B, 2, AD5697R_SCHED_PRIO_CONTROL, 200 + twoUs - 1, usr_done, NULL));
+    fake_time_us += 200;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedDispatch(&sched));
+    TEST_ASSERT_EQUAL_UINT32(2, cb_count);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, cb_ret[0]);
+    TEST_ASSERT_FALSE(cb_missed[0]);
+    TEST_ASSERT_TRUE(cb_missed[1]);
+
+    TEST_ASSERT_EQUAL_UINT32(2, sched.stats.cls[AD5697R_SCHED_PRIO_CONTROL].completed);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.stats.cls[AD5697R_SCHED_PRIO_CONTROL].missed);
+    TEST_ASSERT_EQUAL_UINT32(200, sched.stats.cls[AD5697R_SCHED_PRIO_CONTROL].maxQueueUs);
+    TEST_ASSERT_EQUAL_UINT64(400, sched.stats.cls[AD5697R_SCHED_PRIO_CONTROL].totalQueueUs);
+
+    // Bus busy for one two-frame transaction over the window
+    fake_time_us += 800;
+    TEST_ASSERT_EQUAL_UINT32(ad5697r_getTransactionTimeNs(AD5697R_I2C_FAST_MODE_HZ, 6) / 1000, ad5697r_schedGetUtilisation(&sched));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedResetStats(&sched));
+    TEST_ASSERT_EQUAL_UINT32(0, sched.stats.cls[AD5697R_SCHED_PRIO_CONTROL].completed);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_schedGetUtilisation(&sched));
+}
+
+void test_ad5697r_schedDispatch_TransportError(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_schedSubmit(&sched, AD5697R_SCHED_OP_WRITE, AD5697R_OUTPUT_CH_A, 1, AD5697R_SCHED_PRIO_WAVEFORM, 1000, usr_done, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_TIMEOUT, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_schedDispatch(&sched));
+    TEST_ASSERT_EQUAL_UINT32(1, cb_count);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, cb_ret[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.stats.cls[AD5697R_SCHED_PRIO_WAVEFORM].errors);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_schedGetPending(&sched));
+}
@@ -0,0 +1,119 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_scrub.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device;
+static ad5697r_scrub_t scrub;
+static uint32_t check_ns = 0;
+static uint32_t repair_ns = 0;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    ad5697r_device.intf.write = ad5697r_emuWrite;
+    ad5697r_device.intf.read = ad5697r_emuRead;
+
+    check_ns = ad5697r_getTransactionTimeNs(AD5697R_I2C_FAST_MODE_HZ, 3) + ad5697r_getTransactionTimeNs(AD5697R_I2C_FAST_MODE_HZ, 2);
+    repair_ns = ad5697r_getTransactionTimeNs(AD5697R_I2C_FAST_MODE_HZ, 3);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubInit(&scrub, &ad5697r_device, AD5697R_I2C_FAST_MODE_HZ, check_ns + repair_ns));
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_scrubInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_scrubInit(NULL, &ad5697r_device, AD5697R_I2C_FAST_MODE_HZ, 1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_scrubInit(&scrub, NULL, AD5697R_I2C_FAST_MODE_HZ, 1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_scrubInit(&scrub, &ad5697r_device, 0, 1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_scrubInit(&scrub, &ad5697r_device, AD5697R_I2C_FAST_MODE_HZ, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_scrubStep(NULL, NULL));
+}
+
+/****************************** Step ******************************/
+void test_ad5697r_scrubStep_HealthyDevice(void) {
+    uint8_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0456));
+
+    // One register per call, alternating, nothing rewritten
+    for( i = 0; i < 4; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubStep(&scrub, NULL));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(4, scrub.stats.checks);
+    TEST_ASSERT_EQUAL_UINT32(4, emu.stats.reads);
+    TEST_ASSERT_EQUAL_UINT32(4, emu.stats.cmdCount[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, emu.stats.cmdCount[3]);
+    TEST_ASSERT_EQUAL_UINT32(0, scrub.stats.repairs);
+}
+
+void test_ad5697r_scrubStep_RepairsCorruption(void) {
+    uint8_t repaired = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0456));
+
+    // A brown-out resets channel A and a glitch flips a bit of input register B
+    emu.input[0] = 0x0000;
+    emu.dac[0] = 0x0000;
+    emu.input[1] = 0x0457;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubStep(&scrub, &repaired));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_INPUT_A, repaired);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.input[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, emu.dac[0]);
+
+    // The staged input register is restored without touching the output
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubStep(&scrub, &repaired));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_INPUT_B, repaired);
+    TEST_ASSERT_EQUAL_HEX16(0x0456, emu.input[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, emu.dac[1]);
+
+    TEST_ASSERT_EQUAL_UINT32(2, scrub.stats.mismatches);
+    TEST_ASSERT_EQUAL_UINT32(2, scrub.stats.repairs);
+}
+
+void test_ad5697r_scrubStep_Budget(void) {
+    uint64_t start = 0;
+    uint8_t i = 0;
+
+    // A quarter of a check and rewrite per call
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubInit(&scrub, &ad5697r_device, AD5697R_I2C_FAST_MODE_HZ, (check_ns + repair_ns + 3) / 4));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    start = bus.busTimeNs;
+
+    for( i = 0; i < 8; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubStep(&scrub, NULL));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(6, scrub.stats.deferred);
+    TEST_ASSERT_EQUAL_UINT32(2, scrub.stats.checks);
+    TEST_ASSERT_TRUE((bus.busTimeNs - start) <= (uint64_t)8 * scrub.budgetNs);
+}
+
+void test_ad5697r_scrubStep_NothingShadowed(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_scrubStep(&scrub, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, scrub.stats.checks);
+    TEST_ASSERT_EQUAL_UINT32(0, bus.transactions);
+}
+
+void test_ad5697r_scrubStep_ReadError(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuInjectError(&emu, AD5697R_RET_ERROR, 1));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_scrubStep(&scrub, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, scrub.stats.errors);
+    TEST_ASSERT_EQUAL_UINT32(0, scrub.stats.repairs);
+}
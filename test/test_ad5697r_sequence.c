@@ -0,0 +1,187 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_sequence.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_sequence_t seq = {0};
+static uint8_t seq_buf[AD5697R_BATCH_BUF_SIZE(16)] = {0};
+static uint8_t last_write[AD5697R_BATCH_BUF_SIZE(16)] = {0};
+static uint32_t last_write_len = 0;
+static uint32_t write_count = 0;
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+void setUp(void)
+{
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = usr_i2c_write;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqInit(&seq, seq_buf, sizeof(seq_buf)));
+
+    last_write_len = 0;
+    write_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    if( len <= sizeof(last_write) ) {
+        memcpy(last_write, data, len);
+    }
+    last_write_len = len;
+    write_count++;
+
+    return AD5697R_RET_OK;
+}
+
+/****************************** seqInit ******************************/
+void test_ad5697r_seqInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_seqInit(NULL, seq_buf, sizeof(seq_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_seqInit(&seq, NULL, sizeof(seq_buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqInit(&seq, seq_buf, 2));
+}
+
+/****************************** seqAdd ******************************/
+void test_ad5697r_seqAdd_AllOperations(void) {
+    const uint8_t expected[] = {
+        0x40, 0x00, 0x3C,   // Power up both channels
+        0x70, 0x00, 0x00,   // Internal reference on
+        0x31, 0x12, 0x30,   // Write and update DAC A
+        0x18, 0x45, 0x60,   // Write input register B
+        0x28, 0x00, 0x00,   // Update DAC B
+        0x11, 0x0A, 0xB0,   // Synchronized - input register A
+        0x18, 0x0C, 0xD0,   // Synchronized - input register B
+        0x29, 0x00, 0x00,   // Synchronized - update DAC A and B
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddOperatingMode(&seq, AD5697R_OP_MODE_NORMAL, AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddReferenceMode(&seq, AD5697R_REF_ON));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddWriteChannel(&seq, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddWriteInputRegister(&seq, AD5697R_OUTPUT_CH_B, 0x0456));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddUpdateChannel(&seq, AD5697R_OUTPUT_CH_B));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddSynchronized(&seq, 0x00AB, 0x00CD));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ad5697r_seqGetFrames(&seq));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, seq_buf, sizeof(expected));
+}
+
+void test_ad5697r_seqAdd_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddWriteChannel(&seq, AD5697R_OUTPUT_CH__MAX__, 0x0000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddWriteChannel(&seq, (ad5697r_output_channel_t)0, 0x0000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddUpdateChannel(&seq, (ad5697r_output_channel_t)2));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddSweep(&seq, (ad5697r_output_channel_t)7, 0, 100, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddOperatingMode(&seq, AD5697R_OP_MODE__MAX__, AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddReferenceMode(&seq, AD5697R_REF__MAX__));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddSweep(&seq, AD5697R_OUTPUT_CH_A, 0, 100, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_seqAddTable(&seq, AD5697R_OUTPUT_CH_A, NULL, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_seqGetFrames(&seq));
+}
+
+void test_ad5697r_seqAdd_CodeRange(void) {
+    const uint16_t table[] = {0x0000, 0x0FFF, 0x1000};
+
+    // A code above 12 bits is rejected before anything is appended
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddWriteChannel(&seq, AD5697R_OUTPUT_CH_A, 0x1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddWriteInputRegister(&seq, AD5697R_OUTPUT_CH_B, 0xFFFF));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddSynchronized(&seq, 0x0123, 0x1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqAddTable(&seq, AD5697R_OUTPUT_CH_A, table, 3));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_seqGetFrames(&seq));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddTable(&seq, AD5697R_OUTPUT_CH_A, table, 2));
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_seqGetFrames(&seq));
+}
+
+void test_ad5697r_seqAdd_Full(void) {
+    // A waveform that does not fit is rejected as a whole
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddSweep(&seq, AD5697R_OUTPUT_CH_A, 0, 10, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_seqAddSine(&seq, AD5697R_OUTPUT_CH_A, 8, 0x0800, 0x07FF));
+    TEST_ASSERT_EQUAL_UINT32(11, ad5697r_seqGetFrames(&seq));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqClear(&seq));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_seqGetFrames(&seq));
+}
+
+/****************************** Waveforms ******************************/
+void test_ad5697r_seqAddSine_Codes(void) {
+    const uint8_t expected[] = {
+        0x31, 0x80, 0x00,   // 0 deg    - 0x800
+        0x31, 0xFF, 0xF0,   // 90 deg   - 0xFFF
+        0x31, 0x80, 0x00,   // 180 deg  - 0x800
+        0x31, 0x00, 0x10,   // 270 deg  - 0x001
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddSine(&seq, AD5697R_OUTPUT_CH_A, 4, 0x0800, 0x07FF));
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, seq_buf, sizeof(expected));
+}
+
+void test_ad5697r_seqAddTriangle_Codes(void) {
+    const uint8_t expected[] = {
+        0x38, 0x00, 0x00,   // 0x000
+        0x38, 0x7F, 0xF0,   // 0x7FF
+        0x38, 0xFF, 0xF0,   // 0xFFF
+        0x38, 0x7F, 0xF0,   // 0x7FF
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddTriangle(&seq, AD5697R_OUTPUT_CH_B, 4, 0x0000, 0x0FFF));
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, seq_buf, sizeof(expected));
+}
+
+void test_ad5697r_seqAddSweep_Descending(void) {
+    const uint8_t expected[] = {
+        0x31, 0x00, 0x30,   // 0x003
+        0x31, 0x00, 0x20,   // 0x002
+        0x31, 0x00, 0x10,   // 0x001
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddSweep(&seq, AD5697R_OUTPUT_CH_A, 3, 1, 1));
+
+    TEST_ASSERT_EQUAL_UINT32(3, ad5697r_seqGetFrames(&seq));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, seq_buf, sizeof(expected));
+}
+
+/****************************** seqReplay ******************************/
+void test_ad5697r_seqReplay_SingleTransaction(void) {
+    const uint16_t table[] = {0x0001, 0x0002, 0x0003, 0x0004};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddTable(&seq, AD5697R_OUTPUT_CH_A, table, 4));
+
+    // Execute the function under test twice, nothing is re-encoded
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqReplay(&ad5697r_device, &seq));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqReplay(&ad5697r_device, &seq));
+
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_BATCH_BUF_SIZE(4), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(seq_buf, last_write, AD5697R_BATCH_BUF_SIZE(4));
+}
+
+void test_ad5697r_seqReplayChunk_Range(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddSweep(&seq, AD5697R_OUTPUT_CH_A, 0, 9, 1));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_seqReplayChunk(&ad5697r_device, &seq, 8, 2);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_BATCH_BUF_SIZE(2), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&seq_buf[AD5697R_BATCH_BUF_SIZE(8)], last_write, AD5697R_BATCH_BUF_SIZE(2));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqReplayChunk(&ad5697r_device, &seq, 9, 2));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_seqReplayChunk(&ad5697r_device, &seq, 10, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_seqReplayChunk(NULL, &seq, 0, 1));
+}
+
+void test_ad5697r_seqReplay_InvalidatesShadow(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0100));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqAddWriteChannel(&seq, AD5697R_OUTPUT_CH_A, 0x0200));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqReplay(&ad5697r_device, &seq));
+
+    // The original value has to be written again
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0100));
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+}
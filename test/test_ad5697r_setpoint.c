@@ -0,0 +1,176 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_setpoint.h"
+#include "ad5697r_emu.h"
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_setpoint_t sp;
+static uint32_t write_count = 0;
+static const uint8_t *last_data = NULL;
+static uint32_t last_len = 0;
+static int8_t write_ret = AD5697R_RET_OK;
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = usr_i2c_write;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+
+    write_count = 0;
+    last_data = NULL;
+    last_len = 0;
+    write_ret = AD5697R_RET_OK;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    write_count++;
+    last_data = data;
+    last_len = len;
+
+    if( write_ret != AD5697R_RET_OK ) {
+        return write_ret;
+    }
+
+    return ad5697r_emuWrite(busAddr, data, len);
+}
+
+/*!
+ * @brief Checks the producer, the ISR and the latest setpoint each own a different buffer
+ */
+static void setpoint_assertOwnership(void) {
+    const uint8_t latest = sp.latest & 0x03;
+
+    TEST_ASSERT_TRUE(sp.back < AD5697R_SETPOINT_BUFFERS);
+    TEST_ASSERT_TRUE(sp.front < AD5697R_SETPOINT_BUFFERS);
+    TEST_ASSERT_TRUE(latest < AD5697R_SETPOINT_BUFFERS);
+    TEST_ASSERT_TRUE((sp.back != sp.front) && (sp.back != latest) && (sp.front != latest));
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_setpointInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setpointInit(NULL, &ad5697r_device, AD5697R_OUTPUT_CH_A, 0, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setpointInit(&sp, NULL, AD5697R_OUTPUT_CH_A, 0, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH__MAX__, 0, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A, 0x1000, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0, 0x1000, NULL));
+
+    // Code B is ignored for a single channel
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_B, 0, 0x1000, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_setpointSet(&sp, 0x1000, 0));
+
+    ad5697r_device.intf.write = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A, 0, 0, NULL));
+}
+
+void test_ad5697r_setpointInit_PublishesInitialCodes(void) {
+    uint16_t codeA = 0;
+    uint16_t codeB = 0;
+
+    ad5697r_device.registers.bits.valid = AD5697R_SHADOW_ALL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0123, 0x0456, NULL));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_POWER | AD5697R_SHADOW_LDAC | AD5697R_SHADOW_REF, ad5697r_device.registers.bits.valid);
+    setpoint_assertOwnership();
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+    TEST_ASSERT_EQUAL_UINT32(3 * AD5697R_FRAME_SIZE, last_len);
+    TEST_ASSERT_EQUAL_UINT16(0x0123, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT16(0x0456, emu.dac[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, sp.stats.fresh);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointGetPublished(&sp, &codeA, &codeB));
+    TEST_ASSERT_EQUAL_UINT16(0x0123, codeA);
+    TEST_ASSERT_EQUAL_UINT16(0x0456, codeB);
+}
+
+/****************************** Set and publish ******************************/
+void test_ad5697r_setpointPublish_LatestCompleteSetpoint(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0000, 0, NULL));
+
+    // Only the last of several setpoints completed between two ticks goes out
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointSet(&sp, 0x0100, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointSet(&sp, 0x0200, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointSet(&sp, 0x0300, 0));
+    setpoint_assertOwnership();
+    TEST_ASSERT_EQUAL_UINT32(3, sp.stats.sets);
+    TEST_ASSERT_EQUAL_UINT32(2, sp.stats.overwritten);
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+    setpoint_assertOwnership();
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, last_len);
+    TEST_ASSERT_EQUAL_HEX8(0x31, last_data[0]);
+    TEST_ASSERT_EQUAL_UINT16(0x0300, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, sp.stats.fresh);
+}
+
+void test_ad5697r_setpointPublish_RepeatsWithoutNewSetpoint(void) {
+    const uint8_t *first = NULL;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0000, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointSet(&sp, 0x0ABC, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+    first = last_data;
+
+    // Every tick writes the same bytes, the held setpoint is simply repeated
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+    TEST_ASSERT_EQUAL_PTR(first, last_data);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, last_len);
+    TEST_ASSERT_EQUAL_UINT32(3, sp.stats.published);
+    TEST_ASSERT_EQUAL_UINT32(1, sp.stats.fresh);
+    TEST_ASSERT_EQUAL_UINT16(0x0ABC, emu.dac[1]);
+}
+
+void test_ad5697r_setpointPublish_BuffersNeverShared(void) {
+    uint16_t codeA = 0;
+    uint16_t codeB = 0;
+    uint32_t i = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0000, 0x0FFF, NULL));
+
+    // Interleave the two sides in an irregular pattern, as a free running main loop and timer would
+    for( i = 0; i < 64; i++ ) {
+        if( (i % 3) != 0 ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointSet(&sp, (uint16_t)i, (uint16_t)(0x0FFF - i)));
+            setpoint_assertOwnership();
+        }
+        if( (i % 4) != 1 ) {
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+            setpoint_assertOwnership();
+
+            // The published frames always match one complete setpoint
+            TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointGetPublished(&sp, &codeA, &codeB));
+            TEST_ASSERT_EQUAL_UINT16(0x0FFF, codeA + codeB);
+            TEST_ASSERT_EQUAL_UINT16(codeA, emu.dac[0]);
+            TEST_ASSERT_EQUAL_UINT16(codeB, emu.dac[1]);
+        }
+    }
+}
+
+void test_ad5697r_setpointPublish_OwnWriteAndErrors(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0010, 0, ad5697r_emuWrite));
+
+    // The device transport is not used once a write function is provided
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointPublish(&sp));
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+    TEST_ASSERT_EQUAL_UINT16(0x0010, emu.dac[0]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setpointInit(&sp, &ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0010, 0, NULL));
+    write_ret = AD5697R_RET_BUSY;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ad5697r_setpointPublish(&sp));
+    TEST_ASSERT_EQUAL_UINT32(1, sp.stats.writeErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, sp.stats.published);
+}
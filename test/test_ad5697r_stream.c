@@ -0,0 +1,242 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_stream.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_stream_t stream = {0};
+static ad5697r_stream_config_t config = {0};
+static uint16_t ring[8] = {0};
+static uint32_t clock_us = 0;
+static uint32_t write_cost_us = 0;
+static uint32_t write_count = 0;
+static uint32_t last_write_len = 0;
+static uint8_t last_write[16] = {0};
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+void usr_delay_us(uint32_t period);
+uint32_t usr_get_time_us(void);
+
+void setUp(void)
+{
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.delay_us = usr_delay_us;
+    ad5697r_device.intf.write = usr_i2c_write;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+
+    memset(&config, 0, sizeof(config));
+    config.layout = AD5697R_STREAM_SINGLE;
+    config.ch = AD5697R_OUTPUT_CH_A;
+    config.sampleRate = 1000;
+    config.get_time_us = usr_get_time_us;
+
+    clock_us = 1000;
+    write_cost_us = 0;
+    write_count = 0;
+    last_write_len = 0;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    // Model the time the transaction spends on the bus
+    clock_us += write_cost_us;
+
+    if( len <= sizeof(last_write) ) {
+        memcpy(last_write, data, len);
+    }
+    last_write_len = len;
+    write_count++;
+
+    return AD5697R_RET_OK;
+}
+
+void usr_delay_us(uint32_t period) {
+    clock_us += period;
+}
+
+uint32_t usr_get_time_us(void) {
+    return clock_us;
+}
+
+/****************************** streamInit ******************************/
+void test_ad5697r_streamInit_AllValid(void) {
+    ad5697r_return_code_t ret = ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_streamGetLevel(&stream));
+}
+
+void test_ad5697r_streamInit_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_streamInit(NULL, &ad5697r_device, &config, ring, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_streamInit(&stream, NULL, &config, ring, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_streamInit(&stream, &ad5697r_device, &config, NULL, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 0));
+
+    config.sampleRate = 0;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    config.sampleRate = 1000;
+    config.layout = AD5697R_STREAM__MAX__;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    // The indices wrap onto the ring with a power of two capacity only
+    config.layout = AD5697R_STREAM_SINGLE;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 6));
+
+    config.ch = 0;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+    config.ch = 2;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    // An interleaved frame writes both channels
+    config.ch = AD5697R_OUTPUT_CH_A;
+    config.layout = AD5697R_STREAM_INTERLEAVED;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 4));
+}
+
+void test_ad5697r_streamInit_NeedsClockOrDelay(void) {
+    // Paced by the delays alone
+    config.get_time_us = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    // Neither a clock nor a delay, the stream time would never advance
+    ad5697r_device.intf.delay_us = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    config.get_time_us = usr_get_time_us;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+}
+
+/****************************** streamWrite ******************************/
+void test_ad5697r_streamWrite_RingFull(void) {
+    uint16_t codes[10] = {0};
+    uint32_t queued = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_streamWrite(&stream, codes, 10, &queued);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(8, queued);
+
+    ret = ad5697r_streamWrite(&stream, codes, 1, &queued);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(0, queued);
+    TEST_ASSERT_EQUAL_UINT32(8, ad5697r_streamGetLevel(&stream));
+}
+
+/****************************** streamPump ******************************/
+void test_ad5697r_streamPump_DeadlinePaced(void) {
+    const uint16_t codes[4] = {0x0100, 0x0200, 0x0300, 0x0400};
+    const uint8_t expected[] = {0x31, 0x40, 0x00};
+    uint32_t queued = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamWrite(&stream, codes, 4, &queued));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamStart(&stream));
+
+    // Execute the function under test
+    write_cost_us = 100;
+    ad5697r_return_code_t ret = ad5697r_streamPump(&stream, 4);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(4, write_count);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT32(4, stream.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, stream.stats.maxJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stream.stats.underruns);
+
+    // Absolute deadlines keep the write time from adding up
+    TEST_ASSERT_EQUAL_UINT32(3000, stream.stats.elapsedUs);
+    TEST_ASSERT_EQUAL_FLOAT(1000.0f, ad5697r_streamGetAchievedRate(&stream));
+}
+
+void test_ad5697r_streamPump_Jitter(void) {
+    const uint16_t codes[2] = {0x0100, 0x0200};
+    uint32_t queued = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamWrite(&stream, codes, 2, &queued));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamStart(&stream));
+
+    // The pump is serviced 250us late for the second deadline
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamPump(&stream, 1));
+    clock_us += 1250;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamPump(&stream, 1));
+
+    TEST_ASSERT_EQUAL_UINT32(250, stream.stats.lastJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(250, stream.stats.maxJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(250, (uint32_t)stream.stats.totalJitterUs);
+}
+
+void test_ad5697r_streamPump_Underrun(void) {
+    const uint16_t codes[1] = {0x0100};
+    uint32_t queued = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamWrite(&stream, codes, 1, &queued));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamStart(&stream));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_streamPump(&stream, 3);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(2, stream.stats.underruns);
+}
+
+void test_ad5697r_streamPump_NonBlocking(void) {
+    const uint16_t codes[2] = {0x0100, 0x0200};
+    uint32_t queued = 0;
+
+    // Without a delay function the pump only writes what is due
+    ad5697r_device.intf.delay_us = NULL;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamWrite(&stream, codes, 2, &queued));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamStart(&stream));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamPump(&stream, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+
+    clock_us += 1000;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamPump(&stream, 10));
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+}
+
+void test_ad5697r_streamPump_Interleaved(void) {
+    const uint16_t codes[4] = {0x0123, 0x0456, 0x0789, 0x0ABC};
+    const uint8_t expected[] = {0x11, 0x78, 0x90, 0x18, 0xAB, 0xC0, 0x29, 0x00, 0x00};
+    uint32_t queued = 0;
+
+    // Use the delay function alone to pace the stream
+    config.layout = AD5697R_STREAM_INTERLEAVED;
+    config.ch = AD5697R_OUTPUT_CH_A_B;
+    config.get_time_us = NULL;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 4));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamWrite(&stream, codes, 2, &queued));
+    TEST_ASSERT_EQUAL_UINT32(2, queued);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamStart(&stream));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_streamPump(&stream, 2);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT32(2000, clock_us);
+}
+
+void test_ad5697r_streamPump_NotStarted(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_streamInit(&stream, &ad5697r_device, &config, ring, 8));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_streamPump(&stream, 1));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_streamPump(NULL, 1));
+}
@@ -0,0 +1,193 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_sequence.h"
+#include "ad5697r_volts.h"
+
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_volts_t conv;
+static uint32_t write_count = 0;
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+
+void setUp(void)
+{
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.write = usr_i2c_write;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+    write_count = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsInit(&conv, &ad5697r_device, 1, 0.0f));
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    write_count++;
+    return AD5697R_RET_OK;
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_voltsInit_InvalidParams(void) {
+    ad5697r_volts_cal_t cal = {1.0f, 0.0f, 1.0f, 0.5f};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_voltsInit(NULL, &ad5697r_device, 1, 0.0f));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_voltsInit(&conv, NULL, 1, 0.0f));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_voltsInit(&conv, &ad5697r_device, 3, 0.0f));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_voltsInit(&conv, &ad5697r_device, 1, -1.0f));
+
+    // min above max
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_voltsSetCalibration(&conv, AD5697R_OUTPUT_CH_A, &cal));
+    cal.min = 0.0f;
+    cal.gain = 0.0f;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_voltsSetCalibration(&conv, AD5697R_OUTPUT_CH_A, &cal));
+    cal.gain = 1.0f;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_voltsSetCalibration(&conv, AD5697R_OUTPUT_CH_A_B, &cal));
+}
+
+/****************************** Codes ******************************/
+void test_ad5697r_voltsToCodes_InternalReference(void) {
+    const float volts[] = {0.0f, 1.25f, 2.5f, 3.0f, -1.0f, 0.000305f, 0.000306f, 1.0f};
+    const uint16_t expected[] = {0, 2048, 4095, 4095, 0, 0, 1, 1638};
+    uint16_t codes[8] = {0};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_A, volts, codes, 8);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(expected, codes, 8);
+}
+
+void test_ad5697r_voltsToCodes_FollowsReference(void) {
+    const float volts[] = {1.25f, 2.5f};
+    uint16_t codes[2] = {0};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsInit(&conv, &ad5697r_device, 2, 4.096f));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_B, volts, codes, 2));
+    TEST_ASSERT_EQUAL_HEX16(1024, codes[0]);
+    TEST_ASSERT_EQUAL_HEX16(2048, codes[1]);
+
+    // Switch to the external reference, 0 - 8.192 V with the gain of 2
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_B, volts, codes, 2));
+    TEST_ASSERT_EQUAL_HEX16(625, codes[0]);
+    TEST_ASSERT_EQUAL_HEX16(1250, codes[1]);
+
+    // No external reference fitted
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsInit(&conv, &ad5697r_device, 1, 0.0f));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_B, volts, codes, 2));
+}
+
+void test_ad5697r_voltsToCodes_Calibration(void) {
+    // Channel A reads 2% high with 10 mV offset, clamp to 0.5 - 2.0 V
+    const ad5697r_volts_cal_t cal = {1.02f, 0.010f, 0.5f, 2.0f};
+    const float volts[] = {1.0f, 0.1f, 2.4f};
+    uint16_t codesA[3] = {0};
+    uint16_t codesB[3] = {0};
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsSetCalibration(&conv, AD5697R_OUTPUT_CH_A, &cal));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_A, volts, codesA, 3));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_B, volts, codesB, 3));
+
+    // (1.0 - 0.01) / 1.02 * 4096 / 2.5 = 1590.4
+    TEST_ASSERT_EQUAL_HEX16(1590, codesA[0]);
+    // ceil((0.5 - 0.01) / 1.02 * 1638.4) = 788, floor((2.0 - 0.01) / 1.02 * 1638.4) = 3196
+    TEST_ASSERT_EQUAL_HEX16(788, codesA[1]);
+    TEST_ASSERT_EQUAL_HEX16(3196, codesA[2]);
+
+    // Channel B keeps the ideal calibration
+    TEST_ASSERT_EQUAL_HEX16(1638, codesB[0]);
+    TEST_ASSERT_EQUAL_HEX16(164, codesB[1]);
+    TEST_ASSERT_EQUAL_HEX16(3932, codesB[2]);
+}
+
+void test_ad5697r_voltsToCodes_VectorMatchesScalar(void) {
+    const ad5697r_volts_cal_t cal = {0.997f, -0.0021f, 0.0f, 2.45f};
+    float volts[203];
+    uint16_t codes[203];
+    uint16_t single = 0;
+    uint32_t i = 0;
+
+    for( i = 0; i < 203; i++ ) {
+        volts[i] = -0.1f + 2.7f * (float)i / 202.0f;
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsSetCalibration(&conv, AD5697R_OUTPUT_CH_A, &cal));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_A, volts, codes, 203));
+
+    // One sample at a time always takes the scalar path
+    for( i = 0; i < 203; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_A, &volts[i], &single, 1));
+        TEST_ASSERT_EQUAL_HEX16(single, codes[i]);
+    }
+}
+
+void test_ad5697r_voltsQ16ToCodes_MatchesFloat(void) {
+    int32_t q16[100];
+    float volts[100];
+    uint16_t codesQ[100];
+    uint16_t codesF[100];
+    uint32_t i = 0;
+
+    for( i = 0; i < 100; i++ ) {
+        q16[i] = (int32_t)(i * 1700);
+        volts[i] = (float)q16[i] / 65536.0f;
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsQ16ToCodes(&conv, AD5697R_OUTPUT_CH_A, q16, codesQ, 100));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsToCodes(&conv, AD5697R_OUTPUT_CH_A, volts, codesF, 100));
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(codesF, codesQ, 100);
+}
+
+/****************************** Frames ******************************/
+void test_ad5697r_voltsToFrames_WireFormat(void) {
+    const float volts[] = {1.25f, 2.5f};
+    const int32_t q16[] = {81920};  // 1.25 V
+    const uint8_t expected[] = {
+        0x38, 0x80, 0x00,   // Write and update DAC B, 0x800
+        0x38, 0xFF, 0xF0,   // Write and update DAC B, 0xFFF
+    };
+    uint8_t frames[AD5697R_BATCH_BUF_SIZE(2)] = {0};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_voltsToFrames(&conv, AD5697R_OUTPUT_CH_B, volts, frames, 2);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frames, sizeof(expected));
+
+    memset(frames, 0, sizeof(frames));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_voltsQ16ToFrames(&conv, AD5697R_OUTPUT_CH_B, q16, frames, 1));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frames, AD5697R_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_voltsToFrames(&conv, AD5697R_OUTPUT_CH_B, volts, NULL, 2));
+}
+
+void test_ad5697r_voltsToSequence_Replay(void) {
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(100)];
+    ad5697r_sequence_t seq;
+    float volts[100];
+    uint32_t i = 0;
+
+    for( i = 0; i < 100; i++ ) {
+        volts[i] = 0.025f * (float)i;
+    }
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqInit(&seq, buf, sizeof(buf)));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_voltsToSequence(&conv, &seq, AD5697R_OUTPUT_CH_A, volts, 100);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(100, ad5697r_seqGetFrames(&seq));
+    TEST_ASSERT_EQUAL_HEX8(0x31, buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x31, buf[99 * AD5697R_FRAME_SIZE]);
+
+    // No room left, nothing is added
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_voltsToSequence(&conv, &seq, AD5697R_OUTPUT_CH_A, volts, 1));
+    TEST_ASSERT_EQUAL_UINT32(100, ad5697r_seqGetFrames(&seq));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_seqReplay(&ad5697r_device, &seq));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+}
@@ -0,0 +1,368 @@
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_wave.h"
+#include "ad5697r_wave_file.h"
+#include "ad5697r_emu.h"
+
+#define WAVE_MAX_SAMPLES    (16)
+#define WAVE_MAX_WRITES     (64)
+
+static ad5697r_emu_bus_t bus;
+static ad5697r_emu_dev_t emu;
+static ad5697r_dev_t ad5697r_device = {0};
+static ad5697r_wave_player_t player;
+static ad5697r_wave_config_t config;
+static ad5697r_wave_info_t info;
+static ad5697r_wave_t wave;
+static uint8_t file[AD5697R_WAVE_HEADER_SIZE + (WAVE_MAX_SAMPLES * AD5697R_WAVE_SAMPLE_SIZE(AD5697R_STREAM_INTERLEAVED))];
+static uint32_t file_len = 0;
+static uint32_t clock_us = 0;
+static uint32_t write_count = 0;
+static const uint8_t *write_data[WAVE_MAX_WRITES];
+static uint32_t write_len[WAVE_MAX_WRITES];
+static int8_t write_ret = AD5697R_RET_OK;
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+void usr_delay_us(uint32_t period);
+uint32_t usr_get_time_us(void);
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuBusInit(&bus, AD5697R_I2C_FAST_MODE_HZ));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_emuAttach(&bus, &emu, 0x0C, false));
+
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
+    ad5697r_device.intf.delay_us = usr_delay_us;
+    ad5697r_device.intf.write = usr_i2c_write;
+    ad5697r_device.intf.i2c_addr = 0x0C;
+
+    memset(&info, 0, sizeof(info));
+    info.layout = AD5697R_STREAM_SINGLE;
+    info.ch = AD5697R_OUTPUT_CH_A;
+    info.codeBits = AD5697R_WAVE_CODE_BITS;
+    info.sampleRate = 1000;
+
+    memset(&config, 0, sizeof(config));
+    config.get_time_us = usr_get_time_us;
+
+    clock_us = 1000;
+    write_count = 0;
+    write_ret = AD5697R_RET_OK;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    if( write_count < WAVE_MAX_WRITES ) {
+        write_data[write_count] = data;
+        write_len[write_count] = len;
+    }
+    write_count++;
+
+    if( write_ret != AD5697R_RET_OK ) {
+        return write_ret;
+    }
+
+    return ad5697r_emuWrite(busAddr, data, len);
+}
+
+void usr_delay_us(uint32_t period) {
+    clock_us += period;
+}
+
+uint32_t usr_get_time_us(void) {
+    return clock_us;
+}
+
+/*!
+ * @brief Builds a waveform file of the given codes in file[] and opens it
+ */
+static void wave_build(const uint16_t *codes, const uint32_t samples) {
+    const uint32_t size = AD5697R_WAVE_SAMPLE_SIZE(info.layout);
+    const uint32_t columns = (info.layout == AD5697R_STREAM_INTERLEAVED) ? 2 : 1;
+    uint32_t i = 0;
+
+    info.samples = samples;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_waveEncodeHeader(file, &info));
+    for( i = 0; i < samples; i++ ) {
+        TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_waveEncodeSample(&file[AD5697R_WAVE_HEADER_SIZE + (i * size)], &info, &codes[i * columns]));
+    }
+    file_len = AD5697R_WAVE_HEADER_SIZE + (samples * size);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_waveOpen(&wave, file, file_len));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerInit(&player, &ad5697r_device, &wave, &config));
+}
+
+/****************************** File format ******************************/
+void test_ad5697r_waveOpen_RoundTrip(void) {
+    const uint16_t codes[] = { 0x0000, 0x0ABC, 0x0FFF };
+
+    info.ch = AD5697R_OUTPUT_CH_B;
+    info.loopStart = 1;
+    info.loopEnd = 3;
+    wave_build(codes, 3);
+
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_WAVE_HEADER_SIZE + 9, file_len);
+    TEST_ASSERT_EQUAL_INT(AD5697R_STREAM_SINGLE, wave.info.layout);
+    TEST_ASSERT_EQUAL_INT(AD5697R_OUTPUT_CH_B, wave.info.ch);
+    TEST_ASSERT_EQUAL_UINT8(12, wave.info.codeBits);
+    TEST_ASSERT_EQUAL_UINT32(1000, wave.info.sampleRate);
+    TEST_ASSERT_EQUAL_UINT32(3, wave.info.samples);
+    TEST_ASSERT_EQUAL_UINT32(1, wave.info.loopStart);
+    TEST_ASSERT_EQUAL_UINT32(3, wave.info.loopEnd);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, wave.sampleSize);
+
+    // The samples are used in place, already in wire format
+    TEST_ASSERT_EQUAL_PTR(&file[AD5697R_WAVE_HEADER_SIZE], wave.samples);
+    TEST_ASSERT_EQUAL_HEX8(0x38, wave.samples[3]);
+    TEST_ASSERT_EQUAL_HEX8(0xAB, wave.samples[4]);
+    TEST_ASSERT_EQUAL_HEX8(0xC0, wave.samples[5]);
+}
+
+void test_ad5697r_waveOpen_Malformed(void) {
+    const uint16_t codes[] = { 0x0100, 0x0200 };
+
+    wave_build(codes, 2);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_waveOpen(NULL, file, file_len));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveOpen(&wave, file, AD5697R_WAVE_HEADER_SIZE - 1));
+
+    // Truncated sample data
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveOpen(&wave, file, file_len - 1));
+
+    file[0] = 'X';
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveOpen(&wave, file, file_len));
+    file[0] = 'A';
+
+    file[4] = AD5697R_WAVE_VERSION + 1;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveOpen(&wave, file, file_len));
+    file[4] = AD5697R_WAVE_VERSION;
+
+    // Loop region past the last sample
+    file[24] = 3;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveOpen(&wave, file, file_len));
+    file[24] = 0;
+
+    // A soft reset frame smuggled into the samples
+    file[AD5697R_WAVE_HEADER_SIZE + 3] = 0x60;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveOpen(&wave, file, file_len));
+
+    // Invalid descriptions are not encoded
+    info.loopStart = 2;
+    info.loopEnd = 1;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveEncodeHeader(file, &info));
+    info.loopStart = 0;
+    info.loopEnd = 0;
+    info.codeBits = 16;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveEncodeHeader(file, &info));
+    info.codeBits = AD5697R_WAVE_CODE_BITS;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveEncodeSample(file, &info, (const uint16_t[]){ 0x1000 }));
+}
+
+/****************************** Playback ******************************/
+void test_ad5697r_wavePlayerPump_PacedFromTheFile(void) {
+    const uint16_t codes[] = { 0x0100, 0x0200, 0x0300, 0x0400 };
+    uint32_t i = 0;
+
+    wave_build(codes, 4);
+    TEST_ASSERT_TRUE(ad5697r_wavePlayerIsDone(&player));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+    TEST_ASSERT_FALSE(ad5697r_wavePlayerIsDone(&player));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 100));
+
+    TEST_ASSERT_TRUE(ad5697r_wavePlayerIsDone(&player));
+    TEST_ASSERT_EQUAL_UINT32(4, write_count);
+    for( i = 0; i < 4; i++ ) {
+        TEST_ASSERT_EQUAL_PTR(&wave.samples[i * AD5697R_FRAME_SIZE], write_data[i]);
+        TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, write_len[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4000, clock_us);
+    TEST_ASSERT_EQUAL_UINT16(0x0400, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, player.stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(4, player.stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, player.stats.maxLatenessUs);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_wavePlayerPump(&player, 1));
+}
+
+void test_ad5697r_wavePlayerPump_Interleaved(void) {
+    const uint16_t codes[] = { 0x0111, 0x0222, 0x0333, 0x0444 };
+
+    info.layout = AD5697R_STREAM_INTERLEAVED;
+    info.ch = AD5697R_OUTPUT_CH_A_B;
+    wave_build(codes, 2);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_WAVE_HEADER_SIZE + 18, file_len);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 1));
+    TEST_ASSERT_EQUAL_UINT32(9, write_len[0]);
+    TEST_ASSERT_EQUAL_UINT16(0x0111, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT16(0x0222, emu.dac[1]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 1));
+    TEST_ASSERT_EQUAL_PTR(&wave.samples[9], write_data[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x0333, emu.dac[0]);
+    TEST_ASSERT_EQUAL_UINT16(0x0444, emu.dac[1]);
+    TEST_ASSERT_TRUE(ad5697r_wavePlayerIsDone(&player));
+}
+
+void test_ad5697r_wavePlayerPump_CatchesUpInChunks(void) {
+    const uint16_t codes[] = { 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008 };
+
+    ad5697r_device.intf.delay_us = NULL;
+    config.chunkSamples = 4;
+    wave_build(codes, 8);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+
+    // Three deadlines passed while the caller was busy, they go out together
+    clock_us += 2500;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 100));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(3 * AD5697R_FRAME_SIZE, write_len[0]);
+    TEST_ASSERT_EQUAL_UINT32(2500, player.stats.maxLatenessUs);
+    TEST_ASSERT_EQUAL_UINT16(0x0003, emu.dac[0]);
+
+    // The chunks never grow past chunkSamples
+    clock_us += 10000;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 100));
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+    TEST_ASSERT_EQUAL_PTR(&wave.samples[3 * AD5697R_FRAME_SIZE], write_data[1]);
+    TEST_ASSERT_EQUAL_UINT32(4 * AD5697R_FRAME_SIZE, write_len[1]);
+    TEST_ASSERT_EQUAL_UINT32(1 * AD5697R_FRAME_SIZE, write_len[2]);
+    TEST_ASSERT_EQUAL_UINT32(8, player.stats.samples);
+    TEST_ASSERT_TRUE(ad5697r_wavePlayerIsDone(&player));
+}
+
+void test_ad5697r_wavePlayerPump_LoopRegion(void) {
+    const uint16_t codes[] = { 0x0010, 0x0020, 0x0030, 0x0040 };
+
+    info.loopStart = 1;
+    info.loopEnd = 3;
+    config.loops = 2;
+    config.chunkSamples = 8;
+    wave_build(codes, 4);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+
+    // Even with every deadline passed, no transaction spans the end of the loop region
+    clock_us += 100000;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 100));
+    TEST_ASSERT_TRUE(ad5697r_wavePlayerIsDone(&player));
+    TEST_ASSERT_EQUAL_UINT32(8, player.stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(2, player.stats.loops);
+
+    // Samples 0-2, 1-2 and, with the loops done, 1-3
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+    TEST_ASSERT_EQUAL_PTR(&wave.samples[0], write_data[0]);
+    TEST_ASSERT_EQUAL_UINT32(3 * AD5697R_FRAME_SIZE, write_len[0]);
+    TEST_ASSERT_EQUAL_PTR(&wave.samples[AD5697R_FRAME_SIZE], write_data[1]);
+    TEST_ASSERT_EQUAL_UINT32(2 * AD5697R_FRAME_SIZE, write_len[1]);
+    TEST_ASSERT_EQUAL_PTR(&wave.samples[AD5697R_FRAME_SIZE], write_data[2]);
+    TEST_ASSERT_EQUAL_UINT32(3 * AD5697R_FRAME_SIZE, write_len[2]);
+    TEST_ASSERT_EQUAL_UINT16(0x0040, emu.dac[0]);
+}
+
+void test_ad5697r_wavePlayerPump_LoopForever(void) {
+    const uint16_t codes[] = { 0x0000, 0x0FFF };
+
+    info.loopEnd = 2;
+    config.loops = AD5697R_WAVE_LOOP_FOREVER;
+    config.get_time_us = NULL;
+    wave_build(codes, 2);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+
+    // Paced by the delays alone, the deadlines stay exact across the rebasing every second
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 2501));
+    TEST_ASSERT_FALSE(ad5697r_wavePlayerIsDone(&player));
+    TEST_ASSERT_EQUAL_UINT32(2501, player.stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(1250, player.stats.loops);
+    TEST_ASSERT_EQUAL_UINT32(2500000, player.paceUs);
+    TEST_ASSERT_EQUAL_UINT32(501, player.slot);
+    TEST_ASSERT_EQUAL_UINT16(0x0000, emu.dac[0]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStop(&player));
+    TEST_ASSERT_TRUE(ad5697r_wavePlayerIsDone(&player));
+}
+
+void test_ad5697r_wavePlayerPump_ShadowAndErrors(void) {
+    const uint16_t codes[] = { 0x0100, 0x0200, 0x0300 };
+
+    ad5697r_device.registers.bits.valid = AD5697R_SHADOW_ALL;
+    wave_build(codes, 3);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_ALL & ~(AD5697R_SHADOW_INPUT_A | AD5697R_SHADOW_DAC_A), ad5697r_device.registers.bits.valid);
+
+    // A failed transaction is counted and its slot is not repeated
+    write_ret = AD5697R_RET_TIMEOUT;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_wavePlayerPump(&player, 100));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(1, player.stats.writeErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, player.pos);
+
+    write_ret = AD5697R_RET_OK;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 100));
+    TEST_ASSERT_EQUAL_UINT32(2, player.stats.samples);
+    TEST_ASSERT_EQUAL_UINT16(0x0300, emu.dac[0]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_wavePlayerInit(NULL, &ad5697r_device, &wave, &config));
+    wave.sampleSize = 9;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_wavePlayerInit(&player, &ad5697r_device, &wave, &config));
+}
+
+void test_ad5697r_wavePlayerInit_NeedsClockOrDelay(void) {
+    const uint16_t codes[] = { 0x0001, 0x0002 };
+
+    wave_build(codes, 2);
+
+    // Paced by the delays alone
+    config.get_time_us = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerInit(&player, &ad5697r_device, &wave, &config));
+
+    // Neither a clock nor a delay, the player time would never advance
+    ad5697r_device.intf.delay_us = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_wavePlayerInit(&player, &ad5697r_device, &wave, &config));
+
+    config.get_time_us = usr_get_time_us;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerInit(&player, &ad5697r_device, &wave, &config));
+}
+
+/****************************** File ******************************/
+void test_ad5697r_waveMap_FileRoundTrip(void) {
+    const uint16_t codes[] = { 0x0123, 0x0456 };
+    char path[] = "/tmp/ad5697r_waveXXXXXX";
+    ad5697r_wave_map_t map;
+    int fd = mkstemp(path);
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    wave_build(codes, 2);
+    TEST_ASSERT_EQUAL_INT((int)file_len, (int)write(fd, file, file_len));
+    close(fd);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_waveMap(&map, path));
+    TEST_ASSERT_EQUAL_UINT32(file_len, map.len);
+    TEST_ASSERT_EQUAL_PTR(&map.data[AD5697R_WAVE_HEADER_SIZE], map.wave.samples);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerInit(&player, &ad5697r_device, &map.wave, &config));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerStart(&player));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_wavePlayerPump(&player, 100));
+    TEST_ASSERT_EQUAL_PTR(&map.wave.samples[AD5697R_FRAME_SIZE], write_data[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x0456, emu.dac[0]);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_waveUnmap(&map));
+    TEST_ASSERT_NULL(map.data);
+
+    // A file that is not a waveform is not left mapped
+    fd = open(path, O_WRONLY | O_TRUNC);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(AD5697R_WAVE_HEADER_SIZE, (int)write(fd, file, AD5697R_WAVE_HEADER_SIZE));
+    close(fd);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_waveMap(&map, path));
+    TEST_ASSERT_NULL(map.data);
+    unlink(path);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_waveMap(&map, "/tmp/ad5697r_wave_does_not_exist"));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_waveMap(NULL, path));
+}
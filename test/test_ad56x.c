@@ -1,19 +1,37 @@
+#include <string.h>
 #include "unity.h"
 #include "ad5697r.h"
 
 static ad5697r_dev_t ad5697r_device = {0};
 static ad5697r_return_code_t desired_read_ret = AD5697R_RET_OK;
+static ad5697r_return_code_t desired_write_ret = AD5697R_RET_OK;
+static uint8_t last_write[64] = {0};
+static uint32_t last_write_len = 0;
+static uint32_t write_count = 0;
+static uint8_t read_data[2] = {0};
+static uint32_t fake_time_us = 0;
+static uint32_t delayed_us = 0;
 
 int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
 int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len);
 void usr_delay_us(uint32_t period);
+uint32_t usr_get_time_us(void);
 
 void setUp(void)
 {
+    memset(&ad5697r_device, 0, sizeof(ad5697r_device));
     ad5697r_device.intf.delay_us = usr_delay_us;
     ad5697r_device.intf.read = usr_i2c_read;
     ad5697r_device.intf.write = usr_i2c_write;
     ad5697r_device.intf.i2c_addr = 0x01;
+
+    desired_write_ret = AD5697R_RET_OK;
+    desired_read_ret = AD5697R_RET_OK;
+    memset(read_data, 0, sizeof(read_data));
+    last_write_len = 0;
+    write_count = 0;
+    fake_time_us = 0;
+    delayed_us = 0;
 }
 
 void tearDown(void)
@@ -23,8 +41,13 @@ void tearDown(void)
 int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
     ad5697r_return_code_t ret = AD5697R_RET_OK;
 
-    // Transmit the data to the specified device from the provided
-    // data buffer.
+    // Capture the data so the tests can check the frames on the wire
+    if( len <= sizeof(last_write) ) {
+        memcpy(last_write, data, len);
+    }
+    last_write_len = len;
+    write_count++;
+    ret = desired_write_ret;
 
     return ret;
 }
@@ -32,6 +55,11 @@ int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t
 int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len) {
     ad5697r_return_code_t ret = AD5697R_RET_OK;
 
+    // Hand back the register contents the test expects
+    if( len <= sizeof(read_data) ) {
+        memcpy(data, read_data, len);
+    }
+
     switch( desired_read_ret ) {
         case AD5697R_RET_OK:
             ret = AD5697R_RET_OK;
@@ -54,6 +82,12 @@ int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len) {
 
 void usr_delay_us(uint32_t period) {
     // Delay for the requested period
+    delayed_us += period;
+    fake_time_us += period;
+}
+
+uint32_t usr_get_time_us(void) {
+    return fake_time_us;
 }
 
 /****************************** writeChannel ******************************/
@@ -230,3 +264,566 @@ void test_ad5697r_setReferenceMode_InvalidRefMode(void) {
 
     TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ret);
 }
+
+/****************************** Frame Layout ******************************/
+void test_ad5697r_writeChannel_FrameLayout(void) {
+    const uint8_t expected[] = {0x38, 0xAB, 0xC0};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0ABC);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+}
+
+void test_ad5697r_setOperatingMode_FrameLayout(void) {
+    const uint8_t expected[] = {0x40, 0x00, 0xBD};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE_1K_TO_GND);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+
+    ret = ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_10K_TO_GND);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+}
+
+void test_ad5697r_setReferenceMode_FrameLayout(void) {
+    const uint8_t expected[] = {0x70, 0x00, 0x01};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+}
+
+/****************************** batch ******************************/
+void test_ad5697r_batch_AllValid(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(5)];
+    const uint8_t expected[] = {
+        0x31, 0x12, 0x30,   // Write and update DAC A
+        0x18, 0x45, 0x60,   // Write input register B
+        0x29, 0x00, 0x00,   // Update DAC A and B
+        0x40, 0x00, 0xFC,   // Power down B, tri-state
+        0x70, 0x00, 0x00,   // Internal reference on
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_B, 0x0456));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchUpdateChannel(&batch, AD5697R_OUTPUT_CH_A_B));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchSetOperatingMode(&batch, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_TRI_STATE));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchSetReferenceMode(&batch, AD5697R_REF_ON));
+
+    // Nothing should hit the bus until the batch is committed
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_batchCommit(&batch);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_INT(AD5697R_OP_MODE_TRI_STATE, ad5697r_device.registers.bits.CHB_mode);
+    TEST_ASSERT_EQUAL_UINT32(5, batch.stats.updates);
+    TEST_ASSERT_EQUAL_UINT32(16, batch.stats.wireBytes);
+    TEST_ASSERT_EQUAL_FLOAT(3.2f, ad5697r_batchGetBytesPerUpdate(&batch));
+}
+
+void test_ad5697r_batch_Full(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(1)];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, 0x0000));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_B, 0x0000);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ret);
+}
+
+void test_ad5697r_batch_CommitFailureKeepsFrames(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(2)];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchSetOperatingMode(&batch, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE_1K_TO_GND));
+
+    // Fail the write and execute the function under test
+    desired_write_ret = AD5697R_RET_BUSY;
+    ad5697r_return_code_t ret = ad5697r_batchCommit(&batch);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_BUSY, ret);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, batch.len);
+    TEST_ASSERT_EQUAL_UINT32(0, batch.stats.updates);
+
+    // The retried commit should go through with the same frames
+    desired_write_ret = AD5697R_RET_OK;
+    ret = ad5697r_batchCommit(&batch);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(0, batch.len);
+    TEST_ASSERT_EQUAL_INT(AD5697R_OP_MODE_1K_TO_GND, ad5697r_device.registers.bits.CHA_mode);
+}
+
+void test_ad5697r_batch_CommitKeepsDirectWrites(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(1)];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    // A direct write between init and commit, on a channel the batch does not touch
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0456));
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_batchCommit(&batch);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT16(0x0123, ad5697r_device.registers.bits.CHA_dac);
+    TEST_ASSERT_EQUAL_UINT16(0x0456, ad5697r_device.registers.bits.CHB_dac);
+    TEST_ASSERT_EQUAL_UINT16(0x0456, ad5697r_device.registers.bits.CHB_input);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_INPUT_A | AD5697R_SHADOW_INPUT_B | AD5697R_SHADOW_DAC_A | AD5697R_SHADOW_DAC_B,
+                           ad5697r_device.registers.bits.valid & (AD5697R_SHADOW_INPUT_A | AD5697R_SHADOW_INPUT_B | AD5697R_SHADOW_DAC_A | AD5697R_SHADOW_DAC_B));
+}
+
+void test_ad5697r_batch_NullParams(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(1)];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_batchInit(NULL, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_batchInit(&batch, NULL, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_batchInit(&batch, &ad5697r_device, NULL, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_batchInit(&batch, &ad5697r_device, buf, 0));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_batchCommit(NULL));
+}
+
+void test_ad5697r_batch_InvalidParams(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(1)];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH__MAX__, 0x0000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_batchSetOperatingMode(&batch, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE__MAX__));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_batchSetReferenceMode(&batch, AD5697R_REF__MAX__));
+    TEST_ASSERT_EQUAL_UINT32(0, batch.len);
+}
+
+/****************************** Write Cache ******************************/
+void test_ad5697r_writeElision_Disabled(void) {
+    // Without elision every call goes on the wire
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.cache.stats.elidedWrites);
+}
+
+void test_ad5697r_writeElision_SkipsRedundantWrites(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+
+    // Execute the functions under test
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0124));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_A, AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_ON));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_ON));
+
+    TEST_ASSERT_EQUAL_UINT32(4, write_count);
+    TEST_ASSERT_EQUAL_UINT32(3, ad5697r_device.cache.stats.elidedWrites);
+    TEST_ASSERT_EQUAL_UINT32(12, ad5697r_device.cache.stats.savedBytes);
+    TEST_ASSERT_EQUAL_HEX16(0x0123, ad5697r_device.registers.bits.CHA_dac);
+    TEST_ASSERT_EQUAL_HEX16(0x0124, ad5697r_device.registers.bits.CHB_dac);
+}
+
+void test_ad5697r_writeElision_FailedWriteInvalidatesShadow(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    // The failed write may or may not have reached the DAC
+    desired_write_ret = AD5697R_RET_TIMEOUT;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0456));
+
+    // So restoring the old value must go on the wire
+    desired_write_ret = AD5697R_RET_OK;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.cache.stats.elidedWrites);
+}
+
+void test_ad5697r_writeElision_InputRegisterInvalidatesDac(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(2)];
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    // Writing the input register may be transparent to the DAC register
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteInputRegister(&batch, AD5697R_OUTPUT_CH_A, 0x0456));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0123));
+
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+}
+
+void test_ad5697r_writeElision_BatchCoalescing(void) {
+    ad5697r_batch_t batch;
+    uint8_t buf[AD5697R_BATCH_BUF_SIZE(4)];
+    const uint8_t expected[] = {
+        0x31, 0x03, 0x00,   // Write and update DAC A, last value wins
+        0x38, 0x01, 0x00,   // Write and update DAC B
+    };
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchInit(&batch, &ad5697r_device, buf, sizeof(buf)));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, 0x0010));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, 0x0020));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_A, 0x0030));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_B, 0x0010));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchWriteChannel(&batch, AD5697R_OUTPUT_CH_B, 0x0010));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_batchCommit(&batch));
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT32(2, ad5697r_device.cache.stats.coalescedWrites);
+    TEST_ASSERT_EQUAL_UINT32(1, ad5697r_device.cache.stats.elidedWrites);
+    TEST_ASSERT_EQUAL_UINT32(9, ad5697r_device.cache.stats.savedBytes);
+
+    // Values committed by the batch are now known to the device shadow
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, 0x0030));
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_resetCacheStats(&ad5697r_device));
+    TEST_ASSERT_EQUAL_UINT32(0, ad5697r_device.cache.stats.savedBytes);
+}
+
+void test_ad5697r_writeElision_InvalidateShadow(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+
+    // Execute the function under test
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_invalidateShadow(&ad5697r_device));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&ad5697r_device, AD5697R_REF_OFF));
+
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_invalidateShadow(NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setWriteElision(NULL, true));
+}
+
+/****************************** Staged Updates ******************************/
+void test_ad5697r_writeInputRegister_AllValid(void) {
+    const uint8_t expected[] = {0x18, 0xFF, 0xF0};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_B, 0x0FFF);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+}
+
+void test_ad5697r_writeInputRegister_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_writeInputRegister(NULL, AD5697R_OUTPUT_CH_A, 0x0000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_writeInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH__MAX__, 0x0000));
+}
+
+void test_ad5697r_updateChannel_AllValid(void) {
+    const uint8_t expected[] = {0x29, 0x00, 0x00};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_updateChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A_B);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+}
+
+void test_ad5697r_writeChannelsSynchronized_AllValid(void) {
+    const uint8_t expected[] = {
+        0x11, 0x12, 0x30,   // Write input register A
+        0x18, 0x45, 0x60,   // Write input register B
+        0x29, 0x00, 0x00,   // Update DAC A and B
+    };
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0123, 0x0456);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX16(0x0123, ad5697r_device.registers.bits.CHA_dac);
+    TEST_ASSERT_EQUAL_HEX16(0x0456, ad5697r_device.registers.bits.CHB_dac);
+}
+
+void test_ad5697r_writeChannelsSynchronized_Elided(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0123, 0x0456));
+
+    // Execute the function under test with only channel B changing
+    ad5697r_return_code_t ret = ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0123, 0x0789);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(6, last_write_len);
+
+    // Execute the function under test with nothing changing
+    ret = ad5697r_writeChannelsSynchronized(&ad5697r_device, 0x0123, 0x0789);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+}
+
+void test_ad5697r_writeChannelsSynchronized_NullDevice(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_writeChannelsSynchronized(NULL, 0x0000, 0x0000));
+}
+
+/****************************** LDAC ******************************/
+static bool ldac_levels[4] = {0};
+static uint32_t ldac_count = 0;
+
+static void usr_ldac(const bool level) {
+    if( ldac_count < sizeof(ldac_levels) ) {
+        ldac_levels[ldac_count] = level;
+    }
+    ldac_count++;
+}
+
+void test_ad5697r_setLdacMask_AllValid(void) {
+    const uint8_t expectedAB[] = {0x50, 0x00, 0x09};
+    const uint8_t expectedA[] = {0x50, 0x00, 0x01};
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_setLdacMask(&ad5697r_device, AD5697R_OUTPUT_CH_A_B);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAB), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedAB, last_write, sizeof(expectedAB));
+
+    ret = ad5697r_setLdacMask(&ad5697r_device, AD5697R_OUTPUT_CH_A);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedA, last_write, sizeof(expectedA));
+}
+
+void test_ad5697r_setLdacMask_Elided(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setWriteElision(&ad5697r_device, true));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setLdacMask(&ad5697r_device, AD5697R_OUTPUT_CH_B));
+
+    // Execute the function under test with the same mask
+    ad5697r_return_code_t ret = ad5697r_setLdacMask(&ad5697r_device, AD5697R_OUTPUT_CH_B);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+}
+
+void test_ad5697r_setLdacMask_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_setLdacMask(NULL, AD5697R_OUTPUT_CH_A));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_setLdacMask(&ad5697r_device, 0x02));
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+}
+
+void test_ad5697r_pulseLdac_AllValid(void) {
+    ad5697r_device.intf.ldac = usr_ldac;
+    ldac_count = 0;
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_pulseLdac(&ad5697r_device);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(2, ldac_count);
+    TEST_ASSERT_FALSE(ldac_levels[0]);
+    TEST_ASSERT_TRUE(ldac_levels[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+}
+
+void test_ad5697r_pulseLdac_NoPin(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_pulseLdac(&ad5697r_device));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_pulseLdac(NULL));
+}
+
+/****************************** Readback ******************************/
+void test_ad5697r_readInputRegister_AllValid(void) {
+    const uint8_t expected[] = {0x08, 0x00, 0x00};
+    uint16_t outputVal = 0;
+
+    read_data[0] = 0xAB;
+    read_data[1] = 0xC0;
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_B, &outputVal);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX16(0x0ABC, outputVal);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+}
+
+void test_ad5697r_readInputRegister_InvalidParams(void) {
+    uint16_t outputVal = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_readInputRegister(NULL, AD5697R_OUTPUT_CH_A, &outputVal));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A, NULL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A_B, &outputVal));
+
+    ad5697r_device.intf.read = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A, &outputVal));
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+}
+
+void test_ad5697r_readInputRegister_ReadError(void) {
+    uint16_t outputVal = 0x0123;
+
+    desired_read_ret = AD5697R_RET_ERROR;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_ERROR, ad5697r_readInputRegister(&ad5697r_device, AD5697R_OUTPUT_CH_A, &outputVal));
+    TEST_ASSERT_EQUAL_HEX16(0x0123, outputVal);
+}
+
+void test_ad5697r_verifyShadow_Mismatch(void) {
+    uint8_t mismatch = 0xFF;
+
+    // Nothing shadowed, nothing read back
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_verifyShadow(&ad5697r_device, &mismatch));
+    TEST_ASSERT_EQUAL_HEX8(0x00, mismatch);
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&ad5697r_device, AD5697R_OUTPUT_CH_A, 0x0ABC));
+    read_data[0] = 0xAB;
+    read_data[1] = 0xC0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_verifyShadow(&ad5697r_device, &mismatch));
+    TEST_ASSERT_EQUAL_HEX8(0x00, mismatch);
+
+    // Execute the function under test with a corrupted register
+    read_data[1] = 0xD0;
+    ad5697r_return_code_t ret = ad5697r_verifyShadow(&ad5697r_device, &mismatch);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_INPUT_A, mismatch);
+}
+
+/****************************** Init ******************************/
+void test_ad5697r_init_SoftResetDefaults(void) {
+    const uint8_t expected[] = {0x39, 0x80, 0x00};  // Write and update A and B, midscale
+    ad5697r_config_t config = {0};
+    ad5697r_init_report_t report;
+
+    config.softReset = true;
+    config.setCodes = true;
+    config.codeA = 0x0800;
+    config.codeB = 0x0800;
+
+    // Execute the function under test
+    ad5697r_return_code_t ret = ad5697r_init(&ad5697r_device, &config, &report);
+
+    // The reset leaves the control registers as configured, only the codes follow
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ret);
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+    TEST_ASSERT_EQUAL_UINT32(2, report.transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, report.frames);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_FRAME_SIZE, last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, AD5697R_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_ALL, ad5697r_device.registers.bits.valid);
+}
+
+void test_ad5697r_init_SingleTransaction(void) {
+    const uint8_t expected[] = {
+        0x70, 0x00, 0x01,   // Reference off
+        0x50, 0x00, 0x01,   // Channel A ignores !LDAC
+        0x40, 0x00, 0xFC,   // B tri-state, A normal
+        0x31, 0x12, 0x30,   // Write and update A
+        0x38, 0x45, 0x60,   // Write and update B
+    };
+    ad5697r_config_t config = {0};
+    ad5697r_init_report_t report;
+
+    config.refMode = AD5697R_REF_OFF;
+    config.modeB = AD5697R_OP_MODE_TRI_STATE;
+    config.ldacMask = AD5697R_OUTPUT_CH_A;
+    config.setCodes = true;
+    config.codeA = 0x0123;
+    config.codeB = 0x0456;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_UINT32(1, report.transactions);
+    TEST_ASSERT_EQUAL_UINT32(5, report.frames);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), last_write_len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_ALL, ad5697r_device.registers.bits.valid);
+    TEST_ASSERT_EQUAL_HEX16(0x0456, ad5697r_device.registers.bits.CHB_dac);
+}
+
+void test_ad5697r_init_SettlingTime(void) {
+    ad5697r_config_t config = {0};
+    ad5697r_init_report_t report;
+
+    ad5697r_device.intf.get_time_us = usr_get_time_us;
+    fake_time_us = 5000;
+
+    // The internal reference has to power up before the outputs are valid
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_REF_POWER_UP_US, report.settleUs);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_REF_POWER_UP_US, delayed_us);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_REF_POWER_UP_US, report.firstOutputUs);
+
+    // An external reference only needs the outputs to settle
+    delayed_us = 0;
+    config.refMode = AD5697R_REF_OFF;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_SETTLING_TIME_US, report.settleUs);
+    TEST_ASSERT_EQUAL_UINT32(AD5697R_SETTLING_TIME_US, delayed_us);
+
+    // Without a clock the time to first output is not measured
+    ad5697r_device.intf.get_time_us = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(0, report.firstOutputUs);
+}
+
+void test_ad5697r_init_InvalidParams(void) {
+    ad5697r_config_t config = {0};
+    ad5697r_init_report_t report;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_init(NULL, &config, &report));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5697r_init(&ad5697r_device, NULL, &report));
+    config.modeA = AD5697R_OP_MODE__MAX__;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_init(&ad5697r_device, &config, &report));
+    config.modeA = AD5697R_OP_MODE_NORMAL;
+    config.ldacMask = 0x02;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_init(&ad5697r_device, &config, &report));
+    config.ldacMask = 0;
+    config.codeB = 0x1000;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+}
+
+void test_ad5697r_init_WriteError(void) {
+    ad5697r_config_t config = {0};
+    ad5697r_init_report_t report;
+
+    config.softReset = true;
+    config.refMode = AD5697R_REF_OFF;
+    desired_write_ret = AD5697R_RET_TIMEOUT;
+
+    // A failed reset stops the bring-up
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5697r_init(&ad5697r_device, &config, &report));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+    TEST_ASSERT_EQUAL_HEX8(0, ad5697r_device.registers.bits.valid);
+    TEST_ASSERT_EQUAL_UINT32(0, delayed_us);
+
+    desired_write_ret = AD5697R_RET_OK;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_softReset(&ad5697r_device));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_SHADOW_POWER | AD5697R_SHADOW_LDAC | AD5697R_SHADOW_REF, ad5697r_device.registers.bits.valid);
+    TEST_ASSERT_EQUAL_HEX8(0x60, last_write[0]);
+}
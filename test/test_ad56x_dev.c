@@ -0,0 +1,305 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_encode.h"
+#include "ad56x_family.h"
+#include "ad56x_dev.h"
+
+AD56X_DEFINE_PART(ad5693r, AD5693R)
+AD56X_DEFINE_DEV(ad5693r, AD5693R)
+AD56X_DEFINE_PART(ad5696r, AD5696R)
+AD56X_DEFINE_DEV(ad5696r, AD5696R)
+AD56X_DEFINE_DEV(ad56x_ad5697r, AD5697R)
+
+static ad56x_dev_t ad56x_device = {0};
+static ad5697r_dev_intf_t intf = {0};
+static ad5697r_return_code_t desired_write_ret = AD5697R_RET_OK;
+static uint8_t last_write[AD56X_FRAME_SIZE] = {0};
+static uint32_t write_count = 0;
+static uint32_t read_count = 0;
+static uint8_t read_data[2] = {0};
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len);
+int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len);
+
+void setUp(void)
+{
+    memset(&ad56x_device, 0, sizeof(ad56x_device));
+    memset(&intf, 0, sizeof(intf));
+    intf.read = usr_i2c_read;
+    intf.write = usr_i2c_write;
+    intf.i2c_addr = 0x0C;
+
+    desired_write_ret = AD5697R_RET_OK;
+    memset(last_write, 0, sizeof(last_write));
+    memset(read_data, 0, sizeof(read_data));
+    write_count = 0;
+    read_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+int8_t usr_i2c_write(const uint8_t busAddr, const uint8_t *data, const uint32_t len) {
+    // Capture the frame so the tests can check it
+    if( len == sizeof(last_write) ) {
+        memcpy(last_write, data, len);
+    }
+    write_count++;
+
+    return desired_write_ret;
+}
+
+int8_t usr_i2c_read(const uint8_t busAddr, uint8_t *data, const uint32_t len) {
+    if( len <= sizeof(read_data) ) {
+        memcpy(data, read_data, len);
+    }
+    read_count++;
+
+    return AD5697R_RET_OK;
+}
+
+/****************************** Init ******************************/
+void test_ad56x_devInit_Checks(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5696r_devInit(NULL, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5696r_devInit(&ad56x_device, NULL));
+
+    intf.i2c_addr = 0x80;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5696r_devInit(&ad56x_device, &intf));
+
+    intf.write = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5696r_devInit(&ad56x_device, &intf));
+
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+}
+
+/****************************** AD5696R ******************************/
+void test_ad56x_writeChannel_AD5696R(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeChannel(&ad56x_device, AD56X_CH(2), 0xABCD));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x34, 0xAB, 0xCD}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX16(0xABCD, ad56x_device.shadow.input[2]);
+    TEST_ASSERT_EQUAL_HEX16(0xABCD, ad56x_device.shadow.dac[2]);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_SHADOW_INPUT(2) | AD56X_SHADOW_DAC(2), ad56x_device.shadow.valid);
+
+    // One frame addresses several channels
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeInputRegister(&ad56x_device, AD56X_CH(0) | AD56X_CH(3), 0x1234));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x19, 0x12, 0x34}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, ad56x_device.shadow.input[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, ad56x_device.shadow.input[3]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_updateChannel(&ad56x_device, AD56X_CH_ALL(AD5696R)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x2F, 0x00, 0x00}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, ad56x_device.shadow.dac[3]);
+    TEST_ASSERT_TRUE(ad56x_device.shadow.valid & AD56X_SHADOW_DAC(3));
+    TEST_ASSERT_FALSE(ad56x_device.shadow.valid & AD56X_SHADOW_DAC(1));
+
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+}
+
+void test_ad56x_writeChannel_InvalidParams(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_devInit(&ad56x_device, &intf));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_writeChannel(&ad56x_device, 0, 0x0000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_writeChannel(&ad56x_device, AD56X_CH(2), 0x0000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_writeChannel(&ad56x_device, AD56X_CH(0), 0x1000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_setLdacMask(&ad56x_device, AD56X_CH(3)));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE__MAX__));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad56x_ad5697r_writeChannel(NULL, AD56X_CH(0), 0x0000));
+
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+}
+
+void test_ad56x_setOperatingMode_AD5696R(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setOperatingMode(&ad56x_device, AD56X_CH(1), AD5697R_OP_MODE_1K_TO_GND));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x00, 0x04}), last_write, AD56X_FRAME_SIZE);
+
+    // The other channels keep their mode
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setOperatingMode(&ad56x_device, AD56X_CH(3), AD5697R_OP_MODE_TRI_STATE));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x00, 0xC4}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_SHADOW_POWER, ad56x_device.shadow.ctrlValid);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setReferenceMode(&ad56x_device, AD5697R_REF_OFF));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x70, 0x00, 0x01}), last_write, AD56X_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setLdacMask(&ad56x_device, AD56X_CH(0) | AD56X_CH(2)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x50, 0x00, 0x05}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_SHADOW_POWER | AD56X_SHADOW_REF | AD56X_SHADOW_LDAC, ad56x_device.shadow.ctrlValid);
+}
+
+void test_ad56x_setWriteElision_SkipsUnchanged(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_setWriteElision(&ad56x_device, true));
+
+    // Unknown registers are always written
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeChannel(&ad56x_device, AD56X_CH(0) | AD56X_CH(1), 0x8000));
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeChannel(&ad56x_device, AD56X_CH(0) | AD56X_CH(1), 0x8000));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeChannel(&ad56x_device, AD56X_CH(1), 0x8000));
+    TEST_ASSERT_EQUAL_UINT32(2, write_count);
+
+    // A channel of the mask that differs sends the frame
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeChannel(&ad56x_device, AD56X_CH(1) | AD56X_CH(2), 0x8000));
+    TEST_ASSERT_EQUAL_UINT32(3, write_count);
+}
+
+void test_ad56x_writeChannel_FailureInvalidates(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_writeChannel(&ad56x_device, AD56X_CH_ALL(AD5696R), 0x0100));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_NORMAL));
+
+    desired_write_ret = AD5697R_RET_TIMEOUT;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5696r_writeChannel(&ad56x_device, AD56X_CH(1), 0x0200));
+    TEST_ASSERT_EQUAL_HEX8(0xFF & ~(AD56X_SHADOW_INPUT(1) | AD56X_SHADOW_DAC(1)), ad56x_device.shadow.valid);
+    TEST_ASSERT_EQUAL_HEX16(0x0100, ad56x_device.shadow.input[1]);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_TIMEOUT, ad5696r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_TRI_STATE));
+    TEST_ASSERT_EQUAL_HEX8(0x00, ad56x_device.shadow.ctrlValid);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_OP_MODE_NORMAL, ad56x_device.shadow.mode[0]);
+}
+
+/****************************** AD5693R ******************************/
+void test_ad56x_controlRegister_AD5693R(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_devInit(&ad56x_device, &intf));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_writeChannel(&ad56x_device, AD56X_CH(0), 0xFFFF));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x30, 0xFF, 0xFF}), last_write, AD56X_FRAME_SIZE);
+
+    // Power-down, reference and gain share the control register, each frame carries all of them
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setReferenceMode(&ad56x_device, AD5697R_REF_OFF));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x10, 0x00}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_SHADOW_POWER | AD56X_SHADOW_REF | AD56X_SHADOW_GAIN, ad56x_device.shadow.ctrlValid);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_10K_TO_GND));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x50, 0x00}), last_write, AD56X_FRAME_SIZE);
+
+    // Gain bit DB11
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setGain(&ad56x_device, AD56X_GAIN_2X));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x58, 0x00}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_GAIN_2X, ad56x_device.shadow.gain);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_NORMAL));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x18, 0x00}), last_write, AD56X_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5693r_setGain(&ad56x_device, AD56X_GAIN__MAX__));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5693r_setLdacMask(&ad56x_device, 0));
+    TEST_ASSERT_EQUAL_UINT32(5, write_count);
+}
+
+void test_ad56x_setGain_ElisionAndPins(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_setWriteElision(&ad56x_device, true));
+
+    // The first write sets the whole control register, so the others become known as well
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setGain(&ad56x_device, AD56X_GAIN_2X));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setGain(&ad56x_device, AD56X_GAIN_2X));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setReferenceMode(&ad56x_device, AD5697R_REF_ON));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+
+    // The parts with a GAIN pin have no gain bit
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad5696r_setGain(&ad56x_device, AD56X_GAIN_2X));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_setGain(&ad56x_device, AD56X_GAIN_2X));
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+}
+
+void test_ad56x_softReset_AD5693R(void) {
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_writeChannel(&ad56x_device, AD56X_CH(0), 0x1234));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setOperatingMode(&ad56x_device, AD56X_CH(0), AD5697R_OP_MODE_TRI_STATE));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_setGain(&ad56x_device, AD56X_GAIN_2X));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_softReset(&ad56x_device));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x80, 0x00}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(0x00, ad56x_device.shadow.valid);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_OP_MODE_NORMAL, ad56x_device.shadow.mode[0]);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_REF_ON, ad56x_device.shadow.refMode);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_GAIN_1X, ad56x_device.shadow.gain);
+    TEST_ASSERT_EQUAL_HEX8(AD56X_SHADOW_POWER | AD56X_SHADOW_LDAC | AD56X_SHADOW_REF | AD56X_SHADOW_GAIN, ad56x_device.shadow.ctrlValid);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_softReset(&ad56x_device));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x60, 0x00, 0x00}), last_write, AD56X_FRAME_SIZE);
+}
+
+/****************************** Readback ******************************/
+void test_ad56x_readInputRegister_Select(void) {
+    uint16_t code = 0;
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_devInit(&ad56x_device, &intf));
+    read_data[0] = 0xBE;
+    read_data[1] = 0xEF;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5696r_readInputRegister(&ad56x_device, 3, &code));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x08, 0x00, 0x00}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, code);
+    TEST_ASSERT_EQUAL_UINT32(1, write_count);
+
+    // The AD5697R code is left aligned in the 16 bits read back
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_devInit(&ad56x_device, &intf));
+    read_data[0] = 0xAB;
+    read_data[1] = 0xC0;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_readInputRegister(&ad56x_device, 1, &code));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x08, 0x00, 0x00}), last_write, AD56X_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX16(0x0ABC, code);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_INV_PARAM, ad56x_ad5697r_readInputRegister(&ad56x_device, 2, &code));
+}
+
+void test_ad56x_readInputRegister_NoSelect(void) {
+    uint16_t code = 0;
+
+    // The single channel part reads back without a no-operation frame
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_devInit(&ad56x_device, &intf));
+    read_data[0] = 0x12;
+    read_data[1] = 0x34;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5693r_readInputRegister(&ad56x_device, 0, &code));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, code);
+    TEST_ASSERT_EQUAL_UINT32(0, write_count);
+    TEST_ASSERT_EQUAL_UINT32(1, read_count);
+
+    ad56x_device.intf.read = NULL;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_NULL_PTR, ad5693r_readInputRegister(&ad56x_device, 0, &code));
+}
+
+/****************************** AD5697R ******************************/
+void test_ad56x_frames_MatchAD5697RDriver(void) {
+    ad5697r_dev_t drv = {0};
+    uint8_t expected[AD56X_FRAME_SIZE];
+
+    // The ad5697r_* driver and the device built on the same instantiation put the same frames on the wire
+    drv.intf = intf;
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_devInit(&ad56x_device, &intf));
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_writeChannel(&drv, AD5697R_OUTPUT_CH_A_B, 0x0ABC));
+    memcpy(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_writeChannel(&ad56x_device, AD56X_CH(0) | AD56X_CH(1), 0x0ABC));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, AD56X_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setOperatingMode(&drv, AD5697R_OUTPUT_CH_B, AD5697R_OP_MODE_TRI_STATE));
+    memcpy(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_setOperatingMode(&ad56x_device, AD56X_CH(1), AD5697R_OP_MODE_TRI_STATE));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, AD56X_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setReferenceMode(&drv, AD5697R_REF_OFF));
+    memcpy(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_setReferenceMode(&ad56x_device, AD5697R_REF_OFF));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, AD56X_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_setLdacMask(&drv, AD5697R_OUTPUT_CH_B));
+    memcpy(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_setLdacMask(&ad56x_device, AD56X_CH(1)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, AD56X_FRAME_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad5697r_softReset(&drv));
+    memcpy(expected, last_write, sizeof(expected));
+    TEST_ASSERT_EQUAL_INT(AD5697R_RET_OK, ad56x_ad5697r_softReset(&ad56x_device));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, last_write, AD56X_FRAME_SIZE);
+}
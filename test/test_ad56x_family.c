@@ -0,0 +1,118 @@
+#include <string.h>
+#include "unity.h"
+#include "ad5697r.h"
+#include "ad5697r_encode.h"
+#include "ad56x_family.h"
+
+AD56X_DEFINE_PART(ad5693r, AD5693R)
+AD56X_DEFINE_PART(ad5696r, AD5696R)
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/****************************** Descriptors ******************************/
+void test_ad56x_part_Descriptors(void) {
+    TEST_ASSERT_EQUAL_STRING("AD5697R", AD56X_AD5697R_NAME);
+    TEST_ASSERT_EQUAL_UINT8(12, AD56X_AD5697R_BITS);
+    TEST_ASSERT_EQUAL_UINT8(2, AD56X_AD5697R_CHANNELS);
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_OUTPUT_CH_A, ad56x_ad5697r_addr(0));
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_OUTPUT_CH_B, ad56x_ad5697r_addr(1));
+    TEST_ASSERT_EQUAL_HEX8(0x08, ad5696r_addr(3));
+    TEST_ASSERT_FALSE(AD56X_AD5693R_LDAC_MASK);
+    TEST_ASSERT_FALSE(AD56X_AD5693R_READ_SELECT);
+    TEST_ASSERT_TRUE(AD56X_AD5696R_READ_SELECT);
+    TEST_ASSERT_TRUE(AD56X_AD5696R_LDAC_MASK);
+    TEST_ASSERT_TRUE(AD56X_AD5693R_GAIN);
+    TEST_ASSERT_FALSE(AD56X_AD5696R_GAIN);
+    TEST_ASSERT_FALSE(AD56X_AD5697R_GAIN);
+
+    TEST_ASSERT_EQUAL_HEX16(0x0FFF, AD56X_MAX_CODE(AD5697R));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, AD56X_MAX_CODE(AD5696R));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, AD56X_MAX_CODE(AD5693R));
+
+    TEST_ASSERT_EQUAL_HEX8(AD5697R_OUTPUT_CH_A_B, ad56x_ad5697r_addrAll());
+    TEST_ASSERT_EQUAL_HEX8(0x0F, ad5696r_addrAll());
+    TEST_ASSERT_EQUAL_HEX8(0x00, ad5693r_addrAll());
+}
+
+/****************************** Data frames ******************************/
+void test_ad56x_encDac_Resolutions(void) {
+    uint8_t frame[AD56X_FRAME_SIZE];
+
+    ad56x_ad5697r_encDac(frame, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_B, 0x0ABC);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x38, 0xAB, 0xC0}), frame, AD56X_FRAME_SIZE);
+
+    ad5696r_encDac(frame, AD5697R_CMD_WRITE_DAC, ad5696r_addr(2), 0xABCD);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x34, 0xAB, 0xCD}), frame, AD56X_FRAME_SIZE);
+
+    ad5693r_encDac(frame, AD5697R_CMD_W_INPUT_REG_N, ad5693r_addr(0), 0x1234);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x10, 0x12, 0x34}), frame, AD56X_FRAME_SIZE);
+}
+
+void test_ad56x_decCode_RoundTrip(void) {
+    uint8_t frame[AD56X_FRAME_SIZE];
+    uint32_t code = 0;
+
+    for( code = 0; code <= AD56X_MAX_CODE(AD5696R); code++ ) {
+        ad5696r_encDac(frame, AD5697R_CMD_WRITE_DAC, ad5696r_addr(0), (uint16_t)code);
+        TEST_ASSERT_EQUAL_HEX16(code, ad5696r_decCode(&frame[1]));
+
+        // Codes above full scale lose their upper bits
+        ad56x_ad5697r_encDac(frame, AD5697R_CMD_WRITE_DAC, AD5697R_OUTPUT_CH_A, (uint16_t)code);
+        TEST_ASSERT_EQUAL_HEX16(code & AD56X_MAX_CODE(AD5697R), ad5697r_decCode(&frame[1]));
+    }
+}
+
+/****************************** Control frames ******************************/
+void test_ad56x_encPower_Layouts(void) {
+    const uint8_t modes[AD56X_MAX_CHANNELS] = {AD5697R_OP_MODE_1K_TO_GND, AD5697R_OP_MODE_10K_TO_GND, AD5697R_OP_MODE_TRI_STATE, AD5697R_OP_MODE_NORMAL};
+    uint8_t frame[AD56X_FRAME_SIZE];
+
+    ad56x_ad5697r_encPower(frame, modes);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x00, 0xBD}), frame, AD56X_FRAME_SIZE);
+
+    ad5696r_encPower(frame, modes);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x00, 0x39}), frame, AD56X_FRAME_SIZE);
+
+    ad5693r_encPower(frame, modes);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x20, 0x00}), frame, AD56X_FRAME_SIZE);
+}
+
+void test_ad56x_encControl_SharedRegister(void) {
+    const uint8_t modes[AD56X_MAX_CHANNELS] = {AD5697R_OP_MODE_10K_TO_GND, AD5697R_OP_MODE_TRI_STATE, 0, 0};
+    uint8_t frame[AD56X_FRAME_SIZE];
+
+    // The AD5693R control register carries power-down, reference and gain (DB11)
+    ad5693r_encControl(frame, AD56X_CMD_POWER, modes, AD5697R_REF_OFF, 1);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x58, 0x00}), frame, AD56X_FRAME_SIZE);
+
+    // The other parts keep the reference in its own register and have no gain bit
+    ad56x_ad5697r_encControl(frame, AD56X_CMD_POWER, modes, AD5697R_REF_OFF, 1);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x00, 0xFE}), frame, AD56X_FRAME_SIZE);
+    ad56x_ad5697r_encControl(frame, AD56X_CMD_REF_SETUP, modes, AD5697R_REF_OFF, 1);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x70, 0x00, 0x01}), frame, AD56X_FRAME_SIZE);
+}
+
+void test_ad56x_encControl_ReferenceResetMask(void) {
+    uint8_t frame[AD56X_FRAME_SIZE];
+
+    ad5696r_encReference(frame, AD5697R_REF_OFF);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x70, 0x00, 0x01}), frame, AD56X_FRAME_SIZE);
+    ad5693r_encReference(frame, AD5697R_REF_OFF);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x10, 0x00}), frame, AD56X_FRAME_SIZE);
+
+    ad5696r_encSoftReset(frame);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x60, 0x00, 0x00}), frame, AD56X_FRAME_SIZE);
+    ad5693r_encSoftReset(frame);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x40, 0x80, 0x00}), frame, AD56X_FRAME_SIZE);
+
+    ad5696r_encLdacMask(frame, 0xFF);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x50, 0x00, 0x0F}), frame, AD56X_FRAME_SIZE);
+    ad56x_ad5697r_encLdacMask(frame, 0xFF);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((uint8_t[]){0x50, 0x00, 0x09}), frame, AD56X_FRAME_SIZE);
+}
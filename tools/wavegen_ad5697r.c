@@ -0,0 +1,338 @@
+/*! @file wavegen_ad5697r.c
+ * @brief Host tool converting CSV data into AD5697R waveform files for ad5697r_wave.h.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ad5697r.h"
+#include "ad5697r_wave.h"
+
+#define WAVEGEN_LINE_SIZE       (256u)
+#define WAVEGEN_MAX_COLUMNS     (2u)
+#define WAVEGEN_FULL_SCALE      (2.5)
+
+/*!
+ * @brief Unit of the values in the input
+ */
+typedef enum {
+    WAVEGEN_CODES,      /* 12bit codes */
+    WAVEGEN_VOLTS,      /* Output voltage, scaled by the full scale */
+    WAVEGEN_UNIT        /* 0.0 to 1.0 of the full scale code */
+} wavegen_format_t;
+
+/*!
+ * @brief Samples read from the input
+ */
+typedef struct {
+    uint16_t *codes;    /* Codes, interleaved A/B for two columns */
+    uint32_t count;     /* Samples read */
+    uint32_t capacity;  /* Samples the codes array holds */
+    uint32_t columns;   /* Columns per sample, 0 until the first sample */
+    uint32_t clamped;   /* Values outside the code range */
+} wavegen_samples_t;
+
+static void wavegen_usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s -r rate [-c A|B|AB] [-f codes|volts|unit] [-s fullscale] [-l start:end] input.csv output.ad5w\n"
+            "  One column is played on the -c channel(s), two columns on A and B together.\n"
+            "  -f volts scales by the -s full scale output, %.1f V by default.\n"
+            "  -l loops the samples from start up to, not including, end.\n",
+            name, WAVEGEN_FULL_SCALE);
+}
+
+/*!
+ * @brief Converts one value to a code, clamping what does not fit
+ *
+ * @return 0, -1 for a value that is not a 12bit code, -2 for a value that is not finite
+ */
+static int wavegen_toCode(const double value, const wavegen_format_t format, const double fullScale, uint16_t *code, uint32_t *clamped) {
+    double scaled = value;
+
+    if( !isfinite(value) ) {
+        return -2;
+    }
+    else if( format == WAVEGEN_VOLTS ) {
+        scaled = (value * (AD5697R_WAVE_MAX_CODE + 1)) / fullScale;
+    }
+    else if( format == WAVEGEN_UNIT ) {
+        scaled = value * AD5697R_WAVE_MAX_CODE;
+    }
+    else if( (value != floor(value)) || (value < 0.0) || (value > AD5697R_WAVE_MAX_CODE) ) {
+        // Codes are taken as they are, a wrong one is an error rather than clamped
+        return -1;
+    }
+
+    if( !isfinite(scaled) ) {
+        // A huge value that overflowed the scaling
+        return -2;
+    }
+
+    scaled = floor(scaled + 0.5);
+    if( (scaled < 0.0) || (scaled > AD5697R_WAVE_MAX_CODE) ) {
+        scaled = (scaled < 0.0) ? 0.0 : AD5697R_WAVE_MAX_CODE;
+        (*clamped)++;
+    }
+
+    *code = (uint16_t)scaled;
+    return 0;
+}
+
+/*!
+ * @brief Splits a line into up to WAVEGEN_MAX_COLUMNS values
+ *
+ * @return Number of values, 0 for a blank or comment line, -1 for a line that does not parse
+ */
+static int wavegen_parseLine(char *line, double *values) {
+    char *p = line;
+    char *end = NULL;
+    int n = 0;
+
+    while( *p != '\0' ) {
+        while( isspace((unsigned char)*p) || (*p == ',') || (*p == ';') ) {
+            p++;
+        }
+        if( (*p == '\0') || (*p == '#') ) {
+            break;
+        }
+        if( n == WAVEGEN_MAX_COLUMNS ) {
+            return -1;
+        }
+
+        errno = 0;
+        values[n] = strtod(p, &end);
+        if( (end == p) || (errno != 0) || !isfinite(values[n]) ) {
+            return -1;
+        }
+
+        p = end;
+        n++;
+    }
+
+    return n;
+}
+
+/*!
+ * @brief Reads every sample of the input
+ */
+static int wavegen_read(FILE *in, const char *path, const wavegen_format_t format, const double fullScale, wavegen_samples_t *samples) {
+    char line[WAVEGEN_LINE_SIZE];
+    double values[WAVEGEN_MAX_COLUMNS];
+    uint16_t *codes = NULL;
+    uint32_t lineNo = 0;
+    int n = 0;
+    int i = 0;
+    int ret = 0;
+
+    while( fgets(line, sizeof(line), in) != NULL ) {
+        lineNo++;
+
+        n = wavegen_parseLine(line, values);
+        if( (n < 0) && (lineNo == 1) ) {
+            // A header row naming the columns
+            continue;
+        }
+        else if( n < 0 ) {
+            fprintf(stderr, "%s:%u: not a row of numbers\n", path, lineNo);
+            return -1;
+        }
+        else if( n == 0 ) {
+            continue;
+        }
+
+        if( samples->columns == 0 ) {
+            samples->columns = (uint32_t)n;
+        }
+        else if( samples->columns != (uint32_t)n ) {
+            fprintf(stderr, "%s:%u: expected %u columns\n", path, lineNo, samples->columns);
+            return -1;
+        }
+
+        if( samples->count == samples->capacity ) {
+            samples->capacity = (samples->capacity == 0) ? 4096 : (samples->capacity * 2);
+            codes = realloc(samples->codes, (size_t)samples->capacity * samples->columns * sizeof(*codes));
+            if( codes == NULL ) {
+                perror("realloc");
+                return -1;
+            }
+            samples->codes = codes;
+        }
+
+        for( i = 0; i < n; i++ ) {
+            ret = wavegen_toCode(values[i], format, fullScale, &samples->codes[(samples->count * samples->columns) + i], &samples->clamped);
+            if( ret == -2 ) {
+                fprintf(stderr, "%s:%u: %g is not finite or out of range\n", path, lineNo, values[i]);
+                return -1;
+            }
+            else if( ret < 0 ) {
+                fprintf(stderr, "%s:%u: %g is not a 12bit code\n", path, lineNo, values[i]);
+                return -1;
+            }
+        }
+        samples->count++;
+    }
+
+    if( ferror(in) ) {
+        perror(path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief Writes the header and the encoded samples
+ */
+static int wavegen_write(FILE *out, const char *path, const ad5697r_wave_info_t *info, const wavegen_samples_t *samples) {
+    uint8_t header[AD5697R_WAVE_HEADER_SIZE];
+    uint8_t sample[AD5697R_WAVE_SAMPLE_SIZE(AD5697R_STREAM_INTERLEAVED)];
+    const uint32_t sampleSize = AD5697R_WAVE_SAMPLE_SIZE(info->layout);
+    uint32_t i = 0;
+
+    if( ad5697r_waveEncodeHeader(header, info) != AD5697R_RET_OK ) {
+        fprintf(stderr, "invalid rate, channel or loop region\n");
+        return -1;
+    }
+    if( fwrite(header, 1, sizeof(header), out) != sizeof(header) ) {
+        perror(path);
+        return -1;
+    }
+
+    for( i = 0; i < samples->count; i++ ) {
+        ad5697r_waveEncodeSample(sample, info, &samples->codes[i * samples->columns]);
+        if( fwrite(sample, 1, sampleSize, out) != sampleSize ) {
+            perror(path);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    wavegen_samples_t samples = {0};
+    ad5697r_wave_info_t info = {0};
+    wavegen_format_t format = WAVEGEN_CODES;
+    double fullScale = WAVEGEN_FULL_SCALE;
+    FILE *in = NULL;
+    FILE *out = NULL;
+    char *end = NULL;
+    int ret = 1;
+    int opt = 0;
+
+    info.ch = AD5697R_OUTPUT_CH_A;
+    info.codeBits = AD5697R_WAVE_CODE_BITS;
+
+    while( (opt = getopt(argc, argv, "r:c:f:s:l:h")) != -1 ) {
+        switch( opt ) {
+            case 'r':
+                info.sampleRate = (uint32_t)strtoul(optarg, &end, 10);
+                if( (*end != '\0') || (info.sampleRate == 0) ) {
+                    fprintf(stderr, "invalid rate: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'c':
+                if( strcmp(optarg, "A") == 0 ) {
+                    info.ch = AD5697R_OUTPUT_CH_A;
+                }
+                else if( strcmp(optarg, "B") == 0 ) {
+                    info.ch = AD5697R_OUTPUT_CH_B;
+                }
+                else if( strcmp(optarg, "AB") == 0 ) {
+                    info.ch = AD5697R_OUTPUT_CH_A_B;
+                }
+                else {
+                    fprintf(stderr, "invalid channel: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'f':
+                if( strcmp(optarg, "codes") == 0 ) {
+                    format = WAVEGEN_CODES;
+                }
+                else if( strcmp(optarg, "volts") == 0 ) {
+                    format = WAVEGEN_VOLTS;
+                }
+                else if( strcmp(optarg, "unit") == 0 ) {
+                    format = WAVEGEN_UNIT;
+                }
+                else {
+                    fprintf(stderr, "invalid format: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 's':
+                fullScale = strtod(optarg, &end);
+                if( (*end != '\0') || !(fullScale > 0.0) ) {
+                    fprintf(stderr, "invalid full scale: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'l':
+                if( sscanf(optarg, "%u:%u", &info.loopStart, &info.loopEnd) != 2 ) {
+                    fprintf(stderr, "invalid loop region: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            default:
+                wavegen_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if( ((argc - optind) != 2) || (info.sampleRate == 0) ) {
+        wavegen_usage(argv[0]);
+        return 1;
+    }
+
+    in = fopen(argv[optind], "r");
+    if( in == NULL ) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    if( wavegen_read(in, argv[optind], format, fullScale, &samples) == 0 ) {
+        if( samples.count == 0 ) {
+            fprintf(stderr, "%s: no samples\n", argv[optind]);
+        }
+        else {
+            info.samples = samples.count;
+            info.layout = (samples.columns == 2) ? AD5697R_STREAM_INTERLEAVED : AD5697R_STREAM_SINGLE;
+            if( info.layout == AD5697R_STREAM_INTERLEAVED ) {
+                info.ch = AD5697R_OUTPUT_CH_A_B;
+            }
+
+            out = fopen(argv[optind + 1], "wb");
+            if( out == NULL ) {
+                perror(argv[optind + 1]);
+            }
+            else {
+                ret = (wavegen_write(out, argv[optind + 1], &info, &samples) == 0) ? 0 : 1;
+                if( fclose(out) != 0 ) {
+                    perror(argv[optind + 1]);
+                    ret = 1;
+                }
+
+                // Leave no partial file behind
+                if( ret != 0 ) {
+                    remove(argv[optind + 1]);
+                }
+            }
+        }
+    }
+
+    fclose(in);
+    free(samples.codes);
+
+    if( ret == 0 ) {
+        printf("%s: %u samples, %u column(s), %u Hz, %u clamped\n", argv[optind + 1], info.samples, samples.columns, info.sampleRate, samples.clamped);
+    }
+
+    return ret;
+}